@@ -10,6 +10,7 @@
 
 // TODO: Temp
 #include <Systems/GeometrySystem.h>
+#include <Systems/JobSystem.hpp>
 #include <Systems/TextureSystem.h>
 #include <Systems/ShaderSystem.h>
 #include <Systems/RenderViewSystem.hpp>
@@ -23,9 +24,57 @@
 #include "GameLogic/TestActors/RotationCubeActor.h"
 #include "Framework/Components/CameraComponent.h"
 
+#define GAME_CULL_GRAIN 64		// 每个并行剔除块至少包含的几何体个数
+
 static FrustumCullMode CullMode = FrustumCullMode::eAABB_Cull;
 static bool EnableFrustumCulling = true;
 
+// Frustum's tests are not const but only read the planes, so it is shared by the culling jobs.
+static bool IsGeometryVisible(Frustum& frustum, const GeometryRenderData& data) {
+	const Geometry* g = data.geometry;
+	const Matrix4& Model = data.model_mat;
+
+	switch (CullMode)
+	{
+	// Bounding sphere calculation
+	case FrustumCullMode::eSphere_Cull:
+	{
+		Vector3 ExtensMin = g->Extents.min.Transform(Model);
+		Vector3 ExtensMax = g->Extents.max.Transform(Model);
+
+		float Min = DMIN(DMIN(ExtensMin.x, ExtensMin.y), ExtensMin.z);
+		float Max = DMIN(DMIN(ExtensMax.x, ExtensMax.y), ExtensMax.z);
+		float Diff = Dabs(Max - Min);
+		float Radius = Diff / 2.0f;
+
+		// Translate/scale the center.
+		Vector3 Center = g->Center.Transform(Model);
+		return frustum.IntersectsSphere(Center, Radius);
+	}
+	// AABB calculation
+	case FrustumCullMode::eAABB_Cull:
+	{
+		if (!EnableFrustumCulling) {
+			return true;
+		}
+
+		// Translate/scale the extents.
+		Vector3 ExtentsMax = g->Extents.max.Transform(Model);
+
+		// Translate/scale the center.
+		Vector3 Center = g->Center.Transform(Model);
+		Vector3 HalfExtents = {
+			Dabs(ExtentsMax.x - Center.x),
+			Dabs(ExtentsMax.y - Center.y),
+			Dabs(ExtentsMax.z - Center.z)
+		};
+		return frustum.IntersectsAABB(Center, HalfExtents);
+	}
+	}
+
+	return false;
+}
+
 bool GameOnEvent(eEventCode code, void* sender, void* listender_inst, SEventContext context) {
 	GameInstance* GameInst = (GameInstance*)listender_inst;
 
@@ -332,12 +381,8 @@ bool GameInstance::Update(float delta_time) {
 	TestText->Tick(delta_time);
 	TestSysText->Tick(delta_time);
 
-	// Ensure this is cleaned up to avoid leaking memory.
-	// TODO: Need a version of this that uses the frame allocator.
-	if (!FrameData.WorldGeometries.empty()) {
-		FrameData.WorldGeometries.clear();
-		std::vector<GeometryRenderData>().swap(FrameData.WorldGeometries);
-	}
+	// Keep the capacity so the list is not reallocated every frame.
+	FrameData.WorldGeometries.clear();
 
 	int px, py, cx, cy;
 	Controller::GetMousePosition(cx, cy);
@@ -384,87 +429,54 @@ bool GameInstance::Update(float delta_time) {
 	CameraFrustum = Frustum(CameraComp->GetPosition(), Forward, Right, Up,
 		(float)WindowSize.Width / (float)WindowSize.Height, Deg2Rad(45.0f), 0.1f, 1000.0f);
 
-	// NOTE: starting at a reasonable default to avoid too many realloc.
-	uint32_t DrawCount = 0;
+	// Gather every geometry of the loaded meshes, cull them in parallel, then keep the visible
+	// ones in their original order.
+	uint32_t CandidateCount = 0;
+	for (uint32_t i = 0; i < (uint32_t)Meshes.Size(); ++i) {
+		if (Meshes[i] != nullptr && Meshes[i]->Generation != INVALID_ID_U8) {
+			CandidateCount += Meshes[i]->geometry_count;
+		}
+	}
+
+	GeometryRenderData* Candidates = FrameAllocator::NewArray<GeometryRenderData>(CandidateCount);
+	uint8_t* Visible = FrameAllocator::NewArray<uint8_t>(CandidateCount);
+	CandidateCount = 0;
 	for (uint32_t i = 0; i < (uint32_t)Meshes.Size(); ++i) {
 		AStaticMeshActor* m = Meshes[i];
-		if (m == nullptr) {
+		if (m == nullptr || m->Generation == INVALID_ID_U8) {
 			continue;
 		}
 
-		if (m->Generation != INVALID_ID_U8) {
-			Matrix4 Model = m->GetWorldTransform();
-
-			for (uint32_t j = 0; j < m->geometry_count; j++) {
-				Geometry* g = m->geometries[j];
-				if (g == nullptr) {
-					continue;
-				}
-
-				switch (CullMode)
-				{
-				// Bounding sphere calculation
-				case FrustumCullMode::eSphere_Cull:
-				{
-					Vector3 ExtensMin = g->Extents.min.Transform(Model);
-					Vector3 ExtensMax = g->Extents.max.Transform(Model);
-
-					float Min = DMIN(DMIN(ExtensMin.x, ExtensMin.y), ExtensMin.z);
-					float Max = DMIN(DMIN(ExtensMax.x, ExtensMax.y), ExtensMax.z);
-					float Diff = Dabs(Max - Min);
-					float Radius = Diff / 2.0f;
-
-					// Translate/scale the center.
-					Vector3 Center = g->Center.Transform(Model);
-
-					if (CameraFrustum.IntersectsSphere(Center, Radius)) {
-						// Add it to the list to be rendered.
-						GeometryRenderData Data;
-						Data.model_mat = Model;
-						Data.geometry = g;
-						Data.uniqueID = m->GetUniqueID();
-						FrameData.WorldGeometries.push_back(Data);
-						DrawCount++;
-					}
-				} break;
-				// AABB calculation
-				case FrustumCullMode::eAABB_Cull:
-				{
-					// Translate/scale the extents.
-					Vector3 ExtentsMax = g->Extents.max.Transform(Model);
-
-					// Translate/scale the center.
-					Vector3 Center = g->Center.Transform(Model);
-					Vector3 HalfExtents = {
-						Dabs(ExtentsMax.x - Center.x),
-						Dabs(ExtentsMax.y - Center.y),
-						Dabs(ExtentsMax.z - Center.z)
-					};
-
-					if (CameraFrustum.IntersectsAABB(Center, HalfExtents) && EnableFrustumCulling) {
-						// Add it to the list to be rendered.
-						GeometryRenderData Data;
-						Data.model_mat = Model;
-						Data.geometry = g;
-						Data.uniqueID = m->GetUniqueID();
-						FrameData.WorldGeometries.push_back(Data);
-						DrawCount++;
-					}
-					else if (!EnableFrustumCulling) {
-						// Add it to the list to be rendered.
-						GeometryRenderData Data;
-						Data.model_mat = Model;
-						Data.geometry = g;
-						Data.uniqueID = m->GetUniqueID();
-						FrameData.WorldGeometries.push_back(Data);
-						DrawCount++;
-					}
-				} break;
-				}
+		Matrix4 Model = m->GetWorldTransform();
+		for (uint32_t j = 0; j < m->geometry_count; j++) {
+			Geometry* g = m->geometries[j];
+			if (g == nullptr) {
+				continue;
 			}
+
+			GeometryRenderData& Data = Candidates[CandidateCount++];
+			Data.model_mat = Model;
+			Data.geometry = g;
+			Data.uniqueID = m->GetUniqueID();
+			Data.InstanceIndex = 0;
 		}
 	}
 
+	Frustum& CullFrustum = CameraFrustum;
+	JobSystem::ParallelFor(0, CandidateCount, GAME_CULL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			Visible[i] = IsGeometryVisible(CullFrustum, Candidates[i]) ? 1 : 0;
+		}
+	});
+
+	uint32_t DrawCount = 0;
+	for (uint32_t i = 0; i < CandidateCount; ++i) {
+		if (Visible[i]) {
+			// Add it to the list to be rendered.
+			FrameData.WorldGeometries.push_back(Candidates[i]);
+			DrawCount++;
+		}
+	}
 
 	// TODO: Temp
 	std::string HoverdObjectName = "None";
@@ -540,7 +552,7 @@ bool GameInstance::Render(SRenderPacket* packet, float delta_time) {
 	IRenderView* WorldView = RenderviewSys.Get("WorldDeferred");
 	if(WorldView) {
 		WorldPacketData WorldData;
-		WorldData.Meshes = FrameData.WorldGeometries;
+		WorldData.Meshes.assign(FrameData.WorldGeometries.begin(), FrameData.WorldGeometries.end());
 		WorldData.GlobalTime = GameTime;
 		if (!RenderviewSys.BuildPacket(WorldView, &WorldData, &packet->views[ViewCounter++])) {
 			GLOG(Log::eError, "Failed to build packet for view 'World'.");
@@ -550,8 +562,7 @@ bool GameInstance::Render(SRenderPacket* packet, float delta_time) {
 	
 	// UI
 	uint32_t UIMeshCount = 0;
-	AStaticMeshActor** TempUIMeshes = (AStaticMeshActor**)Memory::Allocate(sizeof(AStaticMeshActor*) * 10, MemoryType::eMemory_Type_Array);
-	// TODO: Flexible size array.
+	AStaticMeshActor** TempUIMeshes = FrameAllocator::NewArray<AStaticMeshActor*>(UIMeshes.Size());
 	for (uint32_t i = 0; i < (uint32_t)UIMeshes.Size(); ++i) {
 		if (UIMeshes[i]->Generation != INVALID_ID_U8) {
 			TempUIMeshes[UIMeshCount] = UIMeshes[i];
@@ -559,7 +570,7 @@ bool GameInstance::Render(SRenderPacket* packet, float delta_time) {
 		}
 	}
 
-	ATextActor** Texts = (ATextActor**)Memory::Allocate(sizeof(ATextActor*) * 4, MemoryType::eMemory_Type_Array);
+	ATextActor** Texts = FrameAllocator::NewArray<ATextActor*>(4);
 	Texts[0] = TestText;
 	Texts[1] = TestSysText;
 	Texts[2] = GameConsole->GetText();
@@ -584,7 +595,7 @@ bool GameInstance::Render(SRenderPacket* packet, float delta_time) {
 		// Pick uses both world and ui packet data.
 		PickPacketData PickPacket;
 		PickPacket.UIMeshData = UIPacket.meshData;
-		PickPacket.WorldMeshData = FrameData.WorldGeometries;
+		PickPacket.WorldMeshData.assign(FrameData.WorldGeometries.begin(), FrameData.WorldGeometries.end());
 		PickPacket.Texts = UIPacket.Textes;
 		PickPacket.TextCount = UIPacket.textCount;
 
@@ -7,4 +7,6 @@ public:
 	ACubeActor();
 	ACubeActor(const FString& Name);
 	virtual ~ACubeActor();
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(ACubeActor)
\ No newline at end of file
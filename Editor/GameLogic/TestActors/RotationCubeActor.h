@@ -8,4 +8,6 @@ public:
 	ARotationCubeActor(const FString& Name);
 
 	virtual void Tick(float DeltaTime) override;
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(ARotationCubeActor)
\ No newline at end of file
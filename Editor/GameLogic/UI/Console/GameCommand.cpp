@@ -1,6 +1,12 @@
 ﻿#include "GameCommand.h"
 #include <Core/Event.hpp>
 #include <Core/EngineLogger.hpp>
+#include <Systems/JobSystem.hpp>
+
+#include <cstdlib>
+
+#define GAME_JOB_TRACE_FILE "job_trace.json"
+#define GAME_JOB_TRACE_DEFAULT_SECONDS 5.0		// 不带参数时导出最近几秒
 
 void GameCommand::GameExit(CommandContext cmd) {
 	EngineEvent::Fire(eEventCode::Application_Quit, nullptr, SEventContext());
@@ -20,8 +26,74 @@ void GameCommand::GameOnCompilerShader(CommandContext cmd) {
     }
 }
 
+void GameCommand::GameOnJobStats(CommandContext cmd) {
+	JobSystemStats Stats;
+	JobSystem::GetStats(Stats);
+	for (uint32_t i = 0; i < (uint32_t)JobType::eCount; ++i) {
+		GLOG(Log::eInfo, "Jobs %s: %u queued, %.0f%% utilization.", JobSystem::GetTypeName((JobType)i), Stats.queued[i], Stats.type_utilization[i] * 100.0f);
+	}
+	GLOG(Log::eInfo, "Jobs: %u in worker queues, %u of %u workers sleeping.",
+		Stats.local_queued, Stats.sleeping_workers, (uint32_t)Stats.workers.size());
+	GLOG(Log::eInfo, "Jobs: %u callbacks pending, oldest %.1f ms.", Stats.callback_backlog, Stats.oldest_callback_ms);
+	for (uint32_t i = 0; i < (uint32_t)Stats.workers.size(); ++i) {
+		const JobWorkerStats& Worker = Stats.workers[i];
+		if (Worker.processor != INVALID_ID) {
+			GLOG(Log::eInfo, "Job thread #%u (%s): processor %u, node %u, %.0f%% utilization.", i,
+				JobSystem::GetTypeName(Worker.type), Worker.processor, Worker.numa_node, Worker.utilization * 100.0f);
+		}
+	}
+}
+
+void GameCommand::GameOnJobTrace(CommandContext cmd) {
+	double Seconds = GAME_JOB_TRACE_DEFAULT_SECONDS;
+	if (!cmd.Arguments.empty()) {
+		Seconds = atof(cmd.Arguments[0].c_str());
+	}
+
+	uint64_t End = JobSystem::GetTraceTime();
+	uint64_t Window = (uint64_t)(Seconds * 1e9);
+	JobSystem::DumpTrace(GAME_JOB_TRACE_FILE, End > Window ? End - Window : 0, End);
+}
+
+void GameCommand::GameOnLogLevel(CommandContext cmd) {
+	// 不带参数时列出每个分类当前的级别
+	if (cmd.Arguments.size() < 2) {
+		for (uint32_t i = 0; i < (uint32_t)Log::Category::eCount; ++i) {
+			Log::Category Category = (Log::Category)i;
+			GLOG(Log::eInfo, "Log %s: %s.", EngineLogger::GetCategoryName(Category), EngineLogger::GetLevelName(EngineLogger::GetCategoryLevel(Category)));
+		}
+		return;
+	}
+
+	Log::Level Level;
+	if (!EngineLogger::ParseLevel(cmd.Arguments[1].c_str(), Level)) {
+		GLOG(Log::eError, "Unknown log level '%s'.", cmd.Arguments[1].c_str());
+		return;
+	}
+	if (Level < LOG_COMPILE_MIN_LEVEL) {
+		GLOG(Log::eWarn, "Log level %s is compiled out of this build.", EngineLogger::GetLevelName(Level));
+	}
+
+	if (cmd.Arguments[0] == "all") {
+		for (uint32_t i = 0; i < (uint32_t)Log::Category::eCount; ++i) {
+			EngineLogger::SetCategoryLevel((Log::Category)i, Level);
+		}
+		return;
+	}
+
+	Log::Category Category;
+	if (!EngineLogger::ParseCategory(cmd.Arguments[0].c_str(), Category)) {
+		GLOG(Log::eError, "Unknown log category '%s'.", cmd.Arguments[0].c_str());
+		return;
+	}
+	EngineLogger::SetCategoryLevel(Category, Level);
+}
+
 void GameCommand::Setup() {
 	Console::RegisterCommand("exit", 0, std::bind(&GameCommand::GameExit, this, std::placeholders::_1));
 	Console::RegisterCommand("quit", 0, std::bind(&GameCommand::GameExit, this, std::placeholders::_1));
     Console::RegisterCommand("compile shader", 1, std::bind(&GameCommand::GameOnCompilerShader, this, std::placeholders::_1));
+	Console::RegisterCommand("jobs stats", 0, std::bind(&GameCommand::GameOnJobStats, this, std::placeholders::_1));
+	Console::RegisterCommand("jobs trace", 1, std::bind(&GameCommand::GameOnJobTrace, this, std::placeholders::_1));
+	Console::RegisterCommand("log level", 2, std::bind(&GameCommand::GameOnLogLevel, this, std::placeholders::_1));
 }
@@ -8,4 +8,7 @@ public:
 public:
 	void GameExit(CommandContext cmd);
 	void GameOnCompilerShader(CommandContext cmd);
+	void GameOnJobStats(CommandContext cmd);
+	void GameOnJobTrace(CommandContext cmd);
+	void GameOnLogLevel(CommandContext cmd);
 };
\ No newline at end of file
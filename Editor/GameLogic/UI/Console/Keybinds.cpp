@@ -278,13 +278,10 @@ void Keybind::GameOnPrintMemory(eKeys key, KeymapEntryBindType type, KeymapModif
 	(void)user_data;
 	(void)key;
 
-	static size_t AllocCount = 0;
-	size_t PrevAllocCount = AllocCount;
-	AllocCount = Memory::GetAllocateCount();
-	size_t UsedMemory = AllocCount - PrevAllocCount;
+	SMemoryTagStats Stats = Memory::GetTotalStats();
 	FString Usage = Memory::GetMemoryUsageStr();
-	GLOG(Log::eInfo, Usage.CStr());
-	GLOG(Log::eDebug, "Allocations: %llu (%llu this frame)", AllocCount, UsedMemory);
+	GLOG(Log::eInfo, "%s", Usage.CStr());
+	GLOG(Log::eDebug, "Allocations: %llu live (%llu last frame, %.2f KiB/s)", Stats.Count, Stats.FrameAllocations, Stats.BytesPerSecond / 1024.0);
 }
 
 void Keybind::GameOnLoadScene(eKeys key, KeymapEntryBindType type, KeymapModifierFlags modifiers, void* user_data) {
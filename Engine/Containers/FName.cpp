@@ -0,0 +1,183 @@
+﻿#include "FName.hpp"
+
+#include "Platform/Platform.hpp"
+
+#include <atomic>
+#include <new>
+
+#define FNAME_TABLE_SIZE (FNAME_MAX_COUNT * 2)			// 哈希槽数，负载不超过一半
+#define FNAME_BLOCK_COUNT (FNAME_MAX_COUNT / FNAME_BLOCK_SIZE)
+
+struct FNameEntry {
+	const char* Str;
+	uint32_t Length;
+	uint32_t Hash;
+};
+
+struct FNameStringPage {
+	std::atomic<size_t> Used;
+	char Chars[FNAME_PAGE_SIZE];
+};
+
+// Everything is zero-initialized at load time, so names can be created during static initialization.
+// A slot holds the index of its entry, 0 while it is empty. An entry is fully written before its
+// index is published to a slot, and never changes afterwards.
+static std::atomic<uint32_t> NameSlots[FNAME_TABLE_SIZE];
+static std::atomic<FNameEntry*> NameBlocks[FNAME_BLOCK_COUNT];
+static std::atomic<uint32_t> NextNameIndex{ 1 };
+static std::atomic<FNameStringPage*> CurrentPage{ nullptr };
+
+static uint32_t HashName(const char* str, size_t length) {
+	// FNV-1a
+	uint32_t Hash = 2166136261u;
+	for (size_t i = 0; i < length; ++i) {
+		Hash ^= (unsigned char)str[i];
+		Hash *= 16777619u;
+	}
+	return Hash;
+}
+
+static const FNameEntry& GetEntry(uint32_t index) {
+	return NameBlocks[index / FNAME_BLOCK_SIZE].load(std::memory_order_acquire)[index % FNAME_BLOCK_SIZE];
+}
+
+static bool IsSameName(uint32_t index, const char* str, size_t length, uint32_t hash) {
+	const FNameEntry& Entry = GetEntry(index);
+	return Entry.Hash == hash && Entry.Length == length && memcmp(Entry.Str, str, length) == 0;
+}
+
+static FNameEntry* GetOrCreateBlock(uint32_t block_index) {
+	FNameEntry* Block = NameBlocks[block_index].load(std::memory_order_acquire);
+	if (Block != nullptr) {
+		return Block;
+	}
+
+	FNameEntry* NewBlock = (FNameEntry*)Platform::PlatformAllocate(sizeof(FNameEntry) * FNAME_BLOCK_SIZE, false);
+	if (NewBlock == nullptr) {
+		return nullptr;
+	}
+
+	if (NameBlocks[block_index].compare_exchange_strong(Block, NewBlock, std::memory_order_acq_rel)) {
+		return NewBlock;
+	}
+
+	// Another thread installed the block first.
+	Platform::PlatformFree(NewBlock, false);
+	return Block;
+}
+
+static char* AllocateChars(size_t size) {
+	if (size > FNAME_PAGE_SIZE / 4) {
+		return (char*)Platform::PlatformAllocate(size, false);
+	}
+
+	for (;;) {
+		FNameStringPage* Page = CurrentPage.load(std::memory_order_acquire);
+		if (Page != nullptr) {
+			size_t Offset = Page->Used.fetch_add(size, std::memory_order_relaxed);
+			if (Offset + size <= FNAME_PAGE_SIZE) {
+				return Page->Chars + Offset;
+			}
+		}
+
+		FNameStringPage* NewPage = (FNameStringPage*)Platform::PlatformAllocate(sizeof(FNameStringPage), false);
+		if (NewPage == nullptr) {
+			return nullptr;
+		}
+
+		new (&NewPage->Used) std::atomic<size_t>(size);
+		if (CurrentPage.compare_exchange_strong(Page, NewPage, std::memory_order_acq_rel)) {
+			return NewPage->Chars;
+		}
+
+		Platform::PlatformFree(NewPage, false);
+	}
+}
+
+static uint32_t CreateEntry(const char* str, size_t length, uint32_t hash) {
+	uint32_t Index = NextNameIndex.fetch_add(1, std::memory_order_relaxed);
+	if (Index >= FNAME_MAX_COUNT) {
+		GLOG(Log::eFatal, "FName table is full (%u names), cannot add '%.*s'.", FNAME_MAX_COUNT, (int)length, str);
+		return 0;
+	}
+
+	FNameEntry* Block = GetOrCreateBlock(Index / FNAME_BLOCK_SIZE);
+	char* Chars = AllocateChars(length + 1);
+	if (Block == nullptr || Chars == nullptr) {
+		GLOG(Log::eFatal, "FName cannot allocate storage for '%.*s'.", (int)length, str);
+		return 0;
+	}
+
+	Platform::PlatformCopyMemory(Chars, str, length);
+	Chars[length] = '\0';
+
+	FNameEntry& Entry = Block[Index % FNAME_BLOCK_SIZE];
+	Entry.Str = Chars;
+	Entry.Length = (uint32_t)length;
+	Entry.Hash = hash;
+	return Index;
+}
+
+static uint32_t FindOrAddName(const char* str, size_t length, bool add) {
+	if (str == nullptr || length == 0) {
+		return 0;
+	}
+
+	uint32_t Hash = HashName(str, length);
+	uint32_t NewIndex = 0;
+
+	for (size_t Slot = Hash & (FNAME_TABLE_SIZE - 1);; Slot = (Slot + 1) & (FNAME_TABLE_SIZE - 1)) {
+		uint32_t Index = NameSlots[Slot].load(std::memory_order_acquire);
+
+		while (Index == 0) {
+			if (!add) {
+				return 0;
+			}
+
+			// Created lazily, and kept across retries, so losing a race costs no extra entry.
+			if (NewIndex == 0) {
+				NewIndex = CreateEntry(str, length, Hash);
+				if (NewIndex == 0) {
+					return 0;
+				}
+			}
+
+			if (NameSlots[Slot].compare_exchange_strong(Index, NewIndex, std::memory_order_acq_rel)) {
+				return NewIndex;
+			}
+			// Index now holds whatever another thread published here, check it below.
+		}
+
+		if (IsSameName(Index, str, length, Hash)) {
+			// NewIndex, if any, stays unreachable. Only happens when two threads add the same name at once.
+			return Index;
+		}
+	}
+}
+
+FName::FName(const char* str) : Index(FindOrAddName(str, str ? strlen(str) : 0, true)) {}
+
+FName::FName(const char* str, size_t length) : Index(FindOrAddName(str, length, true)) {}
+
+FName FName::Find(const char* str) {
+	FName Name;
+	Name.Index = FindOrAddName(str, str ? strlen(str) : 0, false);
+	return Name;
+}
+
+const char* FName::CStr() const {
+	return Index == 0 ? "" : GetEntry(Index).Str;
+}
+
+size_t FName::Length() const {
+	return Index == 0 ? 0 : GetEntry(Index).Length;
+}
+
+uint32_t FName::GetHash() const {
+	return Index == 0 ? 0 : GetEntry(Index).Hash;
+}
+
+uint32_t FName::GetNameCount() {
+	uint32_t Count = NextNameIndex.load(std::memory_order_relaxed);
+	return Count < FNAME_MAX_COUNT ? Count : FNAME_MAX_COUNT;
+}
@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include "FString.hpp"
+
+#define FNAME_MAX_COUNT (1u << 16)		// 名字表最多容纳的名字数
+#define FNAME_BLOCK_SIZE 1024			// 名字条目按块分配，每块的条目数
+#define FNAME_PAGE_SIZE KIBIBYTES(64)	// 名字字符按页分配
+
+/**
+ * @brief 全局驻留的名字，内部只是名字表中的 32 位下标。
+ *
+ * 特性：
+ *  - 相同内容（区分大小写）的字符串总是得到同一个下标，比较与哈希都是整数操作
+ *  - 名字表无锁：查找只读原子槽，新名字通过 CAS 发布，可在任意线程构造 FName
+ *  - 每个条目缓存字符串长度与哈希，驻留时不需要重新计算
+ *  - 名字一旦驻留就不会释放，不依赖 Memory 的初始化与关闭顺序
+ *  - 下标 0 保留给空名字（None）
+ *
+ * 使用示例：
+ *   FName Name("Checkerboard");
+ *   if (Name == FName("Checkerboard")) { ... }   // 只比较下标
+ *   Name.CStr();                                  // 取回原始字符串
+ *
+ * 构造 FName 需要对字符串做一次哈希和查表，频繁使用的名字应当保存 FName 而不是每次从字符串构造。
+ */
+class DAPI FName {
+public:
+	FName() : Index(0) {}
+	FName(const char* str);
+	FName(const char* str, size_t length);
+	FName(const FString& str) : FName(str.CStr(), str.Length()) {}
+
+	/**
+	 * @brief 只查找不驻留，名字不存在时返回 None。
+	 */
+	static FName Find(const char* str);
+
+	const char* CStr() const;
+	FString ToString() const { return FString(CStr()); }
+	size_t Length() const;
+
+	uint32_t GetIndex() const { return Index; }
+	uint32_t GetHash() const;
+	bool IsNone() const { return Index == 0; }
+
+	friend bool operator==(FName n1, FName n2) { return n1.Index == n2.Index; }
+	friend bool operator!=(FName n1, FName n2) { return n1.Index != n2.Index; }
+	// 按驻留顺序排序，不是字典序
+	friend bool operator<(FName n1, FName n2) { return n1.Index < n2.Index; }
+
+	/**
+	 * @brief 已分配的名字下标数（包含 None）。两个线程同时驻留同一个新名字时会多占一个下标。
+	 */
+	static uint32_t GetNameCount();
+
+private:
+	uint32_t Index;
+};
+
+// 下标本身就唯一，TMap 会再混合一次哈希
+template<>
+struct TDefaultHasher<FName> {
+	size_t operator()(FName name) const noexcept {
+		return name.GetIndex();
+	}
+};
+
+namespace std {
+	template<>
+	struct hash<FName> {
+		size_t operator()(FName name) const noexcept {
+			return name.GetIndex();
+		}
+	};
+}
@@ -3,31 +3,33 @@
 #include <climits>
 #include <cstdlib>
 
-FString::FString() : Str(nullptr), Len(0), Capacity(0) { InitializeEmpty(); }
+FString::FString() : Len(0), HeapCapacity(0) { InitializeEmpty(); }
 
-FString::FString(const FString& str) : Str(nullptr), Len(0), Capacity(0) {
-	if (str.Len > 0 && str.Str != nullptr) {
+FString::FString(const FString& str) : Len(0), HeapCapacity(0) {
+	InitializeEmpty();
+	if (str.Len > 0) {
 		EnsureCapacity(str.Len);
 		Len = str.Len;
-		Memory::Copy(Str, str.Str, Len);
-		Str[Len] = '\0';
+		Memory::Copy(Buffer(), str.Buffer(), Len);
+		Buffer()[Len] = '\0';
 	}
-	else { InitializeEmpty(); }
 }
 
-FString::FString(FString&& str) noexcept
-	: Str(str.Str), Len(str.Len), Capacity(str.Capacity) {
-	str.Str = nullptr; str.Len = 0; str.Capacity = 0;
+FString::FString(FString&& str) noexcept : Len(0), HeapCapacity(0) {
+	// 没有自引用，整体拷贝即可同时处理内联与堆两种情况
+	Memory::Copy(this, &str, sizeof(FString));
+	str.Len = 0; str.HeapCapacity = 0; str.InlineStr[0] = '\0';
 }
 
-FString::FString(const char* str) : Str(nullptr), Len(0), Capacity(0) {
+FString::FString(const char* str) : Len(0), HeapCapacity(0) {
+	InitializeEmpty();
 	if (str != nullptr && str[0] != '\0') {
-		Len = strlen(str);
-		EnsureCapacity(Len);
-		Memory::Copy(Str, str, Len);
-		Str[Len] = '\0';
+		size_t new_len = strlen(str);
+		EnsureCapacity(new_len);
+		Len = static_cast<uint32_t>(new_len);
+		Memory::Copy(Buffer(), str, Len);
+		Buffer()[Len] = '\0';
 	}
-	else { InitializeEmpty(); }
 }
 
 FString::~FString() { ReleaseMemory(); }
@@ -38,11 +40,11 @@ FString::~FString() { ReleaseMemory(); }
 
 FString& FString::operator=(const FString& str) {
 	if (this == &str) return *this;
-	if (str.Len > 0 && str.Str != nullptr) {
+	if (str.Len > 0) {
 		EnsureCapacity(str.Len);
 		Len = str.Len;
-		Memory::Copy(Str, str.Str, Len);
-		Str[Len] = '\0';
+		Memory::Copy(Buffer(), str.Buffer(), Len);
+		Buffer()[Len] = '\0';
 	}
 	else { Clear(); }
 	return *this;
@@ -51,20 +53,20 @@ FString& FString::operator=(const FString& str) {
 FString& FString::operator=(FString&& str) noexcept {
 	if (this != &str) {
 		ReleaseMemory();
-		Str = str.Str; Len = str.Len; Capacity = str.Capacity;
-		str.Str = nullptr; str.Len = 0; str.Capacity = 0;
+		Memory::Copy(this, &str, sizeof(FString));
+		str.Len = 0; str.HeapCapacity = 0; str.InlineStr[0] = '\0';
 	}
 	return *this;
 }
 
 FString& FString::operator=(const char* str) {
-	if (str == Str) return *this;
+	if (str == Buffer()) return *this;
 	if (str != nullptr && str[0] != '\0') {
 		size_t new_len = strlen(str);
 		EnsureCapacity(new_len);
-		Len = new_len;
-		Memory::Copy(Str, str, Len);
-		Str[Len] = '\0';
+		Len = static_cast<uint32_t>(new_len);
+		Memory::Copy(Buffer(), str, Len);
+		Buffer()[Len] = '\0';
 	}
 	else { Clear(); }
 	return *this;
@@ -76,9 +78,11 @@ FString& FString::operator=(const char* str) {
 
 FString& FString::operator+=(const FString& str) {
 	if (str.Len > 0) {
-		EnsureCapacity(Len + str.Len);
-		Memory::Copy(Str + Len, str.Str, str.Len);
-		Len += str.Len; Str[Len] = '\0';
+		// str 可能就是 *this，扩容前先记下长度
+		uint32_t slen = str.Len;
+		EnsureCapacity(Len + slen);
+		Memory::Copy(Buffer() + Len, str.Buffer(), slen);
+		Len += slen; Buffer()[Len] = '\0';
 	}
 	return *this;
 }
@@ -86,16 +90,21 @@ FString& FString::operator+=(const FString& str) {
 FString& FString::operator+=(const char* str) {
 	if (str != nullptr && str[0] != '\0') {
 		size_t slen = strlen(str);
+		// str 可能指向自身的缓冲区，扩容会覆盖内联字符或释放旧的堆内存，按偏移重新定位
+		const char* Chars = Buffer();
+		const bool Aliased = str >= Chars && str < Chars + Len;
+		const size_t Offset = Aliased ? static_cast<size_t>(str - Chars) : 0;
 		EnsureCapacity(Len + slen);
-		Memory::Copy(Str + Len, str, slen);
-		Len += slen; Str[Len] = '\0';
+		if (Aliased) str = Buffer() + Offset;
+		Memory::Copy(Buffer() + Len, str, slen);
+		Len += static_cast<uint32_t>(slen); Buffer()[Len] = '\0';
 	}
 	return *this;
 }
 
 FString& FString::operator+=(char c) {
 	EnsureCapacity(Len + 1);
-	Str[Len++] = c; Str[Len] = '\0';
+	Buffer()[Len++] = c; Buffer()[Len] = '\0';
 	return *this;
 }
 
@@ -105,12 +114,12 @@ FString& FString::operator+=(char c) {
 
 char& FString::operator[](size_t i) {
 	if (i >= Len) throw std::out_of_range("FString index out of range");
-	return Str[i];
+	return Buffer()[i];
 }
 
 const char& FString::operator[](size_t i) const {
 	if (i >= Len) throw std::out_of_range("FString index out of range");
-	return Str[i];
+	return Buffer()[i];
 }
 
 // ============================================================
@@ -128,39 +137,42 @@ std::istream& operator>>(std::istream& is, FString& str) {
 // ============================================================
 
 void FString::InitializeEmpty() {
-	EnsureCapacity(0);
-	Str[0] = '\0'; Len = 0;
+	Len = 0; HeapCapacity = 0;
+	InlineStr[0] = '\0';
 }
 
 void FString::ReleaseMemory() {
-	if (Str) {
-		Memory::Free(Str, MemoryType::eMemory_Type_String);
-		Str = nullptr; Len = 0; Capacity = 0;
+	if (HeapCapacity != 0) {
+		Memory::Free(HeapStr, MemoryType::eMemory_Type_String);
 	}
+	InitializeEmpty();
 }
 
 void FString::EnsureCapacity(size_t required_size) {
-	if (required_size < Capacity) return;
+	if (required_size <= GetCapacity()) return;
 	size_t new_capacity = required_size * 2 + 16;
+	if (new_capacity >= UINT32_MAX) {
+		GLOG(Log::eFatal, "FString::EnsureCapacity: %zu bytes exceeds the maximum string length", required_size);
+		throw std::bad_alloc();
+	}
 	char* new_str = (char*)Memory::Allocate(new_capacity + 1, MemoryType::eMemory_Type_String);
 	if (!new_str) {
 		GLOG(Log::eFatal, "FString::EnsureCapacity: allocation failed (%zu bytes)", new_capacity + 1);
 		throw std::bad_alloc();
 	}
-	memset(new_str, 0, new_capacity + 1);
-	if (Str) {
-		if (Len > 0) Memory::Copy(new_str, Str, Len);
-		Memory::Free(Str, MemoryType::eMemory_Type_String);
+	if (Len > 0) Memory::Copy(new_str, Buffer(), Len);
+	if (HeapCapacity != 0) {
+		Memory::Free(HeapStr, MemoryType::eMemory_Type_String);
 	}
-	Str = new_str; Capacity = new_capacity;
+	HeapStr = new_str; HeapCapacity = static_cast<uint32_t>(new_capacity);
 }
 
 void FString::Clear() {
-	if (Str) { Str[0] = '\0'; Len = 0; }
+	Buffer()[0] = '\0'; Len = 0;
 }
 
 void FString::Reserve(size_t new_capacity) {
-	if (new_capacity > Capacity) EnsureCapacity(new_capacity);
+	if (new_capacity > GetCapacity()) EnsureCapacity(new_capacity);
 }
 
 // ============================================================
@@ -196,16 +208,18 @@ int FString::Compare(const FString& other) const {
 // ============================================================
 
 int FString::IndexOf(char c, size_t start_pos) const {
-	if (!Str || start_pos >= Len) return -1;
+	if (start_pos >= Len) return -1;
+	const char* Chars = Buffer();
 	for (size_t i = start_pos; i < Len; ++i)
-		if (Str[i] == c) return static_cast<int>(i);
+		if (Chars[i] == c) return static_cast<int>(i);
 	return -1;
 }
 
 int FString::LastIndexOf(char c) const {
-	if (!Str || Len == 0) return -1;
+	if (Len == 0) return -1;
+	const char* Chars = Buffer();
 	for (int i = static_cast<int>(Len) - 1; i >= 0; --i)
-		if (Str[i] == c) return i;
+		if (Chars[i] == c) return i;
 	return -1;
 }
 
@@ -221,21 +235,22 @@ FString FString::SubStr(size_t start, size_t length) const {
 	if (actual == 0) return FString();
 	FString result;
 	result.EnsureCapacity(actual);
-	result.Len = actual;
-	Memory::Copy(result.Str, Str + start, actual);
-	result.Str[actual] = '\0';
+	result.Len = static_cast<uint32_t>(actual);
+	Memory::Copy(result.Buffer(), Buffer() + start, actual);
+	result.Buffer()[actual] = '\0';
 	return result;
 }
 
 FString& FString::Trim() {
-	if (!Str || Len == 0) return *this;
+	if (Len == 0) return *this;
+	char* Chars = Buffer();
 	size_t start = 0;
-	while (start < Len && isspace((unsigned char)Str[start])) ++start;
+	while (start < Len && isspace((unsigned char)Chars[start])) ++start;
 	size_t end = Len;
-	while (end > start && isspace((unsigned char)Str[end - 1])) --end;
+	while (end > start && isspace((unsigned char)Chars[end - 1])) --end;
 	size_t new_len = end - start;
-	if (start > 0 && new_len > 0) memmove(Str, Str + start, new_len);
-	Str[new_len] = '\0'; Len = new_len;
+	if (start > 0 && new_len > 0) memmove(Chars, Chars + start, new_len);
+	Chars[new_len] = '\0'; Len = static_cast<uint32_t>(new_len);
 	return *this;
 }
 
@@ -244,14 +259,16 @@ FString  FString::ToLowerCopy() const { FString c(*this); c.ToLower(); return c;
 FString  FString::ToUpperCopy() const { FString c(*this); c.ToUpper(); return c; }
 
 FString& FString::ToLower() {
+	char* Chars = Buffer();
 	for (size_t i = 0; i < Len; ++i)
-		Str[i] = static_cast<char>(tolower((unsigned char)Str[i]));
+		Chars[i] = static_cast<char>(tolower((unsigned char)Chars[i]));
 	return *this;
 }
 
 FString& FString::ToUpper() {
+	char* Chars = Buffer();
 	for (size_t i = 0; i < Len; ++i)
-		Str[i] = static_cast<char>(toupper((unsigned char)Str[i]));
+		Chars[i] = static_cast<char>(toupper((unsigned char)Chars[i]));
 	return *this;
 }
 
@@ -260,15 +277,16 @@ FString& FString::Insert(size_t pos, const FString& str) {
 	if (str.IsEmpty()) return *this;
 	if (pos > Len) pos = Len;
 	EnsureCapacity(Len + str.Len);
-	memmove(Str + pos + str.Len, Str + pos, Len - pos + 1);
-	Memory::Copy(Str + pos, str.Str, str.Len);
+	char* Chars = Buffer();
+	memmove(Chars + pos + str.Len, Chars + pos, Len - pos + 1);
+	Memory::Copy(Chars + pos, str.Buffer(), str.Len);
 	Len += str.Len;
 	return *this;
 }
 
 // Replace(const FString&, const FString&)
 FString& FString::Replace(const FString& old_str, const FString& new_str) {
-	if (old_str.IsEmpty() || !Str) return *this;
+	if (old_str.IsEmpty()) return *this;
 
 	const char* o = old_str.CStr();
 	const char* n = new_str.CStr();
@@ -276,34 +294,35 @@ FString& FString::Replace(const FString& old_str, const FString& new_str) {
 	size_t new_len = new_str.Len;
 
 	size_t count = 0;
-	const char* p = Str;
+	const char* p = Buffer();
 	while ((p = strstr(p, o)) != nullptr) { ++count; p += old_len; }
 	if (count == 0) return *this;
 
 	size_t result_len = Len + count * (new_len - old_len);
-	char* buf = (char*)Memory::Allocate(result_len + 1, MemoryType::eMemory_Type_String);
-	if (!buf) throw std::bad_alloc();
+	FString result;
+	result.EnsureCapacity(result_len);
 
-	char* dst = buf;
-	const char* src = Str;
+	char* dst = result.Buffer();
+	const char* src = Buffer();
 	while ((p = strstr(src, o)) != nullptr) {
 		size_t prefix = static_cast<size_t>(p - src);
 		Memory::Copy(dst, src, prefix); dst += prefix;
 		Memory::Copy(dst, n, new_len);  dst += new_len;
 		src = p + old_len;
 	}
-	size_t tail = Len - static_cast<size_t>(src - Str);
+	size_t tail = Len - static_cast<size_t>(src - Buffer());
 	Memory::Copy(dst, src, tail);
 	dst[tail] = '\0';
 
-	Memory::Free(Str, MemoryType::eMemory_Type_String);
-	Str = buf; Len = result_len; Capacity = result_len;
+	result.Len = static_cast<uint32_t>(result_len);
+	*this = static_cast<FString&&>(result);
 	return *this;
 }
 
 FString& FString::Replace(char old_char, char new_char) {
+	char* Chars = Buffer();
 	for (size_t i = 0; i < Len; ++i)
-		if (Str[i] == old_char) Str[i] = new_char;
+		if (Chars[i] == old_char) Chars[i] = new_char;
 	return *this;
 }
 
@@ -313,10 +332,10 @@ FString& FString::Replace(char old_char, char new_char) {
 
 TArray<FString> FString::Split(char delimiter, bool trim_entries, bool include_empty) const {
 	TArray<FString> result;
-	if (!Str || Len == 0) return result;
+	if (Len == 0) return result;
 	size_t start = 0;
 	for (size_t i = 0; i <= Len; ++i) {
-		if (i == Len || Str[i] == delimiter) {
+		if (i == Len || Buffer()[i] == delimiter) {
 			size_t seg_len = i - start;
 			if (seg_len > 0 || include_empty) {
 				FString seg = SubStr(start, static_cast<int>(seg_len));
@@ -400,7 +419,7 @@ FString FString::FromDouble(double v) { char b[128]; snprintf(b, sizeof(b), "%lg
 FString FString::DirectoryFromPath(const FString& path) {
 	int len = static_cast<int>(path.Len);
 	for (int i = len - 1; i >= 0; --i)
-		if (path.Str[i] == '/' || path.Str[i] == '\\')
+		if (path.Buffer()[i] == '/' || path.Buffer()[i] == '\\')
 			return path.SubStr(0, i + 1);
 	return FString();
 }
@@ -408,7 +427,7 @@ FString FString::DirectoryFromPath(const FString& path) {
 FString FString::FilenameFromPath(const FString& path) {
 	int len = static_cast<int>(path.Len);
 	for (int i = len - 1; i >= 0; --i)
-		if (path.Str[i] == '/' || path.Str[i] == '\\')
+		if (path.Buffer()[i] == '/' || path.Buffer()[i] == '\\')
 			return path.SubStr(static_cast<size_t>(i + 1));
 	return path;
 }
@@ -418,9 +437,9 @@ FString FString::FilenameNoExtensionFromPath(const FString& path) {
 	size_t start = 0;
 	size_t end = len;
 	for (int i = static_cast<int>(len) - 1; i >= 0; --i)
-		if (path.Str[i] == '/' || path.Str[i] == '\\') { start = i + 1; break; }
+		if (path.Buffer()[i] == '/' || path.Buffer()[i] == '\\') { start = i + 1; break; }
 	for (int i = static_cast<int>(len) - 1; i >= static_cast<int>(start); --i)
-		if (path.Str[i] == '.') { end = i; break; }
+		if (path.Buffer()[i] == '.') { end = i; break; }
 	return path.SubStr(start, static_cast<int>(end - start));
 }
 
@@ -440,7 +459,7 @@ bool FString::Equali(const FString& s1, const FString& s2) {
 	return _strnicmp(s1.CStr(), s2.CStr(), s1.Len) == 0;
 #else
 	for (size_t i = 0; i < s1.Len; ++i)
-		if (tolower((unsigned char)s1.Str[i]) != tolower((unsigned char)s2.Str[i])) return false;
+		if (tolower((unsigned char)s1.Buffer()[i]) != tolower((unsigned char)s2.Buffer()[i])) return false;
 	return true;
 #endif
 }
@@ -457,7 +476,7 @@ bool FString::Nequali(const FString& s1, const FString& s2, size_t len) {
 #else
 	for (size_t i = 0; i < len; ++i) {
 		if (i >= s1.Len || i >= s2.Len) return s1.Len == s2.Len;
-		if (tolower((unsigned char)s1.Str[i]) != tolower((unsigned char)s2.Str[i])) return false;
+		if (tolower((unsigned char)s1.Buffer()[i]) != tolower((unsigned char)s2.Buffer()[i])) return false;
 	}
 	return true;
 #endif
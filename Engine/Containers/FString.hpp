@@ -13,6 +13,8 @@
 #include <ctype.h>
 #endif
 
+#define FSTRING_INLINE_CAPACITY 23		// 不超过该长度的字符串直接存放在对象内，不分配内存
+
 //  UTF-8 码点解码结果
 struct FCodepointResult {
 	int  Codepoint;   // 解码出的 Unicode 码点
@@ -59,21 +61,21 @@ public:
 	//  保留 const char* 重载：让 s == "literal" 无需构造临时对象
 	// =========================================================
 	friend bool operator==(const FString& s1, const FString& s2) {
-		return s1.Len == s2.Len && strcmp(s1.Str, s2.Str) == 0;
+		return s1.Len == s2.Len && memcmp(s1.Buffer(), s2.Buffer(), s1.Len) == 0;
 	}
 	friend bool operator==(const FString& s1, const char* s2) {
-		return s2 != nullptr && strcmp(s1.Str, s2) == 0;
+		return s2 != nullptr && strcmp(s1.Buffer(), s2) == 0;
 	}
 	friend bool operator==(const char* s1, const FString& s2) {
-		return s1 != nullptr && strcmp(s1, s2.Str) == 0;
+		return s1 != nullptr && strcmp(s1, s2.Buffer()) == 0;
 	}
 	friend bool operator!=(const FString& s1, const FString& s2) { return !(s1 == s2); }
 	friend bool operator!=(const FString& s1, const char* s2) { return !(s1 == s2); }
 	friend bool operator!=(const char* s1, const FString& s2) { return !(s2 == s1); }
-	friend bool operator< (const FString& s1, const FString& s2) { return strcmp(s1.Str, s2.Str) < 0; }
-	friend bool operator> (const FString& s1, const FString& s2) { return strcmp(s1.Str, s2.Str) > 0; }
-	friend bool operator<=(const FString& s1, const FString& s2) { return strcmp(s1.Str, s2.Str) <= 0; }
-	friend bool operator>=(const FString& s1, const FString& s2) { return strcmp(s1.Str, s2.Str) >= 0; }
+	friend bool operator< (const FString& s1, const FString& s2) { return strcmp(s1.Buffer(), s2.Buffer()) < 0; }
+	friend bool operator> (const FString& s1, const FString& s2) { return strcmp(s1.Buffer(), s2.Buffer()) > 0; }
+	friend bool operator<=(const FString& s1, const FString& s2) { return strcmp(s1.Buffer(), s2.Buffer()) <= 0; }
+	friend bool operator>=(const FString& s1, const FString& s2) { return strcmp(s1.Buffer(), s2.Buffer()) >= 0; }
 
 	// =========================================================
 	//  索引
@@ -85,7 +87,7 @@ public:
 	//  流操作符
 	// =========================================================
 	friend std::ostream& operator<<(std::ostream& os, const FString& str) {
-		return os << (str.Str ? str.Str : "");
+		return os << str.Buffer();
 	}
 	friend std::istream& operator>>(std::istream& is, FString& str);
 
@@ -97,9 +99,12 @@ public:
 	size_t      Length() const { return Len; }
 	size_t      Size()   const { return Len; }
 	bool        IsEmpty()  const { return Len == 0; }
-	char* Data() { return Str; }
-	const char* Data()   const { return Str; }
-	const char* CStr()   const { return Str ? Str : ""; }
+	char* Data() { return Buffer(); }
+	const char* Data()   const { return Buffer(); }
+	const char* CStr()   const { return Buffer(); }
+
+	// 字符串是否存放在对象内部（未分配堆内存）
+	bool        IsInline() const { return HeapCapacity == 0; }
 
 	// =========================================================
 	//  容量
@@ -223,10 +228,18 @@ private:
 	void EnsureCapacity(size_t required_size);
 	void InitializeEmpty();
 
+	char* Buffer() { return HeapCapacity == 0 ? InlineStr : HeapStr; }
+	const char* Buffer() const { return HeapCapacity == 0 ? InlineStr : HeapStr; }
+	size_t GetCapacity() const { return HeapCapacity == 0 ? FSTRING_INLINE_CAPACITY : HeapCapacity; }
+
 private:
-	char* Str;
-	size_t Len;
-	size_t Capacity;
+	// 不保存指向自身的指针，移动时按字节拷贝即可
+	uint32_t Len;
+	uint32_t HeapCapacity;		// 0 表示使用 InlineStr
+	union {
+		char* HeapStr;
+		char InlineStr[FSTRING_INLINE_CAPACITY + 1];
+	};
 
 	// =========================================================
 	//  ↓↓↓ 遗留 C 式静态接口 — 可整段删除 ↓↓↓
@@ -254,14 +267,14 @@ DAPI FString operator+(const char* s1, const FString& s2);
 // ============================================================
 template<typename... Args>
 inline FString::FString(const char* format, Args... args)
-	: Str(nullptr), Len(0), Capacity(0)
+	: Len(0), HeapCapacity(0)
 {
 	if (format != nullptr) {
 		int required_len = snprintf(nullptr, 0, format, args...);
 		if (required_len > 0) {
-			Len = static_cast<size_t>(required_len);
-			EnsureCapacity(Len);
-			snprintf(Str, Len + 1, format, args...);
+			EnsureCapacity(static_cast<size_t>(required_len));
+			Len = static_cast<uint32_t>(required_len);
+			snprintf(Buffer(), Len + 1, format, args...);
 		}
 		else {
 			InitializeEmpty();
@@ -277,13 +290,18 @@ inline FString FString::Format(const char* format, Args... args) {
 	return FString(format, args...);
 }
 
+// 不保存自身地址（短字符串存在对象内部，长字符串只有堆指针），数组扩容时可以直接按字节搬移
+template<>
+struct TIsTriviallyRelocatable<FString> : std::true_type {};
+
 // 自定义类型的Hash
 template<>
 struct TDefaultHasher<FString> {
 	size_t operator()(const FString& str) const noexcept {
 		size_t hash = 5381;
 		const char* s = str.CStr();
-		while (*s)
+		const char* end = s + str.Length();
+		while (s != end)
 			hash = ((hash << 5) + hash) ^ static_cast<unsigned char>(*s++);
 		return hash;
 	}
@@ -4,12 +4,115 @@
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
 #include "Platform/Platform.hpp"
+#include <cstring>
+#include <memory>
 #include <type_traits>
 #include <utility>
 
 #define ARRAY_DEFAULT_CAPACITY 1
 #define ARRAY_DEFAULT_RESIZE_FACTOR 2
 
+/**
+ * @brief 可以按字节搬移的类型：拷贝到新地址后旧地址直接作废，不需要调用移动构造和析构。
+ * 默认包含所有可平凡拷贝的类型（POD、指针、Vertex 等），不保存自身地址的类型可以特化为 true。
+ */
+template<typename T>
+struct TIsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// unique_ptr 只是一个指针
+template<typename T>
+struct TIsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+// TArray 与 TInlineArray 共用的元素搬移操作，可搬移的类型走 memcpy/memmove
+namespace ArrayDetail {
+	template<typename T>
+	void DestroyElements(T* data, size_t count) {
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_t i = 0; i < count; ++i) {
+				data[i].~T();
+			}
+		}
+	}
+
+	// 把 count 个元素从 src 搬到未初始化的 dst（两块内存不重叠），之后 src 中的元素视为已销毁
+	template<typename T>
+	void RelocateElements(T* dst, T* src, size_t count) {
+		if constexpr (TIsTriviallyRelocatable<T>::value) {
+			if (count > 0) {
+				memcpy((void*)dst, (const void*)src, count * sizeof(T));
+			}
+		}
+		else {
+			size_t i = 0;
+			try {
+				for (; i < count; ++i) {
+					new(dst + i) T(std::move(src[i]));
+				}
+			}
+			catch (...) {
+				// 异常安全：清理已构造的元素，src 保持不变
+				DestroyElements(dst, i);
+				throw;
+			}
+			DestroyElements(src, count);
+		}
+	}
+
+	// 在未初始化的 dst 上拷贝构造 count 个元素
+	template<typename T>
+	void CopyConstructElements(T* dst, const T* src, size_t count) {
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			if (count > 0) {
+				memcpy((void*)dst, (const void*)src, count * sizeof(T));
+			}
+		}
+		else {
+			size_t i = 0;
+			try {
+				for (; i < count; ++i) {
+					new(dst + i) T(src[i]);
+				}
+			}
+			catch (...) {
+				DestroyElements(dst, i);
+				throw;
+			}
+		}
+	}
+
+	// 把 [index, length) 的元素整体后移 count 位，空出的 [index, index + count) 未初始化
+	template<typename T>
+	void ShiftRight(T* data, size_t index, size_t length, size_t count) {
+		if constexpr (TIsTriviallyRelocatable<T>::value) {
+			if (length > index) {
+				memmove((void*)(data + index + count), (const void*)(data + index), (length - index) * sizeof(T));
+			}
+		}
+		else {
+			for (size_t i = length; i > index; --i) {
+				new(data + i - 1 + count) T(std::move(data[i - 1]));
+				data[i - 1].~T();
+			}
+		}
+	}
+
+	// 把 [index + count, length) 的元素整体前移 count 位，[index, index + count) 必须已经销毁
+	template<typename T>
+	void ShiftLeft(T* data, size_t index, size_t length, size_t count) {
+		if constexpr (TIsTriviallyRelocatable<T>::value) {
+			if (length > index + count) {
+				memmove((void*)(data + index), (const void*)(data + index + count), (length - index - count) * sizeof(T));
+			}
+		}
+		else {
+			for (size_t i = index + count; i < length; ++i) {
+				new(data + i - count) T(std::move(data[i]));
+				data[i].~T();
+			}
+		}
+	}
+}
+
 /*
 Memory layout
 size_t(unsigned long long) capacity = number elements that can be held
@@ -20,16 +123,8 @@ void* elements
 template<typename ElementType>
 class DAPI TArray {
 public:
-	TArray() : ArrayMemory(nullptr), Capacity(0), Stride(sizeof(ElementType)), Length(0) {
-		size_t ArrayMemSize = ARRAY_DEFAULT_CAPACITY * sizeof(ElementType);
-		ArrayMemory = (ElementType*)Memory::Allocate(ArrayMemSize, MemoryType::eMemory_Type_Array);
-		if (!ArrayMemory) {
-			GLOG(Log::eError, "Failed to allocate memory for TArray");
-			return;
-		}
-		Platform::PlatformSetMemory(ArrayMemory, 0, ArrayMemSize);
-		Capacity = ARRAY_DEFAULT_CAPACITY;
-	}
+	// 空数组不分配内存，第一次添加元素时才分配
+	TArray() : ArrayMemory(nullptr), Capacity(0), Stride(sizeof(ElementType)), Length(0) {}
 
 	// 拷贝构造函数 - 修正了内存分配失败处理
 	TArray(const TArray& arr) : ArrayMemory(nullptr), Capacity(0), Stride(sizeof(ElementType)), Length(0) {
@@ -42,30 +137,24 @@ public:
 		Length = arr.Length;
 
 		size_t ArrayMemSize = Capacity * Stride;
-		ArrayMemory = (ElementType*)Memory::Allocate(ArrayMemSize, MemoryType::eMemory_Type_Array);
+		ArrayMemory = (ElementType*)Memory::AllocateUninitialized(ArrayMemSize, MemoryType::eMemory_Type_Array);
 		if (!ArrayMemory) {
-			GLOG(Log::eError, "Failed to allocate memory in copy constructor");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to allocate memory in copy constructor");
 			Capacity = 0;
 			Length = 0;
 			return;
 		}
 
-		// 使用placement new和拷贝构造函数
-		for (size_t i = 0; i < Length; ++i) {
-			try {
-				new(ArrayMemory + i) ElementType(arr[i]);
-			}
-			catch (...) {
-				// 异常安全：销毁已构造的元素
-				for (size_t j = 0; j < i; ++j) {
-					ArrayMemory[j].~ElementType();
-				}
-				Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
-				ArrayMemory = nullptr;
-				Capacity = 0;
-				Length = 0;
-				throw;
-			}
+		try {
+			ArrayDetail::CopyConstructElements(ArrayMemory, arr.ArrayMemory, Length);
+		}
+		catch (...) {
+			// 异常安全：已构造的元素由 CopyConstructElements 销毁
+			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
+			ArrayMemory = nullptr;
+			Capacity = 0;
+			Length = 0;
+			throw;
 		}
 	}
 
@@ -77,9 +166,9 @@ public:
 		}
 
 		size_t ArrayMemSize = size * sizeof(ElementType);
-		ArrayMemory = (ElementType*)Memory::Allocate(ArrayMemSize, MemoryType::eMemory_Type_Array);
+		ArrayMemory = (ElementType*)Memory::AllocateUninitialized(ArrayMemSize, MemoryType::eMemory_Type_Array);
 		if (!ArrayMemory) {
-			GLOG(Log::eError, "Failed to allocate memory for TArray with size %zu", size);
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to allocate memory for TArray with size %zu", size);
 			return;
 		}
 
@@ -118,9 +207,9 @@ public:
 		}
 
 		size_t ArrayMemSize = list.size() * sizeof(ElementType);
-		ArrayMemory = (ElementType*)Memory::Allocate(ArrayMemSize, MemoryType::eMemory_Type_Array);
+		ArrayMemory = (ElementType*)Memory::AllocateUninitialized(ArrayMemSize, MemoryType::eMemory_Type_Array);
 		if (!ArrayMemory) {
-			GLOG(Log::eError, "Failed to allocate memory for TArray initializer_list");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to allocate memory for TArray initializer_list");
 			return;
 		}
 
@@ -169,81 +258,40 @@ public:
 public:
 	// 修正了Resize函数的异常安全性
 	void Resize(size_t newSize = 0) {
-		size_t NewCapacity = newSize > 0 ? newSize : Capacity * ARRAY_DEFAULT_RESIZE_FACTOR;
-
-		if (NewCapacity == Capacity) {
-			if (newSize > 0 && newSize != Length) {
-				// 只改变Length，不重新分配内存
-				if (newSize > Length) {
-					// 扩展：构造新元素
-					for (size_t i = Length; i < newSize; ++i) {
-						new(ArrayMemory + i) ElementType();
-					}
-				}
-				else {
-					// 收缩：销毁多余元素
-					for (size_t i = newSize; i < Length; ++i) {
-						if constexpr (!std::is_pointer<ElementType>::value) {
-							ArrayMemory[i].~ElementType();
-						}
-					}
-				}
+		size_t NewCapacity = newSize > 0 ? newSize : DMAX(Capacity * ARRAY_DEFAULT_RESIZE_FACTOR, (size_t)ARRAY_DEFAULT_CAPACITY);
+
+		if (NewCapacity != Capacity) {
+			// 收缩：先销毁多余元素，只搬移保留下来的部分
+			if (newSize > 0 && newSize < Length) {
+				ArrayDetail::DestroyElements(ArrayMemory + newSize, Length - newSize);
 				Length = newSize;
 			}
-			return;
-		}
 
-		ElementType* TempMemory = (ElementType*)Memory::Allocate(NewCapacity * Stride, MemoryType::eMemory_Type_Array);
-		if (!TempMemory) {
-			GLOG(Log::eError, "Failed to allocate memory during resize");
-			return;
+			if (!Reallocate(NewCapacity)) {
+				return;
+			}
 		}
 
-		size_t copyLength = (newSize > 0 && newSize < Length) ? newSize : Length;
-
-		// 移动或拷贝现有元素
-		if (ArrayMemory) {
-			for (size_t i = 0; i < copyLength; ++i) {
-				try {
-					// 如果ElementType为unique_ptr会失败
-					/*if constexpr (std::is_move_constructible<ElementType>::value && !std::is_pointer<ElementType>::value) {
-						new(TempMemory + i) ElementType(std::move(ArrayMemory[i]));
-					}
-					else {
-						new(TempMemory + i) ElementType(ArrayMemory[i]);
-					}*/
-
-					new(TempMemory + i) ElementType(std::move(ArrayMemory[i]));
-				}
-				catch (...) {
-					// 异常安全：清理已构造的元素
-					for (size_t j = 0; j < i; ++j) {
-						TempMemory[j].~ElementType();
-					}
-					Memory::Free(TempMemory, MemoryType::eMemory_Type_Array);
-					throw;
+		if (newSize > 0 && newSize != Length) {
+			if (newSize > Length) {
+				// 扩展：构造新元素
+				for (size_t i = Length; i < newSize; ++i) {
+					new(ArrayMemory + i) ElementType();
 				}
 			}
-
-			// 销毁原数组中的元素
-			if constexpr (!std::is_pointer<ElementType>::value) {
-				for (size_t i = 0; i < Length; ++i) {
-					ArrayMemory[i].~ElementType();
-				}
+			else {
+				// 收缩：销毁多余元素
+				ArrayDetail::DestroyElements(ArrayMemory + newSize, Length - newSize);
 			}
-			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
+			Length = newSize;
 		}
+	}
 
-		// 如果新大小大于原长度，构造新元素
-		if (newSize > copyLength) {
-			for (size_t i = copyLength; i < newSize; ++i) {
-				new(TempMemory + i) ElementType();
-			}
+	// 保证容量至少为 capacity，不改变元素个数
+	void Reserve(size_t capacity) {
+		if (capacity > Capacity) {
+			Reallocate(capacity);
 		}
-
-		ArrayMemory = TempMemory;
-		Capacity = NewCapacity;
-		Length = newSize > 0 ? newSize : copyLength;
 	}
 
 	void Push(const ElementType& value) {
@@ -256,7 +304,7 @@ public:
 			Length++;
 		}
 		catch (...) {
-			GLOG(Log::eError, "Failed to push element");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to push element");
 			throw;
 		}
 	}
@@ -288,7 +336,7 @@ public:
 	// 修正了InsertAt函数的逻辑错误
 	void InsertAt(size_t index, const ElementType& val) {
 		if (index > Length) {
-			GLOG(Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
 			return;
 		}
 
@@ -297,16 +345,7 @@ public:
 		}
 
 		// 从后往前移动元素，为新元素腾出空间
-		for (size_t i = Length; i > index; --i) {
-			try {
-				new(ArrayMemory + i) ElementType(std::move(ArrayMemory[i - 1]));
-				ArrayMemory[i - 1].~ElementType();
-			}
-			catch (...) {
-				GLOG(Log::eError, "Failed to move element during insertion");
-				throw;
-			}
-		}
+		ArrayDetail::ShiftRight(ArrayMemory, index, Length, 1);
 
 		// 在指定位置构造新元素
 		try {
@@ -314,14 +353,48 @@ public:
 			Length++;
 		}
 		catch (...) {
-			GLOG(Log::eError, "Failed to insert element at index %zu", index);
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to insert element at index %zu", index);
 			throw;
 		}
 	}
 
+	// 在 index 处插入 count 个元素，data 不能指向数组自身
+	void InsertAt(size_t index, const ElementType* data, size_t count) {
+		if (index > Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			return;
+		}
+
+		if (count == 0) {
+			return;
+		}
+
+		if (Length + count > Capacity && !Reallocate(DMAX(Length + count, Capacity * ARRAY_DEFAULT_RESIZE_FACTOR))) {
+			return;
+		}
+
+		ArrayDetail::ShiftRight(ArrayMemory, index, Length, count);
+		ArrayDetail::CopyConstructElements(ArrayMemory + index, data, count);
+		Length += count;
+	}
+
+	// 在末尾追加 count 个元素，data 不能指向数组自身
+	void Append(const ElementType* data, size_t count) {
+		InsertAt(Length, data, count);
+	}
+
+	void Append(const TArray<ElementType>& other) {
+		if (this == &other) {
+			TArray<ElementType> Copy(other);
+			Append(Copy.Data(), Copy.Size());
+			return;
+		}
+		Append(other.Data(), other.Size());
+	}
+
 	ElementType Pop() {
 		if (Length < 1) {
-			GLOG(Log::eError, "Trying to pop from empty array");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Trying to pop from empty array");
 			return ElementType();
 		}
 
@@ -337,44 +410,44 @@ public:
 
 	ElementType PopAt(size_t index) {
 		if (index >= Length) {
-			GLOG(Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
 			return ElementType();
 		}
 
 		ElementType result = std::move(ArrayMemory[index]);
+		ArrayMemory[index].~ElementType();
 
 		// 向前移动后续元素
-		for (size_t i = index; i < Length - 1; ++i) {
-			ArrayMemory[i].~ElementType();
-			new(ArrayMemory + i) ElementType(std::move(ArrayMemory[i + 1]));
-		}
+		ArrayDetail::ShiftLeft(ArrayMemory, index, Length, 1);
 
-		if constexpr (!std::is_pointer<ElementType>::value) {
-			ArrayMemory[Length - 1].~ElementType();
+		Length--;
+		return result;
+	}
+
+	// 用最后一个元素填补被删除的位置，O(1)，不保持元素顺序
+	void RemoveSwap(size_t index) {
+		if (index >= Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			return;
 		}
 
+		ArrayMemory[index].~ElementType();
+		if (index != Length - 1) {
+			ArrayDetail::RelocateElements(ArrayMemory + index, ArrayMemory + Length - 1, 1);
+		}
 		Length--;
-		return result;
 	}
 
 	void Clear() {
 		if (ArrayMemory != nullptr) {
-			if constexpr (!std::is_pointer<ElementType>::value) {
-				for (size_t i = 0; i < Length; ++i) {
-					ArrayMemory[i].~ElementType();
-				}
-			}
+			ArrayDetail::DestroyElements(ArrayMemory, Length);
 			Length = 0;
 		}
 	}
 
 	void Destroy() {
 		if (ArrayMemory != nullptr) {
-			if constexpr (!std::is_pointer<ElementType>::value) {
-				for (size_t i = 0; i < Length; ++i) {
-					ArrayMemory[i].~ElementType();
-				}
-			}
+			ArrayDetail::DestroyElements(ArrayMemory, Length);
 			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
 			ArrayMemory = nullptr;
 		}
@@ -410,29 +483,24 @@ public:
 		Length = other.Length;
 
 		size_t ArrayMemSize = Capacity * Stride;
-		ArrayMemory = (ElementType*)Memory::Allocate(ArrayMemSize, MemoryType::eMemory_Type_Array);
+		ArrayMemory = (ElementType*)Memory::AllocateUninitialized(ArrayMemSize, MemoryType::eMemory_Type_Array);
 		if (!ArrayMemory) {
-			GLOG(Log::eError, "Failed to allocate memory in assignment operator");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to allocate memory in assignment operator");
 			Capacity = 0;
 			Length = 0;
 			return *this;
 		}
 
-		for (size_t i = 0; i < Length; ++i) {
-			try {
-				new(ArrayMemory + i) ElementType(other[i]);
-			}
-			catch (...) {
-				// 异常安全：清理已构造的元素
-				for (size_t j = 0; j < i; ++j) {
-					ArrayMemory[j].~ElementType();
-				}
-				Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
-				ArrayMemory = nullptr;
-				Capacity = 0;
-				Length = 0;
-				throw;
-			}
+		try {
+			ArrayDetail::CopyConstructElements(ArrayMemory, other.ArrayMemory, Length);
+		}
+		catch (...) {
+			// 异常安全：已构造的元素由 CopyConstructElements 销毁
+			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
+			ArrayMemory = nullptr;
+			Capacity = 0;
+			Length = 0;
+			throw;
 		}
 
 		return *this;
@@ -468,7 +536,7 @@ public:
 	template<typename IntegerType>
 	ElementType& operator[](const IntegerType& i) {
 		if (static_cast<size_t>(i) >= Length) {
-			GLOG(Log::eError, "Index out of bounds! Length: %zu, Index: %lld", Length, static_cast<long long>(i));
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %lld", Length, static_cast<long long>(i));
 		}
 		return ArrayMemory[i];
 	}
@@ -476,11 +544,37 @@ public:
 	template<typename IntegerType>
 	const ElementType& operator[](const IntegerType& i) const {
 		if (static_cast<size_t>(i) >= Length) {
-			GLOG(Log::eError, "Index out of bounds! Length: %zu, Index: %lld", Length, static_cast<long long>(i));
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %lld", Length, static_cast<long long>(i));
 		}
 		return ArrayMemory[i];
 	}
 
+private:
+	// 把现有元素搬到容量为 new_capacity 的新内存，new_capacity 不能小于 Length
+	bool Reallocate(size_t new_capacity) {
+		ElementType* TempMemory = (ElementType*)Memory::AllocateUninitialized(new_capacity * sizeof(ElementType), MemoryType::eMemory_Type_Array);
+		if (!TempMemory) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to allocate memory during resize");
+			return false;
+		}
+
+		if (ArrayMemory) {
+			try {
+				ArrayDetail::RelocateElements(TempMemory, ArrayMemory, Length);
+			}
+			catch (...) {
+				Memory::Free(TempMemory, MemoryType::eMemory_Type_Array);
+				throw;
+			}
+			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
+		}
+
+		ArrayMemory = TempMemory;
+		Capacity = new_capacity;
+		Stride = sizeof(ElementType);
+		return true;
+	}
+
 private:
 	ElementType* ArrayMemory;
 	size_t Capacity;
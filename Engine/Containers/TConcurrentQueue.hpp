@@ -0,0 +1,467 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "TArray.hpp"
+#include "Platform/Platform.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * 无锁的定长环形队列，容量向上取整到 2 的幂，不会动态扩容。
+ *
+ *  - TSPSCQueue: 单生产者单消费者，Push/Pop 都是 wait-free，适合渲染线程、日志写线程这类固定的流水线
+ *  - TMPMCQueue: 多生产者多消费者，每个槽带序号（Vyukov 有界队列），适合任务与事件的提交
+ *  - TIntrusiveMPSCQueue: 多生产者单消费者的侵入式链表，节点自带 next 指针，没有容量上限
+ *
+ * 两者的读写下标各占一条缓存行，生产者与消费者不会互相使缓存失效。队列满时 Push 返回 false，
+ * 队列空时 Pop 返回 false，由调用方决定重试还是丢弃。批量接口一次认领多个槽，只做一次原子操作，
+ * 返回实际写入或读出的个数。
+ *
+ * 存储通过 Platform::PlatformAllocate 分配，可以在 Memory 初始化之前创建（例如日志队列）。
+ */
+
+namespace ConcurrentQueueDetail {
+	inline size_t RoundUpCapacity(size_t capacity) {
+		size_t Result = 2;
+		while (Result < capacity) {
+			Result <<= 1;
+		}
+		return Result;
+	}
+
+	// 把 src 中 count 个元素移动到已构造的 dst，并销毁 src 中的元素
+	template<typename T>
+	void MoveOut(T* dst, T* src, size_t count) {
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			if (count > 0) {
+				memcpy((void*)dst, (const void*)src, count * sizeof(T));
+			}
+		}
+		else {
+			for (size_t i = 0; i < count; ++i) {
+				dst[i] = std::move(src[i]);
+				src[i].~T();
+			}
+		}
+	}
+}
+
+/**
+ * @brief 单生产者单消费者的无锁环形队列。
+ *
+ * 同一时刻只能有一个线程调用 Push 系列接口、一个线程调用 Pop 系列接口。双方各自缓存对方的下标，
+ * 只有缓存的值显示队列已满/已空时才重新读取，大部分操作不会访问对方的缓存行。
+ */
+template<typename ElementType>
+class TSPSCQueue {
+public:
+	explicit TSPSCQueue(uint32_t capacity = 1024) {
+		Capacity = ConcurrentQueueDetail::RoundUpCapacity(capacity);
+		Mask = Capacity - 1;
+		Slots = (ElementType*)Platform::PlatformAllocate(Capacity * sizeof(ElementType), false);
+		if (Slots == nullptr) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "Failed to allocate SPSC queue with capacity %zu.", Capacity);
+		}
+	}
+
+	TSPSCQueue(const TSPSCQueue&) = delete;
+	TSPSCQueue& operator=(const TSPSCQueue&) = delete;
+
+	~TSPSCQueue() {
+		if (Slots == nullptr) {
+			return;
+		}
+
+		if constexpr (!std::is_trivially_destructible<ElementType>::value) {
+			for (size_t i = Head.load(std::memory_order_relaxed); i != Tail.load(std::memory_order_relaxed); ++i) {
+				Slots[i & Mask].~ElementType();
+			}
+		}
+		Platform::PlatformFree(Slots, false);
+	}
+
+	/**
+	 * @brief 生产者线程调用。
+	 *
+	 * @return 队列已满时返回 false，不会构造元素。
+	 */
+	template<typename... Args>
+	bool Emplace(Args&&... args) {
+		const size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+		if (CurrentTail - CachedHead >= Capacity) {
+			CachedHead = Head.load(std::memory_order_acquire);
+			if (CurrentTail - CachedHead >= Capacity) {
+				return false;
+			}
+		}
+
+		new(Slots + (CurrentTail & Mask)) ElementType(std::forward<Args>(args)...);
+		Tail.store(CurrentTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool Push(const ElementType& value) { return Emplace(value); }
+	bool Push(ElementType&& value) { return Emplace(std::move(value)); }
+
+	/**
+	 * @brief 生产者线程调用，尽可能多地写入，只发布一次。
+	 *
+	 * @return 实际写入的个数，队列剩余空间不足时小于 count。
+	 */
+	uint32_t PushBatch(const ElementType* values, uint32_t count) {
+		const size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+		size_t Free = Capacity - (CurrentTail - CachedHead);
+		if (Free < count) {
+			CachedHead = Head.load(std::memory_order_acquire);
+			Free = Capacity - (CurrentTail - CachedHead);
+		}
+
+		const size_t Count = DMIN((size_t)count, Free);
+		const size_t Start = CurrentTail & Mask;
+		const size_t FirstPart = DMIN(Count, Capacity - Start);
+		ArrayDetail::CopyConstructElements(Slots + Start, values, FirstPart);
+		ArrayDetail::CopyConstructElements(Slots, values + FirstPart, Count - FirstPart);
+
+		Tail.store(CurrentTail + Count, std::memory_order_release);
+		return (uint32_t)Count;
+	}
+
+	/**
+	 * @brief 消费者线程调用。
+	 *
+	 * @param out_value 取出的元素移动赋值到这里。
+	 * @return 队列为空时返回 false。
+	 */
+	bool Pop(ElementType& out_value) {
+		const size_t CurrentHead = Head.load(std::memory_order_relaxed);
+		if (CurrentHead == CachedTail) {
+			CachedTail = Tail.load(std::memory_order_acquire);
+			if (CurrentHead == CachedTail) {
+				return false;
+			}
+		}
+
+		ElementType& Slot = Slots[CurrentHead & Mask];
+		out_value = std::move(Slot);
+		Slot.~ElementType();
+		Head.store(CurrentHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief 消费者线程调用，一次取出最多 max_count 个元素，只发布一次。
+	 *
+	 * @param out_values 已构造的元素数组，取出的元素移动赋值到这里。
+	 * @return 实际取出的个数。
+	 */
+	uint32_t PopBatch(ElementType* out_values, uint32_t max_count) {
+		const size_t CurrentHead = Head.load(std::memory_order_relaxed);
+		size_t Available = CachedTail - CurrentHead;
+		if (Available < max_count) {
+			CachedTail = Tail.load(std::memory_order_acquire);
+			Available = CachedTail - CurrentHead;
+		}
+
+		const size_t Count = DMIN((size_t)max_count, Available);
+		const size_t Start = CurrentHead & Mask;
+		const size_t FirstPart = DMIN(Count, Capacity - Start);
+		ConcurrentQueueDetail::MoveOut(out_values, Slots + Start, FirstPart);
+		ConcurrentQueueDetail::MoveOut(out_values + FirstPart, Slots, Count - FirstPart);
+
+		Head.store(CurrentHead + Count, std::memory_order_release);
+		return (uint32_t)Count;
+	}
+
+	// 其它线程调用时只是一个近似值
+	bool IsEmpty() const { return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire); }
+	uint32_t GetLength() const {
+		const size_t CurrentHead = Head.load(std::memory_order_acquire);
+		return (uint32_t)(Tail.load(std::memory_order_acquire) - CurrentHead);
+	}
+	uint32_t GetCapacity() const { return (uint32_t)Capacity; }
+
+private:
+	// 只读，两边共享
+	ElementType* Slots;
+	size_t Capacity;
+	size_t Mask;
+
+	// 生产者独占
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> Tail{ 0 };
+	size_t CachedHead = 0;
+
+	// 消费者独占
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> Head{ 0 };
+	size_t CachedTail = 0;
+};
+
+/**
+ * @brief 多生产者多消费者的有界无锁队列。
+ *
+ * 每个槽保存一个序号：序号等于写下标时槽可写，等于写下标 + 1 时槽可读，读完后序号加上容量留给下一圈。
+ * 生产者之间、消费者之间只在各自的下标上做一次 CAS 竞争，不会互相阻塞。
+ *
+ * 批量接口先检查从当前下标开始有多少个连续的槽已经就绪，再用一次 CAS 全部认领。
+ * 正被其它线程读写到一半的槽不会被认领，所有接口都不会等待其它线程。
+ */
+template<typename ElementType>
+class TMPMCQueue {
+public:
+	explicit TMPMCQueue(uint32_t capacity = 1024) {
+		Capacity = ConcurrentQueueDetail::RoundUpCapacity(capacity);
+		Mask = Capacity - 1;
+		Slots = (Slot*)Platform::PlatformAllocate(Capacity * sizeof(Slot), false);
+		if (Slots == nullptr) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "Failed to allocate MPMC queue with capacity %zu.", Capacity);
+			return;
+		}
+
+		for (size_t i = 0; i < Capacity; ++i) {
+			new(&Slots[i].Sequence) std::atomic<size_t>(i);
+		}
+	}
+
+	TMPMCQueue(const TMPMCQueue&) = delete;
+	TMPMCQueue& operator=(const TMPMCQueue&) = delete;
+
+	~TMPMCQueue() {
+		if (Slots == nullptr) {
+			return;
+		}
+
+		if constexpr (!std::is_trivially_destructible<ElementType>::value) {
+			for (size_t i = DequeuePos.load(std::memory_order_relaxed); i != EnqueuePos.load(std::memory_order_relaxed); ++i) {
+				Slots[i & Mask].Value()->~ElementType();
+			}
+		}
+		Platform::PlatformFree(Slots, false);
+	}
+
+	/**
+	 * @brief 任意线程调用。
+	 *
+	 * @return 队列已满时返回 false，不会构造元素。
+	 */
+	template<typename... Args>
+	bool Emplace(Args&&... args) {
+		size_t Pos = EnqueuePos.load(std::memory_order_relaxed);
+		Slot* Target;
+		for (;;) {
+			Target = &Slots[Pos & Mask];
+			const intptr_t Diff = (intptr_t)Target->Sequence.load(std::memory_order_acquire) - (intptr_t)Pos;
+			if (Diff == 0) {
+				if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (Diff < 0) {
+				// 上一圈的元素还没被取走
+				return false;
+			}
+			else {
+				Pos = EnqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		new(Target->Value()) ElementType(std::forward<Args>(args)...);
+		Target->Sequence.store(Pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool Push(const ElementType& value) { return Emplace(value); }
+	bool Push(ElementType&& value) { return Emplace(std::move(value)); }
+
+	/**
+	 * @brief 任意线程调用，一次认领最多 count 个连续的空槽。
+	 *
+	 * @return 实际写入的个数，队列剩余空间不足时小于 count。
+	 */
+	uint32_t PushBatch(const ElementType* values, uint32_t count) {
+		size_t Pos = EnqueuePos.load(std::memory_order_relaxed);
+		size_t Count;
+		for (;;) {
+			// 只认领已经空出来的前缀，认领成功后这些槽不会再被别的线程改动
+			Count = 0;
+			while (Count < count && Slots[(Pos + Count) & Mask].Sequence.load(std::memory_order_acquire) == Pos + Count) {
+				++Count;
+			}
+
+			if (Count == 0) {
+				const size_t Current = EnqueuePos.load(std::memory_order_relaxed);
+				if (Current == Pos) {
+					return 0;
+				}
+				Pos = Current;
+				continue;
+			}
+
+			if (EnqueuePos.compare_exchange_weak(Pos, Pos + Count, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+
+		for (size_t i = 0; i < Count; ++i) {
+			Slot& Target = Slots[(Pos + i) & Mask];
+			new(Target.Value()) ElementType(values[i]);
+			Target.Sequence.store(Pos + i + 1, std::memory_order_release);
+		}
+		return (uint32_t)Count;
+	}
+
+	/**
+	 * @brief 任意线程调用。
+	 *
+	 * @param out_value 取出的元素移动赋值到这里。
+	 * @return 队列为空时返回 false。
+	 */
+	bool Pop(ElementType& out_value) {
+		size_t Pos = DequeuePos.load(std::memory_order_relaxed);
+		Slot* Target;
+		for (;;) {
+			Target = &Slots[Pos & Mask];
+			const intptr_t Diff = (intptr_t)Target->Sequence.load(std::memory_order_acquire) - (intptr_t)(Pos + 1);
+			if (Diff == 0) {
+				if (DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (Diff < 0) {
+				// 这个位置还没有写入
+				return false;
+			}
+			else {
+				Pos = DequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		ElementType* Value = Target->Value();
+		out_value = std::move(*Value);
+		Value->~ElementType();
+		Target->Sequence.store(Pos + Capacity, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief 任意线程调用，一次认领最多 max_count 个连续的已写入的槽。
+	 *
+	 * @param out_values 已构造的元素数组，取出的元素移动赋值到这里。
+	 * @return 实际取出的个数。
+	 */
+	uint32_t PopBatch(ElementType* out_values, uint32_t max_count) {
+		size_t Pos = DequeuePos.load(std::memory_order_relaxed);
+		size_t Count;
+		for (;;) {
+			// 只认领已经写完的前缀，正在写入的槽留给下一次
+			Count = 0;
+			while (Count < max_count && Slots[(Pos + Count) & Mask].Sequence.load(std::memory_order_acquire) == Pos + Count + 1) {
+				++Count;
+			}
+
+			if (Count == 0) {
+				const size_t Current = DequeuePos.load(std::memory_order_relaxed);
+				if (Current == Pos) {
+					return 0;
+				}
+				Pos = Current;
+				continue;
+			}
+
+			if (DequeuePos.compare_exchange_weak(Pos, Pos + Count, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+
+		for (size_t i = 0; i < Count; ++i) {
+			Slot& Target = Slots[(Pos + i) & Mask];
+			ElementType* Value = Target.Value();
+			out_values[i] = std::move(*Value);
+			Value->~ElementType();
+			Target.Sequence.store(Pos + i + Capacity, std::memory_order_release);
+		}
+		return (uint32_t)Count;
+	}
+
+	// 其它线程同时读写时只是一个近似值
+	uint32_t GetLength() const {
+		const size_t Dequeued = DequeuePos.load(std::memory_order_acquire);
+		const intptr_t Length = (intptr_t)(EnqueuePos.load(std::memory_order_acquire) - Dequeued);
+		return Length > 0 ? (uint32_t)Length : 0;
+	}
+	bool IsEmpty() const { return GetLength() == 0; }
+	uint32_t GetCapacity() const { return (uint32_t)Capacity; }
+
+private:
+	struct Slot {
+		std::atomic<size_t> Sequence;
+		alignas(ElementType) unsigned char Storage[sizeof(ElementType)];
+
+		ElementType* Value() { return reinterpret_cast<ElementType*>(Storage); }
+	};
+
+	// 只读，所有线程共享
+	Slot* Slots;
+	size_t Capacity;
+	size_t Mask;
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> EnqueuePos{ 0 };
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> DequeuePos{ 0 };
+};
+
+/**
+ * @brief 多生产者单消费者的侵入式无锁队列。
+ *
+ * 节点通过 NextMember 指向的成员串成链表，队列本身不分配内存，也没有容量上限。生产者用一次 CAS
+ * 把节点挂到链表头；消费者用 PopAll 一次取走整条链，并反转成入队顺序。适合“很多线程产出、
+ * 一个线程定期统一处理”的场景，例如任务完成回调。
+ *
+ * 节点入队后归消费者所有，生产者不能再访问它；PopAll 返回的链表由调用方沿 NextMember 遍历。
+ *
+ * 使用示例：
+ *   struct Node { Node* Next; ... };
+ *   TIntrusiveMPSCQueue<Node, &Node::Next> Queue;
+ *   Queue.Push(NewNode);                                      // 任意线程
+ *   for (Node* It = Queue.PopAll(); It != nullptr; ) { ... }  // 消费者线程
+ */
+template<typename NodeType, NodeType* NodeType::*NextMember>
+class TIntrusiveMPSCQueue {
+public:
+	TIntrusiveMPSCQueue() = default;
+	TIntrusiveMPSCQueue(const TIntrusiveMPSCQueue&) = delete;
+	TIntrusiveMPSCQueue& operator=(const TIntrusiveMPSCQueue&) = delete;
+
+	/**
+	 * @brief 任意线程调用，总是成功。
+	 */
+	void Push(NodeType* node) {
+		NodeType* CurrentHead = Head.load(std::memory_order_relaxed);
+		do {
+			node->*NextMember = CurrentHead;
+		} while (!Head.compare_exchange_weak(CurrentHead, node, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/**
+	 * @brief 消费者线程调用，取走当前所有节点。
+	 *
+	 * @return 最早入队的节点，后续节点按入队顺序通过 NextMember 链接，队列为空时返回 nullptr。
+	 */
+	NodeType* PopAll() {
+		NodeType* List = Head.exchange(nullptr, std::memory_order_acquire);
+		NodeType* Ordered = nullptr;
+		while (List != nullptr) {
+			NodeType* Next = List->*NextMember;
+			List->*NextMember = Ordered;
+			Ordered = List;
+			List = Next;
+		}
+		return Ordered;
+	}
+
+	bool IsEmpty() const { return Head.load(std::memory_order_acquire) == nullptr; }
+
+private:
+	alignas(CACHE_LINE_SIZE) std::atomic<NodeType*> Head{ nullptr };
+};
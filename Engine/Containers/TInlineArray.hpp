@@ -0,0 +1,288 @@
+﻿#pragma once
+
+#include "TArray.hpp"
+
+#include <initializer_list>
+#include <new>
+
+/**
+ * @brief 带内联存储的数组，前 InlineCapacity 个元素直接存放在对象内部。
+ *
+ * 特性：
+ *  - 元素个数不超过 InlineCapacity 时不分配内存，空数组也不分配
+ *  - 超出后转为堆内存，按 ARRAY_DEFAULT_RESIZE_FACTOR 扩容，之后不再回到内联存储
+ *  - 可按字节搬移的类型（见 TIsTriviallyRelocatable）扩容、插入、删除都是整块 memcpy/memmove
+ *  - 接口与 TArray 一致，另有批量 Append/InsertAt 与 O(1) 的 RemoveSwap
+ *
+ * 适合大多数时候只有几个元素的小数组，例如子 Actor 列表、组件的材质列表：
+ *   TInlineArray<AActor*, 4> Children;
+ *   Children.Push(Child);                 // 前 4 个不分配内存
+ *
+ * 对象本身保存指向内联存储的指针，移动时内联元素需要逐个搬移，大小为 InlineCapacity * sizeof(T) 加 24 字节。
+ */
+template<typename ElementType, size_t InlineCapacity>
+class TInlineArray {
+	static_assert(InlineCapacity > 0, "TInlineArray needs an inline capacity, use TArray otherwise");
+
+public:
+	TInlineArray() : ArrayMemory(GetInlineMemory()), Capacity(InlineCapacity), Length(0) {}
+
+	TInlineArray(std::initializer_list<ElementType> list) : TInlineArray() {
+		Append(list.begin(), list.size());
+	}
+
+	TInlineArray(const TInlineArray& other) : TInlineArray() {
+		Append(other.ArrayMemory, other.Length);
+	}
+
+	TInlineArray(TInlineArray&& other) noexcept : TInlineArray() {
+		MoveFrom(other);
+	}
+
+	~TInlineArray() {
+		Destroy();
+	}
+
+	TInlineArray& operator=(const TInlineArray& other) {
+		if (this != &other) {
+			Clear();
+			Append(other.ArrayMemory, other.Length);
+		}
+		return *this;
+	}
+
+	TInlineArray& operator=(TInlineArray&& other) noexcept {
+		if (this != &other) {
+			Destroy();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	ElementType* begin() { return ArrayMemory; }
+	const ElementType* begin() const { return ArrayMemory; }
+	ElementType* end() { return ArrayMemory + Length; }
+	const ElementType* end() const { return ArrayMemory + Length; }
+
+public:
+	// 扩容失败时与 Emplace 一样抛出 std::bad_alloc，不会悄悄丢掉元素
+	void Push(const ElementType& value) {
+		Emplace(value);
+	}
+
+	void Push(ElementType&& value) {
+		Emplace(std::move(value));
+	}
+
+	template<typename... Args>
+	ElementType& Emplace(Args&&... args) {
+		if (Length >= Capacity) {
+			// 参数可能引用数组里的元素，先构造好再扩容
+			ElementType Value(std::forward<Args>(args)...);
+			if (!Grow(Length + 1)) {
+				throw std::bad_alloc();
+			}
+			new(ArrayMemory + Length) ElementType(std::move(Value));
+		}
+		else {
+			new(ArrayMemory + Length) ElementType(std::forward<Args>(args)...);
+		}
+		return ArrayMemory[Length++];
+	}
+
+	void InsertAt(size_t index, const ElementType& val) {
+		if (index > Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			return;
+		}
+
+		ElementType Copy(val);
+		if (Length >= Capacity && !Grow(Length + 1)) {
+			return;
+		}
+
+		ArrayDetail::ShiftRight(ArrayMemory, index, Length, 1);
+		new(ArrayMemory + index) ElementType(std::move(Copy));
+		Length++;
+	}
+
+	// 在 index 处插入 count 个元素，data 不能指向数组自身
+	void InsertAt(size_t index, const ElementType* data, size_t count) {
+		if (index > Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			return;
+		}
+
+		if (count == 0 || (Length + count > Capacity && !Grow(Length + count))) {
+			return;
+		}
+
+		ArrayDetail::ShiftRight(ArrayMemory, index, Length, count);
+		ArrayDetail::CopyConstructElements(ArrayMemory + index, data, count);
+		Length += count;
+	}
+
+	// 在末尾追加 count 个元素，data 不能指向数组自身
+	void Append(const ElementType* data, size_t count) {
+		InsertAt(Length, data, count);
+	}
+
+	ElementType Pop() {
+		if (Length < 1) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Trying to pop from empty array");
+			return ElementType();
+		}
+
+		ElementType Result = std::move(ArrayMemory[Length - 1]);
+		ArrayMemory[Length - 1].~ElementType();
+		Length--;
+		return Result;
+	}
+
+	ElementType PopAt(size_t index) {
+		if (index >= Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			return ElementType();
+		}
+
+		ElementType Result = std::move(ArrayMemory[index]);
+		ArrayMemory[index].~ElementType();
+		ArrayDetail::ShiftLeft(ArrayMemory, index, Length, 1);
+		Length--;
+		return Result;
+	}
+
+	// 用最后一个元素填补被删除的位置，O(1)，不保持元素顺序
+	void RemoveSwap(size_t index) {
+		if (index >= Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %zu", Length, index);
+			return;
+		}
+
+		ArrayMemory[index].~ElementType();
+		if (index != Length - 1) {
+			ArrayDetail::RelocateElements(ArrayMemory + index, ArrayMemory + Length - 1, 1);
+		}
+		Length--;
+	}
+
+	// 保证容量至少为 capacity，不改变元素个数
+	void Reserve(size_t capacity) {
+		if (capacity > Capacity) {
+			Reallocate(capacity);
+		}
+	}
+
+	// 改变元素个数，新增的元素默认构造
+	void Resize(size_t new_size) {
+		if (new_size < Length) {
+			ArrayDetail::DestroyElements(ArrayMemory + new_size, Length - new_size);
+			Length = new_size;
+			return;
+		}
+
+		if (new_size > Capacity && !Reallocate(new_size)) {
+			return;
+		}
+
+		for (size_t i = Length; i < new_size; ++i) {
+			new(ArrayMemory + i) ElementType();
+		}
+		Length = new_size;
+	}
+
+	// 销毁所有元素，保留已分配的内存
+	void Clear() {
+		ArrayDetail::DestroyElements(ArrayMemory, Length);
+		Length = 0;
+	}
+
+	// 销毁所有元素并释放堆内存，回到内联存储
+	void Destroy() {
+		Clear();
+		if (!IsInline()) {
+			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
+			ArrayMemory = GetInlineMemory();
+			Capacity = InlineCapacity;
+		}
+	}
+
+	bool IsEmpty() const { return Length == 0; }
+	bool IsInline() const { return ArrayMemory == GetInlineMemory(); }
+	size_t Size() const { return Length; }
+	size_t GetCapacity() const { return Capacity; }
+
+	ElementType* Data() { return ArrayMemory; }
+	const ElementType* Data() const { return ArrayMemory; }
+
+	template<typename IntegerType>
+	ElementType& operator[](const IntegerType& i) {
+		if (static_cast<size_t>(i) >= Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %lld", Length, static_cast<long long>(i));
+		}
+		return ArrayMemory[i];
+	}
+
+	template<typename IntegerType>
+	const ElementType& operator[](const IntegerType& i) const {
+		if (static_cast<size_t>(i) >= Length) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Index out of bounds! Length: %zu, Index: %lld", Length, static_cast<long long>(i));
+		}
+		return ArrayMemory[i];
+	}
+
+private:
+	ElementType* GetInlineMemory() { return reinterpret_cast<ElementType*>(InlineStorage); }
+	const ElementType* GetInlineMemory() const { return reinterpret_cast<const ElementType*>(InlineStorage); }
+
+	bool Grow(size_t min_capacity) {
+		return Reallocate(DMAX(min_capacity, Capacity * ARRAY_DEFAULT_RESIZE_FACTOR));
+	}
+
+	// 把元素搬到容量为 new_capacity 的堆内存，new_capacity 必须大于当前容量
+	bool Reallocate(size_t new_capacity) {
+		ElementType* NewMemory = (ElementType*)Memory::AllocateUninitialized(new_capacity * sizeof(ElementType), MemoryType::eMemory_Type_Array);
+		if (!NewMemory) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to allocate memory for TInlineArray with capacity %zu", new_capacity);
+			return false;
+		}
+
+		try {
+			ArrayDetail::RelocateElements(NewMemory, ArrayMemory, Length);
+		}
+		catch (...) {
+			Memory::Free(NewMemory, MemoryType::eMemory_Type_Array);
+			throw;
+		}
+
+		if (!IsInline()) {
+			Memory::Free(ArrayMemory, MemoryType::eMemory_Type_Array);
+		}
+		ArrayMemory = NewMemory;
+		Capacity = new_capacity;
+		return true;
+	}
+
+	// 调用前自身必须为空且使用内联存储
+	void MoveFrom(TInlineArray& other) noexcept {
+		if (other.IsInline()) {
+			// 内联元素只能逐个搬过来，可按字节搬移的类型是一次 memcpy
+			ArrayDetail::RelocateElements(ArrayMemory, other.ArrayMemory, other.Length);
+			Length = other.Length;
+		}
+		else {
+			ArrayMemory = other.ArrayMemory;
+			Capacity = other.Capacity;
+			Length = other.Length;
+			other.ArrayMemory = other.GetInlineMemory();
+			other.Capacity = InlineCapacity;
+		}
+		other.Length = 0;
+	}
+
+private:
+	ElementType* ArrayMemory;
+	size_t Capacity;
+	size_t Length;
+	alignas(ElementType) unsigned char InlineStorage[InlineCapacity * sizeof(ElementType)];
+};
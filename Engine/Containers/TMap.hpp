@@ -4,12 +4,18 @@
 #include "Core/DMemory.hpp"
 
 /**
- * @brief 开放寻址（Robin Hood）哈希表，替代 std::unordered_map。
+ * @brief 开放寻址（Swiss table）哈希表，替代 std::unordered_map。
  *
  * 特性：
  *  - 完全模板化，类型安全
- *  - Robin Hood 线性探测，减少平均探测长度
- *  - 负载因子超过 0.75 时自动扩容（容量翻倍）
+ *  - 控制字节与键值分开存放，每个槽一个字节：空 / 墓碑 / 哈希低 7 位（H2）
+ *  - 查找时一次比较 16 个控制字节（SSE2 / NEON，其它平台退化为标量），
+ *    只有 H2 相同的槽才会比较键
+ *  - 哈希高位（H1）决定起始位置，按组做三角探测
+ *  - 负载因子超过 7/8 时扩容（容量翻倍）；扩容与重哈希不保留墓碑，
+ *    墓碑过多时按原容量重建
+ *  - 删除时如果所在窗口从未满过，直接置空而不是留下墓碑
+ *  - 默认构造不分配内存，首次插入时才分配
  *  - 不依赖任何 std 容器
  *  - 支持自定义哈希仿函数（默认 TDefaultHasher<K>）
  *
@@ -24,6 +30,8 @@
  *       Pair.Key;   Pair.Value;
  *       Pair.First(); Pair.Second();  // 等价写法
  *   }
+ *
+ * 迭代时可以 Remove 当前元素，但不能插入。
  */
 
  // ============================================================
@@ -62,6 +70,158 @@ struct TDefaultHasher<T*> {
     }
 };
 
+// ============================================================
+//  控制字节组
+// ============================================================
+
+// 直接按编译器宏选择指令集：Defines.hpp 中的 SIMD_SUPPORTED_* 在 MSVC 上是运行时检测，
+// 且开启 AVX2 时不会定义 SIMD_SUPPORTED_SSE2。
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TMAP_GROUP_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define TMAP_GROUP_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace TMapDetail {
+
+    using Ctrl = int8_t;
+
+    static constexpr Ctrl   kEmpty = -128;     // 0b10000000
+    static constexpr Ctrl   kDeleted = -2;     // 0b11111110，墓碑
+    static constexpr size_t kGroupWidth = 16;
+
+    inline uint32_t CountTrailingZeros(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long Index;
+        _BitScanForward64(&Index, v);
+        return (uint32_t)Index;
+#else
+        return (uint32_t)__builtin_ctzll(v);
+#endif
+    }
+
+    inline uint32_t CountLeadingZeros(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long Index;
+        _BitScanReverse64(&Index, v);
+        return 63 - (uint32_t)Index;
+#else
+        return (uint32_t)__builtin_clzll(v);
+#endif
+    }
+
+    /**
+     * @brief 一组 16 个槽的匹配结果，每个命中的槽对应一位。
+     * SSE2 / 标量版本每槽 1 位，NEON 版本每槽 4 位（只保留最高位）。
+     */
+    template<uint32_t Shift>
+    struct TBitMask {
+        uint64_t Mask;
+
+        explicit operator bool() const { return Mask != 0; }
+
+        // 最低的命中槽
+        uint32_t Lowest() const { return CountTrailingZeros(Mask) >> Shift; }
+        // 最高的命中槽
+        uint32_t Highest() const { return (63 - CountLeadingZeros(Mask)) >> Shift; }
+        void ClearLowest() { Mask &= Mask - 1; }
+    };
+
+#if defined(TMAP_GROUP_SSE2)
+
+    struct Group {
+        using BitMask = TBitMask<0>;
+
+        __m128i Ctrls;
+
+        explicit Group(const Ctrl* pos) : Ctrls(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+        BitMask Match(Ctrl h2) const {
+            return BitMask{ (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), Ctrls)) };
+        }
+
+        BitMask MatchEmpty() const {
+            return Match(kEmpty);
+        }
+
+        // 空和墓碑都小于 -1，满槽的控制字节 >= 0
+        BitMask MatchEmptyOrDeleted() const {
+            return BitMask{ (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), Ctrls)) };
+        }
+    };
+
+#elif defined(TMAP_GROUP_NEON)
+
+    struct Group {
+        using BitMask = TBitMask<2>;
+
+        int8x16_t Ctrls;
+
+        explicit Group(const Ctrl* pos) : Ctrls(vld1q_s8(pos)) {}
+
+        // 把 16 字节的比较结果压成 64 位，每个槽 4 位
+        static BitMask ToMask(uint8x16_t lanes) {
+            uint8x8_t Narrowed = vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4);
+            return BitMask{ vget_lane_u64(vreinterpret_u64_u8(Narrowed), 0) & 0x8888888888888888ULL };
+        }
+
+        BitMask Match(Ctrl h2) const {
+            return ToMask(vceqq_s8(vdupq_n_s8(h2), Ctrls));
+        }
+
+        BitMask MatchEmpty() const {
+            return Match(kEmpty);
+        }
+
+        BitMask MatchEmptyOrDeleted() const {
+            return ToMask(vcltq_s8(Ctrls, vdupq_n_s8(-1)));
+        }
+    };
+
+#else
+
+    struct Group {
+        using BitMask = TBitMask<0>;
+
+        const Ctrl* Ctrls;
+
+        explicit Group(const Ctrl* pos) : Ctrls(pos) {}
+
+        BitMask Match(Ctrl h2) const {
+            uint64_t Mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i)
+                Mask |= (uint64_t)(Ctrls[i] == h2) << i;
+            return BitMask{ Mask };
+        }
+
+        BitMask MatchEmpty() const {
+            return Match(kEmpty);
+        }
+
+        BitMask MatchEmptyOrDeleted() const {
+            uint64_t Mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i)
+                Mask |= (uint64_t)(Ctrls[i] < -1) << i;
+            return BitMask{ Mask };
+        }
+    };
+
+#endif
+
+    // 对用户哈希再做一次混合，弱哈希（整数恒等映射）也能让 H1 / H2 分布均匀
+    inline uint64_t MixHash(size_t hash) {
+        uint64_t h = (uint64_t)hash * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    }
+
+} // namespace TMapDetail
+
 // ============================================================
 //  TMap
 // ============================================================
@@ -87,51 +247,34 @@ public:
     };
 
 private:
-    // ── 内部桶状态 ────────────────────────────────────────
-    enum class EBucketState : uint8_t {
-        Empty = 0,
-        Occupied,
-        Deleted     // 墓碑，用于支持删除后继续探测
-    };
+    using Ctrl = TMapDetail::Ctrl;
+    using Group = TMapDetail::Group;
 
-    struct Bucket {
-        Pair         Data;
-        EBucketState State = EBucketState::Empty;
-        uint32_t     ProbeLen = 0;   // Robin Hood 探测距离
-    };
-
-    static constexpr size_t   kInitialCapacity = 16;
-    static constexpr float    kMaxLoadFactor = 0.75f;
+    static constexpr size_t kInitialCapacity = 16;     // 至少一组
+    static constexpr size_t kGroupWidth = TMapDetail::kGroupWidth;
 
 public:
     // ─────────────────────────────────────────────────────
     //  构造 / 析构
     // ─────────────────────────────────────────────────────
-    TMap() : Buckets_(nullptr), Capacity_(0), Count_(0) {
-        Resize(kInitialCapacity);
-    }
+    TMap() : Ctrl_(nullptr), Slots_(nullptr), Capacity_(0), Count_(0), GrowthLeft_(0) {}
 
     explicit TMap(size_t initial_capacity)
-        : Buckets_(nullptr), Capacity_(0), Count_(0) {
-        // 向上取到 2 的幂
-        size_t cap = kInitialCapacity;
-        while (cap < initial_capacity) cap <<= 1;
-        Resize(cap);
+        : Ctrl_(nullptr), Slots_(nullptr), Capacity_(0), Count_(0), GrowthLeft_(0) {
+        Resize(CapacityFor(initial_capacity));
     }
 
-    TMap(const TMap& other) : Buckets_(nullptr), Capacity_(0), Count_(0) {
-        Resize(other.Capacity_);
-        for (size_t i = 0; i < other.Capacity_; ++i) {
-            if (other.Buckets_[i].State == EBucketState::Occupied)
-                Insert(other.Buckets_[i].Data.Key, other.Buckets_[i].Data.Value);
-        }
+    TMap(const TMap& other) : Ctrl_(nullptr), Slots_(nullptr), Capacity_(0), Count_(0), GrowthLeft_(0) {
+        CopyFrom(other);
     }
 
     TMap(TMap&& other) noexcept
-        : Buckets_(other.Buckets_), Capacity_(other.Capacity_), Count_(other.Count_) {
-        other.Buckets_ = nullptr;
+        : Ctrl_(other.Ctrl_), Slots_(other.Slots_), Capacity_(other.Capacity_), Count_(other.Count_), GrowthLeft_(other.GrowthLeft_) {
+        other.Ctrl_ = nullptr;
+        other.Slots_ = nullptr;
         other.Capacity_ = 0;
         other.Count_ = 0;
+        other.GrowthLeft_ = 0;
     }
 
     ~TMap() { FreeBuckets(); }
@@ -139,22 +282,23 @@ public:
     TMap& operator=(const TMap& other) {
         if (this == &other) return *this;
         FreeBuckets();
-        Resize(other.Capacity_);
-        for (size_t i = 0; i < other.Capacity_; ++i)
-            if (other.Buckets_[i].State == EBucketState::Occupied)
-                Insert(other.Buckets_[i].Data.Key, other.Buckets_[i].Data.Value);
+        CopyFrom(other);
         return *this;
     }
 
     TMap& operator=(TMap&& other) noexcept {
         if (this != &other) {
             FreeBuckets();
-            Buckets_ = other.Buckets_;
+            Ctrl_ = other.Ctrl_;
+            Slots_ = other.Slots_;
             Capacity_ = other.Capacity_;
             Count_ = other.Count_;
-            other.Buckets_ = nullptr;
+            GrowthLeft_ = other.GrowthLeft_;
+            other.Ctrl_ = nullptr;
+            other.Slots_ = nullptr;
             other.Capacity_ = 0;
             other.Count_ = 0;
+            other.GrowthLeft_ = 0;
         }
         return *this;
     }
@@ -168,12 +312,10 @@ public:
      * @return 指向最终存储值的指针。
      */
     V* Insert(const K& key, const V& value) {
-        MaybeGrow();
         return InsertInternal(key, value);
     }
 
     V* Insert(const K& key, V&& value) {
-        MaybeGrow();
         return InsertInternal(key, static_cast<V&&>(value));
     }
 
@@ -183,13 +325,13 @@ public:
     V* Find(const K& key) {
         size_t idx = FindBucket(key);
         if (idx == kInvalid) return nullptr;
-        return &Buckets_[idx].Data.Value;
+        return &Slots_[idx].Value;
     }
 
     const V* Find(const K& key) const {
         size_t idx = FindBucket(key);
         if (idx == kInvalid) return nullptr;
-        return &Buckets_[idx].Data.Value;
+        return &Slots_[idx].Value;
     }
 
     /**
@@ -211,21 +353,21 @@ public:
     Pair& Get(const K& key) {
         size_t idx = FindBucket(key);
         if (idx == kInvalid) {
-            GLOG(Log::eError, "TMap::Get: key does not exist, call Contains() first");
+            GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "TMap::Get: key does not exist, call Contains() first");
             ASSERT(false);
         }
 
-        return Buckets_[idx].Data;
+        return Slots_[idx];
     }
 
     const Pair& Get(const K& key) const {
         size_t idx = FindBucket(key);
 		if (idx == kInvalid) {
-            GLOG(Log::eError, "TMap::Get: key does not exist, call Contains() first");
+            GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "TMap::Get: key does not exist, call Contains() first");
 			ASSERT(false);
 		}
 
-        return Buckets_[idx].Data;
+        return Slots_[idx];
     }
 
     /**
@@ -241,14 +383,14 @@ public:
     bool TryGet(const K& key, Pair& out_pair) {
         size_t idx = FindBucket(key);
         if (idx == kInvalid) return false;
-        out_pair = Buckets_[idx].Data;
+        out_pair = Slots_[idx];
         return true;
     }
 
     bool TryGet(const K& key, const Pair*& out_pair) const {
         size_t idx = FindBucket(key);
         if (idx == kInvalid) return false;
-        out_pair = &Buckets_[idx].Data;
+        out_pair = &Slots_[idx];
         return true;
     }
 
@@ -257,7 +399,7 @@ public:
      */
     V& operator[](const K& key) {
         size_t idx = FindBucket(key);
-        if (idx != kInvalid) return Buckets_[idx].Data.Value;
+        if (idx != kInvalid) return Slots_[idx].Value;
         V* inserted = Insert(key, V{});
         return *inserted;
     }
@@ -268,9 +410,8 @@ public:
     bool Remove(const K& key) {
         size_t idx = FindBucket(key);
         if (idx == kInvalid) return false;
-        Buckets_[idx].State = EBucketState::Deleted;
-        Buckets_[idx].Data.Key = K{};
-        Buckets_[idx].Data.Value = V{};
+        Slots_[idx].~Pair();
+        EraseMeta(idx);
         --Count_;
         return true;
     }
@@ -279,9 +420,11 @@ public:
      * @brief 清空所有条目（保留已分配容量）。
      */
     void Clear() {
-        for (size_t i = 0; i < Capacity_; ++i)
-            Buckets_[i].State = EBucketState::Empty;
+        if (!Ctrl_) return;
+        DestroySlots();
+        Memory::Set(Ctrl_, (uint8_t)TMapDetail::kEmpty, Capacity_ + kGroupWidth);
         Count_ = 0;
+        GrowthLeft_ = MaxLoad(Capacity_);
     }
 
     // ─────────────────────────────────────────────────────
@@ -292,21 +435,23 @@ public:
     bool   IsEmpty()  const { return Count_ == 0; }
 
     // ─────────────────────────────────────────────────────
-    //  迭代器（只前向，跳过空桶和墓碑）
+    //  迭代器（只前向，跳过空槽和墓碑）
     // ─────────────────────────────────────────────────────
     struct Iterator {
-        Bucket* Ptr;
-        Bucket* End;
+        const Ctrl* CtrlPtr;
+        Pair* Ptr;
+        Pair* End;
 
-        Iterator(Bucket* ptr, Bucket* end) : Ptr(ptr), End(end) {
+        Iterator(const Ctrl* ctrl, Pair* ptr, Pair* end) : CtrlPtr(ctrl), Ptr(ptr), End(end) {
             SkipEmpty();
         }
 
-        Pair& operator*()  const { return Ptr->Data; }
-        Pair* operator->() const { return &Ptr->Data; }
+        Pair& operator*()  const { return *Ptr; }
+        Pair* operator->() const { return Ptr; }
 
         Iterator& operator++() {
             ++Ptr;
+            ++CtrlPtr;
             SkipEmpty();
             return *this;
         }
@@ -316,37 +461,42 @@ public:
 
     private:
         void SkipEmpty() {
-            while (Ptr != End && Ptr->State != EBucketState::Occupied)
+            while (Ptr != End && *CtrlPtr < 0) {
                 ++Ptr;
+                ++CtrlPtr;
+            }
         }
     };
 
     struct ConstIterator {
-        const Bucket* Ptr;
-        const Bucket* End;
+        const Ctrl* CtrlPtr;
+        const Pair* Ptr;
+        const Pair* End;
 
-        ConstIterator(const Bucket* ptr, const Bucket* end) : Ptr(ptr), End(end) {
+        ConstIterator(const Ctrl* ctrl, const Pair* ptr, const Pair* end) : CtrlPtr(ctrl), Ptr(ptr), End(end) {
             SkipEmpty();
         }
 
-        const Pair& operator*()  const { return Ptr->Data; }
-        const Pair* operator->() const { return &Ptr->Data; }
+        const Pair& operator*()  const { return *Ptr; }
+        const Pair* operator->() const { return Ptr; }
 
-        ConstIterator& operator++() { ++Ptr; SkipEmpty(); return *this; }
+        ConstIterator& operator++() { ++Ptr; ++CtrlPtr; SkipEmpty(); return *this; }
         bool operator==(const ConstIterator& o) const { return Ptr == o.Ptr; }
         bool operator!=(const ConstIterator& o) const { return Ptr != o.Ptr; }
 
     private:
         void SkipEmpty() {
-            while (Ptr != End && Ptr->State != EBucketState::Occupied)
+            while (Ptr != End && *CtrlPtr < 0) {
                 ++Ptr;
+                ++CtrlPtr;
+            }
         }
     };
 
-    Iterator      begin() { return Iterator(Buckets_, Buckets_ + Capacity_); }
-    Iterator      end() { return Iterator(Buckets_ + Capacity_, Buckets_ + Capacity_); }
-    ConstIterator begin()  const { return ConstIterator(Buckets_, Buckets_ + Capacity_); }
-    ConstIterator end()    const { return ConstIterator(Buckets_ + Capacity_, Buckets_ + Capacity_); }
+    Iterator      begin() { return Iterator(Ctrl_, Slots_, Slots_ + Capacity_); }
+    Iterator      end() { return Iterator(Ctrl_ + Capacity_, Slots_ + Capacity_, Slots_ + Capacity_); }
+    ConstIterator begin()  const { return ConstIterator(Ctrl_, Slots_, Slots_ + Capacity_); }
+    ConstIterator end()    const { return ConstIterator(Ctrl_ + Capacity_, Slots_ + Capacity_, Slots_ + Capacity_); }
 
 private:
     // ─────────────────────────────────────────────────────
@@ -354,134 +504,200 @@ private:
     // ─────────────────────────────────────────────────────
     static constexpr size_t kInvalid = static_cast<size_t>(-1);
 
-    Bucket* Buckets_;
+    // 控制字节数组长度为 Capacity_ + kGroupWidth，末尾复制前 16 个字节，
+    // 这样从任意位置读取一组都不需要处理回绕
+    Ctrl*   Ctrl_;
+    Pair*   Slots_;
     size_t  Capacity_;
     size_t  Count_;
+    size_t  GrowthLeft_;    // 还能占用多少个空槽（墓碑不计入）
     Hasher  Hasher_;
 
-    // 分配并零初始化桶数组
+    static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+    static size_t CapacityFor(size_t count) {
+        // 向上取到 2 的幂，并保证负载不超过 7/8
+        size_t cap = kInitialCapacity;
+        while (MaxLoad(cap) < count) cap <<= 1;
+        return cap;
+    }
+
+    static size_t H1(uint64_t hash) { return (size_t)(hash >> 7); }
+    static Ctrl   H2(uint64_t hash) { return (Ctrl)(hash & 0x7F); }
+
+    static size_t CtrlBytes(size_t capacity) {
+        return PaddingAligned(capacity + kGroupWidth, alignof(Pair));
+    }
+
+    static size_t AllocationSize(size_t capacity) {
+        return CtrlBytes(capacity) + capacity * sizeof(Pair);
+    }
+
+    void SetCtrl(size_t idx, Ctrl h) {
+        Ctrl_[idx] = h;
+        // 同步末尾的镜像字节
+        if (idx < kGroupWidth)
+            Ctrl_[Capacity_ + idx] = h;
+    }
+
+    // 分配控制字节与槽，并把旧元素移动到新数组（不保留墓碑）
     void Resize(size_t new_capacity) {
-        Bucket* new_buckets = (Bucket*)Memory::Allocate(
-            new_capacity * sizeof(Bucket), MemoryType::eMemory_Type_Map);
-        if (!new_buckets) {
-            GLOG(Log::eFatal, "TMap::Resize: allocation failed");
+        size_t alignment = alignof(Pair) > 16 ? alignof(Pair) : 16;
+        char* block = (char*)Memory::AllocateUninitializedAligned(
+            AllocationSize(new_capacity), alignment, MemoryType::eMemory_Type_Map);
+        if (!block) {
+            GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "TMap::Resize: allocation failed");
             return;
         }
-        // placement new 初始化每个桶
-        for (size_t i = 0; i < new_capacity; ++i)
-            new (new_buckets + i) Bucket();
 
-        Bucket* old_buckets = Buckets_;
-        size_t  old_capacity = Capacity_;
+        Ctrl*  old_ctrl = Ctrl_;
+        Pair*  old_slots = Slots_;
+        size_t old_capacity = Capacity_;
 
-        Buckets_ = new_buckets;
+        Ctrl_ = (Ctrl*)block;
+        Slots_ = (Pair*)(block + CtrlBytes(new_capacity));
         Capacity_ = new_capacity;
-        Count_ = 0;
+        Memory::Set(Ctrl_, (uint8_t)TMapDetail::kEmpty, new_capacity + kGroupWidth);
 
-        // 将旧桶数据 rehash 到新数组
-        if (old_buckets) {
+        // 将旧槽数据 rehash 到新数组
+        if (old_ctrl) {
             for (size_t i = 0; i < old_capacity; ++i) {
-                if (old_buckets[i].State == EBucketState::Occupied)
-                    InsertInternal(old_buckets[i].Data.Key,
-                        static_cast<V&&>(old_buckets[i].Data.Value));
+                if (old_ctrl[i] < 0) continue;
+                uint64_t hash = TMapDetail::MixHash(Hasher_(old_slots[i].Key));
+                size_t idx = FindFirstNonFull(hash);
+                SetCtrl(idx, H2(hash));
+                new (Slots_ + idx) Pair(static_cast<Pair&&>(old_slots[i]));
+                old_slots[i].~Pair();
             }
-            // 析构旧桶
-            for (size_t i = 0; i < old_capacity; ++i)
-                old_buckets[i].~Bucket();
-            Memory::Free(old_buckets, MemoryType::eMemory_Type_Map);
+            Memory::FreeAligned(old_ctrl, AllocationSize(old_capacity), MemoryType::eMemory_Type_Map);
+        }
+
+        GrowthLeft_ = MaxLoad(Capacity_) - Count_;
+    }
+
+    void DestroySlots() {
+        for (size_t i = 0; i < Capacity_; ++i) {
+            if (Ctrl_[i] >= 0)
+                Slots_[i].~Pair();
         }
     }
 
     void FreeBuckets() {
-        if (Buckets_) {
-            for (size_t i = 0; i < Capacity_; ++i)
-                Buckets_[i].~Bucket();
-            Memory::Free(Buckets_, MemoryType::eMemory_Type_Map);
-            Buckets_ = nullptr;
+        if (Ctrl_) {
+            DestroySlots();
+            Memory::FreeAligned(Ctrl_, AllocationSize(Capacity_), MemoryType::eMemory_Type_Map);
+            Ctrl_ = nullptr;
+            Slots_ = nullptr;
             Capacity_ = 0;
             Count_ = 0;
+            GrowthLeft_ = 0;
         }
     }
 
-    void MaybeGrow() {
-        if (Count_ + 1 > static_cast<size_t>(Capacity_ * kMaxLoadFactor))
-            Resize(Capacity_ << 1);  // 容量翻倍
+    void CopyFrom(const TMap& other) {
+        if (other.Count_ == 0) return;
+        Resize(CapacityFor(other.Count_));
+        for (size_t i = 0; i < other.Capacity_; ++i) {
+            if (other.Ctrl_[i] >= 0)
+                Insert(other.Slots_[i].Key, other.Slots_[i].Value);
+        }
     }
 
-    // Robin Hood 插入
-    template<typename VV>
-    V* InsertInternal(const K& key, VV&& value) {
-        size_t hash = Hasher_(key) & (Capacity_ - 1);
-        uint32_t probe = 0;
-
-        // 当前"正在插入"的候选条目
-        Bucket candidate;
-        candidate.Data.Key = key;
-        candidate.Data.Value = static_cast<VV&&>(value);
-        candidate.State = EBucketState::Occupied;
-        candidate.ProbeLen = 0;
-
-        V* result = nullptr;
+    // 墓碑太多时按原容量重建，否则翻倍
+    void RehashAndGrowIfNecessary() {
+        if (Capacity_ == 0)
+            Resize(kInitialCapacity);
+        else if (Count_ <= MaxLoad(Capacity_) / 2)
+            Resize(Capacity_);
+        else
+            Resize(Capacity_ << 1);
+    }
 
+    // 探测序列中第一个空槽或墓碑
+    size_t FindFirstNonFull(uint64_t hash) const {
+        size_t mask = Capacity_ - 1;
+        size_t offset = H1(hash) & mask;
+        size_t step = 0;
         for (;;) {
-            size_t idx = (hash + probe) & (Capacity_ - 1);
-            Bucket& slot = Buckets_[idx];
-
-            if (slot.State == EBucketState::Empty ||
-                slot.State == EBucketState::Deleted) {
-                // 找到空槽：放入候选
-                if (!result) result = &slot.Data.Value;
-                slot = static_cast<Bucket&&>(candidate);
-                ++Count_;
-                return result;
-            }
-
-            // 键相同：覆盖
-            if (slot.Data.Key == candidate.Data.Key) {
-                slot.Data.Value = static_cast<VV&&>(candidate.Data.Value);
-                return &slot.Data.Value;
-            }
+            typename Group::BitMask match = Group(Ctrl_ + offset).MatchEmptyOrDeleted();
+            if (match)
+                return (offset + match.Lowest()) & mask;
+            step += kGroupWidth;
+            offset = (offset + step) & mask;
+        }
+    }
 
-            // Robin Hood：如果现有条目的探测距离更短，则抢占
-            if (slot.ProbeLen < candidate.ProbeLen) {
-                if (!result) result = &slot.Data.Value;
-                // 交换 candidate 和 slot
-                Bucket tmp = static_cast<Bucket&&>(slot);
-                slot = static_cast<Bucket&&>(candidate);
-                candidate = static_cast<Bucket&&>(tmp);
+    size_t FindIndex(const K& key, uint64_t hash) const {
+        size_t mask = Capacity_ - 1;
+        size_t offset = H1(hash) & mask;
+        size_t step = 0;
+        Ctrl h2 = H2(hash);
+        for (;;) {
+            Group group(Ctrl_ + offset);
+            for (typename Group::BitMask match = group.Match(h2); match; match.ClearLowest()) {
+                size_t idx = (offset + match.Lowest()) & mask;
+                if (Slots_[idx].Key == key)
+                    return idx;
             }
-
-            ++probe;
-            candidate.ProbeLen = probe;
+            // 一组里有空槽说明探测链到此为止（负载上限保证一定存在空槽）
+            if (group.MatchEmpty())
+                return kInvalid;
+            step += kGroupWidth;
+            offset = (offset + step) & mask;
         }
     }
 
     // 查找桶下标，未找到返回 kInvalid
     size_t FindBucket(const K& key) const {
-        if (Capacity_ == 0) return kInvalid;
-        size_t hash = Hasher_(key) & (Capacity_ - 1);
-        uint32_t probe = 0;
+        if (Count_ == 0) return kInvalid;
+        return FindIndex(key, TMapDetail::MixHash(Hasher_(key)));
+    }
 
-        for (;;) {
-            size_t idx = (hash + probe) & (Capacity_ - 1);
-            const Bucket& slot = Buckets_[idx];
+    template<typename VV>
+    V* InsertInternal(const K& key, VV&& value) {
+        uint64_t hash = TMapDetail::MixHash(Hasher_(key));
+
+        // 键相同：覆盖
+        if (Count_ > 0) {
+            size_t existing = FindIndex(key, hash);
+            if (existing != kInvalid) {
+                Slots_[existing].Value = static_cast<VV&&>(value);
+                return &Slots_[existing].Value;
+            }
+        }
 
-            if (slot.State == EBucketState::Empty)
-                return kInvalid;
+        size_t idx = Capacity_ > 0 ? FindFirstNonFull(hash) : kInvalid;
+        // 复用墓碑不消耗空槽；没有余量时先扩容或清理墓碑
+        if (idx == kInvalid || (GrowthLeft_ == 0 && Ctrl_[idx] != TMapDetail::kDeleted)) {
+            RehashAndGrowIfNecessary();
+            idx = FindFirstNonFull(hash);
+        }
 
-            if (slot.State == EBucketState::Occupied &&
-                slot.Data.Key == key)
-                return idx;
+        if (Ctrl_[idx] == TMapDetail::kEmpty)
+            --GrowthLeft_;
+        SetCtrl(idx, H2(hash));
+        new (Slots_ + idx) Pair{ key, static_cast<VV&&>(value) };
+        ++Count_;
+        return &Slots_[idx].Value;
+    }
 
-            // Robin Hood 早停：现有条目探测距离更短意味着目标不可能在更后面
-            if (slot.ProbeLen < probe)
-                return kInvalid;
+    // 如果包含该槽的任意 16 槽窗口都从未满过，就没有探测链经过它，可以直接置空
+    void EraseMeta(size_t idx) {
+        size_t before = (idx - kGroupWidth) & (Capacity_ - 1);
+        typename Group::BitMask empty_after = Group(Ctrl_ + idx).MatchEmpty();
+        typename Group::BitMask empty_before = Group(Ctrl_ + before).MatchEmpty();
+
+        bool was_never_full = empty_before && empty_after &&
+            (empty_after.Lowest() + (kGroupWidth - 1 - empty_before.Highest())) < kGroupWidth;
 
-            ++probe;
+        if (was_never_full) {
+            SetCtrl(idx, TMapDetail::kEmpty);
+            ++GrowthLeft_;
+        }
+        else {
+            SetCtrl(idx, TMapDetail::kDeleted);
         }
     }
-
-
 };
 
 // ============================================================
@@ -9,22 +9,27 @@
 /**
  * @brief Represents a ring queue of a particular size. Does not resize dynamically.
  * Naturally, this is a FIFO structure,
+ * Single-threaded only, see TConcurrentQueue.hpp for the lock-free SPSC and MPMC queues.
  */
 template<typename ElementType>
 class RingQueue{
 public:
-	RingQueue() {
-		RingQueue(1024);
-	}
+	RingQueue() : RingQueue(1024) {}
 
-	RingQueue(const RingQueue& q) {
+	// The copy always owns its own block, so both queues can be cleared independently.
+	RingQueue(const RingQueue& q) : RingQueue(q.Capacity) {
 		Length = q.Length;
-		Capacity = q.Capacity;
-		Stride = q.Stride;
 		Head = q.Head;
 		Tail = q.Tail;
-		OwnsMemory = q.OwnsMemory;
-		Block = q.Block;
+		if (Block != nullptr && q.Block != nullptr) {
+			Platform::PlatformCopyMemory(Block, q.Block, Capacity * Stride);
+		}
+	}
+
+	RingQueue& operator=(const RingQueue&) = delete;
+
+	~RingQueue() {
+		Clear();
 	}
 
 	/**
@@ -73,12 +78,12 @@ public:
 		}
 
 		if (Length == Capacity) {
-			GLOG(Log::eError, "Ring::Enqueue() Attempted to enqueue value in full ring queue: %p.", this);
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Ring::Enqueue() Attempted to enqueue value in full ring queue: %p.", this);
 			return false;
 		}
 
 		Tail = (Tail + 1) % Capacity;
-		Platform::PlatformCopyMemory(Block + Tail * Stride, value, Stride);
+		Platform::PlatformCopyMemory(Block + Tail, value, Stride);
 		Length++;
 		return true;
 	}
@@ -95,11 +100,11 @@ public:
 		}
 
 		if (Length == 0) {
-			GLOG(Log::eError, "RingQueue::Dequeue() Attempted to dequeue value in empty ring queue.");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "RingQueue::Dequeue() Attempted to dequeue value in empty ring queue.");
 			return false;
 		}
 
-		Platform::PlatformCopyMemory(out_val, Block + Head * Stride, Stride);
+		Platform::PlatformCopyMemory(out_val, Block + Head, Stride);
 		Head = (Head + 1) % Capacity;
 		Length--;
 		return true;
@@ -117,11 +122,11 @@ public:
 		}
 
 		if (Length == 0) {
-			GLOG(Log::eError, "RingQueue::Dequeue() Attempted to dequeue value in empty ring queue.");
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "RingQueue::Dequeue() Attempted to dequeue value in empty ring queue.");
 			return false;
 		}
 
-		Platform::PlatformCopyMemory(out_val, Block + Head * Stride, Stride);
+		Platform::PlatformCopyMemory(out_val, Block + Head, Stride);
 		return true;
 	}
 
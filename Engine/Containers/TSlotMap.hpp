@@ -0,0 +1,156 @@
+﻿#pragma once
+
+#include "TArray.hpp"
+
+/**
+ * @brief 槽位句柄：槽位下标加代数。槽位被释放后代数加一，旧句柄随之失效。
+ * 默认构造的句柄无效，打包成 64 位时等于 INVALID_ID_U64。
+ */
+struct FSlotHandle {
+	uint32_t Index = INVALID_ID;
+	uint32_t Generation = INVALID_ID;
+
+	FSlotHandle() = default;
+	FSlotHandle(uint32_t index, uint32_t generation) : Index(index), Generation(generation) {}
+
+	bool IsValid() const { return Index != INVALID_ID; }
+
+	// 高 32 位是代数，低 32 位是下标。第 0 代的句柄打包后就等于下标
+	uint64_t ToUInt64() const { return ((uint64_t)Generation << 32) | Index; }
+	static FSlotHandle FromUInt64(uint64_t value) { return FSlotHandle((uint32_t)value, (uint32_t)(value >> 32)); }
+
+	friend bool operator==(FSlotHandle h1, FSlotHandle h2) { return h1.Index == h2.Index && h1.Generation == h2.Generation; }
+	friend bool operator!=(FSlotHandle h1, FSlotHandle h2) { return !(h1 == h2); }
+};
+
+/**
+ * @brief 带代数的槽位表，用来替代“固定数组 + 线性查找空位 + 手动维护 generation”的资源注册表。
+ *
+ * 特性：
+ *  - 元素紧密存放在 Values 中，遍历只走连续内存
+ *  - 插入 O(1)：优先复用空闲链表中的槽位，没有才追加新槽位
+ *  - 删除 O(1)：用最后一个元素填补空位，再修正被搬动元素的槽位
+ *  - 句柄在元素被删除前一直有效，不受其他元素的插入删除影响；删除后再用旧句柄只会得到 nullptr
+ *
+ * 使用示例：
+ *   TSlotMap<Geometry*> Geometries;
+ *   FSlotHandle Handle = Geometries.Insert(NewGeometry);
+ *   if (Geometry** Found = Geometries.Get(Handle)) { ... }
+ *   Geometries.Erase(Handle);                     // 之后 Get(Handle) 返回 nullptr
+ *
+ * Get 返回的指针指向紧密数组，任何插入或删除之后都可能失效，需要长期保存的是句柄。
+ */
+template<typename ElementType>
+class TSlotMap {
+public:
+	TSlotMap() : FreeHead(INVALID_ID) {}
+
+	ElementType* begin() { return Values.begin(); }
+	const ElementType* begin() const { return Values.begin(); }
+	ElementType* end() { return Values.end(); }
+	const ElementType* end() const { return Values.end(); }
+
+public:
+	FSlotHandle Insert(const ElementType& value) {
+		return Emplace(value);
+	}
+
+	FSlotHandle Insert(ElementType&& value) {
+		return Emplace(std::move(value));
+	}
+
+	template<typename... Args>
+	FSlotHandle Emplace(Args&&... args) {
+		uint32_t DenseIndex = (uint32_t)Values.Size();
+		Values.Emplace(std::forward<Args>(args)...);
+
+		uint32_t SlotIndex = FreeHead;
+		if (SlotIndex != INVALID_ID) {
+			FreeHead = Slots[SlotIndex].DenseIndex;
+			Slots[SlotIndex].DenseIndex = DenseIndex;
+		}
+		else {
+			SlotIndex = (uint32_t)Slots.Size();
+			Slots.Push(FSlot{ DenseIndex, 0 });
+		}
+
+		DenseToSlot.Push(SlotIndex);
+		return FSlotHandle(SlotIndex, Slots[SlotIndex].Generation);
+	}
+
+	// 删除句柄指向的元素，句柄已失效时返回 false
+	bool Erase(FSlotHandle handle) {
+		if (!Contains(handle)) {
+			return false;
+		}
+
+		FSlot& Slot = Slots[handle.Index];
+		uint32_t DenseIndex = Slot.DenseIndex;
+		uint32_t LastIndex = (uint32_t)Values.Size() - 1;
+		if (DenseIndex != LastIndex) {
+			Slots[DenseToSlot[LastIndex]].DenseIndex = DenseIndex;
+		}
+		Values.RemoveSwap(DenseIndex);
+		DenseToSlot.RemoveSwap(DenseIndex);
+
+		// 跳过 INVALID_ID，保证句柄的代数永远不会是无效值
+		Slot.Generation = Slot.Generation + 1 == INVALID_ID ? 0 : Slot.Generation + 1;
+		Slot.DenseIndex = FreeHead;
+		FreeHead = handle.Index;
+		return true;
+	}
+
+	bool Contains(FSlotHandle handle) const {
+		if (handle.Index >= Slots.Size()) {
+			return false;
+		}
+
+		// 空闲槽位的 DenseIndex 存的是链表的下一项，需要反查确认槽位正在使用
+		const FSlot& Slot = Slots[handle.Index];
+		return Slot.Generation == handle.Generation && Slot.DenseIndex < DenseToSlot.Size() && DenseToSlot[Slot.DenseIndex] == handle.Index;
+	}
+
+	ElementType* Get(FSlotHandle handle) {
+		return Contains(handle) ? &Values[Slots[handle.Index].DenseIndex] : nullptr;
+	}
+
+	const ElementType* Get(FSlotHandle handle) const {
+		return Contains(handle) ? &Values[Slots[handle.Index].DenseIndex] : nullptr;
+	}
+
+	// 紧密数组中第 dense_index 个元素的句柄，遍历时用来取回句柄
+	FSlotHandle GetHandle(size_t dense_index) const {
+		uint32_t SlotIndex = DenseToSlot[dense_index];
+		return FSlotHandle(SlotIndex, Slots[SlotIndex].Generation);
+	}
+
+	void Reserve(size_t capacity) {
+		Values.Reserve(capacity);
+		DenseToSlot.Reserve(capacity);
+		Slots.Reserve(capacity);
+	}
+
+	// 删除所有元素，已发出的句柄全部失效，槽位保留给之后的插入复用
+	void Clear() {
+		while (!Values.IsEmpty()) {
+			Erase(GetHandle(Values.Size() - 1));
+		}
+	}
+
+	bool IsEmpty() const { return Values.IsEmpty(); }
+	size_t Size() const { return Values.Size(); }
+
+	ElementType* Data() { return Values.Data(); }
+	const ElementType* Data() const { return Values.Data(); }
+
+private:
+	struct FSlot {
+		uint32_t DenseIndex;		// 使用中：元素在 Values 中的下标；空闲：空闲链表的下一个槽位
+		uint32_t Generation;
+	};
+
+	TArray<ElementType> Values;
+	TArray<uint32_t> DenseToSlot;
+	TArray<FSlot> Slots;
+	uint32_t FreeHead;
+};
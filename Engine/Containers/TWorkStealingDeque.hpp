@@ -0,0 +1,168 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "Platform/Platform.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Chase-Lev 工作窃取双端队列（按 Lê 等人 2013 年的弱内存序版本实现）。
+ *
+ * 队列属于一个线程（所有者），所有者在底部 Push/Pop，后进先出，刚提交的任务数据还在缓存里；
+ * 其他线程从顶部 Steal，先进先出，偷走的是最早提交、通常也是最大块的任务。
+ * 只有队列里剩最后一个元素时所有者和窃取者才会竞争同一个 CAS，其余情况下所有者不做原子 RMW。
+ *
+ *  - 元素必须可平凡拷贝，一般存任务指针
+ *  - 满了就把容量翻倍。旧缓冲区可能还有窃取者在读，保留到析构时再释放
+ *  - GetLength/IsEmpty 只是瞬时的近似值
+ *
+ * 使用示例：
+ *   TWorkStealingDeque<Job*> Deque;
+ *   Deque.Push(NewJob);                  // 所有者线程
+ *   Job* Next;
+ *   if (Deque.Pop(Next)) { ... }         // 所有者线程
+ *   if (Other.Steal(Next)) { ... }       // 任意线程
+ */
+template<typename ElementType>
+class TWorkStealingDeque {
+	static_assert(std::is_trivially_copyable<ElementType>::value, "TWorkStealingDeque elements must be trivially copyable.");
+
+public:
+	explicit TWorkStealingDeque(uint32_t capacity = 256) {
+		int64_t Capacity = 2;
+		while (Capacity < (int64_t)capacity) {
+			Capacity <<= 1;
+		}
+		Buffer.store(CreateBuffer(Capacity), std::memory_order_relaxed);
+	}
+
+	TWorkStealingDeque(const TWorkStealingDeque&) = delete;
+	TWorkStealingDeque& operator=(const TWorkStealingDeque&) = delete;
+
+	~TWorkStealingDeque() {
+		FBuffer* Current = Buffer.load(std::memory_order_relaxed);
+		while (Current != nullptr) {
+			FBuffer* Previous = Current->Retired;
+			Platform::PlatformFree(Current, false);
+			Current = Previous;
+		}
+	}
+
+	/**
+	 * @brief 所有者线程调用，压入底部，队列满时扩容。
+	 */
+	void Push(ElementType value) {
+		const int64_t CurrentBottom = Bottom.load(std::memory_order_relaxed);
+		const int64_t CurrentTop = Top.load(std::memory_order_acquire);
+		FBuffer* Current = Buffer.load(std::memory_order_relaxed);
+		if (CurrentBottom - CurrentTop > Current->Mask) {
+			Current = Grow(Current, CurrentTop, CurrentBottom);
+		}
+
+		// 论文里是 release 栅栏加 relaxed 写，这里直接用 release 写，窃取方 acquire 读 Bottom 与之配对
+		Current->Slot(CurrentBottom).store(value, std::memory_order_relaxed);
+		Bottom.store(CurrentBottom + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief 所有者线程调用，从底部取出最近压入的元素。
+	 *
+	 * @return 队列为空，或最后一个元素被窃取者抢走时返回 false。
+	 */
+	bool Pop(ElementType& out_value) {
+		const int64_t CurrentBottom = Bottom.load(std::memory_order_relaxed) - 1;
+		FBuffer* Current = Buffer.load(std::memory_order_relaxed);
+		Bottom.store(CurrentBottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t CurrentTop = Top.load(std::memory_order_relaxed);
+
+		if (CurrentTop > CurrentBottom) {
+			// 本来就是空的
+			Bottom.store(CurrentBottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		out_value = Current->Slot(CurrentBottom).load(std::memory_order_relaxed);
+		if (CurrentTop == CurrentBottom) {
+			// 最后一个元素，和窃取者抢顶部下标
+			bool Won = Top.compare_exchange_strong(CurrentTop, CurrentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			Bottom.store(CurrentBottom + 1, std::memory_order_relaxed);
+			return Won;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief 任意线程调用，从顶部取出最早压入的元素。
+	 *
+	 * @return 队列为空，或与其他线程竞争失败时返回 false。失败不代表队列已空，调用方可以换个队列再试。
+	 */
+	bool Steal(ElementType& out_value) {
+		int64_t CurrentTop = Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t CurrentBottom = Bottom.load(std::memory_order_acquire);
+		if (CurrentTop >= CurrentBottom) {
+			return false;
+		}
+
+		FBuffer* Current = Buffer.load(std::memory_order_acquire);
+		ElementType Value = Current->Slot(CurrentTop).load(std::memory_order_relaxed);
+		if (!Top.compare_exchange_strong(CurrentTop, CurrentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return false;
+		}
+
+		out_value = Value;
+		return true;
+	}
+
+	size_t GetLength() const {
+		const int64_t Length = Bottom.load(std::memory_order_relaxed) - Top.load(std::memory_order_relaxed);
+		return Length > 0 ? (size_t)Length : 0;
+	}
+
+	bool IsEmpty() const { return GetLength() == 0; }
+
+	size_t GetCapacity() const { return (size_t)Buffer.load(std::memory_order_relaxed)->Mask + 1; }
+
+private:
+	struct FBuffer {
+		int64_t Mask;
+		FBuffer* Retired;				// 扩容前的缓冲区，析构时一起释放
+
+		std::atomic<ElementType>& Slot(int64_t index) {
+			return ((std::atomic<ElementType>*)(this + 1))[index & Mask];
+		}
+	};
+
+	static FBuffer* CreateBuffer(int64_t capacity) {
+		FBuffer* Result = (FBuffer*)Platform::PlatformAllocate(sizeof(FBuffer) + capacity * sizeof(std::atomic<ElementType>), false);
+		if (Result == nullptr) {
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "Failed to allocate work stealing deque with capacity %lld.", (long long)capacity);
+			return nullptr;
+		}
+		Result->Mask = capacity - 1;
+		Result->Retired = nullptr;
+		for (int64_t i = 0; i < capacity; ++i) {
+			new(&Result->Slot(i)) std::atomic<ElementType>();
+		}
+		return Result;
+	}
+
+	FBuffer* Grow(FBuffer* current, int64_t top, int64_t bottom) {
+		FBuffer* Grown = CreateBuffer((current->Mask + 1) * 2);
+		for (int64_t i = top; i < bottom; ++i) {
+			Grown->Slot(i).store(current->Slot(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		Grown->Retired = current;
+		Buffer.store(Grown, std::memory_order_release);
+		return Grown;
+	}
+
+private:
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> Top{ 0 };
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> Bottom{ 0 };
+	std::atomic<FBuffer*> Buffer{ nullptr };
+};
@@ -1,44 +1,158 @@
-﻿#include "DMemory.hpp"
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "DMemory.hpp"
 
 #include "EngineLogger.hpp"
 #include "Platform/Platform.hpp"
 #include "Containers/FString.hpp"
+#include "Memory/ThreadCache.h"
+#include "Memory/ObjectPool.h"
+#include "Memory/MemoryTrace.h"
 
 struct Memory::SMemoryStats Memory::stats;
 size_t Memory::TotalAllocateSize;
-size_t Memory::AllocateCount;
 Mutex Memory::AllocationMutex;
 
+// Only touched by UpdateFrameStats(), which runs on the frame thread.
+static size_t LastTotalCount[eMemory_Type_Max];
+static size_t LastTotalBytes[eMemory_Type_Max];
+static size_t RateWindowBytes[eMemory_Type_Max];
+static double RateWindowTime = 0.0;
+
+static inline void AddStats(size_t size, MemoryType type) {
+	auto& Counters = Memory::stats.tagged[type];
+	size_t Allocated = Counters.allocated.fetch_add(size, std::memory_order_relaxed) + size;
+	Counters.count.fetch_add(1, std::memory_order_relaxed);
+	Counters.total_count.fetch_add(1, std::memory_order_relaxed);
+	Counters.total_bytes.fetch_add(size, std::memory_order_relaxed);
+
+	size_t Peak = Counters.peak.load(std::memory_order_relaxed);
+	while (Allocated > Peak && !Counters.peak.compare_exchange_weak(Peak, Allocated, std::memory_order_relaxed)) {
+	}
+}
+
+static inline void SubStats(size_t size, MemoryType type) {
+	auto& Counters = Memory::stats.tagged[type];
+	Counters.allocated.fetch_sub(size, std::memory_order_relaxed);
+	Counters.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
 bool Memory::Initialize(size_t size) {
-	Platform::PlatformZeroMemory(&stats, sizeof(stats));
-	
+	for (size_t i = 0; i < eMemory_Type_Max; ++i) {
+		auto& Counters = stats.tagged[i];
+		Counters.allocated.store(0);
+		Counters.peak.store(0);
+		Counters.count.store(0);
+		Counters.total_count.store(0);
+		Counters.total_bytes.store(0);
+		Counters.frame_count.store(0);
+		Counters.frame_bytes.store(0);
+		Counters.bytes_per_second.store(0.0);
+
+		LastTotalCount[i] = 0;
+		LastTotalBytes[i] = 0;
+		RateWindowBytes[i] = 0;
+	}
+	stats.total_peak.store(0);
+	RateWindowTime = 0.0;
+
 	DynamicAllocator::Get().Resize(size);
+	// The arena reserves address space only, so it may grow instead of failing when full.
+	DynamicAllocator::Get().SetGrowable(true);
+
+	// Cached blocks and pool slabs point into the previous arena.
+	ThreadCache::Invalidate();
+	ObjectPool::Invalidate();
 
-	AllocateCount = 0;
 	TotalAllocateSize = size;
 
+#if DMEMORY_TRACE
+	if (!MemoryTrace::Start(MEMORY_TRACE_DEFAULT_FILE)) {
+		GLOG(Log::eWarn, "Unable to start memory trace '%s'.", MEMORY_TRACE_DEFAULT_FILE);
+	}
+#endif
+
 	GLOG(Log::eDebug, "Memory system successfully allocated %llu bytes.", TotalAllocateSize);
 	return true;
 }
 
 void Memory::Shutdown() {
-	AllocateCount = 0;
+	ObjectPool::Release();
+#if DMEMORY_TRACE
+	// Everything the trace still sees alive from here on is a leak.
+	MemoryTrace::Stop();
+#endif
+	ThreadCache::Release();
+
 	TotalAllocateSize = 0;
 }
 
+static inline void* ZeroBlock(void* block, size_t size) {
+	if (block != nullptr) {
+		Platform::PlatformZeroMemory(block, size);
+	}
+
+	return block;
+}
+
+static inline void* PoisonBlock(void* block, size_t size) {
+#if DMEMORY_POISON_UNINITIALIZED
+	if (block != nullptr) {
+		Platform::PlatformSetMemory(block, DMEMORY_UNINITIALIZED_POISON, size);
+	}
+#else
+	(void)size;
+#endif
+
+	return block;
+}
+
+// The public entry points call AllocateBlock directly, so the traced call site is their caller.
 void* Memory::Allocate(size_t size, MemoryType type) {
-	return AllocateAligned(size, DEFAULT_ALIGNMENT_SIZE, type);
+	return ZeroBlock(AllocateBlock(size, DEFAULT_ALIGNMENT_SIZE, type, DMEMORY_CALL_SITE()), size);
+}
+
+void* Memory::AllocateZeroed(size_t size, MemoryType type) {
+	return ZeroBlock(AllocateBlock(size, DEFAULT_ALIGNMENT_SIZE, type, DMEMORY_CALL_SITE()), size);
 }
 
 void* Memory::AllocateAligned(size_t size, size_t alignment, MemoryType type) {
+	return ZeroBlock(AllocateBlock(size, alignment, type, DMEMORY_CALL_SITE()), size);
+}
+
+void* Memory::AllocateUninitialized(size_t size, MemoryType type) {
+	return PoisonBlock(AllocateBlock(size, DEFAULT_ALIGNMENT_SIZE, type, DMEMORY_CALL_SITE()), size);
+}
+
+void* Memory::AllocateUninitializedAligned(size_t size, size_t alignment, MemoryType type) {
+	return PoisonBlock(AllocateBlock(size, alignment, type, DMEMORY_CALL_SITE()), size);
+}
+
+void* Memory::AllocateBlock(size_t size, size_t alignment, MemoryType type, const void* call_site) {
 	if (type == eMemory_Type_Unknow) {
 		GLOG(Log::eWarn, "Called allocate using eMemory_Type_Unknow. Re-class this allocation.");
 	}
+#if !DMEMORY_TRACE
+	(void)call_site;
+#endif
 
 	void* Block = nullptr;
-	stats.total_allocated += size;
-	stats.tagged_allocations[type] += size;
-	AllocateCount++;
+
+#if DMEMORY_THREAD_CACHE
+	// Small requests are served from the calling thread's magazine without taking any lock.
+	if (ThreadCache::CanServe(size, alignment)) {
+		Block = ThreadCache::Allocate(size);
+		if (Block != nullptr) {
+			AddStats(ThreadCache::GetClassSize(size), type);
+#if DMEMORY_TRACE
+			MemoryTrace::RecordAllocate(Block, size, (uint16_t)type, 0, call_site);
+#endif
+			return Block;
+		}
+	}
+#endif
+
+	AddStats(size, type);
 
 	// Make sure multi-threaded requests don't trample each other.
 	if (!AllocationMutex.Lock()) {
@@ -57,46 +171,60 @@ void* Memory::AllocateAligned(size_t size, size_t alignment, MemoryType type) {
 	if (Block == nullptr) {
 		GLOG(Log::eFatal, "Allocate failed.");
 	}
-
-	Platform::PlatformZeroMemory(Block, size);
+#if DMEMORY_TRACE
+	else {
+		MemoryTrace::RecordAllocate(Block, size, (uint16_t)type, 0, call_site);
+	}
+#endif
 
 	return Block;
 }
 
 void Memory::AllocateReport(size_t size, MemoryType type) {
-	// Make sure multi-threaded requests don't trample each other.
-	if (!AllocationMutex.Lock()) {
-		GLOG(Log::eFatal, "Error obtaining mutex lock during allocation.");
-		return;
-	}
-
-	stats.total_allocated += size;
-	stats.tagged_allocations[type] += size;
-	AllocateCount++;
-
-	AllocationMutex.UnLock();
+	AddStats(size, type);
 }
 
 void  Memory::Free(void* block, MemoryType type) {
 	size_t alloc_size = 0;
 	Memory::GetAlignmentSize(block, &alloc_size, nullptr);
-	FreeAligned(block, alloc_size, type);
+	FreeBlock(block, alloc_size, type, DMEMORY_CALL_SITE());
 }
 
 void Memory::FreeAligned(void* block, size_t size, MemoryType type) {
+	FreeBlock(block, size, type, DMEMORY_CALL_SITE());
+}
+
+void Memory::FreeBlock(void* block, size_t size, MemoryType type, const void* call_site) {
 	if (type == eMemory_Type_Unknow) {
 		GLOG(Log::eWarn, "Called free using eMemory_Type_Unknow. Re-class this allocation.");
 	}
 
+#if DMEMORY_TRACE
+	// Recorded before the block is released, so a reuse of the address always sorts after it.
+	MemoryTrace::RecordFree(block, (uint16_t)type, 0, call_site);
+#else
+	(void)call_site;
+#endif
+
+#if DMEMORY_THREAD_CACHE
+	// Cached blocks are accounted with their class size, whatever size the caller passed.
+	size_t BlockSize = 0;
+	size_t BlockAlignment = 0;
+	if (DynamicAllocator::Get().GetAlignmentSize(block, &BlockSize, &BlockAlignment) &&
+		ThreadCache::IsCachedBlock(BlockSize, BlockAlignment)) {
+		SubStats(BlockSize, type);
+		ThreadCache::Free(block, BlockSize);
+		return;
+	}
+#endif
+
 	// Make sure multi-threaded requests don't trample each other.
 	if (!AllocationMutex.Lock()) {
 		GLOG(Log::eFatal, "Unable to obtain mutex lock for free operation. Heap corruption is likely.");
 		return;
 	}
 
-	stats.total_allocated -= size;
-	stats.tagged_allocations[type] -= size;
-	AllocateCount--;
+	SubStats(size, type);
 
 	bool Result = DynamicAllocator::Get().FreeAligned(block);
 	AllocationMutex.UnLock();
@@ -109,16 +237,7 @@ void Memory::FreeAligned(void* block, size_t size, MemoryType type) {
 }
 
 void Memory::FreeReport(size_t size, MemoryType type) {
-	if (!AllocationMutex.Lock()) {
-		GLOG(Log::eFatal, "Unable to obtain mutex lock for free operation. Heap corruption is likely.");
-		return;
-	}
-
-	stats.total_allocated -= size;
-	stats.tagged_allocations[type] -= size;
-	AllocateCount--;
-
-	AllocationMutex.UnLock();
+	SubStats(size, type);
 }
 
 bool Memory::GetAlignmentSize(void* block, size_t* out_size, size_t* out_alignment) {
@@ -161,8 +280,10 @@ FString Memory::GetMemoryUsageStr() {
 	size_t offset = strlen(buffer);
 	for (size_t i = 0; i < eMemory_Type_Max; i++) {
 		float amount = 1.0f;
-		const char* Unit = GetUnitForSize(stats.tagged_allocations[i], &amount);
-		int length = snprintf(buffer + offset, 8000, " %s: %.2f%s\n", MemoryTypeStrings[i], amount, Unit);
+		const char* Unit = GetUnitForSize(stats.tagged[i].allocated.load(std::memory_order_relaxed), &amount);
+		float PeakAmount = 1.0f;
+		const char* PeakUnit = GetUnitForSize(stats.tagged[i].peak.load(std::memory_order_relaxed), &PeakAmount);
+		int length = snprintf(buffer + offset, 8000, " %s: %.2f%s (peak %.2f%s)\n", MemoryTypeStrings[i], amount, Unit, PeakAmount, PeakUnit);
 		offset += length;
 	}
 
@@ -181,7 +302,17 @@ FString Memory::GetMemoryUsageStr() {
 
 		double PercentUsed = (double)UsedSpace / (double)TotalSpace;
 
-		snprintf(buffer + offset, 8000, "Total memory usage: %.2f%s of %.2f%s (%d%%%%)\n", UsedAmount, UsedUnit, TotalAmount, TotalUnit, (int)(PercentUsed * 100));
+		int length = snprintf(buffer + offset, 8000, "Total memory usage: %.2f%s of %.2f%s (%d%%%%)\n", UsedAmount, UsedUnit, TotalAmount, TotalUnit, (int)(PercentUsed * 100));
+		offset += length;
+
+		float LargestAmount = 1.0f;
+		const char* LargestUnit = GetUnitForSize(Allocator.GetLargestFreeBlock(), &LargestAmount);
+		length = snprintf(buffer + offset, 8000, "Largest free block: %.2f%s, fragmentation: %.2f%%%%\n", LargestAmount, LargestUnit, Allocator.GetFragmentation() * 100.0f);
+		offset += length;
+
+		float CommittedAmount = 1.0f;
+		const char* CommittedUnit = GetUnitForSize(Allocator.GetCommittedSpace(), &CommittedAmount);
+		snprintf(buffer + offset, 8000, "Committed: %.2f%s in %u chunks\n", CommittedAmount, CommittedUnit, Allocator.GetChunkCount());
 	}
 
 	return buffer;
@@ -189,9 +320,72 @@ FString Memory::GetMemoryUsageStr() {
 
 void Memory::ShowMemoryUsage() {
 	FString Msg = GetMemoryUsageStr();
-	GLOG(Log::eDebug, Msg.CStr());
+	GLOG(Log::eDebug, "%s", Msg.CStr());
 }
 
 size_t Memory::GetAllocateCount() { 
-	return AllocateCount; 
+	return GetTotalStats().Count; 
+}
+
+SMemoryTagStats Memory::GetTagStats(MemoryType type) {
+	const SMemoryTagCounters& Counters = stats.tagged[type];
+
+	SMemoryTagStats Result;
+	Result.Allocated = Counters.allocated.load(std::memory_order_relaxed);
+	Result.Peak = Counters.peak.load(std::memory_order_relaxed);
+	Result.Count = Counters.count.load(std::memory_order_relaxed);
+	Result.FrameAllocations = Counters.frame_count.load(std::memory_order_relaxed);
+	Result.FrameBytes = Counters.frame_bytes.load(std::memory_order_relaxed);
+	Result.BytesPerSecond = Counters.bytes_per_second.load(std::memory_order_relaxed);
+	return Result;
+}
+
+SMemoryTagStats Memory::GetTotalStats() {
+	SMemoryTagStats Result;
+	for (size_t i = 0; i < eMemory_Type_Max; ++i) {
+		SMemoryTagStats Tag = GetTagStats((MemoryType)i);
+		Result.Allocated += Tag.Allocated;
+		Result.Count += Tag.Count;
+		Result.FrameAllocations += Tag.FrameAllocations;
+		Result.FrameBytes += Tag.FrameBytes;
+		Result.BytesPerSecond += Tag.BytesPerSecond;
+	}
+
+	// The per-tag peaks may come from different moments, so the total peak is sampled once per frame instead.
+	Result.Peak = DMAX(stats.total_peak.load(std::memory_order_relaxed), Result.Allocated);
+	return Result;
+}
+
+void Memory::UpdateFrameStats(double delta_time) {
+	RateWindowTime += delta_time;
+	bool UpdateRate = RateWindowTime >= 1.0;
+
+	size_t Allocated = 0;
+	for (size_t i = 0; i < eMemory_Type_Max; ++i) {
+		SMemoryTagCounters& Counters = stats.tagged[i];
+		size_t TotalCount = Counters.total_count.load(std::memory_order_relaxed);
+		size_t TotalBytes = Counters.total_bytes.load(std::memory_order_relaxed);
+
+		size_t FrameBytes = TotalBytes - LastTotalBytes[i];
+		Counters.frame_count.store(TotalCount - LastTotalCount[i], std::memory_order_relaxed);
+		Counters.frame_bytes.store(FrameBytes, std::memory_order_relaxed);
+		LastTotalCount[i] = TotalCount;
+		LastTotalBytes[i] = TotalBytes;
+
+		RateWindowBytes[i] += FrameBytes;
+		if (UpdateRate) {
+			Counters.bytes_per_second.store((double)RateWindowBytes[i] / RateWindowTime, std::memory_order_relaxed);
+			RateWindowBytes[i] = 0;
+		}
+
+		Allocated += Counters.allocated.load(std::memory_order_relaxed);
+	}
+
+	if (UpdateRate) {
+		RateWindowTime = 0.0;
+	}
+
+	if (Allocated > stats.total_peak.load(std::memory_order_relaxed)) {
+		stats.total_peak.store(Allocated, std::memory_order_relaxed);
+	}
 }
@@ -4,6 +4,9 @@
 #include "EngineLogger.hpp"
 #include "Platform/Thread/DMutex.hpp"
 #include "Memory/DynamicAllocator.h"
+#include "Memory/ObjectPool.h"
+
+#include <atomic>
 
 class FString;
 
@@ -11,6 +14,18 @@ class FString;
 #define DEFAULT_ALIGNMENT_SIZE 8
 #endif
 
+// Fill memory returned by the uninitialized allocation path with a pattern, so reads of
+// data that was never written show up as obviously wrong values.
+#ifndef DMEMORY_POISON_UNINITIALIZED
+#ifdef LEVEL_DEBUG
+#define DMEMORY_POISON_UNINITIALIZED 1
+#else
+#define DMEMORY_POISON_UNINITIALIZED 0
+#endif
+#endif
+
+#define DMEMORY_UNINITIALIZED_POISON 0xCD
+
 enum MemoryType {
 	eMemory_Type_Unknow,
 	eMemory_Type_Array,
@@ -72,11 +87,36 @@ static const char* MemoryTypeStrings[eMemory_Type_Max]{
 	"System_Font"
 };
 
+/**
+ * @brief Snapshot of the allocation statistics of one tag, or of all tags together.
+ */
+struct SMemoryTagStats {
+	size_t Allocated = 0;					// Bytes currently allocated
+	size_t Peak = 0;						// Highest value Allocated has reached
+	size_t Count = 0;						// Blocks currently allocated
+	size_t FrameAllocations = 0;			// Allocations made during the last frame
+	size_t FrameBytes = 0;					// Bytes allocated during the last frame
+	double BytesPerSecond = 0.0;			// Allocation rate over the last second
+};
+
 class Memory {
 private:
+	// One cache line per tag, so threads working on different tags don't contend. The hot
+	// counters are relaxed atomics; the frame fields are only written by UpdateFrameStats().
+	struct alignas(64) SMemoryTagCounters {
+		std::atomic<size_t> allocated;
+		std::atomic<size_t> peak;
+		std::atomic<size_t> count;
+		std::atomic<size_t> total_count;
+		std::atomic<size_t> total_bytes;
+		std::atomic<size_t> frame_count;
+		std::atomic<size_t> frame_bytes;
+		std::atomic<double> bytes_per_second;
+	};
+
 	struct SMemoryStats {
-		size_t total_allocated;
-		size_t tagged_allocations[eMemory_Type_Max];
+		SMemoryTagCounters tagged[eMemory_Type_Max];
+		std::atomic<size_t> total_peak;
 	};
 
 public:
@@ -87,8 +127,15 @@ public:
 	static DAPI bool Initialize(size_t size);
 	static DAPI void Shutdown();
 
+	// Allocate and AllocateAligned return zeroed memory, same as AllocateZeroed.
 	static DAPI void* Allocate(size_t size, MemoryType type = MemoryType::eMemory_Type_Unknow);
 	static DAPI void* AllocateAligned(size_t size, size_t alignment, MemoryType type);
+	static DAPI void* AllocateZeroed(size_t size, MemoryType type = MemoryType::eMemory_Type_Unknow);
+
+	// For buffers the caller overwrites completely right away (loaded assets, staging copies,
+	// container storage). The contents are undefined, or poisoned with DMEMORY_POISON_UNINITIALIZED.
+	static DAPI void* AllocateUninitialized(size_t size, MemoryType type = MemoryType::eMemory_Type_Unknow);
+	static DAPI void* AllocateUninitializedAligned(size_t size, size_t alignment, MemoryType type);
 	static DAPI void Free(void* block, MemoryType type = MemoryType::eMemory_Type_Unknow);
 	static DAPI void FreeAligned(void* block, size_t size, MemoryType type);
 	static DAPI void* Zero(void* block, size_t size);
@@ -103,14 +150,28 @@ public:
 
 	static DAPI size_t GetAllocateCount();
 
+	/**
+	 * @brief Lock-free statistics queries, cheap enough to poll every frame.
+	 */
+	static DAPI SMemoryTagStats GetTagStats(MemoryType type);
+	static DAPI SMemoryTagStats GetTotalStats();
+
+	/**
+	 * @brief Closes the per-frame counters and updates the allocation rates. Called once per frame.
+	 *
+	 * @param delta_time Wall-clock time since the previous call, in seconds, the same delta the game updates with.
+	 */
+	static DAPI void UpdateFrameStats(double delta_time);
+
 private:
+	static void* AllocateBlock(size_t size, size_t alignment, MemoryType type, const void* call_site);
+	static void FreeBlock(void* block, size_t size, MemoryType type, const void* call_site);
 	static const char* GetUnitForSize(size_t size_bytes, float* out_amount);
 
 public:
 	static struct SMemoryStats stats;
 	static size_t TotalAllocateSize;
-	static size_t AllocateCount;
-	
+
 	static Mutex AllocationMutex;
 };
 
@@ -120,9 +181,19 @@ T* NewObject(Args&&... args) {
 	static_assert(std::is_constructible_v<T, Args...>,
 		"T must be constructible with given arguments");
 
-	void* memory = Memory::Allocate(sizeof(T), MemoryType::eMemory_Type_Entity);
+	void* memory = nullptr;
+#if DMEMORY_OBJECT_POOL
+	// Registered types come from their own pool; the pool falls back to the heap if it can't serve.
+	if constexpr (TObjectPoolTraits<T>::Pooled) {
+		memory = TObjectPoolTraits<T>::Get().Allocate();
+	}
+#endif
 	if (memory == nullptr) {
-		GLOG(Log::eFatal, "Failed to allocate memory");
+		memory = Memory::Allocate(sizeof(T), MemoryType::eMemory_Type_Entity);
+	}
+
+	if (memory == nullptr) {
+		GLOG_CATEGORY(Log::Category::eMemory, Log::eFatal, "Failed to allocate memory");
 		return nullptr;
 	}
 
@@ -131,8 +202,14 @@ T* NewObject(Args&&... args) {
 	}
 	catch (const std::exception& e)
 	{
+		GLOG_CATEGORY(Log::Category::eMemory, Log::eFatal, "Constructor exception: %s", e.what());
+#if DMEMORY_OBJECT_POOL
+		if (ObjectPool* Pool = ObjectPool::FindOwner(memory)) {
+			Pool->Free(memory);
+			throw;
+		}
+#endif
 		Memory::Free(memory, MemoryType::eMemory_Type_Entity);
-		GLOG(Log::eFatal, "Constructor exception: %s", e.what());
 		throw;
 	}
 }
@@ -145,8 +222,16 @@ void DeleteObject(T* obj) noexcept {
 		obj->~T();
 	}
 	catch (...) {
-		GLOG(Log::eError, "Exception during destruction");
+		GLOG_CATEGORY(Log::Category::eMemory, Log::eError, "Exception during destruction");
 	}
 
+#if DMEMORY_OBJECT_POOL
+	// Looked up by address, so objects deleted through a base class pointer find their pool too.
+	if (ObjectPool* Pool = ObjectPool::FindOwner(obj)) {
+		Pool->Free(obj);
+		return;
+	}
+#endif
+
 	Memory::Free(obj, MemoryType::eMemory_Type_Entity);
 }
\ No newline at end of file
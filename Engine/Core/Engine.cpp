@@ -13,6 +13,8 @@
 #include "Rendering/Renderer.hpp"
 #include "Rendering/Interface/IRenderpass.hpp"
 #include "Math/MathTypes.hpp"
+#include "Memory/FrameAllocator.h"
+#include "Memory/MemoryTrace.h"
 
 // Systems
 #include "Systems/TextureSystem.h"
@@ -25,6 +27,44 @@
 #include "Systems/JobSystem.hpp"
 #include "Systems/FontSystem.hpp"
 #include "Utils/FileWatcher.h"
+#include "Platform/File/JsonObject.h"
+
+#define ENGINE_JOB_CALLBACK_BUDGET_MS 2.0		// 每帧执行任务完成回调的时间预算，剩下的留到下一帧
+
+static ThreadPriority ParseThreadPriority(const std::string& name, ThreadPriority default_priority) {
+	if (name == "low") return ThreadPriority::eLow;
+	if (name == "normal") return ThreadPriority::eNormal;
+	if (name == "high") return ThreadPriority::eHigh;
+	return default_priority;
+}
+
+// Reads the "jobs" section of the engine config. Missing keys keep the JobSystemConfig defaults.
+static JobSystemConfig LoadJobSystemConfig() {
+	JobSystemConfig Config;
+	File ConfigFile(ENGINE_CONFIG_PATH);
+	if (!ConfigFile.IsExist()) {
+		return Config;
+	}
+
+	JsonObject Content = JsonObject(ConfigFile);
+	Config.pin_threads = Content.ReadBool("jobs.pin_threads", Config.pin_threads);
+	Config.avoid_smt_siblings = Content.ReadBool("jobs.avoid_smt_siblings", Config.avoid_smt_siblings);
+	const int ReservedCores = Content.ReadInt("jobs.reserved_cores", (int)Config.reserved_cores);
+	Config.reserved_cores = ReservedCores > 0 ? (uint32_t)ReservedCores : 0;
+
+	// Keyed in JobType order.
+	const char* TypeKeys[] = { "jobs.general", "jobs.resource_load", "jobs.gpu_resource" };
+	static_assert(sizeof(TypeKeys) / sizeof(TypeKeys[0]) == static_cast<uint32_t>(JobType::eCount), "Update the job type keys.");
+	for (uint32_t i = 0; i < static_cast<uint32_t>(JobType::eCount); ++i) {
+		JobTypeConfig& Type = Config.types[i];
+		const std::string Key = TypeKeys[i];
+		const int Threads = Content.ReadInt(Key + ".threads", 0);
+		Type.thread_count = Threads > 0 ? (uint32_t)Threads : 0;
+		Type.priority = ParseThreadPriority(Content.ReadString(Key + ".priority"), Type.priority);
+	}
+
+	return Config;
+}
 
 bool Engine::Initialize(){
 	if (Initialized) {
@@ -43,6 +83,12 @@ bool Engine::Initialize(){
 	// Metrics
 	Metrics::Initialize();
 
+	// Transient per-frame memory for render packets.
+	if (!FrameAllocator::Initialize()) {
+		GLOG(Log::eFatal, "Frame allocator failed to initialize!");
+		return false;
+	}
+
 	is_running = true;
 	is_suspended = false;
 
@@ -100,32 +146,8 @@ bool Engine::Initialize(){
 		return false;
 	}
 
-	// This is really a core count. Subtract 1 to account for the main thread already being in use.
-	bool RenderWithMultithread = Renderer->GetEnabledMutiThread();
-	int ThreadCount = Platform::GetProcessorCount() - 1;
-	if (ThreadCount < 1) {
-		GLOG(Log::eFatal, "Error: Platform reported processor count (minus one for main thread) as %i. Need at least one additional thread for the job system.", ThreadCount);
-	}
-	else {
-		GLOG(Log::eInfo, "Available threads: %i.", ThreadCount);
-	}
-
-	// Cap the thread count.
-	const int MaxThreadCount = 15;
-	if (ThreadCount > MaxThreadCount) {
-		GLOG(Log::eInfo, "Available threads on the system is %i, but will be capped at %i.", ThreadCount, MaxThreadCount);
-		ThreadCount = MaxThreadCount;
-	}
-
-	// Initialize the job system.
-	// Requires knowledge of renderer multithread support, so should be initialized here.
-	uint32_t JobThreadTypes[3];
-	JobThreadTypes[0] = RenderWithMultithread ? ThreadCount / 2 : ThreadCount;	// General
-	JobThreadTypes[1] = RenderWithMultithread ? ThreadCount / 4 : 0;	// Render
-	JobThreadTypes[2] = RenderWithMultithread ? ThreadCount - JobThreadTypes[0] - JobThreadTypes[1] : 0;	// Resource
-
-	// Job system
-	if (!JobSystem::Initialize(JobThreadTypes)) {
+	// Job system. Worker counts and placement follow the processor topology unless the config says otherwise.
+	if (!JobSystem::Initialize(LoadJobSystemConfig())) {
 		GLOG(Log::eFatal, "Job system failed to initialize!");
 		return false;
 	}
@@ -211,7 +233,7 @@ bool Engine::Run() {
 	double FrameElapsedTime = 0.0;
 	double TargetFrameSeconds = 1.0 / 120.0;
 
-	GLOG(Log::eDebug, Memory::GetMemoryUsageStr().CStr());
+	GLOG(Log::eDebug, "%s", Memory::GetMemoryUsageStr().CStr());
 
 	GlobalFileWatcher = NewObject<FileWatcher>();
 
@@ -233,45 +255,59 @@ bool Engine::Run() {
 			double DeltaTime = (CurrentTime - last_time);
 			double FrameStartTime = Platform::PlatformGetAbsoluteTime();
 
+			// Reclaim the frame memory of this frame slot.
+			FrameAllocator::BeginFrame();
+			MemoryTrace::MarkFrame(FrameAllocator::GetFrameNumber());
+
 			// Detective file status.
 			GlobalFileWatcher->Update();
 
 			// Update Job system.
-			JobSystem::Update();
+			JobSystem::Update(ENGINE_JOB_CALLBACK_BUDGET_MS);
 
 			// Update metrics.
 			Metrics::Update(FrameElapsedTime);
+			Memory::UpdateFrameStats(DeltaTime);
 
 			if (!GameInst->Update((float)DeltaTime)) {
 				GLOG(Log::eFatal, "Game update failed!");
+				FrameAllocator::EndFrame();
 				is_running = false;
 				break;
 			}
 			GameController->Update(DeltaTime);
 
-			// TODO: Refactor packet creation.
-			SRenderPacket Packet;
-			Packet.delta_time = DeltaTime;
+			// The packet and everything views build into it live in frame memory,
+			// so it has to be gone before the frame ends.
+			bool RenderFailed = false;
+			{
+				SRenderPacket Packet;
+				Packet.delta_time = DeltaTime;
+
+				// Call the game's render routine.
+				if (!GameInst->Render(&Packet, (float)DeltaTime)) {
+					GLOG(Log::eFatal, "Game render faield. shutting down.");
+					RenderFailed = true;
+				}
+				else {
+					Renderer->DrawFrame(&Packet);
+				}
+
+				// Cleanup the packet.
+				for (uint32_t i = 0; i < (uint32_t)Packet.views.size(); ++i) {
+					IRenderView* RenderView = Packet.views[i].view;
+					if (RenderView) {
+						RenderView->OnDestroyPacket(&Packet.views[i]);
+					}
+				}
+			}
 
-			// Call the game's render routine.
-			if (!GameInst->Render(&Packet, (float)DeltaTime)) {
-				GLOG(Log::eFatal, "Game render faield. shutting down.");
+			FrameAllocator::EndFrame();
+			if (RenderFailed) {
 				is_running = false;
 				break;
 			}
 
-			Renderer->DrawFrame(&Packet);
-
-			// Cleanup the packet.
-			for (uint32_t i = 0; i < (uint32_t)Packet.views.size(); ++i) {
-				IRenderView* RenderView = Packet.views[i].view;
-				if (RenderView) {
-					RenderView->OnDestroyPacket(&Packet.views[i]);
-				}
-			}
-			Packet.views.clear();
-			std::vector<struct RenderViewPacket>().swap(Packet.views);
-
 			double FrameEndTime = Platform::PlatformGetAbsoluteTime();
 			FrameElapsedTime = FrameEndTime - FrameStartTime;
 			double RemainingSceonds = TargetFrameSeconds - FrameElapsedTime;
@@ -317,6 +353,7 @@ bool Engine::Run() {
 	Memory::Free(Renderer, MemoryType::eMemory_Type_Renderer);
 
 	EngineEvent::Shutdown();
+	FrameAllocator::Shutdown();
 	Controller::Shutdown();
 	ResourceSystem::Get().Shutdown();
 	Platform::PlatformShutdown(&platform);
@@ -1,6 +1,16 @@
 ﻿#include "EngineLogger.hpp"
+#include "Platform/Thread/DThread.hpp"
 
-#ifdef __APPLE__
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__APPLE__) || defined(__linux__)
 using namespace std::filesystem;
 #elif _WIN32
 #define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
@@ -8,12 +18,219 @@ using namespace std::filesystem;
 using namespace std::experimental::filesystem;
 #endif
 
+#define LOG_RECORD_ALIGNMENT 8				// Records start on 8 byte boundaries inside the ring
+#define LOG_PADDING_LEVEL 0xFFFFFFFFu		// Level of the filler that skips the ring's tail when a record wraps
+#define LOG_WRITER_IDLE_MS 2				// Writer sleep when every ring is empty
+#define LOG_FORMAT_BUFFER_SIZE 1024			// Longer messages are formatted a second time into a bigger buffer
+
+namespace {
+	// Single producer (the owning thread), single consumer (the writer thread).
+	struct LogRing {
+		alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> Write{ 0 };
+		alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> Read{ 0 };
+		std::atomic<uint64_t> Dropped{ 0 };				// Only written by the owning thread
+		std::atomic<bool> Owned{ true };				// Cleared when the owning thread exits, so another thread can adopt the ring
+		std::atomic<bool> Writing{ false };				// Set by the owning thread between BeginRecord and CommitRecord
+		LogRing* Next = nullptr;
+		alignas(LOG_RECORD_ALIGNMENT) char Data[LOG_RING_SIZE];
+	};
+
+	// Clears ownership when the thread exits. Rings are never freed, the writer may still be draining them.
+	struct LogRingOwner {
+		LogRing* Ring = nullptr;
+		~LogRingOwner() {
+			if (Ring != nullptr) {
+				Ring->Owned.store(false, std::memory_order_release);
+				Ring = nullptr;
+			}
+		}
+	};
+
+	struct PendingLine {
+		uint64_t Timestamp;
+		uint32_t Level;
+		size_t Offset;					// Into the batch text, NUL terminated
+	};
+
+	// A ring's read position, published once its records have been written out.
+	struct RingProgress {
+		LogRing* Ring;
+		uint64_t Read;
+	};
+
+	// Reused between batches so the writer does not allocate once it has warmed up.
+	struct LogBatch {
+		std::vector<PendingLine> Lines;
+		std::vector<RingProgress> Progress;
+		std::string Text;
+	};
+}
+
+static std::atomic<LogRing*> GlobalRings{ nullptr };
+static std::atomic<bool> WriterRunning{ false };
+static std::atomic<bool> WriterExited{ false };
+static uint64_t ReportedDrops = 0;				// Only touched by whoever drains the rings
+static Thread WriterThread;
+
+static thread_local LogRingOwner ThreadRing;
+static thread_local bool IsWriterThread = false;
+// Where the record handed out by BeginRecord lives; nullptr for the calling thread's scratch buffer.
+static thread_local LogRing* PendingRing = nullptr;
+static thread_local uint64_t PendingEnd = 0;
+// Grown on demand. Plain pointers stay usable after thread_local destructors, so logging from
+// static destructors simply grows a new buffer that is reclaimed by process exit.
+static thread_local uint64_t* ScratchRecord = nullptr;
+static thread_local size_t ScratchCapacity = 0;
+
+// Frees the scratch buffer when a worker thread exits.
+struct LogScratchOwner {
+	~LogScratchOwner() {
+		free(ScratchRecord);
+		ScratchRecord = nullptr;
+		ScratchCapacity = 0;
+	}
+};
+static thread_local LogScratchOwner ThreadScratch;
+
+static uint64_t LogNow() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static LogRing* GetThreadRing() {
+	if (ThreadRing.Ring != nullptr) {
+		return ThreadRing.Ring;
+	}
+
+	// Adopt a ring left behind by a thread that has exited.
+	for (LogRing* Ring = GlobalRings.load(std::memory_order_acquire); Ring != nullptr; Ring = Ring->Next) {
+		bool Expected = false;
+		if (!Ring->Owned.load(std::memory_order_relaxed) &&
+			Ring->Owned.compare_exchange_strong(Expected, true, std::memory_order_acquire)) {
+			ThreadRing.Ring = Ring;
+			return Ring;
+		}
+	}
+
+	LogRing* Ring = new LogRing();
+	LogRing* Head = GlobalRings.load(std::memory_order_relaxed);
+	do {
+		Ring->Next = Head;
+	} while (!GlobalRings.compare_exchange_weak(Head, Ring, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+	ThreadRing.Ring = Ring;
+	return Ring;
+}
+
+static void WriteLine(uint32_t level, const char* text) {
+	Log::Logger::Level ULevel = (Log::Logger::Level)level;
+	Console::WriteLine(ULevel, text);
+	Log::Logger::getInstance()->log(ULevel, __FILE__, __LINE__, text);
+}
+
+// Appends the formatted message and its terminating NUL to out_text.
+static bool FormatRecord(const LogRecord& record, std::string& out_text) {
+	char Buffer[LOG_FORMAT_BUFFER_SIZE];
+	const int Length = record.formatter(Buffer, sizeof(Buffer), record.format, record.Payload());
+	if (Length < 0) {
+		return false;
+	}
+
+	if ((size_t)Length < sizeof(Buffer)) {
+		out_text.append(Buffer, (size_t)Length + 1);
+	}
+	else {
+		const size_t Offset = out_text.size();
+		out_text.resize(Offset + (size_t)Length + 1);
+		record.formatter(&out_text[Offset], (size_t)Length + 1, record.format, record.Payload());
+	}
+	return true;
+}
+
+static uint64_t CountDropped() {
+	uint64_t Dropped = 0;
+	for (LogRing* Ring = GlobalRings.load(std::memory_order_acquire); Ring != nullptr; Ring = Ring->Next) {
+		Dropped += Ring->Dropped.load(std::memory_order_relaxed);
+	}
+	return Dropped;
+}
+
+// Formats everything currently in the rings, writes it in timestamp order and then releases
+// the ring space. Returns the number of records written.
+static size_t DrainRings(LogBatch& batch) {
+	std::vector<PendingLine>& Lines = batch.Lines;
+	std::vector<RingProgress>& Progress = batch.Progress;
+	std::string& Text = batch.Text;
+	Lines.clear();
+	Progress.clear();
+	Text.clear();
+
+	for (LogRing* Ring = GlobalRings.load(std::memory_order_acquire); Ring != nullptr; Ring = Ring->Next) {
+		uint64_t Read = Ring->Read.load(std::memory_order_relaxed);
+		const uint64_t Write = Ring->Write.load(std::memory_order_acquire);
+		if (Read == Write) {
+			continue;
+		}
+
+		while (Read < Write) {
+			const LogRecord* Record = reinterpret_cast<const LogRecord*>(Ring->Data + (Read % LOG_RING_SIZE));
+			if (Record->level != LOG_PADDING_LEVEL) {
+				PendingLine Line;
+				Line.Timestamp = Record->timestamp;
+				Line.Level = Record->level;
+				Line.Offset = Text.size();
+				if (FormatRecord(*Record, Text)) {
+					Lines.push_back(Line);
+				}
+			}
+			Read += Record->size;
+		}
+		Progress.push_back({ Ring, Read });
+	}
+
+	// Each ring is already in order, stable sort keeps that for equal timestamps.
+	std::stable_sort(Lines.begin(), Lines.end(), [](const PendingLine& a, const PendingLine& b) { return a.Timestamp < b.Timestamp; });
+	for (const PendingLine& Line : Lines) {
+		WriteLine(Line.Level, Text.c_str() + Line.Offset);
+	}
+
+	const uint64_t Dropped = CountDropped();
+	if (Dropped > ReportedDrops) {
+		char Message[128];
+		snprintf(Message, sizeof(Message), "Logger: %llu record(s) dropped, a thread's log ring was full.", (unsigned long long)(Dropped - ReportedDrops));
+		WriteLine(Log::eWarn, Message);
+		ReportedDrops = Dropped;
+	}
+
+	for (const RingProgress& Ring : Progress) {
+		Ring.Ring->Read.store(Ring.Read, std::memory_order_release);
+	}
+	return Lines.size();
+}
+
+static uint32_t LogWriterThread(void*) {
+	IsWriterThread = true;
+	Thread::SetCurrentName("Log Writer");
+
+	LogBatch Batch;
+	while (WriterRunning.load(std::memory_order_acquire)) {
+		if (DrainRings(Batch) == 0) {
+			Platform::PlatformSleep(LOG_WRITER_IDLE_MS);
+		}
+	}
+	DrainRings(Batch);
+
+	IsWriterThread = false;
+	WriterExited.store(true, std::memory_order_release);
+	return 0;
+}
+
 EngineLogger::EngineLogger(){
     // Get current path
     path curPath = current_path();
     curPath.append("EngineLog");
 
-#ifdef __APPLE__
+#if defined(__APPLE__) || defined(__linux__)
     Log::Logger::getInstance()->open(curPath.c_str(), std::ios_base::ate);
 #elif _WIN32
     Log::Logger::getInstance()->open(curPath.u8string(), std::ios_base::ate);
@@ -31,7 +248,201 @@ EngineLogger::EngineLogger(){
     Log::Logger::getInstance()->setMaxSize(1024000);
     Log::Logger::getInstance()->setLevel(LogLevel);
 
+	// Start the writer thread, until then records are written synchronously.
+	WriterExited.store(false);
+	WriterRunning.store(true, std::memory_order_release);
+	if (!WriterThread.Create(LogWriterThread, nullptr, false)) {
+		WriterRunning.store(false);
+		ELog(Log::eWarn, "Failed to create the log writer thread, logging synchronously.");
+	}
+
     ELog(Log::eInfo, "Logger Init Success.");
     ELog(Log::eInfo, "Mode: Debug.");
 
 }
+
+EngineLogger::~EngineLogger() {
+	if (!WriterRunning.exchange(false)) {
+		return;
+	}
+
+	// Win32's Thread::Destroy does not wait, so wait for the final drain here.
+	while (!WriterExited.load(std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+	WriterThread.Destroy();
+
+	// Threads that saw the writer still running may be filling a record, wait until it is committed
+	// and drain once more on this thread. Everything after this is written synchronously.
+	for (LogRing* Ring = GlobalRings.load(); Ring != nullptr; Ring = Ring->Next) {
+		while (Ring->Writing.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+	}
+	LogBatch Batch;
+	DrainRings(Batch);
+}
+
+void EngineLogger::Flush() {
+	if (IsWriterThread || !WriterRunning.load(std::memory_order_acquire)) {
+		return;
+	}
+
+	std::vector<RingProgress> Targets;
+	for (LogRing* Ring = GlobalRings.load(std::memory_order_acquire); Ring != nullptr; Ring = Ring->Next) {
+		Targets.push_back({ Ring, Ring->Write.load(std::memory_order_acquire) });
+	}
+
+	// The writer releases ring space only after the lines have been written out.
+	for (const RingProgress& Target : Targets) {
+		while (Target.Ring->Read.load(std::memory_order_acquire) < Target.Read && WriterRunning.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+uint64_t EngineLogger::GetDroppedCount() {
+	return CountDropped();
+}
+
+std::atomic<uint8_t> EngineLogger::CategoryLevels[(size_t)Log::Category::eCount] = {
+	{ (uint8_t)LOG_COMPILE_MIN_LEVEL }, { (uint8_t)LOG_COMPILE_MIN_LEVEL }, { (uint8_t)LOG_COMPILE_MIN_LEVEL },
+	{ (uint8_t)LOG_COMPILE_MIN_LEVEL }, { (uint8_t)LOG_COMPILE_MIN_LEVEL }
+};
+
+static const char* CategoryNames[(size_t)Log::Category::eCount] = { "General", "Memory", "Vulkan", "Jobs", "Resources" };
+static const char* LevelNames[Log::eMax] = { "Debug", "Info", "Warn", "Error", "Fatal" };
+
+static bool NameEquals(const char* a, const char* b) {
+	for (; *a != '\0' && *b != '\0'; ++a, ++b) {
+		if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
+			return false;
+		}
+	}
+	return *a == *b;
+}
+
+void EngineLogger::SetCategoryLevel(Log::Category category, Log::Level level) {
+	if (category >= Log::Category::eCount || level >= Log::eMax) {
+		return;
+	}
+	CategoryLevels[(size_t)category].store((uint8_t)level, std::memory_order_relaxed);
+}
+
+Log::Level EngineLogger::GetCategoryLevel(Log::Category category) {
+	if (category >= Log::Category::eCount) {
+		return Log::eMax;
+	}
+	return (Log::Level)CategoryLevels[(size_t)category].load(std::memory_order_relaxed);
+}
+
+const char* EngineLogger::GetCategoryName(Log::Category category) {
+	return category < Log::Category::eCount ? CategoryNames[(size_t)category] : "Unknown";
+}
+
+const char* EngineLogger::GetLevelName(Log::Level level) {
+	return level < Log::eMax ? LevelNames[level] : "Unknown";
+}
+
+bool EngineLogger::ParseCategory(const char* name, Log::Category& out_category) {
+	for (size_t i = 0; i < (size_t)Log::Category::eCount; ++i) {
+		if (NameEquals(name, CategoryNames[i])) {
+			out_category = (Log::Category)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool EngineLogger::ParseLevel(const char* name, Log::Level& out_level) {
+	for (uint32_t i = 0; i < Log::eMax; ++i) {
+		if (NameEquals(name, LevelNames[i])) {
+			out_level = (Log::Level)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// The calling thread's ring marked as being written, or nullptr when the record is written synchronously.
+static LogRing* BeginRingWrite() {
+	if (!WriterRunning.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	// Announce the write before checking again, the destructor waits for announced writes before its last drain.
+	LogRing* Ring = GetThreadRing();
+	Ring->Writing.store(true);
+	if (!WriterRunning.load()) {
+		Ring->Writing.store(false, std::memory_order_relaxed);
+		return nullptr;
+	}
+	return Ring;
+}
+
+LogRecord* EngineLogger::BeginRecord(size_t payload_size) {
+	const size_t Size = PaddingAligned(sizeof(LogRecord) + payload_size, LOG_RECORD_ALIGNMENT);
+	LogRecord* Record = nullptr;
+
+	LogRing* WriteRing = Size <= LOG_MAX_RECORD_SIZE ? BeginRingWrite() : nullptr;
+	if (WriteRing != nullptr) {
+		LogRing& Ring = *WriteRing;
+		const uint64_t Write = Ring.Write.load(std::memory_order_relaxed);
+		const uint64_t Read = Ring.Read.load(std::memory_order_acquire);
+
+		// A record never wraps, the tail that is too short is skipped with a filler.
+		const size_t Offset = (size_t)(Write % LOG_RING_SIZE);
+		const size_t Tail = LOG_RING_SIZE - Offset;
+		const size_t Padding = Tail < Size ? Tail : 0;
+		if (Write + Padding + Size - Read > LOG_RING_SIZE) {
+			Ring.Dropped.store(Ring.Dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			Ring.Writing.store(false, std::memory_order_release);
+			return nullptr;
+		}
+
+		if (Padding > 0) {
+			uint32_t* Filler = reinterpret_cast<uint32_t*>(Ring.Data + Offset);
+			Filler[0] = (uint32_t)Padding;
+			Filler[1] = LOG_PADDING_LEVEL;
+		}
+
+		const uint64_t Start = Write + Padding;
+		Record = reinterpret_cast<LogRecord*>(Ring.Data + (Start % LOG_RING_SIZE));
+		PendingRing = &Ring;
+		PendingEnd = Start + Size;
+	}
+	else {
+		if (Size > ScratchCapacity) {
+			(void)&ThreadScratch;	// First use constructs the owner, which registers its destructor for this thread
+			uint64_t* Grown = (uint64_t*)realloc(ScratchRecord, Size);
+			if (Grown == nullptr) {
+				return nullptr;
+			}
+			ScratchRecord = Grown;
+			ScratchCapacity = Size;
+		}
+		Record = reinterpret_cast<LogRecord*>(ScratchRecord);
+		PendingRing = nullptr;
+	}
+
+	Record->size = (uint32_t)Size;
+	Record->timestamp = LogNow();
+	return Record;
+}
+
+void EngineLogger::CommitRecord(LogRecord* record) {
+	if (PendingRing == nullptr) {
+		std::string Text;
+		if (FormatRecord(*record, Text)) {
+			WriteLine(record->level, Text.c_str());
+		}
+		return;
+	}
+
+	PendingRing->Write.store(PendingEnd, std::memory_order_release);
+	PendingRing->Writing.store(false, std::memory_order_release);
+	PendingRing = nullptr;
+	if (record->level >= Log::eFatal) {
+		Flush();
+	}
+}
@@ -2,6 +2,18 @@
 #include "Platform/Platform.hpp"
 #include "Core/Console.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#define LOG_RING_SIZE (64 * 1024)				// Bytes of the per-thread record ring
+#define LOG_MAX_RECORD_SIZE (LOG_RING_SIZE / 4)	// Bigger records are formatted and written on the calling thread
+
 namespace Log {
     enum Level{
         eDebug,
@@ -11,47 +23,211 @@ namespace Log {
         eFatal,
         eMax
     };
+
+    // Verbosity is set per category, see EngineLogger::SetCategoryLevel.
+    enum class Category : uint8_t {
+        eGeneral,
+        eMemory,
+        eVulkan,
+        eJobs,
+        eResources,
+        eCount
+    };
+}
+
+// Calls below this level are removed by the preprocessor and compiler, the arguments are never evaluated.
+#ifndef LOG_COMPILE_MIN_LEVEL
+#ifdef LEVEL_DEBUG
+#define LOG_COMPILE_MIN_LEVEL Log::eDebug
+#else
+#define LOG_COMPILE_MIN_LEVEL Log::eInfo
+#endif
+#endif
+
+// Category of the GLOG calls in a source file. Define it before the includes to change it.
+// Headers must use GLOG_CATEGORY instead: an inline function logging through LOG_CATEGORY
+// would be defined differently in every file that includes it.
+#ifndef LOG_CATEGORY
+#define LOG_CATEGORY Log::Category::eGeneral
+#endif
+
+typedef int(*PFN_log_format)(char* out, size_t size, const char* format, const char* payload);
+
+/**
+ * A log call as stored in the ring: the format string pointer, the arguments packed
+ * behind the header, and the function that knows how to unpack them.
+ */
+struct LogRecord {
+	uint32_t size;					// Whole record including the payload, multiple of 8
+	uint32_t level;
+	uint64_t timestamp;
+	const char* format;				// String literal, see GLOG
+	PFN_log_format formatter;
+
+	char* Payload() { return reinterpret_cast<char*>(this + 1); }
+	const char* Payload() const { return reinterpret_cast<const char*>(this + 1); }
+};
+
+namespace LogDetail {
+	// Arguments are copied by value, C strings are copied by content since the caller's
+	// buffer is usually gone by the time the writer thread formats the record.
+	template<typename T>
+	struct ArgCodec {
+		static_assert(std::is_trivially_copyable<T>::value, "GLOG arguments must be trivially copyable or C strings.");
+
+		static size_t Size(const T&) { return sizeof(T); }
+		static char* Encode(char* out, const T& value) { memcpy(out, &value, sizeof(T)); return out + sizeof(T); }
+		static const char* Decode(const char* in, T& out_value) { memcpy(&out_value, in, sizeof(T)); return in + sizeof(T); }
+	};
+
+	template<>
+	struct ArgCodec<const char*> {
+		static const char* Text(const char* value) { return value != nullptr ? value : "(null)"; }
+
+		static size_t Size(const char* value) { return strlen(Text(value)) + 1; }
+		static char* Encode(char* out, const char* value) {
+			const size_t Length = strlen(Text(value)) + 1;
+			memcpy(out, Text(value), Length);
+			return out + Length;
+		}
+		static const char* Decode(const char* in, const char*& out_value) { out_value = in; return in + strlen(in) + 1; }
+	};
+
+	template<>
+	struct ArgCodec<char*> {
+		static size_t Size(char* value) { return ArgCodec<const char*>::Size(value); }
+		static char* Encode(char* out, char* value) { return ArgCodec<const char*>::Encode(out, value); }
+		static const char* Decode(const char* in, char*& out_value) {
+			const char* Text = nullptr;
+			in = ArgCodec<const char*>::Decode(in, Text);
+			out_value = const_cast<char*>(Text);
+			return in;
+		}
+	};
+
+	template<typename ... Args>
+	size_t PayloadSize(const Args& ... args) {
+		size_t Size = 0;
+		(void)std::initializer_list<int>{ 0, ((Size += ArgCodec<Args>::Size(args)), 0)... };
+		return Size;
+	}
+
+	template<typename ... Args>
+	void Encode(char* out, const Args& ... args) {
+		(void)std::initializer_list<int>{ 0, ((out = ArgCodec<Args>::Encode(out, args)), 0)... };
+		(void)out;
+	}
+
+	template<typename Tuple, size_t ... Indices>
+	void Decode(const char* in, Tuple& values, std::index_sequence<Indices...>) {
+		(void)std::initializer_list<int>{ 0, ((in = ArgCodec<std::tuple_element_t<Indices, Tuple>>::Decode(in, std::get<Indices>(values))), 0)... };
+		(void)in;
+	}
+
+	// Runs on the writer thread with the same argument types the call site used.
+	template<typename ... Args>
+	int Format(char* out, size_t size, const char* format, const char* payload) {
+		std::tuple<Args...> Values;
+		Decode(payload, Values, std::index_sequence_for<Args...>{});
+		return std::apply([&](auto ... values) { return std::snprintf(out, size, format, values...); }, Values);
+	}
 }
 
+/**
+ * Asynchronous logger. GLOG first drops calls below the compile-time minimum and below the
+ * category's runtime level, without evaluating the arguments. Otherwise it packs the call into the calling thread's lock-free ring
+ * without formatting it; a background thread formats records from all rings in batches,
+ * in timestamp order, and hands them to the console and the log file.
+ *
+ * - A full ring drops the record and counts it, the caller never blocks.
+ * - eFatal records wait until the writer has written everything before them.
+ * - Before the writer starts and after it stops, records are written on the calling thread.
+ */
 class DAPI EngineLogger{
 public:
     EngineLogger();
+    ~EngineLogger();
 
 public:
-	template<typename ... Args>
-	static void ELog(Log::Level level, const char* format, Args ... args) {
-		char* str = AppendLogMessage(format, args...);
-		Log::Logger::Level ULevel = (Log::Logger::Level)level;
-		if (str == nullptr
-#ifndef LEVEL_DEBUG
-			|| ULevel < Log::Logger::eINFO
-#endif
-			) return;
-		Console::WriteLine(ULevel, str);
-		Log::Logger::getInstance()->log(ULevel, __FILE__, __LINE__, str);
-		delete[] str;
+	/**
+	 * Whether a category currently logs at this level. A relaxed load, cheap enough for hot paths.
+	 */
+	static bool IsEnabled(Log::Category category, Log::Level level) {
+		return (uint8_t)level >= CategoryLevels[(size_t)category].load(std::memory_order_relaxed);
 	}
 
-private:
+	/**
+	 * Sets the lowest level a category logs at. Levels below LOG_COMPILE_MIN_LEVEL stay compiled out.
+	 */
+	static void SetCategoryLevel(Log::Category category, Log::Level level);
+	static Log::Level GetCategoryLevel(Log::Category category);
+
+	static const char* GetCategoryName(Log::Category category);
+	static const char* GetLevelName(Log::Level level);
+
+	/**
+	 * Case insensitive, e.g. "vulkan" or "warn". Return false if the name is unknown.
+	 */
+	static bool ParseCategory(const char* name, Log::Category& out_category);
+	static bool ParseLevel(const char* name, Log::Level& out_level);
+
+	// Does not filter, GLOG checks the level before it gets here.
 	template<typename ... Args>
-	static char* AppendLogMessage(const char* format, Args ... args)
-	{
-		int size_s = std::snprintf(nullptr, 0, format, args ...) + 1; // Extra space for '\0'
-		if (size_s > 0) {
-			size_t size = static_cast<size_t>(size_s);
-			char* buf = new char[size];
-			std::snprintf(buf, size, format, args ...);
-			return buf;
+	static void ELog(Log::Level level, const char* format, Args ... args) {
+		const size_t PayloadSize = LogDetail::PayloadSize(args...);
+		LogRecord* Record = BeginRecord(PayloadSize);
+		if (Record == nullptr) {
+			// Ring is full, already counted as dropped.
+			return;
 		}
 
-		return nullptr;
+		Record->level = (uint32_t)level;
+		Record->format = format;
+		Record->formatter = &LogDetail::Format<Args...>;
+		LogDetail::Encode(Record->Payload(), args...);
+		CommitRecord(Record);
 	}
 
+	/**
+	 * Blocks until everything logged before the call has been written.
+	 */
+	static void Flush();
+
+	/**
+	 * Records dropped because a thread's ring was full, since startup.
+	 */
+	static uint64_t GetDroppedCount();
+
+private:
+	static LogRecord* BeginRecord(size_t payload_size);
+	static void CommitRecord(LogRecord* record);
+
+private:
+	static std::atomic<uint8_t> CategoryLevels[(size_t)Log::Category::eCount];
+
 };
 
-// Logger
+// First argument of a pack. The trailing 0 keeps the inner '...' non-empty, LOG_EXPAND makes MSVC split the pack.
+#define LOG_EXPAND(x) x
+#define LOG_FIRST_ARG_IMPL(first, ...) first
+#define LOG_FIRST_ARG(...) LOG_EXPAND(LOG_FIRST_ARG_IMPL(__VA_ARGS__, 0))
+
+// Logger. The format must be a string literal, the writer thread reads it after the call returns.
+// The level must be a constant so calls below LOG_COMPILE_MIN_LEVEL compile to nothing.
+#ifndef GLOG_CATEGORY
+#define GLOG_CATEGORY(category, level, ...) \
+	do { \
+		static_assert(sizeof("" LOG_FIRST_ARG(__VA_ARGS__)) > 0, "GLOG format must be a string literal."); \
+		if constexpr ((level) >= LOG_COMPILE_MIN_LEVEL) { \
+			if (EngineLogger::IsEnabled(category, level)) { \
+				EngineLogger::ELog(level, __VA_ARGS__); \
+			} \
+		} \
+	} while (0)
+#endif
+
 #ifndef GLOG
-#define GLOG EngineLogger::ELog
+#define GLOG(level, ...) GLOG_CATEGORY(LOG_CATEGORY, level, __VA_ARGS__)
 #endif
 
 #ifdef LEVEL_DEBUG
@@ -59,4 +235,3 @@ private:
 #else
 #define ASSERT(expr) {}
 #endif //ifdef DEBUG
-
@@ -193,6 +193,21 @@ inline bool is_avx2_supported() {
 #define MEGABYTES(amount) (amount * 1000 * 1000)
 #define KIGABYTES(amount) (amount * 1000)
 
+#define CACHE_LINE_SIZE 64		// 多线程读写的数据按缓存行隔开，避免伪共享
+
+// 自旋等待时提示 CPU 降低功耗、让出超线程资源
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define DCPU_PAUSE() _mm_pause()
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+#define DCPU_PAUSE() __yield()
+#elif defined(__x86_64__) || defined(__i386__)
+#define DCPU_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define DCPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#define DCPU_PAUSE() ((void)0)
+#endif
+
 #include <filesystem>
 #ifndef ROOT_PATH
 #if defined(DPLATFORM_MACOS)
@@ -1,42 +1,42 @@
 ﻿#include "Core/Engine.hpp"
 #include "IGame.hpp"
 
-// Init logger
-static EngineLogger* GlobalLogger = new EngineLogger();
+// Init logger. Destroyed at exit on every return path, which stops the writer thread and flushes the log.
+static EngineLogger GlobalLogger;
 
 extern bool CreateGame(IGame* out_game);
 
 int main(void) {
 
     if (!Memory::Initialize(MEBIBYTES(500))) {
-        GLOG(Log::eError, "Failed to initialize memory system; shuting down.");
+        GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Failed to initialize memory system; shuting down.");
         return 0;
     }
 
     IGame* GameInst = NewObject<GameInstance>();
     if (GameInst == nullptr) {
-		GLOG(Log::eFatal, "Could not allocate memory for Game!");
+		GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "Could not allocate memory for Game!");
 		return -2;
     }
 
 	if (!CreateGame(GameInst)) {
-		GLOG(Log::eFatal, "Could not Create Game!");
+		GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "Could not Create Game!");
 		return -1;
 	}
 
     Engine* CoreEngine = NewObject<Engine>(GameInst);
 	if (CoreEngine == nullptr) {
-		GLOG(Log::eFatal, "Could not allocate memory for Application!");
+		GLOG_CATEGORY(Log::Category::eGeneral, Log::eFatal, "Could not allocate memory for Application!");
 		return 0;
 	}
 
     if (!CoreEngine->Initialize()) {
-		GLOG(Log::eInfo, "Application did not initialize gracefully!");
+		GLOG_CATEGORY(Log::Category::eGeneral, Log::eInfo, "Application did not initialize gracefully!");
 		return 1;
     }
 
     if (!CoreEngine->Run()) {
-        GLOG(Log::eInfo, "Application did not shutdown gracefully!");
+        GLOG_CATEGORY(Log::Category::eGeneral, Log::eInfo, "Application did not shutdown gracefully!");
         return 2;
     }
 
@@ -49,7 +49,6 @@ int main(void) {
     }
 
     Memory::Shutdown();
-    delete(GlobalLogger);
 
     return 0;
 }
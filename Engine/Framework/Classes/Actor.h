@@ -3,7 +3,9 @@
 #include "Framework/BaseObject.h"
 #include "Containers/TMap.hpp"
 #include "Containers/FString.hpp"
+#include "Containers/TInlineArray.hpp"
 #include "Framework/Components/TransformComponent.h"
+#include "Memory/ObjectPool.h"
 #include <typeinfo>
 #include <typeindex>
 
@@ -113,5 +115,7 @@ protected:
 
 	// 父对象
 	AActor* ParentActor;
-	TArray<AActor*> ChildrenActors;
-};
\ No newline at end of file
+	TInlineArray<AActor*, 4> ChildrenActors;
+};
+
+DECLARE_OBJECT_POOL(AActor)
\ No newline at end of file
@@ -31,4 +31,6 @@ public:
 private:
     uint32_t ReferenceCount = 0;
     UCameraComponent* CameraComponent;
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(ACameraActor)
\ No newline at end of file
@@ -51,12 +51,13 @@ bool AStaticMeshActor::LoadFromResource(const FString& resource_name) {
 	Name_ = resource_name;
 
 	JobInfo Job;
+	Job.name = "StaticMeshLoad";
 	Job.entry = [this]() {return LoadJobStart(); };
 	Job.on_success = [this]() {return LoadJobSuccess(); };
 	Job.on_failed = [this]() {return LoadJobFail(); };
 	Job.type = JobType::eResource_Load;
 
-	JobSystem::Submit(Job);
+	JobSystem::Submit(std::move(Job));
 
 	return true;
 }
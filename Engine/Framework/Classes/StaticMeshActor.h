@@ -38,3 +38,5 @@ public:
 
 	struct FMeshLoadParams LoadParams;
 };
+
+DECLARE_OBJECT_POOL(AStaticMeshActor)
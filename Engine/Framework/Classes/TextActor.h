@@ -25,4 +25,6 @@ public:
 protected:
 	FString Content;
 	UTextComponent* TextComponent;
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(ATextActor)
\ No newline at end of file
@@ -63,4 +63,6 @@ protected:
 
 	// Pitch ޷ȣԼ 89
 	static constexpr float PitchLimit = 1.55334306f;
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(UCameraComponent)
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Framework/BaseObject.h"
 #include "Containers/FString.hpp"
+#include "Memory/ObjectPool.h"
 
 class AActor;
 
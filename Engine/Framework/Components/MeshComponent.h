@@ -1,7 +1,7 @@
 ﻿#pragma once
 
 #include "PrimitiveComponent.h"
-#include "Containers/TArray.hpp"
+#include "Containers/TInlineArray.hpp"
 
 class Material;
 class UTexture;
@@ -18,6 +18,6 @@ public:
 	virtual void DrawMesh() = 0;
 
 protected:
-	TArray<Material*> Materials;	// 材质
-	TArray<UTexture*> Textures;		// 纹理
+	TInlineArray<Material*, 2> Materials;	// 材质
+	TInlineArray<UTexture*, 4> Textures;	// 纹理
 };
\ No newline at end of file
@@ -14,4 +14,6 @@ public:
 
 protected:
 	Geometry* Mesh = nullptr;
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(UStaticMeshComponent)
\ No newline at end of file
@@ -59,14 +59,13 @@ bool UTextComponent::Load(UITextType type, const FString& fontName, int fontSize
 	const TextureMap& Atlas = FontData->GetAtlas();
 	std::vector<TextureMap*> FontMaps = { const_cast<TextureMap*>(&Atlas) };
 	InstanceID = Renderer->AcquireInstanceResource(UIShader, FontMaps);
-	if (InstanceID == INVALID_ID) {
+	if (InstanceID == INVALID_ID_U64) {
 		GLOG(Log::eFatal, "Unable to acquire shader resource for font texture map.");
 		return false;
 	}
 
 	// 㻺
-	VertexBuffer = (VulkanBuffer*)Memory::Allocate(sizeof(VulkanBuffer), MemoryType::eMemory_Type_Vulkan);
-	VertexBuffer = new (VertexBuffer)VulkanBuffer();
+	VertexBuffer = NewObject<VulkanBuffer>();
 	VertexBuffer->Type = EGPUBufferType::eRenderbuffer_Type_Vertex;
 	VertexBuffer->TotalSize = TextLength * QuadSize;
 	VertexBuffer->UseFreelist = false;
@@ -80,8 +79,7 @@ bool UTextComponent::Load(UITextType type, const FString& fontName, int fontSize
 	}
 
 	// 
-	IndexBuffer = (VulkanBuffer*)Memory::Allocate(sizeof(VulkanBuffer), MemoryType::eMemory_Type_Vulkan);
-	IndexBuffer = new (IndexBuffer)VulkanBuffer();
+	IndexBuffer = NewObject<VulkanBuffer>();
 	static const unsigned char QuadIndexSize = sizeof(uint32_t) * 6;
 	IndexBuffer->Type = EGPUBufferType::eRenderbuffer_Type_Index;
 	IndexBuffer->TotalSize = TextLength * QuadIndexSize;
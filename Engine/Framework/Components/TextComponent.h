@@ -34,8 +34,8 @@ public:
 
 	IFont* GetFont() { return FontData; }
 
-	void SetInstance(uint32_t id) { InstanceID = id; }
-	uint32_t GetInstance() const { return InstanceID; }
+	void SetInstance(uint64_t id) { InstanceID = id; }
+	uint64_t GetInstance() const { return InstanceID; }
 
 private:
 	void RegenerateGeometry();
@@ -50,5 +50,7 @@ protected:
 	Vector4 Color = Vector4(1.0f);
 	size_t  RenderFrameNumber = 0;
 
-	uint32_t InstanceID = INVALID_ID;
-};
\ No newline at end of file
+	uint64_t InstanceID = INVALID_ID_U64;
+};
+
+DECLARE_OBJECT_POOL(UTextComponent)
\ No newline at end of file
@@ -33,4 +33,6 @@ public:
         : FTransform(dat, count) {
         Name_ = "TransformComponent";
     }
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(UTransformComponent)
\ No newline at end of file
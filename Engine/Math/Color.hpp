@@ -7,7 +7,7 @@ struct FColor {
 	FColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) : R(r), G(g), B(b), A(a) {}
 	FColor(const TArray<uint8_t>& arr) {
 		if (arr.Size() != 4) {
-			GLOG(Log::eError, "Invalid array size for FColor constructor. Expected 4, got %zu.", arr.Size());
+			GLOG_CATEGORY(Log::Category::eGeneral, Log::eError, "Invalid array size for FColor constructor. Expected 4, got %zu.", arr.Size());
 			return;
 		}
 
@@ -1,5 +1,9 @@
 ﻿#include "GeometryUtils.hpp"
 #include "Core/EngineLogger.hpp"
+#include "Memory/ScratchAllocator.h"
+#include "Systems/JobSystem.hpp"
+
+#define GEOMETRY_PARALLEL_GRAIN 4096		// 顶点哈希与索引重映射每块至少处理的元素数
 
 void GeometryUtils::GenerateNormals(uint32_t vertex_count, Vertex* vertices,
 	uint32_t index_count, uint32_t* indices, bool smooth) {
@@ -174,49 +178,59 @@ void GeometryUtils::DeduplicateVertices(uint32_t vertex_count, Vertex* vertices,
 		return;
 	}
 
-	// 使用哈希表进行快速查找
-	struct VertexHash {
-		std::size_t operator()(const Vertex& v) const {
+	// 哈希表的键是顶点下标，哈希值预先并行算好，查表时只取数组
+	struct VertexIndexHash {
+		const size_t* hashes;
+		std::size_t operator()(uint32_t index) const { return hashes[index]; }
+	};
+	struct VertexIndexEqual {
+		const Vertex* vertices;
+		bool operator()(uint32_t a, uint32_t b) const { return vertices[a] == vertices[b]; }
+	};
+
+	// 临时数组只在本线程分配，ParallelFor 的帮手在返回前读写完毕
+	ScratchScope Scratch;
+	size_t* hashes = ScratchAllocator::NewArray<size_t>(vertex_count);
+	JobSystem::ParallelFor(0, vertex_count, GEOMETRY_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
 			// 简单的哈希函数组合
+			const Vertex& v = vertices[i];
 			auto h1 = std::hash<float>{}(v.position.x);
 			auto h2 = std::hash<float>{}(v.position.y);
 			auto h3 = std::hash<float>{}(v.position.z);
 			auto h4 = std::hash<float>{}(v.texcoord.x);
 			auto h5 = std::hash<float>{}(v.texcoord.y);
-			return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3) ^ (h5 << 4);
+			hashes[i] = h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3) ^ (h5 << 4);
 		}
-	};
+	});
 
-	std::unordered_map<Vertex, uint32_t, VertexHash> vertex_map;
-	std::vector<Vertex> unique_vertices;
-	std::vector<uint32_t> remap_table(vertex_count);
+	TScratchMap<uint32_t, uint32_t, VertexIndexHash, VertexIndexEqual> vertex_map(vertex_count, VertexIndexHash{ hashes }, VertexIndexEqual{ vertices });
+	TScratchVector<Vertex> unique_vertices;
+	TScratchVector<uint32_t> remap_table(vertex_count);
+	unique_vertices.reserve(vertex_count);
 
-	// 第一遍：建立唯一顶点列表和重映射表
+	// 第一遍：建立唯一顶点列表和重映射表。按顺序插入，保证输出顺序与串行版本一致
 	for (uint32_t i = 0; i < vertex_count; ++i) {
-		auto it = vertex_map.find(vertices[i]);
-		if (it != vertex_map.end()) {
-			// 找到重复顶点
-			remap_table[i] = it->second;
-		}
-		else {
+		auto inserted = vertex_map.emplace(i, static_cast<uint32_t>(unique_vertices.size()));
+		if (inserted.second) {
 			// 新的唯一顶点
-			uint32_t new_index = static_cast<uint32_t>(unique_vertices.size());
 			unique_vertices.push_back(vertices[i]);
-			vertex_map[vertices[i]] = new_index;
-			remap_table[i] = new_index;
 		}
+		remap_table[i] = inserted.first->second;
 	}
 
 	// 第二遍：重新映射索引
-	for (uint32_t i = 0; i < index_count; ++i) {
-		if (indices[i] < vertex_count) {
-			indices[i] = remap_table[indices[i]];
+	JobSystem::ParallelFor(0, index_count, GEOMETRY_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (indices[i] < vertex_count) {
+				indices[i] = remap_table[indices[i]];
+			}
 		}
-	}
+	});
 
 	// 分配输出内存
 	*out_vertex_count = static_cast<uint32_t>(unique_vertices.size());
-	*out_vertices = static_cast<Vertex*>(Memory::Allocate(
+	*out_vertices = static_cast<Vertex*>(Memory::AllocateUninitialized(
 		sizeof(Vertex) * (*out_vertex_count), MemoryType::eMemory_Type_Array));
 
 	// 复制唯一顶点
@@ -430,7 +430,7 @@ public:
 	* @return A matrix looking at target from the perspective of position.
 	*/
 	static TMatrix4 LookAtLH(const TVector3<T>& position, const TVector3<T>& target, const TVector3<T>& up) {
-		GLOG(Log::eWarn, "Not support LookAtLH yet!");
+		GLOG_CATEGORY(Log::Category::eGeneral, Log::eWarn, "Not support LookAtLH yet!");
 		return TMatrix4();
 	}
 
@@ -766,7 +766,7 @@ public:
 
         TVector4<T> GetColumn(int Col) const {
             if (Col < 0 || Col > 3) {
-                GLOG(Log::eWarn, "Invalid matrix boundings. Return Vec4().");
+                GLOG_CATEGORY(Log::Category::eGeneral, Log::eWarn, "Invalid matrix boundings. Return Vec4().");
                 return TVector4<T>();
             }
 
@@ -775,7 +775,7 @@ public:
 
         TVector4<T> GetRow(int Row) const {
             if (Row < 0 || Row > 3) {
-                GLOG(Log::eWarn, "Invalid matrix boundings. Return Vec4().");
+                GLOG_CATEGORY(Log::Category::eGeneral, Log::eWarn, "Invalid matrix boundings. Return Vec4().");
                 return TVector4<T>(0.0f);
             }
 
@@ -1,4 +1,6 @@
-﻿#include "DynamicAllocator.h"
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "DynamicAllocator.h"
 
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
@@ -12,25 +14,28 @@ struct AllocHeader {
 	size_t alignment;
 };
 
+static inline bool TestBit(const uint64_t* bits, size_t index) {
+	return (bits[index >> 6] >> (index & 63)) & 1;
+}
+
+static inline void SetBits(uint64_t* bits, size_t first, size_t last, bool value) {
+	for (size_t i = first; i < last; ++i) {
+		if (value) bits[i >> 6] |= (uint64_t)1 << (i & 63);
+		else bits[i >> 6] &= ~((uint64_t)1 << (i & 63));
+	}
+}
+
 DynamicAllocator::DynamicAllocator() : DynamicAllocator(MEBIBYTES(10)) {}
 
-DynamicAllocator::DynamicAllocator(size_t total_size) {
+DynamicAllocator::DynamicAllocator(size_t total_size)
+	: TotalSize(0), HugePages(DYNAMIC_ALLOCATOR_HUGE_PAGES), Growable(false), ChunkCount(0) {
 	if (total_size < 1) {
 		GLOG(Log::eError, "Dynamic allocator create can not have a total_size of 0. Failed.");
 		return;
 	}
 
-	TotalSize = total_size;
-	if (!List.Create(TotalSize)) {
-		return;
-	}
-	
-	MemoryBlock = Platform::PlatformAllocate(total_size, false);
-	if (MemoryBlock == nullptr) {
-		GLOG(Log::eFatal, "DynamicAllocator::Create() Cannot allocate enough memory for dynamic allocator.");
-	}
-
-	Platform::PlatformSetMemory(MemoryBlock, 0, total_size);
+	MutexGuard Guard(Lock);
+	AddChunk(total_size);
 }
 
 DynamicAllocator& DynamicAllocator::Get() {
@@ -38,7 +43,7 @@ DynamicAllocator& DynamicAllocator::Get() {
 	return AllocatorInstance;
 }
 
-bool DynamicAllocator::Resize(size_t total_size) {
+bool DynamicAllocator::Resize(size_t total_size, HugePageMode huge_pages) {
 	if (total_size < 1) {
 		GLOG(Log::eError, "Dynamic allocator create can not have a total_size of 0. Failed.");
 		return false;
@@ -50,32 +55,173 @@ bool DynamicAllocator::Resize(size_t total_size) {
 	// 先清空
 	Destroy();
 
-	TotalSize = total_size;
-	if (!List.Create(TotalSize)) {
+	MutexGuard Guard(Lock);
+	HugePages = huge_pages;
+	return AddChunk(total_size);
+}
+
+bool DynamicAllocator::Destroy() {
+	MutexGuard Guard(Lock);
+
+	uint32_t Count = ChunkCount.load(std::memory_order_relaxed);
+	if (Count == 0) {
 		return false;
 	}
 
-	MemoryBlock = Platform::PlatformAllocate(total_size, false);
-	if (MemoryBlock == nullptr) {
-		GLOG(Log::eFatal, "DynamicAllocator::Create() Cannot allocate enough memory for dynamic allocator.");
+	// Read before the chunks are released, the getters only see live chunks.
+	const size_t FreeSpace = GetFreeSpace();
+	const size_t LargestBlock = GetLargestFreeBlock();
+	const size_t InUse = TotalSize - FreeSpace;
+
+	ChunkCount.store(0, std::memory_order_release);
+	for (uint32_t i = 0; i < Count; ++i) {
+		DestroyChunk(Chunks[i]);
 	}
+	TotalSize = 0;
 
-	Platform::PlatformSetMemory(MemoryBlock, 0, total_size);
+	GLOG(Log::eInfo, "Shutdown memory system, left memory: %llu, still in use: %llu, largest free block: %llu.",
+		(unsigned long long)FreeSpace, (unsigned long long)InUse, (unsigned long long)LargestBlock);
 	return true;
 }
 
-bool DynamicAllocator::Destroy() {
-	if (MemoryBlock != nullptr) {
-		List.Destroy();
-		Platform::PlatformFree(MemoryBlock, false);
-		MemoryBlock = nullptr;
-		TotalSize = 0;
+bool DynamicAllocator::AddChunk(size_t size) {
+	uint32_t Index = ChunkCount.load(std::memory_order_relaxed);
+	if (Index == DYNAMIC_ALLOCATOR_MAX_CHUNKS) {
+		GLOG(Log::eError, "DynamicAllocator reached its limit of %u chunks.", (uint32_t)DYNAMIC_ALLOCATOR_MAX_CHUNKS);
+		return false;
+	}
+
+	Chunk& New = Chunks[Index];
+
+	// One extra granule lets the chunk start on a granule boundary, so huge pages can back it.
+	size_t ReserveGranule = HugePages != eHuge_Page_None ? DYNAMIC_ALLOCATOR_HUGE_PAGE_GRANULE : DYNAMIC_ALLOCATOR_COMMIT_GRANULE;
+	New.ReservedSize = PaddingAligned(size, ReserveGranule) + ReserveGranule;
+	New.Reservation = Platform::PlatformReserveMemory(New.ReservedSize, HugePages, &New.Backing);
+	if (New.Reservation == nullptr) {
+		GLOG(Log::eFatal, "DynamicAllocator::AddChunk() Cannot reserve %llu bytes of address space.", (unsigned long long)New.ReservedSize);
+		return false;
+	}
+
+	// Regular pages gain nothing from the huge page granule, fall back to the finer one.
+	New.Granule = New.Backing != eHuge_Page_None ? DYNAMIC_ALLOCATOR_HUGE_PAGE_GRANULE : DYNAMIC_ALLOCATOR_COMMIT_GRANULE;
+	size_t CommitSize = PaddingAligned(size, New.Granule);
+
+	size_t WordCount = (CommitSize / New.Granule + 63) / 64;
+	New.CommitBits = (uint64_t*)Platform::PlatformAllocate(sizeof(uint64_t) * WordCount, false);
+	if (New.CommitBits == nullptr || !New.List.Create(size)) {
+		DestroyChunk(New);
+		return false;
+	}
+	Platform::PlatformZeroMemory(New.CommitBits, sizeof(uint64_t) * WordCount);
+
+	New.MemoryBlock = (char*)PaddingAligned((size_t)New.Reservation, New.Granule);
+	New.Size = size;
+	New.CommittedSize = 0;
+	if (New.Backing == eHuge_Page_Explicit) {
+		// Explicit huge pages come committed, mark every granule so CommitRange never touches them.
+		SetBits(New.CommitBits, 0, CommitSize / New.Granule, true);
+		New.CommittedSize = CommitSize;
+	}
+	TotalSize += size;
+
+	// Published last, lock-free readers only look at chunks below ChunkCount.
+	ChunkCount.store(Index + 1, std::memory_order_release);
+	return true;
+}
+
+void DynamicAllocator::DestroyChunk(Chunk& chunk) {
+	chunk.List.Destroy();
+
+	if (chunk.CommitBits != nullptr) {
+		Platform::PlatformFree(chunk.CommitBits, false);
+		chunk.CommitBits = nullptr;
+	}
 
-		GLOG(Log::eInfo, "Shutdown memory system, left memory: %llu.", GetFreeSpace());
-		return true;
+	if (chunk.Reservation != nullptr) {
+		Platform::PlatformReleaseMemory(chunk.Reservation, chunk.ReservedSize);
+		chunk.Reservation = nullptr;
 	}
 
-	return false;
+	chunk.ReservedSize = 0;
+	chunk.Backing = eHuge_Page_None;
+	chunk.MemoryBlock = nullptr;
+	chunk.Size = 0;
+	chunk.CommittedSize = 0;
+}
+
+bool DynamicAllocator::CommitRange(Chunk& chunk, size_t offset, size_t size) {
+	size_t Last = (offset + size + chunk.Granule - 1) / chunk.Granule;
+	size_t i = offset / chunk.Granule;
+
+	while (i < Last) {
+		if (TestBit(chunk.CommitBits, i)) {
+			i++;
+			continue;
+		}
+
+		// Commit each run of missing granules with one call.
+		size_t RunStart = i;
+		while (i < Last && !TestBit(chunk.CommitBits, i)) {
+			i++;
+		}
+
+		if (!Platform::PlatformCommitMemory(chunk.MemoryBlock + RunStart * chunk.Granule, (i - RunStart) * chunk.Granule)) {
+			return false;
+		}
+
+		SetBits(chunk.CommitBits, RunStart, i, true);
+		chunk.CommittedSize += (i - RunStart) * chunk.Granule;
+	}
+
+	return true;
+}
+
+void DynamicAllocator::DecommitFreeRange(Chunk& chunk, size_t offset, size_t size) {
+	// Explicit huge pages stay committed for the lifetime of the chunk.
+	if (chunk.Backing == eHuge_Page_Explicit || size <= DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD) {
+		return;
+	}
+
+	// Only whole granules inside the free range, past the part that is kept committed.
+	size_t First = PaddingAligned(offset + DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD, chunk.Granule) / chunk.Granule;
+	size_t Last = (offset + size) / chunk.Granule;
+	if (offset + size == chunk.Size) {
+		// The tail granule is only shared with the unused padding of the reservation.
+		Last = PaddingAligned(chunk.Size, chunk.Granule) / chunk.Granule;
+	}
+
+	size_t i = First;
+	while (i < Last) {
+		if ((i & 63) == 0 && i + 64 <= Last && chunk.CommitBits[i >> 6] == 0) {
+			i += 64;
+			continue;
+		}
+
+		if (!TestBit(chunk.CommitBits, i)) {
+			i++;
+			continue;
+		}
+
+		size_t RunStart = i;
+		while (i < Last && TestBit(chunk.CommitBits, i)) {
+			i++;
+		}
+
+		Platform::PlatformDecommitMemory(chunk.MemoryBlock + RunStart * chunk.Granule, (i - RunStart) * chunk.Granule);
+		SetBits(chunk.CommitBits, RunStart, i, false);
+		chunk.CommittedSize -= (i - RunStart) * chunk.Granule;
+	}
+}
+
+DynamicAllocator::Chunk* DynamicAllocator::FindChunk(const void* block) {
+	uint32_t Count = ChunkCount.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < Count; ++i) {
+		if ((const char*)block >= Chunks[i].MemoryBlock && (const char*)block < Chunks[i].MemoryBlock + Chunks[i].Size) {
+			return &Chunks[i];
+		}
+	}
+
+	return nullptr;
 }
 
 void* DynamicAllocator::Allocate(size_t size) {
@@ -93,9 +239,36 @@ void* DynamicAllocator::AllocateAligned(size_t size, size_t alignment) {
 		// NOTE: This cast will really only be an issue on allocations over ~4GiB, so... don't do that.
 		ASSERT(RequiredSize < 4294967295U);
 
+		MutexGuard Guard(Lock);
+
+		Chunk* Owner = nullptr;
 		size_t BaseOffset = 0;
-		if (List.AllocateBlock(RequiredSize, &BaseOffset)) {
-			void* ptr = (void*)((size_t)MemoryBlock + BaseOffset);
+		uint32_t Count = ChunkCount.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < Count; ++i) {
+			if (Chunks[i].List.AllocateBlock(RequiredSize, &BaseOffset)) {
+				Owner = &Chunks[i];
+				break;
+			}
+		}
+
+		if (Owner == nullptr && Growable && Count > 0) {
+			size_t ChunkSize = DMAX(Chunks[0].Size, RequiredSize);
+			if (AddChunk(ChunkSize)) {
+				GLOG(Log::eInfo, "DynamicAllocator grew by %llu bytes to %llu bytes in %u chunks.", (unsigned long long)ChunkSize, (unsigned long long)TotalSize, Count + 1);
+				if (Chunks[Count].List.AllocateBlock(RequiredSize, &BaseOffset)) {
+					Owner = &Chunks[Count];
+				}
+			}
+		}
+
+		if (Owner != nullptr) {
+			if (!CommitRange(*Owner, BaseOffset, RequiredSize)) {
+				GLOG(Log::eError, "DynamicAllocator::AllocateAligned() failed to commit %llu bytes.", (unsigned long long)RequiredSize);
+				Owner->List.FreeBlock(RequiredSize, BaseOffset);
+				return nullptr;
+			}
+
+			void* ptr = (void*)(Owner->MemoryBlock + BaseOffset);
 			// Start the alignment after enough space to hold a u32. This allows for the u32 to be stored
 			// immediately before the user block, while maintaining alignment on said user block.
 			size_t AlignedBlockOffset = PaddingAligned((size_t)ptr + DSIZE_STORAGE, alignment);
@@ -112,9 +285,8 @@ void* DynamicAllocator::AllocateAligned(size_t size, size_t alignment) {
 		}
 		else {
 			GLOG(Log::eWarn, "DynamicAllocator::AllocateAligned() allocate no blocks of memory large enough to allocate from.");
-			size_t available = List.GetFreeSpace();
-			GLOG(Log::eWarn, "Requested size: %llu, Total space available: %llu.", size, available);
-			// TODO: Report fragmentation?
+			GLOG(Log::eWarn, "Requested size: %llu, Total space available: %llu, Largest free block: %llu, Fragmentation: %.2f%%.",
+				size, GetFreeSpace(), GetLargestFreeBlock(), GetFragmentation() * 100.0f);
 			return nullptr;
 		}
 	}
@@ -137,43 +309,52 @@ bool DynamicAllocator::Free(void* block, size_t size) {
 }
 
 bool DynamicAllocator::FreeAligned(void* block) {
-	if (block == nullptr || MemoryBlock == nullptr) {
+	if (block == nullptr) {
 		GLOG(Log::eError, "DynamicAllocator::FreeAligned(): Free requires a valid block (0x%p).", block);
 		return false;
 	}
 
-	void* EndOfBlock = (void*)((size_t)MemoryBlock + TotalSize);
-	if (block < MemoryBlock || block >= EndOfBlock) {
-		GLOG(Log::eError, "DynamicAllocator::FreeAligned(): Trying to release block (0x%p) outside of allocator range (0x%p)-(0x%p). Sub size: %uul, Total size: %uul.",
-			block, MemoryBlock, EndOfBlock, (size_t)block - (size_t)MemoryBlock, TotalSize);
+	Chunk* Owner = FindChunk(block);
+	if (Owner == nullptr) {
+		GLOG(Log::eError, "DynamicAllocator::FreeAligned(): Trying to release block (0x%p) outside of allocator range. Total size: %llu, Chunks: %u.",
+			block, (unsigned long long)TotalSize, GetChunkCount());
 		return false;
 	}
 
 	uint32_t* BlockSize = (uint32_t*)((size_t)block - DSIZE_STORAGE);
 	AllocHeader* Header = (AllocHeader*)((size_t)block + *BlockSize);
 	size_t RequiredSize = Header->alignment + sizeof(AllocHeader) + DSIZE_STORAGE + *BlockSize;
-	size_t Offset = (size_t)Header->start - (size_t)MemoryBlock;
+	size_t Offset = (size_t)Header->start - (size_t)Owner->MemoryBlock;
 
-	if (!List.FreeBlock(RequiredSize, Offset)) {
+	MutexGuard Guard(Lock);
+
+	size_t FreeOffset = 0;
+	size_t FreeSize = 0;
+	if (!Owner->List.FreeBlock(RequiredSize, Offset, &FreeOffset, &FreeSize)) {
 		GLOG(Log::eError, "DynamicAllocator::FreeAligned(): Free failed.");
 		return false;
 	}
 
+	// Give large free ranges back to the OS, the address space stays reserved.
+	DecommitFreeRange(*Owner, FreeOffset, FreeSize);
 	return true;
 }
 
 bool DynamicAllocator::GetAlignmentSize(void* block, size_t* out_size, size_t* out_alignment) {
 	// 添加基本的安全检查
-	if (block == nullptr || MemoryBlock == nullptr) {
+	if (block == nullptr) {
 		return false;
 	}
 
 	// 边界检查
-	void* EndOfMemory = (void*)((size_t)MemoryBlock + TotalSize);
-	if (block < MemoryBlock || block >= EndOfMemory) {
+	Chunk* Owner = FindChunk(block);
+	if (Owner == nullptr) {
 		return false;
 	}
 
+	char* MemoryBlock = Owner->MemoryBlock;
+	void* EndOfMemory = (void*)(MemoryBlock + Owner->Size);
+
 	// 检查偏移量
 	size_t offset = (size_t)block - (size_t)MemoryBlock;
 	if (offset < DSIZE_STORAGE) {
@@ -188,7 +369,7 @@ bool DynamicAllocator::GetAlignmentSize(void* block, size_t* out_size, size_t* o
 
 	// 安全读取块大小
 	uint32_t block_size = *(uint32_t*)BlockSizePtr;
-	if (block_size == 0 || block_size > TotalSize) {
+	if (block_size == 0 || block_size > Owner->Size) {
 		return false;
 	}
 
@@ -216,7 +397,38 @@ size_t DynamicAllocator::GetTotalSpace() {
 }
 
 size_t DynamicAllocator::GetFreeSpace() {
-	return List.GetFreeSpace();
+	size_t Free = 0;
+	uint32_t Count = ChunkCount.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < Count; ++i) {
+		Free += Chunks[i].List.GetFreeSpace();
+	}
+	return Free;
+}
+
+size_t DynamicAllocator::GetCommittedSpace() {
+	size_t Committed = 0;
+	uint32_t Count = ChunkCount.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < Count; ++i) {
+		Committed += Chunks[i].CommittedSize;
+	}
+	return Committed;
+}
+
+size_t DynamicAllocator::GetLargestFreeBlock() {
+	size_t Largest = 0;
+	uint32_t Count = ChunkCount.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < Count; ++i) {
+		Largest = DMAX(Largest, Chunks[i].List.GetLargestFreeBlock());
+	}
+	return Largest;
+}
+
+float DynamicAllocator::GetFragmentation() {
+	size_t Free = GetFreeSpace();
+	if (Free == 0) {
+		return 0.0f;
+	}
+	return 1.0f - (float)GetLargestFreeBlock() / (float)Free;
 }
 
 size_t DynamicAllocator::AllocatorHeaderSize() {
@@ -13,7 +13,31 @@
 
 #include "Defines.hpp"
 #include "Memory/Freelist.hpp"
+#include "Platform/Platform.hpp"
+#include "Platform/Thread/DMutex.hpp"
 
+#include <atomic>
+
+#define DYNAMIC_ALLOCATOR_MAX_CHUNKS 16						// 预留区用完后最多追加的区块数
+#define DYNAMIC_ALLOCATOR_COMMIT_GRANULE KIBIBYTES(64)		// 提交/释放物理页的粒度
+#define DYNAMIC_ALLOCATOR_HUGE_PAGE_GRANULE MEBIBYTES(2)	// 使用大页时的粒度
+#define DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD MEBIBYTES(1)	// 合并后的空闲区至少这么大才归还给系统
+
+#ifndef DYNAMIC_ALLOCATOR_HUGE_PAGES
+#define DYNAMIC_ALLOCATOR_HUGE_PAGES eHuge_Page_Transparent
+#endif
+
+/**
+ * @brief General purpose allocator on top of reserved virtual memory.
+ *
+ * Each chunk reserves its address range up front but only commits pages, in
+ * DYNAMIC_ALLOCATOR_COMMIT_GRANULE steps, once an allocation lands on them. Free ranges larger
+ * than DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD are decommitted again, except for their first
+ * DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD bytes so allocations at the edge of a free range don't
+ * keep committing and decommitting the same pages.
+ *
+ * A growable allocator reserves a new chunk when no chunk can serve a request, instead of failing.
+ */
 class DAPI DynamicAllocator {
 public:
 	DynamicAllocator();
@@ -29,7 +53,14 @@ public:
 	 */
 	static DynamicAllocator& Get();
 
-	bool Resize(size_t total_size);
+	/**
+	 * @brief Drops every chunk and reserves a new first chunk of the given size.
+	 *
+	 * @param total_size The size in bytes of the first reservation.
+	 * @param huge_pages Whether the chunks should be backed by huge pages.
+	 * @return True on success.
+	 */
+	bool Resize(size_t total_size, HugePageMode huge_pages = DYNAMIC_ALLOCATOR_HUGE_PAGES);
 
 	/**
 	 * @brief Destroys the allocator.
@@ -94,13 +125,67 @@ public:
 	 */
 	size_t GetTotalSpace();
 
+	/**
+	 * @brief Obtains the amount of memory backed by physical pages.
+	 *
+	 * @return The committed size in bytes.
+	 */
+	size_t GetCommittedSpace();
+
+	/**
+	 * @brief Obtains the number of reserved chunks.
+	 */
+	uint32_t GetChunkCount() const { return ChunkCount.load(std::memory_order_acquire); }
+
+	/**
+	 * @brief Allows the allocator to reserve more chunks when it runs out of space. Off by default.
+	 */
+	void SetGrowable(bool growable) { Growable = growable; }
+
+	/**
+	 * @brief Obtains the size of the largest free block, i.e. the largest block the allocator can still hand out.
+	 *
+	 * @return The size of the largest free block in bytes.
+	 */
+	size_t GetLargestFreeBlock();
+
+	/**
+	 * @brief Obtains the external fragmentation of the allocator.
+	 *
+	 * @return 0 when all free space is contiguous, approaching 1 as it gets scattered.
+	 */
+	float GetFragmentation();
+
 	/**
 	 * Obtains the size of the internal allocation header. This is readlly only used for unit testing purposes. 
 	 */
 	size_t AllocatorHeaderSize();
 
+private:
+	struct Chunk {
+		void* Reservation = nullptr;
+		size_t ReservedSize = 0;
+		char* MemoryBlock = nullptr;
+		size_t Size = 0;
+		size_t Granule = 0;
+		HugePageMode Backing = eHuge_Page_None;		// 平台实际给的页，显式大页整块已提交
+		uint64_t* CommitBits = nullptr;
+		size_t CommittedSize = 0;
+		Freelist List;
+	};
+
+	// 以下函数在持有 Lock 时调用
+	bool AddChunk(size_t size);
+	void DestroyChunk(Chunk& chunk);
+	bool CommitRange(Chunk& chunk, size_t offset, size_t size);
+	void DecommitFreeRange(Chunk& chunk, size_t offset, size_t size);
+	Chunk* FindChunk(const void* block);
+
 private:
 	size_t TotalSize;
-	Freelist List;
-	void* MemoryBlock;
+	HugePageMode HugePages;
+	bool Growable;
+	Chunk Chunks[DYNAMIC_ALLOCATOR_MAX_CHUNKS];
+	std::atomic<uint32_t> ChunkCount;
+	Mutex Lock;
 };
@@ -0,0 +1,106 @@
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "FrameAllocator.h"
+
+#include "Core/EngineLogger.hpp"
+
+#define FRAME_STAMP_MAGIC 0xF4A3E5u
+
+// 调试模式下放在每个块之前，记录分配时所在的帧
+struct FrameStamp {
+	uint32_t Magic;
+	uint32_t Frame;
+};
+
+LinearAllocator FrameAllocator::Arenas[FRAME_ALLOCATOR_FRAME_COUNT];
+std::atomic<uint64_t> FrameAllocator::FrameNumber{ 0 };
+bool FrameAllocator::FrameOpen = false;
+
+bool FrameAllocator::Initialize(size_t frame_size) {
+	for (uint32_t i = 0; i < FRAME_ALLOCATOR_FRAME_COUNT; ++i) {
+		if (!Arenas[i].Create(frame_size)) {
+			GLOG(Log::eFatal, "Frame allocator failed to create arena %u.", i);
+			return false;
+		}
+	}
+
+	FrameNumber.store(0, std::memory_order_relaxed);
+	FrameOpen = false;
+	return true;
+}
+
+void FrameAllocator::Shutdown() {
+	for (uint32_t i = 0; i < FRAME_ALLOCATOR_FRAME_COUNT; ++i) {
+		Arenas[i].Destroy();
+	}
+	FrameOpen = false;
+}
+
+void FrameAllocator::BeginFrame() {
+	uint64_t Frame = FrameNumber.load(std::memory_order_relaxed) + 1;
+
+	// The arena was last used FRAME_ALLOCATOR_FRAME_COUNT frames ago, which the renderer has already waited for.
+	Arenas[Frame % FRAME_ALLOCATOR_FRAME_COUNT].Reset();
+
+	FrameNumber.store(Frame, std::memory_order_release);
+	FrameOpen = true;
+}
+
+void FrameAllocator::EndFrame() {
+	FrameOpen = false;
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment) {
+	uint64_t Frame = FrameNumber.load(std::memory_order_acquire);
+	LinearAllocator& Arena = Arenas[Frame % FRAME_ALLOCATOR_FRAME_COUNT];
+
+#if DMEMORY_FRAME_CHECK
+	if (!FrameOpen) {
+		GLOG(Log::eError, "FrameAllocator::Allocate() called outside of a frame. The block is reclaimed at the next BeginFrame().");
+	}
+
+	// Reserve room for the stamp in front of the block while keeping the block aligned.
+	size_t StampSize = PaddingAligned(sizeof(FrameStamp), DMAX(alignment, alignof(FrameStamp)));
+	char* Block = (char*)Arena.Allocate(StampSize + size, DMAX(alignment, alignof(FrameStamp)));
+	if (Block == nullptr) {
+		return nullptr;
+	}
+
+	FrameStamp* Stamp = (FrameStamp*)(Block + StampSize - sizeof(FrameStamp));
+	Stamp->Magic = FRAME_STAMP_MAGIC;
+	Stamp->Frame = (uint32_t)Frame;
+	return Block + StampSize;
+#else
+	return Arena.Allocate(size, alignment);
+#endif
+}
+
+bool FrameAllocator::IsAlive(const void* block) {
+	uint64_t Frame = FrameNumber.load(std::memory_order_acquire);
+	if (!FrameOpen || !Arenas[Frame % FRAME_ALLOCATOR_FRAME_COUNT].Owns(block)) {
+		return false;
+	}
+
+#if DMEMORY_FRAME_CHECK
+	const FrameStamp* Stamp = (const FrameStamp*)((const char*)block - sizeof(FrameStamp));
+	return Stamp->Magic == FRAME_STAMP_MAGIC && Stamp->Frame == (uint32_t)Frame;
+#else
+	return true;
+#endif
+}
+
+bool FrameAllocator::CheckFrame(uint64_t frame_number) {
+	uint64_t Frame = FrameNumber.load(std::memory_order_acquire);
+	if (frame_number != Frame || !FrameOpen) {
+		GLOG(Log::eFatal, "Frame memory from frame %llu used in frame %llu. It must not outlive its frame.",
+			(unsigned long long)frame_number, (unsigned long long)Frame);
+		return false;
+	}
+
+	return true;
+}
+
+size_t FrameAllocator::GetUsedSize() {
+	uint64_t Frame = FrameNumber.load(std::memory_order_relaxed);
+	return Arenas[Frame % FRAME_ALLOCATOR_FRAME_COUNT].GetUsedSize();
+}
@@ -0,0 +1,147 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "Memory/LinearAllocator.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include <new>
+#include <type_traits>
+
+#ifndef DMEMORY_FRAME_CHECK
+#ifdef LEVEL_DEBUG
+#define DMEMORY_FRAME_CHECK 1
+#else
+#define DMEMORY_FRAME_CHECK 0
+#endif
+#endif
+
+#define FRAME_ALLOCATOR_FRAME_COUNT 2				// 与 VulkanSwapchain::MaxFramesInFlight 一致
+#define FRAME_ALLOCATOR_DEFAULT_SIZE MEBIBYTES(4)	// 每帧初始容量，溢出后在下次复位时自动扩大
+
+/**
+ * @brief Transient memory that lives for exactly one frame.
+ *
+ * One LinearAllocator per frame in flight; BeginFrame() resets the arena of the frame it
+ * starts, so nothing allocated here may be kept past EndFrame(). Memory is never freed
+ * individually, and destructors only run when called through Destroy().
+ *
+ * With DMEMORY_FRAME_CHECK every block carries the frame it was allocated in, and
+ * TFrameAllocator reports containers that are grown after their frame has ended.
+ */
+class DAPI FrameAllocator {
+public:
+	static bool Initialize(size_t frame_size = FRAME_ALLOCATOR_DEFAULT_SIZE);
+	static void Shutdown();
+
+	/**
+	 * @brief Starts a new frame and reclaims the arena it is going to use.
+	 */
+	static void BeginFrame();
+
+	/**
+	 * @brief Ends the current frame. Frame memory must not be touched until the next BeginFrame().
+	 */
+	static void EndFrame();
+
+	/**
+	 * @brief Allocates memory from the current frame. The memory is not zeroed.
+	 *
+	 * @param size The size in bytes to be allocated.
+	 * @param alignment The alignment, must be a power of two.
+	 * @return The allocated block of memory unless this operation fails, then nullptr.
+	 */
+	static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/**
+	 * @brief Checks that a block comes from the frame that is currently running.
+	 * Always true for blocks of the current frame when DMEMORY_FRAME_CHECK is disabled.
+	 */
+	static bool IsAlive(const void* block);
+
+	/**
+	 * @brief Reports an error if the given frame is no longer the running one.
+	 *
+	 * @param frame_number The frame a container or pointer was created in.
+	 * @return True if the frame is still running.
+	 */
+	static bool CheckFrame(uint64_t frame_number);
+
+	static uint64_t GetFrameNumber() { return FrameNumber.load(std::memory_order_relaxed); }
+	static size_t GetUsedSize();
+
+	template<typename T, typename... Args>
+	static T* New(Args&&... args) {
+		void* Block = Allocate(sizeof(T), alignof(T));
+		if (Block == nullptr) {
+			return nullptr;
+		}
+		return new(Block) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	static T* NewArray(size_t count) {
+		static_assert(std::is_trivially_destructible<T>::value, "Frame arrays are never destroyed, T must be trivially destructible.");
+		return (T*)Allocate(sizeof(T) * count, alignof(T));
+	}
+
+	/**
+	 * @brief Runs the destructor of an object created by New(). The memory itself is reclaimed with the frame.
+	 */
+	template<typename T>
+	static void Destroy(T* obj) {
+		if (obj != nullptr) {
+			obj->~T();
+		}
+	}
+
+private:
+	static LinearAllocator Arenas[FRAME_ALLOCATOR_FRAME_COUNT];
+	static std::atomic<uint64_t> FrameNumber;
+	static bool FrameOpen;
+};
+
+/**
+ * @brief STL allocator adapter over FrameAllocator. Deallocation is a no-op.
+ *
+ * The adapter remembers the frame it was created in; with DMEMORY_FRAME_CHECK, growing a
+ * container after that frame ended is reported, since its old elements are already gone.
+ */
+template<typename T>
+class TFrameAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::true_type;
+
+	TFrameAllocator() noexcept : Frame(FrameAllocator::GetFrameNumber()) {}
+	template<typename U>
+	TFrameAllocator(const TFrameAllocator<U>& other) noexcept : Frame(other.Frame) {}
+
+	T* allocate(size_t n) {
+#if DMEMORY_FRAME_CHECK
+		FrameAllocator::CheckFrame(Frame);
+#endif
+		T* Block = (T*)FrameAllocator::Allocate(sizeof(T) * n, alignof(T));
+		if (Block == nullptr) {
+			throw std::bad_alloc();
+		}
+		return Block;
+	}
+
+	void deallocate(T*, size_t) noexcept {}
+
+	template<typename U>
+	bool operator==(const TFrameAllocator<U>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const TFrameAllocator<U>&) const noexcept { return false; }
+
+public:
+	uint64_t Frame;
+};
+
+template<typename T>
+using TFrameVector = std::vector<T, TFrameAllocator<T>>;
@@ -1,385 +1,545 @@
-﻿#include "Freelist.hpp"
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "Freelist.hpp"
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
 #include "Platform/Platform.hpp"
-#include <algorithm>  // for std::min, std::max
-
-bool Freelist::Create(size_t total_size) {
-	MutexGuard Guard(freelist_mutex);
-
-	// Enough space to hold state, plus array for all nodes.
-	TotalSize = total_size;
-
-	// 修复：优化MaxEntries计算，避免过度分配
-	size_t calculated_entries = total_size / sizeof(FreelistNode);
 
-	// 限制最大节点数：基于实际需求
-	// 假设平均分配大小256字节，最大碎片化3倍
-	size_t estimated_max_blocks = (total_size / FREELIST_AVG_ALLOCCATE_SIZE) * FREELIST_MAX_FRAGMENT_RATE;
-	size_t reasonable_limit = std::min(estimated_max_blocks, static_cast<size_t>(FREELIST_MAX_LIMITED_NODE)); // 最多16K节点
+static inline uint32_t FindLowestBit(uint64_t value) {
+#if defined(_MSC_VER)
+	unsigned long Index;
+	_BitScanForward64(&Index, value);
+	return (uint32_t)Index;
+#else
+	return (uint32_t)__builtin_ctzll(value);
+#endif
+}
 
-	MaxEntries = std::min(calculated_entries, reasonable_limit);
+static inline uint32_t FindHighestBit(uint64_t value) {
+#if defined(_MSC_VER)
+	unsigned long Index;
+	_BitScanReverse64(&Index, value);
+	return (uint32_t)Index;
+#else
+	return 63u - (uint32_t)__builtin_clzll(value);
+#endif
+}
 
-	// 确保至少有基本数量
-	MaxEntries = std::max(MaxEntries, static_cast<size_t>(64));
+static inline size_t HashOffset(size_t offset) {
+	uint64_t Key = (uint64_t)offset;
+	Key ^= Key >> 33;
+	Key *= 0xff51afd7ed558ccdULL;
+	Key ^= Key >> 33;
+	return (size_t)Key;
+}
 
-	GLOG(Log::eInfo, "Freelist max entries: %d (optimized from %zu).", MaxEntries, calculated_entries);
+bool Freelist::Create(size_t total_size) {
+	MutexGuard Guard(freelist_mutex);
 
-	size_t UsedSize = sizeof(FreelistNode) * MaxEntries;
-	ListMemory = Platform::PlatformAllocate(UsedSize, false);
-	if (ListMemory == nullptr) {
-		GLOG(Log::eFatal, "Cannot allocate enough memory for freelist!");
-		return false;
+	if (Nodes != nullptr) {
+		GLOG(Log::eWarn, "Freelist::Create() called on a live freelist. Recreating.");
+		Platform::PlatformFree(Nodes, false);
+		Platform::PlatformFree(AllocatedTable, false);
+		Nodes = nullptr;
+		AllocatedTable = nullptr;
 	}
 
-	Memory::Zero(ListMemory, UsedSize);
+	TotalSize = total_size;
 
-	Nodes = (FreelistNode*)ListMemory;
+	NodeCapacity = FREELIST_INITIAL_NODE_COUNT;
+	Nodes = (FreelistNode*)Platform::PlatformAllocate(sizeof(FreelistNode) * NodeCapacity, false);
 
-	Head = &Nodes[0];
-	Head->offset = 0;
-	Head->size = total_size;
-	Head->next = nullptr;
+	TableCapacity = FREELIST_INITIAL_NODE_COUNT * 2;
+	AllocatedTable = (AllocatedEntry*)Platform::PlatformAllocate(sizeof(AllocatedEntry) * TableCapacity, false);
 
-	// Invalidate the offset and size for all but the first node. The invalid value
-	// will be checked for when seeking a new node from the list.
-	for (size_t i = 1; i < MaxEntries; ++i) {
-		Nodes[i].offset = INVALID_ID;
-		Nodes[i].size = INVALID_ID;
+	if (Nodes == nullptr || AllocatedTable == nullptr) {
+		GLOG(Log::eFatal, "Cannot allocate enough memory for freelist!");
+		Platform::PlatformFree(Nodes, false);
+		Platform::PlatformFree(AllocatedTable, false);
+		Nodes = nullptr;
+		AllocatedTable = nullptr;
+		NodeCapacity = 0;
+		TableCapacity = 0;
+		return false;
 	}
 
+	ResetUnsafe();
 	return true;
 }
 
 void Freelist::Destroy() {
-	if (ListMemory != nullptr) {
+	if (Nodes != nullptr) {
 		MutexGuard Guard(freelist_mutex);
 
-		Platform::PlatformFree(ListMemory, false);
-		ListMemory = nullptr;
-		Head = nullptr;
+		Platform::PlatformFree(Nodes, false);
+		Platform::PlatformFree(AllocatedTable, false);
 		Nodes = nullptr;
-		MaxEntries = 0;
+		AllocatedTable = nullptr;
+		NodeCapacity = 0;
+		TableCapacity = 0;
+		TableCount = 0;
+		UnusedNodeHead = INVALID_ID;
+		LastPhysical = INVALID_ID;
 		TotalSize = 0;
+		FreeSize = 0;
+		FreeBlockCount = 0;
 	}
 }
 
 bool Freelist::AllocateBlock(size_t size, size_t* offset) {
 	MutexGuard Guard(freelist_mutex);
 
-	if (offset == nullptr || ListMemory == nullptr) {
+	if (offset == nullptr || Nodes == nullptr || size == 0) {
 		return false;
 	}
 
-	FreelistNode* Node = Head;
-	FreelistNode* Prev = nullptr;
-	while (Node != nullptr) {
-		if (Node->size == size) {
-			// Exact match. Just return the node.
-			// If not aligned, this wont be large enough.
-			*offset = Node->offset;
-			FreelistNode* ReturnNode = nullptr;
-			if (Prev != nullptr) {
-				Prev->next = Node->next;
-				ReturnNode = Node;
-			}
-			else {
-				// This node is the head of the list. Reassign the head and return the previous head node.
-				ReturnNode = Head;
-				Head = Node->next;
-			}
-			ResetNodeUnsafe(ReturnNode);  // 修复：使用不加锁版本
-			return true;
+	// Reserve bookkeeping up front so nothing below can fail halfway.
+	if (!EnsureNodeCapacity() || !EnsureTableCapacity()) {
+		GLOG(Log::eError, "Freelist::AllocateBlock() cannot grow internal storage.");
+		return false;
+	}
+
+	uint32_t Node = FindSuitableNode(size);
+	if (Node == INVALID_ID) {
+		GLOG(Log::eWarn, "Freelist find block, no block with enough free space found (requested: %lluB, available: %lluB, largest: %lluB).",
+			(unsigned long long)size, (unsigned long long)FreeSize, (unsigned long long)GetLargestFreeBlockUnsafe());
+		return false;
+	}
+
+	RemoveFreeNode(Node);
+
+	// Split off the tail so the allocation keeps the lower offset.
+	if (Nodes[Node].size > size) {
+		uint32_t Remainder = AcquireNode();
+		FreelistNode& Block = Nodes[Node];
+		FreelistNode& Rest = Nodes[Remainder];
+
+		Rest.offset = Block.offset + size;
+		Rest.size = Block.size - size;
+		Rest.prev_physical = Node;
+		Rest.next_physical = Block.next_physical;
+		if (Rest.next_physical != INVALID_ID) {
+			Nodes[Rest.next_physical].prev_physical = Remainder;
 		}
-		else if (Node->size > size) {
-			// Node is larger than the requirement + the alignment offset.
-			// Deduct the memory from it and move the offset by that amount.
-			*offset = Node->offset;
-			Node->size -= size;
-			Node->offset += size;
-			return true;
+		else {
+			LastPhysical = Remainder;
 		}
 
-		Prev = Node;
-		Node = Node->next;
+		Block.size = size;
+		Block.next_physical = Remainder;
+		InsertFreeNode(Remainder);
 	}
 
-	size_t FreeSpace = GetFreeSpaceUnsafe();  // 调用内部不加锁版本
-	GLOG(Log::eWarn, "Freelist find block, no block with enough free space found (requested: %uB, available: %lluB).", size, FreeSpace);
-	return false;
+	Nodes[Node].is_free = false;
+	FreeSize -= Nodes[Node].size;
+	TableInsert(Nodes[Node].offset, Node);
+
+	*offset = Nodes[Node].offset;
+	return true;
 }
 
 bool Freelist::FreeBlock(size_t size, size_t offset) {
+	return FreeBlock(size, offset, nullptr, nullptr);
+}
+
+bool Freelist::FreeBlock(size_t size, size_t offset, size_t* out_free_offset, size_t* out_free_size) {
 	MutexGuard Guard(freelist_mutex);
 
-	if (ListMemory == nullptr || size == 0) {
+	if (Nodes == nullptr || size == 0) {
 		return false;
 	}
 
-	FreelistNode* Node = Head;
-	FreelistNode* Prev = nullptr;
+	uint32_t Node = TableRemove(offset);
+	if (Node == INVALID_ID) {
+		GLOG(Log::eFatal, "Attemping to free a block that is not allocated at offset %llu. Double free or corruption?", (unsigned long long)offset);
+		return false;
+	}
 
-	if (Node == nullptr) {
-		// Check for the case where the entire thing is allocated.
-		// In this case a new node is needed at the head.
-		FreelistNode* NewNode = AcquireFreeNodeUnsafe();  // 调用内部不加锁版本
-		if (NewNode == nullptr) {
-			GLOG(Log::eError, "Cannot acquire free node for freelist.");
-			return false;
-		}
-		NewNode->offset = offset;
-		NewNode->size = size;
-		NewNode->next = nullptr;
-		Head = NewNode;
-		return true;
+	if (Nodes[Node].size != size) {
+		GLOG(Log::eWarn, "Freelist::FreeBlock() size mismatch at offset %llu: allocated %llu, freeing %llu.",
+			(unsigned long long)offset, (unsigned long long)Nodes[Node].size, (unsigned long long)size);
 	}
-	else
-	{
-		while (Node != nullptr) {
-			if (Node->offset + Node->size == offset) {
-				// Can just be appended to right of this node.
-				Node->size += size;
-
-				// Check if this then connects the range between this and the next node,
-				// and if so, combine them and return the second node.
-				if (Node->next && Node->next->offset == Node->offset + Node->size) {
-					Node->size += Node->next->size;
-					FreelistNode* Next = Node->next;
-					Node->next = Node->next->next;
-					ResetNodeUnsafe(Next);  // 调用内部不加锁版本
-				}
-				return true;
-			}
-			else if (Node->offset == offset) {
-				// If there is a exact match, this means the exact block of memory
-				// that is already free is being freed again.
-				GLOG(Log::eFatal, "Attemping to free already-freed block of memory at offset %llu.", Node->offset);
-				return false;
-			}
-			else if (Node->offset > offset) {
-				// Iterated beyond the space to be freed. Need a new node.
-				FreelistNode* NewNode = AcquireFreeNodeUnsafe();
-				if (NewNode == nullptr) {
-					GLOG(Log::eError, "Cannot acquire free node for freelist.");
-					return false;
-				}
-				NewNode->offset = offset;
-				NewNode->size = size;
-
-				// If there is a previous node, the new node should be inserted between this and it.
-				if (Prev) {
-					Prev->next = NewNode;
-					NewNode->next = Node;
-				}
-				else {
-					// Otherwise, the new node becomes the head.
-					NewNode->next = Node;
-					Head = NewNode;
-				}
-
-				// Double check next node to see if it can be joined.
-				if (NewNode->next && NewNode->offset + NewNode->size == NewNode->next->offset) {
-					NewNode->size += NewNode->next->size;
-					FreelistNode* Rubbish = NewNode->next;
-					NewNode->next = Rubbish->next;
-					ResetNodeUnsafe(Rubbish);
-				}
-
-				// Double check previous node to see if it can be joined.
-				if (Prev && Prev->offset + Prev->size == NewNode->offset) {
-					Prev->size += NewNode->size;
-					FreelistNode* Rubbish = NewNode;
-					Prev->next = Rubbish->next;
-					ResetNodeUnsafe(Rubbish);
-				}
-
-				return true;
-			}
 
-			// If on the last node and the last node's offset+size < the free offset,
-			// a new node is required.
-			if (!Node->next && Node->offset + Node->size < offset) {
-				FreelistNode* NewNode = AcquireFreeNodeUnsafe();
-				if (NewNode == nullptr) {
-					GLOG(Log::eError, "Cannot acquire free node for freelist.");
-					return false;
-				}
-				NewNode->offset = offset;
-				NewNode->size = size;
-				NewNode->next = nullptr;
-				Node->next = NewNode;
-
-				return true;
-			}
+	FreeSize += Nodes[Node].size;
+
+	// Coalesce with the previous physical block.
+	uint32_t Prev = Nodes[Node].prev_physical;
+	if (Prev != INVALID_ID && Nodes[Prev].is_free) {
+		RemoveFreeNode(Prev);
+		Nodes[Prev].size += Nodes[Node].size;
+		Nodes[Prev].next_physical = Nodes[Node].next_physical;
+		if (Nodes[Prev].next_physical != INVALID_ID) {
+			Nodes[Nodes[Prev].next_physical].prev_physical = Prev;
+		}
+		else {
+			LastPhysical = Prev;
+		}
+		ReleaseNode(Node);
+		Node = Prev;
+	}
 
-			Prev = Node;
-			Node = Node->next;
+	// Coalesce with the next physical block.
+	uint32_t Next = Nodes[Node].next_physical;
+	if (Next != INVALID_ID && Nodes[Next].is_free) {
+		RemoveFreeNode(Next);
+		Nodes[Node].size += Nodes[Next].size;
+		Nodes[Node].next_physical = Nodes[Next].next_physical;
+		if (Nodes[Node].next_physical != INVALID_ID) {
+			Nodes[Nodes[Node].next_physical].prev_physical = Node;
+		}
+		else {
+			LastPhysical = Node;
 		}
+		ReleaseNode(Next);
 	}
 
-	GLOG(Log::eWarn, "Unable to find block to be freed. Corruption possible?");
-	return false;
+	InsertFreeNode(Node);
+
+	if (out_free_offset) *out_free_offset = Nodes[Node].offset;
+	if (out_free_size) *out_free_size = Nodes[Node].size;
+	return true;
 }
 
 bool Freelist::Resize(size_t new_size) {
 	MutexGuard Guard(freelist_mutex);
 
-	if (ListMemory == nullptr || new_size < TotalSize) {
+	if (Nodes == nullptr || new_size < TotalSize) {
 		return false;
 	}
 
-	size_t OldSize = TotalSize;
+	if (new_size == TotalSize) {
+		return true;
+	}
+
 	size_t SizeDiff = new_size - TotalSize;
-	size_t NewMaxEntries = (new_size / sizeof(FreelistNode));
-	size_t NewMemorySize = sizeof(FreelistNode) * NewMaxEntries;
+	if (LastPhysical != INVALID_ID && Nodes[LastPhysical].is_free) {
+		// The tail is free, just extend it.
+		RemoveFreeNode(LastPhysical);
+		Nodes[LastPhysical].size += SizeDiff;
+		InsertFreeNode(LastPhysical);
+	}
+	else {
+		if (!EnsureNodeCapacity()) {
+			return false;
+		}
 
-	// 分配新内存
-	void* NewMemory = Platform::PlatformAllocate(NewMemorySize, false);
-	if (NewMemory == nullptr) {
-		return false;
+		uint32_t Node = AcquireNode();
+		Nodes[Node].offset = TotalSize;
+		Nodes[Node].size = SizeDiff;
+		Nodes[Node].prev_physical = LastPhysical;
+		Nodes[Node].next_physical = INVALID_ID;
+		if (LastPhysical != INVALID_ID) {
+			Nodes[LastPhysical].next_physical = Node;
+		}
+		LastPhysical = Node;
+		InsertFreeNode(Node);
 	}
 
-	Memory::Zero(NewMemory, NewMemorySize);
-	FreelistNode* NewNodes = (FreelistNode*)NewMemory;
+	FreeSize += SizeDiff;
+	TotalSize = new_size;
+	return true;
+}
 
-	// 初始化新节点
-	for (size_t i = 0; i < NewMaxEntries; ++i) {
-		NewNodes[i].offset = INVALID_ID;
-		NewNodes[i].size = INVALID_ID;
-		NewNodes[i].next = nullptr;
+void Freelist::Clear() {
+	if (Nodes != nullptr) {
+		MutexGuard Guard(freelist_mutex);
+		ResetUnsafe();
 	}
+}
+
+size_t Freelist::GetFreeSpace() {
+	MutexGuard Guard(freelist_mutex);
+	return FreeSize;
+}
 
-	// 复制现有的空闲块信息
-	FreelistNode* NewHead = nullptr;
-	FreelistNode* NewTail = nullptr;
-	size_t NodeIndex = 0;
+size_t Freelist::GetLargestFreeBlock() {
+	MutexGuard Guard(freelist_mutex);
+	return GetLargestFreeBlockUnsafe();
+}
+
+size_t Freelist::GetFreeBlockCount() {
+	MutexGuard Guard(freelist_mutex);
+	return FreeBlockCount;
+}
 
-	FreelistNode* OldNode = Head;
-	while (OldNode != nullptr && NodeIndex < NewMaxEntries) {
-		NewNodes[NodeIndex].offset = OldNode->offset;
-		NewNodes[NodeIndex].size = OldNode->size;
-		NewNodes[NodeIndex].next = nullptr;
+float Freelist::GetFragmentation() {
+	MutexGuard Guard(freelist_mutex);
+	if (FreeSize == 0) {
+		return 0.0f;
+	}
 
-		if (NewHead == nullptr) {
-			NewHead = &NewNodes[NodeIndex];
-			NewTail = NewHead;
-		}
-		else {
-			NewTail->next = &NewNodes[NodeIndex];
-			NewTail = &NewNodes[NodeIndex];
+	return 1.0f - (float)((double)GetLargestFreeBlockUnsafe() / (double)FreeSize);
+}
+
+// 内部不加锁的版本，供已经加锁的函数调用
+void Freelist::ResetUnsafe() {
+	FirstLevelBitmap = 0;
+	for (uint32_t i = 0; i < FREELIST_FL_INDEX_COUNT; ++i) {
+		SecondLevelBitmap[i] = 0;
+		for (uint32_t j = 0; j < FREELIST_SL_INDEX_COUNT; ++j) {
+			FreeHeads[i][j] = INVALID_ID;
 		}
+	}
+
+	for (size_t i = 0; i < TableCapacity; ++i) {
+		AllocatedTable[i].node = INVALID_ID;
+	}
+	TableCount = 0;
+
+	// Every node but the first goes on the recycle stack.
+	for (uint32_t i = 0; i < NodeCapacity; ++i) {
+		Nodes[i] = FreelistNode();
+		Nodes[i].next_free = (i + 1 < NodeCapacity) ? i + 1 : INVALID_ID;
+	}
+	UnusedNodeHead = 1 < NodeCapacity ? 1 : INVALID_ID;
+
+	FreeSize = TotalSize;
+	FreeBlockCount = 0;
+	LastPhysical = 0;
+
+	Nodes[0].offset = 0;
+	Nodes[0].size = TotalSize;
+	Nodes[0].next_free = INVALID_ID;
+	InsertFreeNode(0);
+}
+
+size_t Freelist::GetLargestFreeBlockUnsafe() {
+	if (FirstLevelBitmap == 0) {
+		return 0;
+	}
+
+	// The largest block lives in the highest non-empty class; only that list is scanned.
+	uint32_t fl = FindHighestBit(FirstLevelBitmap);
+	uint32_t sl = FindHighestBit(SecondLevelBitmap[fl]);
 
-		OldNode = OldNode->next;
-		NodeIndex++;
+	size_t Largest = 0;
+	for (uint32_t Node = FreeHeads[fl][sl]; Node != INVALID_ID; Node = Nodes[Node].next_free) {
+		if (Nodes[Node].size > Largest) {
+			Largest = Nodes[Node].size;
+		}
 	}
 
-	// 处理新增的空间
-	if (NewHead == nullptr) {
-		// 整个内存都被分配了，添加新的空闲块
-		NewHead = &NewNodes[0];
-		NewHead->offset = OldSize;
-		NewHead->size = SizeDiff;
-		NewHead->next = nullptr;
+	return Largest;
+}
+
+void Freelist::MappingInsert(size_t size, uint32_t* fl, uint32_t* sl) const {
+	if (size < FREELIST_SL_INDEX_COUNT) {
+		// Small sizes are mapped linearly into the first row.
+		*fl = 0;
+		*sl = (uint32_t)size;
 	}
 	else {
-		// 检查最后一个块是否能合并
-		if (NewTail->offset + NewTail->size == OldSize) {
-			NewTail->size += SizeDiff;
+		uint32_t Msb = FindHighestBit((uint64_t)size);
+		*sl = (uint32_t)(size >> (Msb - FREELIST_SL_INDEX_LOG2)) ^ FREELIST_SL_INDEX_COUNT;
+		*fl = Msb - FREELIST_SL_INDEX_LOG2 + 1;
+	}
+}
+
+void Freelist::MappingSearch(size_t size, uint32_t* fl, uint32_t* sl) const {
+	// Round up to the next class boundary so any block in the resulting class fits.
+	if (size >= FREELIST_SL_INDEX_COUNT) {
+		size_t Round = ((size_t)1 << (FindHighestBit((uint64_t)size) - FREELIST_SL_INDEX_LOG2)) - 1;
+		if (size + Round > size) {
+			size += Round;
 		}
-		else {
-			// 创建新的空闲块
-			if (NodeIndex < NewMaxEntries) {
-				NewNodes[NodeIndex].offset = OldSize;
-				NewNodes[NodeIndex].size = SizeDiff;
-				NewNodes[NodeIndex].next = nullptr;
-				NewTail->next = &NewNodes[NodeIndex];
+	}
+	MappingInsert(size, fl, sl);
+}
+
+uint32_t Freelist::FindSuitableNode(size_t size) {
+	uint32_t fl = 0;
+	uint32_t sl = 0;
+	MappingSearch(size, &fl, &sl);
+
+	if (fl < FREELIST_FL_INDEX_COUNT) {
+		uint32_t SecondMap = SecondLevelBitmap[fl] & (~0u << sl);
+		if (SecondMap == 0) {
+			uint64_t FirstMap = (fl + 1 < FREELIST_FL_INDEX_COUNT) ? FirstLevelBitmap & (~0ull << (fl + 1)) : 0;
+			if (FirstMap != 0) {
+				fl = FindLowestBit(FirstMap);
+				SecondMap = SecondLevelBitmap[fl];
 			}
 		}
+
+		if (SecondMap != 0) {
+			return FreeHeads[fl][FindLowestBit(SecondMap)];
+		}
 	}
 
-	// 更新成员变量
-	Platform::PlatformFree(ListMemory, false);
-	ListMemory = NewMemory;
-	Nodes = NewNodes;
-	Head = NewHead;
-	MaxEntries = NewMaxEntries;
-	TotalSize = new_size;
+	// Rounding up skips blocks that share the request's own class; check that list before failing.
+	MappingInsert(size, &fl, &sl);
+	for (uint32_t Node = FreeHeads[fl][sl]; Node != INVALID_ID; Node = Nodes[Node].next_free) {
+		if (Nodes[Node].size >= size) {
+			return Node;
+		}
+	}
 
-	return true;
+	return INVALID_ID;
 }
 
-void Freelist::Clear() {
-	if (ListMemory != nullptr) {
-		MutexGuard Guard(freelist_mutex);
+void Freelist::InsertFreeNode(uint32_t node) {
+	uint32_t fl = 0;
+	uint32_t sl = 0;
+	MappingInsert(Nodes[node].size, &fl, &sl);
+
+	uint32_t Head = FreeHeads[fl][sl];
+	Nodes[node].is_free = true;
+	Nodes[node].prev_free = INVALID_ID;
+	Nodes[node].next_free = Head;
+	if (Head != INVALID_ID) {
+		Nodes[Head].prev_free = node;
+	}
 
-		// Invalidate the offset and size for all but the first node. The invalid value
-		// will be checked for when seeking a new node from the list.
-		for (size_t i = 0; i < MaxEntries; ++i) {
-			Nodes[i].offset = INVALID_ID;
-			Nodes[i].size = INVALID_ID;
-			Nodes[i].next = nullptr;
-		}
+	FreeHeads[fl][sl] = node;
+	FirstLevelBitmap |= (1ull << fl);
+	SecondLevelBitmap[fl] |= (1u << sl);
+	FreeBlockCount++;
+}
+
+void Freelist::RemoveFreeNode(uint32_t node) {
+	uint32_t fl = 0;
+	uint32_t sl = 0;
+	MappingInsert(Nodes[node].size, &fl, &sl);
 
-		// Reset the head to occupy the entire thing.
-		Head = &Nodes[0];
-		Head->offset = 0;
-		Head->size = TotalSize;
-		Head->next = nullptr;
+	uint32_t Prev = Nodes[node].prev_free;
+	uint32_t Next = Nodes[node].next_free;
+	if (Prev != INVALID_ID) {
+		Nodes[Prev].next_free = Next;
+	}
+	if (Next != INVALID_ID) {
+		Nodes[Next].prev_free = Prev;
 	}
-}
 
-size_t Freelist::GetFreeSpace() {
-	MutexGuard Guard(freelist_mutex);
-	size_t FreeSpace = GetFreeSpaceUnsafe();
+	if (FreeHeads[fl][sl] == node) {
+		FreeHeads[fl][sl] = Next;
+		if (Next == INVALID_ID) {
+			SecondLevelBitmap[fl] &= ~(1u << sl);
+			if (SecondLevelBitmap[fl] == 0) {
+				FirstLevelBitmap &= ~(1ull << fl);
+			}
+		}
+	}
 
-	return FreeSpace;
+	Nodes[node].is_free = false;
+	Nodes[node].prev_free = INVALID_ID;
+	Nodes[node].next_free = INVALID_ID;
+	FreeBlockCount--;
 }
 
-// 内部不加锁的版本，供已经加锁的函数调用
-size_t Freelist::GetFreeSpaceUnsafe() {
-	if (ListMemory == nullptr) {
-		return 0;
+bool Freelist::EnsureNodeCapacity() {
+	if (UnusedNodeHead != INVALID_ID) {
+		return true;
+	}
+
+	uint32_t NewCapacity = NodeCapacity * 2;
+	FreelistNode* NewNodes = (FreelistNode*)Platform::PlatformAllocate(sizeof(FreelistNode) * NewCapacity, false);
+	if (NewNodes == nullptr) {
+		return false;
 	}
 
-	size_t RunningTotal = 0;
-	FreelistNode* Node = Head;
-	while (Node != nullptr) {
-		RunningTotal += Node->size;
-		Node = Node->next;
+	Platform::PlatformCopyMemory(NewNodes, Nodes, sizeof(FreelistNode) * NodeCapacity);
+	for (uint32_t i = NodeCapacity; i < NewCapacity; ++i) {
+		NewNodes[i] = FreelistNode();
+		NewNodes[i].next_free = (i + 1 < NewCapacity) ? i + 1 : INVALID_ID;
 	}
 
-	return RunningTotal;
+	Platform::PlatformFree(Nodes, false);
+	Nodes = NewNodes;
+	UnusedNodeHead = NodeCapacity;
+	NodeCapacity = NewCapacity;
+	return true;
 }
 
-FreelistNode* Freelist::AcquireFreeNode() {
-	MutexGuard Guard(freelist_mutex);
-	FreelistNode* FreeNode = AcquireFreeNodeUnsafe();
+uint32_t Freelist::AcquireNode() {
+	uint32_t Node = UnusedNodeHead;
+	if (Node != INVALID_ID) {
+		UnusedNodeHead = Nodes[Node].next_free;
+		Nodes[Node] = FreelistNode();
+	}
 
-	return FreeNode;
+	return Node;
 }
 
-// 内部不加锁的版本
-FreelistNode* Freelist::AcquireFreeNodeUnsafe() {
-	for (size_t i = 1; i < MaxEntries; ++i) {
-		if (Nodes[i].offset == INVALID_ID) {
-			return &Nodes[i];
+void Freelist::ReleaseNode(uint32_t node) {
+	Nodes[node] = FreelistNode();
+	Nodes[node].next_free = UnusedNodeHead;
+	UnusedNodeHead = node;
+}
+
+bool Freelist::EnsureTableCapacity() {
+	// Keep the load factor at or below 0.5.
+	if ((TableCount + 1) * 2 <= TableCapacity) {
+		return true;
+	}
+
+	size_t NewCapacity = TableCapacity * 2;
+	AllocatedEntry* NewTable = (AllocatedEntry*)Platform::PlatformAllocate(sizeof(AllocatedEntry) * NewCapacity, false);
+	if (NewTable == nullptr) {
+		return false;
+	}
+
+	for (size_t i = 0; i < NewCapacity; ++i) {
+		NewTable[i].node = INVALID_ID;
+	}
+
+	AllocatedEntry* OldTable = AllocatedTable;
+	size_t OldCapacity = TableCapacity;
+	AllocatedTable = NewTable;
+	TableCapacity = NewCapacity;
+	TableCount = 0;
+
+	for (size_t i = 0; i < OldCapacity; ++i) {
+		if (OldTable[i].node != INVALID_ID) {
+			TableInsert(OldTable[i].offset, OldTable[i].node);
 		}
 	}
 
-	// Return nothing if no nodes are available.
-	return nullptr;
+	Platform::PlatformFree(OldTable, false);
+	return true;
 }
 
-void Freelist::ResetNode(FreelistNode* node) {
-	MutexGuard Guard(freelist_mutex);
-	ResetNodeUnsafe(node);
+void Freelist::TableInsert(size_t offset, uint32_t node) {
+	size_t Mask = TableCapacity - 1;
+	size_t Index = HashOffset(offset) & Mask;
+	while (AllocatedTable[Index].node != INVALID_ID) {
+		Index = (Index + 1) & Mask;
+	}
+
+	AllocatedTable[Index].offset = offset;
+	AllocatedTable[Index].node = node;
+	TableCount++;
 }
 
-// 内部不加锁的版本
-void Freelist::ResetNodeUnsafe(FreelistNode* node) {
-	if (node != nullptr) {
-		node->offset = INVALID_ID;
-		node->size = INVALID_ID;
-		node->next = nullptr;
+uint32_t Freelist::TableRemove(size_t offset) {
+	size_t Mask = TableCapacity - 1;
+	size_t Index = HashOffset(offset) & Mask;
+	while (AllocatedTable[Index].node != INVALID_ID && AllocatedTable[Index].offset != offset) {
+		Index = (Index + 1) & Mask;
 	}
-}
\ No newline at end of file
+
+	uint32_t Node = AllocatedTable[Index].node;
+	if (Node == INVALID_ID) {
+		return INVALID_ID;
+	}
+
+	// Backward-shift deletion keeps probe chains intact without tombstones.
+	size_t Hole = Index;
+	size_t Probe = Index;
+	for (;;) {
+		Probe = (Probe + 1) & Mask;
+		if (AllocatedTable[Probe].node == INVALID_ID) {
+			break;
+		}
+
+		size_t Home = HashOffset(AllocatedTable[Probe].offset) & Mask;
+		bool StaysPut = (Hole <= Probe) ? (Hole < Home && Home <= Probe) : (Hole < Home || Home <= Probe);
+		if (!StaysPut) {
+			AllocatedTable[Hole] = AllocatedTable[Probe];
+			Hole = Probe;
+		}
+	}
+
+	AllocatedTable[Hole].node = INVALID_ID;
+	TableCount--;
+	return Node;
+}
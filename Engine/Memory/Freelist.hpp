@@ -3,19 +3,38 @@
 #include "Defines.hpp"
 #include "Platform/Thread/DMutex.hpp"
 
-#define FREELIST_MAX_LIMITED_NODE 65536		// 最大可分配节点数量
-#define FREELIST_AVG_ALLOCCATE_SIZE 256		// 平均分配大小(字节)
-#define FREELIST_MAX_FRAGMENT_RATE 3		// 最大碎片化
+#define FREELIST_SL_INDEX_LOG2 4									// 二级索引位数：每个一级区间再细分为 16 份
+#define FREELIST_SL_INDEX_COUNT (1 << FREELIST_SL_INDEX_LOG2)
+#define FREELIST_FL_INDEX_COUNT 64									// 一级索引数量，覆盖 size_t 全范围
+#define FREELIST_INITIAL_NODE_COUNT 1024							// 节点池初始容量，不足时翻倍
 
+/**
+ * @brief A contiguous range tracked by the freelist. Free and allocated ranges are both
+ * nodes; physical neighbours are linked so that coalescing never has to search.
+ */
 struct DAPI FreelistNode {
 	size_t offset = 0;
 	size_t size = 0;
-	struct FreelistNode* next = nullptr;
+	uint32_t prev_physical = INVALID_ID;
+	uint32_t next_physical = INVALID_ID;
+	uint32_t prev_free = INVALID_ID;		// 空闲时：同一尺寸等级链表；未使用时：节点回收栈
+	uint32_t next_free = INVALID_ID;
+	bool is_free = false;
 };
 
+/**
+ * @brief Offset-based two-level segregated fit (TLSF) allocator.
+ *
+ * Tracks ranges only; it never touches the memory it describes, so it can manage both
+ * CPU arenas (DynamicAllocator) and GPU buffers (VulkanBuffer). Free ranges are kept in
+ * FREELIST_FL_INDEX_COUNT x FREELIST_SL_INDEX_COUNT size-class lists indexed by two
+ * bitmaps, which makes allocation, free and coalescing constant time.
+ */
 class DAPI Freelist {
 public:
-	Freelist() : ListMemory(nullptr), Head(nullptr), Nodes(nullptr), MaxEntries(0), TotalSize(0) {}
+	Freelist() : TotalSize(0), FreeSize(0), FreeBlockCount(0), Nodes(nullptr), NodeCapacity(0),
+		UnusedNodeHead(INVALID_ID), LastPhysical(INVALID_ID), AllocatedTable(nullptr), TableCapacity(0),
+		TableCount(0), FirstLevelBitmap(0) {}
 
 public:
 	/*
@@ -49,6 +68,14 @@ public:
 	*/
 	bool FreeBlock(size_t size, size_t offset);
 
+	/*
+	* @brief Same as FreeBlock(), and also reports the free block the freed range was merged into.
+	*
+	* @param out_free_offset A pointer to hold the offset of the merged free block.
+	* @param out_free_size A pointer to hold the size of the merged free block.
+	*/
+	bool FreeBlock(size_t size, size_t offset, size_t* out_free_offset, size_t* out_free_size);
+
 	/**
 	 * @brief Attempts to resize the freelist
 	 *
@@ -63,26 +90,70 @@ public:
 
 	/*
 	* @brief Returns the amount of free space in this list.
-	* NOTE: Since this has to iterate the entire internal list, this can be an expensive operation. Use sparingly.
 	*/
 	size_t GetFreeSpace();
 
+	/*
+	* @brief Returns the size of the largest free block, i.e. the largest request that can succeed.
+	*/
+	size_t GetLargestFreeBlock();
+
+	/*
+	* @brief Returns the number of free blocks.
+	*/
+	size_t GetFreeBlockCount();
+
+	/*
+	* @brief Returns the external fragmentation in [0, 1]: 1 - largest free block / total free space.
+	* 0 means all free space is one contiguous block.
+	*/
+	float GetFragmentation();
+
 private:
-	FreelistNode* AcquireFreeNode();
-	void ResetNode(FreelistNode* node);
+	// 以下函数均假定已持有 freelist_mutex
+	void MappingInsert(size_t size, uint32_t* fl, uint32_t* sl) const;
+	void MappingSearch(size_t size, uint32_t* fl, uint32_t* sl) const;
+	uint32_t FindSuitableNode(size_t size);
+	void InsertFreeNode(uint32_t node);
+	void RemoveFreeNode(uint32_t node);
+
+	bool EnsureNodeCapacity();
+	uint32_t AcquireNode();
+	void ReleaseNode(uint32_t node);
+
+	bool EnsureTableCapacity();
+	void TableInsert(size_t offset, uint32_t node);
+	uint32_t TableRemove(size_t offset);
 
-	// 内部不加锁版本，供已经获得锁的函数使用
-	FreelistNode* AcquireFreeNodeUnsafe();
-	void ResetNodeUnsafe(FreelistNode* node);
-	size_t GetFreeSpaceUnsafe();
+	void ResetUnsafe();
+	size_t GetLargestFreeBlockUnsafe();
 
 private:
+	struct AllocatedEntry {
+		size_t offset;
+		uint32_t node;
+	};
+
 	size_t TotalSize;
-	size_t MaxEntries;
-	FreelistNode* Head;
+	size_t FreeSize;
+	size_t FreeBlockCount;
+
+	// 节点池，按下标引用以便扩容
 	FreelistNode* Nodes;
-	void* ListMemory;
+	uint32_t NodeCapacity;
+	uint32_t UnusedNodeHead;
+	uint32_t LastPhysical;
+
+	// 已分配块：offset -> 节点下标（线性探测，删除时回移，无墓碑）
+	AllocatedEntry* AllocatedTable;
+	size_t TableCapacity;
+	size_t TableCount;
+
+	// TLSF 两级位图与各尺寸等级的空闲链表头
+	uint64_t FirstLevelBitmap;
+	uint32_t SecondLevelBitmap[FREELIST_FL_INDEX_COUNT];
+	uint32_t FreeHeads[FREELIST_FL_INDEX_COUNT][FREELIST_SL_INDEX_COUNT];
 
 	// 线程安全相关
 	mutable Mutex freelist_mutex;  // 保护所有操作的互斥锁
-};
\ No newline at end of file
+};
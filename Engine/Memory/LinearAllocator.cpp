@@ -0,0 +1,141 @@
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "LinearAllocator.h"
+
+#include "Core/EngineLogger.hpp"
+#include "Platform/Platform.hpp"
+
+bool LinearAllocator::Create(size_t total_size) {
+	if (total_size == 0) {
+		GLOG(Log::eError, "LinearAllocator::Create() can not have a total_size of 0.");
+		return false;
+	}
+
+	Destroy();
+
+	MemoryBlock = (char*)Platform::PlatformAllocate(total_size, false);
+	if (MemoryBlock == nullptr) {
+		GLOG(Log::eFatal, "LinearAllocator::Create() Cannot allocate enough memory for linear allocator.");
+		return false;
+	}
+
+	TotalSize = total_size;
+	Offset.store(0, std::memory_order_relaxed);
+	return true;
+}
+
+void LinearAllocator::Destroy() {
+	MutexGuard Guard(OverflowMutex);
+
+	while (OverflowHead != nullptr) {
+		OverflowChunk* Next = OverflowHead->next;
+		Platform::PlatformFree(OverflowHead, false);
+		OverflowHead = Next;
+	}
+	OverflowSize = 0;
+
+	if (MemoryBlock != nullptr) {
+		Platform::PlatformFree(MemoryBlock, false);
+		MemoryBlock = nullptr;
+	}
+
+	TotalSize = 0;
+	PeakSize = 0;
+	Offset.store(0, std::memory_order_relaxed);
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment) {
+	if (MemoryBlock == nullptr || alignment == 0) {
+		GLOG(Log::eError, "LinearAllocator::Allocate() requires a created allocator and a valid alignment.");
+		return nullptr;
+	}
+
+	size_t Current = Offset.load(std::memory_order_relaxed);
+	for (;;) {
+		size_t Aligned = PaddingAligned((size_t)MemoryBlock + Current, alignment);
+		size_t End = Aligned - (size_t)MemoryBlock + size;
+		if (End > TotalSize) {
+			return AllocateOverflow(size, alignment);
+		}
+
+		if (Offset.compare_exchange_weak(Current, End, std::memory_order_relaxed)) {
+			return (void*)Aligned;
+		}
+	}
+}
+
+void* LinearAllocator::AllocateOverflow(size_t size, size_t alignment) {
+	MutexGuard Guard(OverflowMutex);
+
+	if (OverflowHead == nullptr) {
+		GLOG(Log::eWarn, "LinearAllocator overflowed its %llu bytes, falling back to overflow chunks until the next reset.", (unsigned long long)TotalSize);
+	}
+
+	size_t ChunkSize = sizeof(OverflowChunk) + alignment + size;
+	OverflowChunk* Chunk = (OverflowChunk*)Platform::PlatformAllocate(ChunkSize, false);
+	if (Chunk == nullptr) {
+		GLOG(Log::eError, "LinearAllocator::AllocateOverflow() Cannot allocate overflow chunk of %llu bytes.", (unsigned long long)ChunkSize);
+		return nullptr;
+	}
+
+	Chunk->next = OverflowHead;
+	Chunk->size = ChunkSize;
+	OverflowHead = Chunk;
+	OverflowSize += size + alignment;
+
+	return (void*)PaddingAligned((size_t)Chunk + sizeof(OverflowChunk), alignment);
+}
+
+void LinearAllocator::Reset() {
+	size_t Used = GetUsedSize();
+	if (Used > PeakSize) {
+		PeakSize = Used;
+	}
+
+	bool Overflowed = OverflowHead != nullptr;
+	while (OverflowHead != nullptr) {
+		OverflowChunk* Next = OverflowHead->next;
+		Platform::PlatformFree(OverflowHead, false);
+		OverflowHead = Next;
+	}
+	OverflowSize = 0;
+
+	if (Overflowed) {
+		// Grow once so the next cycle fits in the main block again.
+		size_t NewSize = PaddingAligned(Used + Used / 2, 4096);
+		char* NewBlock = (char*)Platform::PlatformAllocate(NewSize, false);
+		if (NewBlock != nullptr) {
+			GLOG(Log::eInfo, "LinearAllocator grows from %llu to %llu bytes.", (unsigned long long)TotalSize, (unsigned long long)NewSize);
+			Platform::PlatformFree(MemoryBlock, false);
+			MemoryBlock = NewBlock;
+			TotalSize = NewSize;
+		}
+	}
+#ifdef LEVEL_DEBUG
+	else if (MemoryBlock != nullptr) {
+		// Make reads through stale pointers obvious.
+		Platform::PlatformSetMemory(MemoryBlock, LINEAR_ALLOCATOR_POISON, Offset.load(std::memory_order_relaxed));
+	}
+#endif
+
+	Offset.store(0, std::memory_order_relaxed);
+}
+
+bool LinearAllocator::Owns(const void* block) {
+	if (block == nullptr || MemoryBlock == nullptr) {
+		return false;
+	}
+
+	if ((const char*)block >= MemoryBlock && (const char*)block < MemoryBlock + TotalSize) {
+		return true;
+	}
+
+	MutexGuard Guard(OverflowMutex);
+	for (OverflowChunk* Chunk = OverflowHead; Chunk != nullptr; Chunk = Chunk->next) {
+		if ((const char*)block >= (const char*)Chunk && (const char*)block < (const char*)Chunk + Chunk->size) {
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "Platform/Thread/DMutex.hpp"
+
+#include <atomic>
+
+#define LINEAR_ALLOCATOR_POISON 0xDD				// 调试模式下 Reset 后回收内存的填充值
+
+/**
+ * @brief Bump allocator over a single block.
+ *
+ * Allocation is one atomic add, so it may be called from several threads at once.
+ * Nothing is freed individually; Reset() reclaims everything at once and must not race
+ * with Allocate(). Requests that do not fit are served from overflow chunks, and the
+ * next Reset() grows the main block so the following cycle fits without overflowing.
+ */
+class DAPI LinearAllocator {
+public:
+	LinearAllocator() : MemoryBlock(nullptr), TotalSize(0), Offset(0), OverflowHead(nullptr),
+		OverflowSize(0), PeakSize(0) {}
+	virtual ~LinearAllocator() { Destroy(); }
+
+public:
+	/**
+	 * @brief Creates the allocator.
+	 *
+	 * @param total_size The size in bytes of the main block.
+	 * @return True on success.
+	 */
+	bool Create(size_t total_size);
+
+	/**
+	 * @brief Destroys the allocator and all overflow chunks.
+	 */
+	void Destroy();
+
+	/**
+	 * @brief Allocates a block of memory. The memory is not zeroed.
+	 *
+	 * @param size The size in bytes to be allocated.
+	 * @param alignment The alignment, must be a power of two.
+	 * @return The allocated block of memory unless this operation fails, then nullptr.
+	 */
+	void* Allocate(size_t size, size_t alignment);
+
+	/**
+	 * @brief Reclaims every allocation made since the last reset.
+	 */
+	void Reset();
+
+	/**
+	 * @brief Checks whether a pointer lies in memory handed out by this allocator.
+	 */
+	bool Owns(const void* block);
+
+	/**
+	 * @brief Obtains the amount of memory handed out since the last reset, overflow included.
+	 */
+	size_t GetUsedSize() const { return Offset.load(std::memory_order_relaxed) + OverflowSize; }
+
+	/**
+	 * @brief Obtains the size of the main block.
+	 */
+	size_t GetTotalSize() const { return TotalSize; }
+
+	/**
+	 * @brief Obtains the highest usage of any cycle so far.
+	 */
+	size_t GetPeakSize() const { return PeakSize; }
+
+private:
+	void* AllocateOverflow(size_t size, size_t alignment);
+
+private:
+	struct OverflowChunk {
+		OverflowChunk* next;
+		size_t size;
+	};
+
+	char* MemoryBlock;
+	size_t TotalSize;
+	std::atomic<size_t> Offset;
+
+	OverflowChunk* OverflowHead;
+	size_t OverflowSize;
+	size_t PeakSize;
+	Mutex OverflowMutex;
+};
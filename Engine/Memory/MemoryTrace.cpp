@@ -0,0 +1,209 @@
+﻿#include "MemoryTrace.h"
+
+#include "Core/DMemory.hpp"
+#include "Platform/Platform.hpp"
+#include "Platform/Thread/DMutex.hpp"
+#include "Platform/Thread/DThread.hpp"
+
+#include <cstdio>
+
+// 每个线程独占一个缓冲，只有 Stop() 会短暂占用其他线程的缓冲
+struct TraceBuffer {
+	std::atomic<bool> Busy;
+	uint32_t Count;
+	MemoryTraceEvent Events[MEMORY_TRACE_BUFFER_EVENTS];
+};
+
+std::atomic<bool> MemoryTrace::Active{ false };
+
+static Mutex FileLock;
+static FILE* TraceFile = nullptr;
+
+static Mutex RegistryLock;
+static TraceBuffer* Buffers[MEMORY_TRACE_MAX_THREADS];
+static uint32_t BufferCount = 0;
+
+static inline uint64_t GetTimestamp() {
+	return (uint64_t)(Platform::PlatformGetAbsoluteTime() * 1000000000.0);
+}
+
+static inline void Lock(TraceBuffer* buffer) {
+	while (buffer->Busy.exchange(true, std::memory_order_acquire)) {
+	}
+}
+
+static inline void UnLock(TraceBuffer* buffer) {
+	buffer->Busy.store(false, std::memory_order_release);
+}
+
+// Called with the buffer locked.
+static void WriteBuffer(TraceBuffer* buffer) {
+	if (buffer->Count == 0) {
+		return;
+	}
+
+	MutexGuard Guard(FileLock);
+	if (TraceFile != nullptr) {
+		fwrite(buffer->Events, sizeof(MemoryTraceEvent), buffer->Count, TraceFile);
+	}
+	buffer->Count = 0;
+}
+
+struct TraceBufferHolder {
+	~TraceBufferHolder();
+	TraceBuffer* Buffer = nullptr;
+};
+
+// 线程退出后缓冲已写出并释放，之后的事件直接丢弃
+static thread_local bool TraceRetired = false;
+static thread_local TraceBufferHolder LocalBuffer;
+
+TraceBufferHolder::~TraceBufferHolder() {
+	TraceRetired = true;
+	if (Buffer == nullptr) {
+		return;
+	}
+
+	MutexGuard Guard(RegistryLock);
+	Lock(Buffer);
+	WriteBuffer(Buffer);
+
+	for (uint32_t i = 0; i < BufferCount; ++i) {
+		if (Buffers[i] == Buffer) {
+			Buffers[i] = Buffers[--BufferCount];
+			break;
+		}
+	}
+
+	Platform::PlatformFree(Buffer, false);
+	Buffer = nullptr;
+}
+
+static TraceBuffer* GetBuffer() {
+	if (TraceRetired) {
+		return nullptr;
+	}
+
+	TraceBufferHolder& Holder = LocalBuffer;
+	if (Holder.Buffer != nullptr) {
+		return Holder.Buffer;
+	}
+
+	// Not taken from Memory, which would record itself.
+	TraceBuffer* Buffer = (TraceBuffer*)Platform::PlatformAllocate(sizeof(TraceBuffer), false);
+	if (Buffer == nullptr) {
+		return nullptr;
+	}
+	new (&Buffer->Busy) std::atomic<bool>(false);
+	Buffer->Count = 0;
+
+	MutexGuard Guard(RegistryLock);
+	if (BufferCount == MEMORY_TRACE_MAX_THREADS) {
+		Platform::PlatformFree(Buffer, false);
+		return nullptr;
+	}
+	Buffers[BufferCount++] = Buffer;
+
+	Holder.Buffer = Buffer;
+	return Buffer;
+}
+
+bool MemoryTrace::Start(const char* path) {
+	if (IsActive()) {
+		return false;
+	}
+
+	MutexGuard Registry(RegistryLock);
+	for (uint32_t i = 0; i < BufferCount; ++i) {
+		Buffers[i]->Count = 0;
+	}
+
+	MutexGuard Guard(FileLock);
+	TraceFile = fopen(path, "wb");
+	if (TraceFile == nullptr) {
+		return false;
+	}
+
+	MemoryTraceHeader Header;
+	Header.Magic = MEMORY_TRACE_MAGIC;
+	Header.Version = MEMORY_TRACE_VERSION;
+	Header.EventSize = sizeof(MemoryTraceEvent);
+	Header.TypeCount = eMemory_Type_Max;
+	Header.Anchor = (uint64_t)(size_t)&MemoryTrace::Start;
+	Header.StartTime = GetTimestamp();
+	fwrite(&Header, sizeof(Header), 1, TraceFile);
+
+	for (uint32_t i = 0; i < eMemory_Type_Max; ++i) {
+		MemoryTraceTypeName TypeName = {};
+		snprintf(TypeName.Name, sizeof(TypeName.Name), "%s", MemoryTypeStrings[i]);
+		fwrite(&TypeName, sizeof(TypeName), 1, TraceFile);
+	}
+
+	Active.store(true, std::memory_order_release);
+	return true;
+}
+
+void MemoryTrace::Stop() {
+	if (!IsActive()) {
+		return;
+	}
+
+	Record(eMemory_Trace_Shutdown, nullptr, 0, 0, 0, nullptr);
+	Active.store(false, std::memory_order_release);
+
+	MutexGuard Registry(RegistryLock);
+	for (uint32_t i = 0; i < BufferCount; ++i) {
+		Lock(Buffers[i]);
+		WriteBuffer(Buffers[i]);
+		UnLock(Buffers[i]);
+	}
+
+	MutexGuard Guard(FileLock);
+	if (TraceFile != nullptr) {
+		fclose(TraceFile);
+		TraceFile = nullptr;
+	}
+}
+
+void MemoryTrace::RecordAllocate(const void* block, size_t size, uint16_t type, uint8_t flags, const void* call_site) {
+	if (IsActive() && block != nullptr) {
+		Record(eMemory_Trace_Allocate, block, size, type, flags, call_site);
+	}
+}
+
+void MemoryTrace::RecordFree(const void* block, uint16_t type, uint8_t flags, const void* call_site) {
+	if (IsActive() && block != nullptr) {
+		Record(eMemory_Trace_Free, block, 0, type, flags, call_site);
+	}
+}
+
+void MemoryTrace::MarkFrame(uint64_t frame_number) {
+	if (IsActive()) {
+		Record(eMemory_Trace_Frame, nullptr, (size_t)frame_number, 0, 0, nullptr);
+	}
+}
+
+void MemoryTrace::Record(uint8_t op, const void* block, size_t size, uint16_t type, uint8_t flags, const void* call_site) {
+	TraceBuffer* Buffer = GetBuffer();
+	if (Buffer == nullptr) {
+		return;
+	}
+
+	Lock(Buffer);
+
+	MemoryTraceEvent& Event = Buffer->Events[Buffer->Count];
+	Event.Timestamp = GetTimestamp();
+	Event.Address = (uint64_t)(size_t)block;
+	Event.Size = (uint64_t)size;
+	Event.CallSite = (uint64_t)(size_t)call_site;
+	Event.ThreadId = (uint32_t)Thread::GetThreadID();
+	Event.Type = type;
+	Event.Op = op;
+	Event.Flags = flags;
+
+	if (++Buffer->Count == MEMORY_TRACE_BUFFER_EVENTS) {
+		WriteBuffer(Buffer);
+	}
+
+	UnLock(Buffer);
+}
@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "Memory/MemoryTraceFormat.h"
+
+#include <atomic>
+
+#ifndef DMEMORY_TRACE
+#define DMEMORY_TRACE 0
+#endif
+
+#define MEMORY_TRACE_BUFFER_EVENTS 4096				// 每个线程缓冲的事件数，满了才写文件
+#define MEMORY_TRACE_MAX_THREADS 256
+#define MEMORY_TRACE_DEFAULT_FILE "memory_trace.dmt"
+
+#if defined(_MSC_VER)
+#define DMEMORY_CALL_SITE() _ReturnAddress()
+#else
+#define DMEMORY_CALL_SITE() __builtin_return_address(0)
+#endif
+
+/**
+ * @brief Opt-in recorder for every allocation and free that goes through Memory.
+ *
+ * Each thread appends events to its own buffer without locking; only a full buffer takes
+ * the file lock to write itself out. The file starts with a MemoryTraceHeader followed by
+ * MemoryTraceEvent records, and is read by the MemoryTraceAnalyzer tool.
+ *
+ * Built with DMEMORY_TRACE, Memory::Initialize() starts a trace into MEMORY_TRACE_DEFAULT_FILE
+ * and Memory::Shutdown() stops it, so blocks still alive at that point show up as leaks.
+ */
+class DAPI MemoryTrace {
+public:
+	/**
+	 * @brief Opens the trace file and starts recording.
+	 *
+	 * @param path The file to write to. Overwritten if it exists.
+	 * @return True on success.
+	 */
+	static bool Start(const char* path);
+
+	/**
+	 * @brief Writes the shutdown marker, flushes every thread buffer and closes the file.
+	 * Other threads must not allocate while the trace stops.
+	 */
+	static void Stop();
+
+	static bool IsActive() { return Active.load(std::memory_order_relaxed); }
+
+	static void RecordAllocate(const void* block, size_t size, uint16_t type, uint8_t flags, const void* call_site);
+	static void RecordFree(const void* block, uint16_t type, uint8_t flags, const void* call_site);
+
+	/**
+	 * @brief Marks the start of a frame so the analyzer can attribute allocations to frames.
+	 */
+	static void MarkFrame(uint64_t frame_number);
+
+private:
+	static void Record(uint8_t op, const void* block, size_t size, uint16_t type, uint8_t flags, const void* call_site);
+
+private:
+	static std::atomic<bool> Active;
+};
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// On-disk layout of a memory trace (.dmt). Shared by the engine and Tools/MemoryTraceAnalyzer,
+// so it must not depend on anything else in the engine.
+
+#define MEMORY_TRACE_MAGIC 0x544D4D44u		// "DMMT"
+#define MEMORY_TRACE_VERSION 1
+
+enum EMemoryTraceOp : uint8_t {
+	eMemory_Trace_Allocate,
+	eMemory_Trace_Free,
+	eMemory_Trace_Frame,					// Size holds the frame number
+	eMemory_Trace_Shutdown					// Emitted by Memory::Shutdown(), every block still alive is a leak
+};
+
+// The block lives inside another recorded block (an object pool slot), so it is left out of the per-tag totals.
+#define MEMORY_TRACE_FLAG_SUB_ALLOCATION 0x1
+
+#pragma pack(push, 1)
+struct MemoryTraceHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t EventSize;
+	uint32_t TypeCount;
+	uint64_t Anchor;						// Address of a function in the engine module, to rebase call sites
+	uint64_t StartTime;						// Nanoseconds
+};
+
+// TypeCount of these follow the header, indexed by MemoryTraceEvent::Type.
+struct MemoryTraceTypeName {
+	char Name[32];
+};
+
+struct MemoryTraceEvent {
+	uint64_t Timestamp;						// Nanoseconds
+	uint64_t Address;
+	uint64_t Size;
+	uint64_t CallSite;
+	uint32_t ThreadId;
+	uint16_t Type;
+	uint8_t Op;
+	uint8_t Flags;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(MemoryTraceEvent) == 40, "MemoryTraceEvent layout changed, bump MEMORY_TRACE_VERSION.");
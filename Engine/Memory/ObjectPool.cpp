@@ -0,0 +1,364 @@
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "ObjectPool.h"
+
+#include "Core/DMemory.hpp"
+#include "Core/EngineLogger.hpp"
+#include "Memory/MemoryTrace.h"
+#include "Platform/Platform.hpp"
+
+#define OBJECT_POOL_CHUNK_SIZE (OBJECT_POOL_SLAB_SIZE * OBJECT_POOL_CHUNK_SLABS)
+#define OBJECT_POOL_MAX_CHUNKS (OBJECT_POOL_MAX_SLABS / OBJECT_POOL_CHUNK_SLABS)
+#define OBJECT_POOL_PAGE_TABLE_SIZE (OBJECT_POOL_MAX_SLABS * 2)
+
+static inline void*& NextOf(void* block) {
+	return *(void**)block;
+}
+
+static inline uintptr_t& MarkerOf(void* block) {
+	return ((uintptr_t*)block)[1];
+}
+
+// Lock order: RegistryLock, then ObjectPool::Lock in registration order, then ProviderLock.
+// GrowUnsafe acquires slabs while its pool's lock is held, so ProviderLock always comes last.
+
+// Slab provider: chunks are over-allocated by one slab so their interior holds
+// OBJECT_POOL_CHUNK_SLABS aligned slabs that no other allocation can share.
+static Mutex ProviderLock;
+static void* Chunks[OBJECT_POOL_MAX_CHUNKS];
+static uint32_t ChunkCount = 0;
+static char* ChunkCursor = nullptr;
+static uint32_t ChunkSlabsLeft = 0;
+
+// Slab page table: (address >> OBJECT_POOL_SLAB_SHIFT) + 1 -> pool. Insert-only between
+// invalidations, so lookups never take a lock.
+static std::atomic<size_t> PageKeys[OBJECT_POOL_PAGE_TABLE_SIZE];
+static std::atomic<ObjectPool*> PageOwners[OBJECT_POOL_PAGE_TABLE_SIZE];
+
+static Mutex RegistryLock;
+static ObjectPool* Pools[OBJECT_POOL_MAX_TYPES];
+static uint32_t PoolCount = 0;
+
+// 全局分配器重建时递增，线程缓存据此丢弃旧的槽
+static std::atomic<uint32_t> PoolGeneration{ 0 };
+
+static inline size_t PageHash(size_t key) {
+	key ^= key >> 15;
+	key *= 0x2c1b3c6dU;
+	key ^= key >> 12;
+	return key & (OBJECT_POOL_PAGE_TABLE_SIZE - 1);
+}
+
+static void RegisterSlab(void* slab, ObjectPool* pool) {
+	size_t Key = ((size_t)slab >> OBJECT_POOL_SLAB_SHIFT) + 1;
+	size_t Index = PageHash(Key);
+	while (PageKeys[Index].load(std::memory_order_relaxed) != 0) {
+		Index = (Index + 1) & (OBJECT_POOL_PAGE_TABLE_SIZE - 1);
+	}
+
+	PageOwners[Index].store(pool, std::memory_order_relaxed);
+	PageKeys[Index].store(Key, std::memory_order_release);
+}
+
+// Hands out one aligned slab and registers it for the given pool.
+static void* AcquireSlab(ObjectPool* pool) {
+	MutexGuard Guard(ProviderLock);
+
+	if (ChunkSlabsLeft == 0) {
+		if (ChunkCount == OBJECT_POOL_MAX_CHUNKS) {
+			GLOG(Log::eError, "Object pool reached its limit of %u slabs.", (uint32_t)OBJECT_POOL_MAX_SLABS);
+			return nullptr;
+		}
+
+		void* Chunk = Memory::AllocateUninitializedAligned(OBJECT_POOL_CHUNK_SIZE + OBJECT_POOL_SLAB_SIZE, DEFAULT_ALIGNMENT_SIZE, MemoryType::eMemory_Type_Entity);
+		if (Chunk == nullptr) {
+			return nullptr;
+		}
+
+		Chunks[ChunkCount++] = Chunk;
+		ChunkCursor = (char*)PaddingAligned((size_t)Chunk, OBJECT_POOL_SLAB_SIZE);
+		ChunkSlabsLeft = OBJECT_POOL_CHUNK_SLABS;
+	}
+
+	void* Slab = ChunkCursor;
+	ChunkCursor += OBJECT_POOL_SLAB_SIZE;
+	ChunkSlabsLeft--;
+
+	RegisterSlab(Slab, pool);
+	return Slab;
+}
+
+struct PoolMagazines {
+	struct Magazine {
+		uint32_t Count = 0;
+		void* Blocks[OBJECT_POOL_MAGAZINE_SIZE];
+	};
+
+	PoolMagazines() : Generation(PoolGeneration.load(std::memory_order_acquire)) {}
+	~PoolMagazines();
+
+	void Drain(uint32_t index, uint32_t count) {
+		Magazine& Mag = Magazines[index];
+		if (count > Mag.Count) count = Mag.Count;
+		if (count == 0) return;
+
+		ObjectPool* Pool = Pools[index];
+		{
+			MutexGuard Guard(Pool->Lock);
+			Pool->PushBatch(Mag.Blocks, count);
+		}
+
+		Mag.Count -= count;
+		for (uint32_t i = 0; i < Mag.Count; ++i) {
+			Mag.Blocks[i] = Mag.Blocks[i + count];
+		}
+	}
+
+	void Validate() {
+		uint32_t Current = PoolGeneration.load(std::memory_order_acquire);
+		if (Generation != Current) {
+			for (uint32_t i = 0; i < OBJECT_POOL_MAX_TYPES; ++i) {
+				Magazines[i].Count = 0;
+			}
+			Generation = Current;
+		}
+	}
+
+	Magazine Magazines[OBJECT_POOL_MAX_TYPES];
+	uint32_t Generation;
+};
+
+// 线程退出后缓存对象已析构，此后的请求直接走池的加锁路径
+static thread_local bool PoolCacheRetired = false;
+static thread_local PoolMagazines LocalMagazines;
+
+PoolMagazines::~PoolMagazines() {
+	Validate();
+	for (uint32_t i = 0; i < PoolCount; ++i) {
+		Drain(i, Magazines[i].Count);
+	}
+	PoolCacheRetired = true;
+}
+
+static inline PoolMagazines* GetMagazines() {
+	if (PoolCacheRetired) {
+		return nullptr;
+	}
+
+	PoolMagazines* Magazines = &LocalMagazines;
+	Magazines->Validate();
+	return Magazines;
+}
+
+ObjectPool::ObjectPool(const char* name, size_t slot_size, size_t slot_alignment)
+	: Name(name), SlotSize(0), Index(INVALID_ID), FreeHead(nullptr), SlabCount(0), LiveCount(0) {
+	size_t Size = PaddingAligned(DMAX(slot_size, sizeof(void*)), DMAX(slot_alignment, sizeof(void*)));
+	if (Size > OBJECT_POOL_SLAB_SIZE || slot_alignment > OBJECT_POOL_SLAB_SIZE) {
+		GLOG(Log::eWarn, "Type '%s' (%llu bytes) is too large to be pooled.", name, (unsigned long long)slot_size);
+		return;
+	}
+	SlotSize = Size;
+
+	MutexGuard Guard(RegistryLock);
+	if (PoolCount < OBJECT_POOL_MAX_TYPES) {
+		Index = PoolCount;
+		Pools[PoolCount++] = this;
+	}
+}
+
+void* ObjectPool::Allocate() {
+	if (SlotSize == 0) {
+		return nullptr;
+	}
+
+	void* Block = nullptr;
+	PoolMagazines* Magazines = Index != INVALID_ID ? GetMagazines() : nullptr;
+	if (Magazines != nullptr) {
+		PoolMagazines::Magazine& Mag = Magazines->Magazines[Index];
+		if (Mag.Count == 0) {
+			MutexGuard Guard(Lock);
+			Mag.Count = PopBatch(Mag.Blocks, OBJECT_POOL_BATCH_SIZE);
+		}
+
+		if (Mag.Count > 0) {
+			Block = Mag.Blocks[--Mag.Count];
+		}
+	}
+	else {
+		MutexGuard Guard(Lock);
+		PopBatch(&Block, 1);
+	}
+
+	if (Block == nullptr) {
+		return nullptr;
+	}
+
+	LiveCount.fetch_add(1, std::memory_order_relaxed);
+	Platform::PlatformZeroMemory(Block, SlotSize);
+#if DMEMORY_TRACE
+	MemoryTrace::RecordAllocate(Block, SlotSize, MemoryType::eMemory_Type_Entity, MEMORY_TRACE_FLAG_SUB_ALLOCATION, DMEMORY_CALL_SITE());
+#endif
+	return Block;
+}
+
+bool ObjectPool::Free(void* block) {
+	if (block == nullptr) {
+		return false;
+	}
+
+#if DMEMORY_OBJECT_POOL_CHECKS
+	if (SlotSize >= 2 * sizeof(void*)) {
+		if (MarkerOf(block) == OBJECT_POOL_FREE_MARKER) {
+			GLOG(Log::eError, "Double free of slot %p in object pool '%s'.", block, Name);
+			return false;
+		}
+		MarkerOf(block) = OBJECT_POOL_FREE_MARKER;
+	}
+#endif
+
+	LiveCount.fetch_sub(1, std::memory_order_relaxed);
+#if DMEMORY_TRACE
+	MemoryTrace::RecordFree(block, MemoryType::eMemory_Type_Entity, MEMORY_TRACE_FLAG_SUB_ALLOCATION, DMEMORY_CALL_SITE());
+#endif
+
+	PoolMagazines* Magazines = Index != INVALID_ID ? GetMagazines() : nullptr;
+	if (Magazines != nullptr) {
+		PoolMagazines::Magazine& Mag = Magazines->Magazines[Index];
+		if (Mag.Count == OBJECT_POOL_MAGAZINE_SIZE) {
+			Magazines->Drain(Index, OBJECT_POOL_BATCH_SIZE);
+		}
+		Mag.Blocks[Mag.Count++] = block;
+		return true;
+	}
+
+	MutexGuard Guard(Lock);
+	PushBatch(&block, 1);
+	return true;
+}
+
+uint32_t ObjectPool::PopBatch(void** out_blocks, uint32_t count) {
+	uint32_t Popped = 0;
+	while (Popped < count) {
+		if (FreeHead == nullptr && !GrowUnsafe()) {
+			break;
+		}
+
+		out_blocks[Popped++] = FreeHead;
+		FreeHead = NextOf(FreeHead);
+	}
+
+	return Popped;
+}
+
+void ObjectPool::PushBatch(void** blocks, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i) {
+		NextOf(blocks[i]) = FreeHead;
+		FreeHead = blocks[i];
+	}
+}
+
+bool ObjectPool::GrowUnsafe() {
+	char* Slab = (char*)AcquireSlab(this);
+	if (Slab == nullptr) {
+		return false;
+	}
+
+	// Thread the free list in address order so consecutive allocations stay adjacent.
+	size_t SlotCount = OBJECT_POOL_SLAB_SIZE / SlotSize;
+	for (size_t i = 0; i < SlotCount; ++i) {
+		NextOf(Slab + i * SlotSize) = (i + 1 < SlotCount) ? (void*)(Slab + (i + 1) * SlotSize) : FreeHead;
+#if DMEMORY_OBJECT_POOL_CHECKS
+		if (SlotSize >= 2 * sizeof(void*)) {
+			MarkerOf(Slab + i * SlotSize) = OBJECT_POOL_FREE_MARKER;
+		}
+#endif
+	}
+
+	FreeHead = Slab;
+	SlabCount++;
+	return true;
+}
+
+ObjectPool* ObjectPool::FindOwner(const void* block) {
+	if (block == nullptr) {
+		return nullptr;
+	}
+
+	size_t Key = ((size_t)block >> OBJECT_POOL_SLAB_SHIFT) + 1;
+	size_t Index = PageHash(Key);
+	for (;;) {
+		size_t Stored = PageKeys[Index].load(std::memory_order_acquire);
+		if (Stored == Key) {
+			return PageOwners[Index].load(std::memory_order_relaxed);
+		}
+		if (Stored == 0) {
+			return nullptr;
+		}
+		Index = (Index + 1) & (OBJECT_POOL_PAGE_TABLE_SIZE - 1);
+	}
+}
+
+void ObjectPool::Flush() {
+	PoolMagazines* Magazines = GetMagazines();
+	if (Magazines == nullptr) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < PoolCount; ++i) {
+		Magazines->Drain(i, Magazines->Magazines[i].Count);
+	}
+}
+
+void ObjectPool::Release() {
+	Flush();
+
+	MutexGuard Registry(RegistryLock);
+	for (uint32_t i = 0; i < PoolCount; ++i) {
+		size_t Live = Pools[i]->GetLiveCount();
+		if (Live > 0) {
+			GLOG(Log::eWarn, "Object pool '%s' still has %llu live objects, slabs are kept.", Pools[i]->GetName(), (unsigned long long)Live);
+			return;
+		}
+	}
+
+	{
+		MutexGuard Guard(ProviderLock);
+		for (uint32_t i = 0; i < ChunkCount; ++i) {
+			Memory::FreeAligned(Chunks[i], OBJECT_POOL_CHUNK_SIZE + OBJECT_POOL_SLAB_SIZE, MemoryType::eMemory_Type_Entity);
+		}
+	}
+
+	Registry.Release();
+	Invalidate();
+}
+
+void ObjectPool::Invalidate() {
+	PoolGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+	MutexGuard Registry(RegistryLock);
+	for (uint32_t i = 0; i < PoolCount; ++i) {
+		Pools[i]->Lock.Lock();
+	}
+
+	{
+		MutexGuard Guard(ProviderLock);
+		for (uint32_t i = 0; i < PoolCount; ++i) {
+			Pools[i]->FreeHead = nullptr;
+			Pools[i]->SlabCount = 0;
+			Pools[i]->LiveCount.store(0, std::memory_order_relaxed);
+		}
+
+		for (size_t i = 0; i < OBJECT_POOL_PAGE_TABLE_SIZE; ++i) {
+			PageKeys[i].store(0, std::memory_order_relaxed);
+			PageOwners[i].store(nullptr, std::memory_order_relaxed);
+		}
+
+		ChunkCount = 0;
+		ChunkCursor = nullptr;
+		ChunkSlabsLeft = 0;
+	}
+
+	for (uint32_t i = PoolCount; i > 0; --i) {
+		Pools[i - 1]->Lock.UnLock();
+	}
+}
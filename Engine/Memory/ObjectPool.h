@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "Platform/Thread/DMutex.hpp"
+
+#include <atomic>
+
+#ifndef DMEMORY_OBJECT_POOL
+#define DMEMORY_OBJECT_POOL 1
+#endif
+
+#define OBJECT_POOL_SLAB_SHIFT 16						// 每个 slab 64 KiB，且按 64 KiB 对齐
+#define OBJECT_POOL_SLAB_SIZE ((size_t)1 << OBJECT_POOL_SLAB_SHIFT)
+#define OBJECT_POOL_CHUNK_SLABS 16						// 一次向全局分配器申请的 slab 数
+#define OBJECT_POOL_MAX_SLABS 16384						// 最多 1 GiB 的池化对象
+#define OBJECT_POOL_MAX_TYPES 64						// 拥有线程缓存的池数量上限
+#define OBJECT_POOL_MAGAZINE_SIZE 32					// 每个线程每个池缓存的空闲槽数
+#define OBJECT_POOL_BATCH_SIZE 16						// 与池之间批量交换的槽数
+
+// 空闲槽的第二个字写入标记，重复释放时报错而不是破坏空闲链表。槽至少要有两个指针大小
+#ifndef DMEMORY_OBJECT_POOL_CHECKS
+#ifdef LEVEL_DEBUG
+#define DMEMORY_OBJECT_POOL_CHECKS 1
+#else
+#define DMEMORY_OBJECT_POOL_CHECKS 0
+#endif
+#endif
+
+#define OBJECT_POOL_FREE_MARKER ((uintptr_t)0xF4EEF4EEF4EEF4EEull)
+
+/**
+ * @brief Fixed-size slot allocator for one object type.
+ *
+ * Slots are carved from 64 KiB slabs, so objects of the same type sit next to each other.
+ * Free slots hold the free list in their first bytes. Each thread keeps a small magazine of
+ * free slots per pool in front of the locked pool list, which makes spawning and
+ * despawning constant time and, on a magazine hit, lock-free.
+ *
+ * Slabs are aligned to OBJECT_POOL_SLAB_SIZE and registered in a page table, so FindOwner()
+ * can map any pointer back to its pool. DeleteObject relies on that to route objects deleted
+ * through a base class pointer.
+ */
+class DAPI ObjectPool {
+public:
+	ObjectPool(const char* name, size_t slot_size, size_t slot_alignment);
+
+public:
+	/**
+	 * @brief Allocates one zeroed slot.
+	 *
+	 * @return The slot, or nullptr if the type can not be pooled or memory ran out.
+	 */
+	void* Allocate();
+
+	/**
+	 * @brief Returns a slot to the pool. The object must already be destroyed.
+	 *
+	 * @param block A slot obtained from this pool.
+	 * @return False if the slot was already free (only detected with DMEMORY_OBJECT_POOL_CHECKS).
+	 */
+	bool Free(void* block);
+
+	const char* GetName() const { return Name; }
+	size_t GetSlotSize() const { return SlotSize; }
+	size_t GetSlabCount() const { return SlabCount; }
+	size_t GetLiveCount() const { return LiveCount.load(std::memory_order_relaxed); }
+
+public:
+	/**
+	 * @brief Finds the pool a pointer was allocated from.
+	 *
+	 * @param block Any pointer.
+	 * @return The owning pool, or nullptr if the pointer is not a pooled slot.
+	 */
+	static ObjectPool* FindOwner(const void* block);
+
+	/**
+	 * @brief Moves every slot cached by the calling thread back to its pool.
+	 * Called automatically when a thread exits.
+	 */
+	static void Flush();
+
+	/**
+	 * @brief Hands all slabs back to the DynamicAllocator if no pooled object is alive.
+	 */
+	static void Release();
+
+	/**
+	 * @brief Forgets every slab without freeing it. Must be called when the
+	 * DynamicAllocator arena is recreated.
+	 */
+	static void Invalidate();
+
+private:
+	friend struct PoolMagazines;
+
+	// 以下函数在持有 Lock 时调用
+	uint32_t PopBatch(void** out_blocks, uint32_t count);
+	void PushBatch(void** blocks, uint32_t count);
+	bool GrowUnsafe();
+
+private:
+	const char* Name;
+	size_t SlotSize;
+	uint32_t Index;
+
+	Mutex Lock;			// 在全局注册表锁之后、slab 提供者锁之前获取，见 ObjectPool.cpp
+	void* FreeHead;
+	size_t SlabCount;
+	std::atomic<size_t> LiveCount;
+};
+
+/**
+ * @brief Marks which types NewObject allocates from an ObjectPool. Use DECLARE_OBJECT_POOL
+ * right after the class definition.
+ */
+template<typename T>
+struct TObjectPoolTraits {
+	static constexpr bool Pooled = false;
+};
+
+#define DECLARE_OBJECT_POOL(Type)													\
+	template<> struct TObjectPoolTraits<Type> {										\
+		static constexpr bool Pooled = true;										\
+		static ObjectPool& Get() {													\
+			static ObjectPool Pool(#Type, sizeof(Type), alignof(Type));				\
+			return Pool;															\
+		}																			\
+	};
@@ -0,0 +1,121 @@
+﻿#define LOG_CATEGORY Log::Category::eMemory
+
+#include "ScratchAllocator.h"
+
+#include "Core/EngineLogger.hpp"
+#include "Platform/Platform.hpp"
+
+struct ScratchStack {
+	char* MemoryBlock = nullptr;
+	size_t Top = 0;
+	size_t CommittedSize = 0;
+	size_t PeakSize = 0;
+	uint32_t ScopeDepth = 0;
+
+	~ScratchStack() {
+		// Runs at thread exit.
+		if (MemoryBlock != nullptr) {
+			Platform::PlatformReleaseMemory(MemoryBlock, SCRATCH_ALLOCATOR_RESERVE_SIZE);
+		}
+	}
+};
+
+static thread_local ScratchStack Stack;
+
+void* ScratchAllocator::Allocate(size_t size, size_t alignment) {
+	if (alignment == 0) {
+		GLOG(Log::eError, "ScratchAllocator::Allocate() requires a valid alignment.");
+		return nullptr;
+	}
+
+	if (Stack.MemoryBlock == nullptr) {
+		Stack.MemoryBlock = (char*)Platform::PlatformReserveMemory(SCRATCH_ALLOCATOR_RESERVE_SIZE, eHuge_Page_None);
+		if (Stack.MemoryBlock == nullptr) {
+			GLOG(Log::eFatal, "ScratchAllocator::Allocate() Cannot reserve the scratch stack of this thread.");
+			return nullptr;
+		}
+	}
+
+#ifdef LEVEL_DEBUG
+	if (Stack.ScopeDepth == 0) {
+		GLOG(Log::eWarn, "ScratchAllocator::Allocate() called outside of a ScratchScope, the block is never released.");
+	}
+#endif
+
+	size_t Aligned = PaddingAligned((size_t)Stack.MemoryBlock + Stack.Top, alignment) - (size_t)Stack.MemoryBlock;
+	size_t End = Aligned + size;
+	if (End > SCRATCH_ALLOCATOR_RESERVE_SIZE) {
+		GLOG(Log::eError, "ScratchAllocator::Allocate() Scratch stack exhausted, %llu of %llu bytes in use, %llu requested.",
+			(unsigned long long)Stack.Top, (unsigned long long)SCRATCH_ALLOCATOR_RESERVE_SIZE, (unsigned long long)size);
+		return nullptr;
+	}
+
+	if (End > Stack.CommittedSize) {
+		size_t NewCommittedSize = DMIN(PaddingAligned(End, SCRATCH_ALLOCATOR_COMMIT_GRANULE), (size_t)SCRATCH_ALLOCATOR_RESERVE_SIZE);
+		if (!Platform::PlatformCommitMemory(Stack.MemoryBlock + Stack.CommittedSize, NewCommittedSize - Stack.CommittedSize)) {
+			GLOG(Log::eError, "ScratchAllocator::Allocate() Cannot commit %llu bytes.", (unsigned long long)(NewCommittedSize - Stack.CommittedSize));
+			return nullptr;
+		}
+		Stack.CommittedSize = NewCommittedSize;
+	}
+
+	Stack.Top = End;
+	if (End > Stack.PeakSize) {
+		Stack.PeakSize = End;
+	}
+
+	return Stack.MemoryBlock + Aligned;
+}
+
+void ScratchAllocator::Free(void* block, size_t size) {
+	if (block == nullptr) {
+		return;
+	}
+
+	if ((char*)block + size == Stack.MemoryBlock + Stack.Top) {
+		FreeToMarker((char*)block - Stack.MemoryBlock);
+	}
+}
+
+size_t ScratchAllocator::GetMarker() {
+	return Stack.Top;
+}
+
+void ScratchAllocator::FreeToMarker(size_t marker) {
+	if (marker > Stack.Top) {
+		GLOG(Log::eError, "ScratchAllocator::FreeToMarker() marker %llu is above the top %llu.", (unsigned long long)marker, (unsigned long long)Stack.Top);
+		return;
+	}
+
+#ifdef LEVEL_DEBUG
+	// Make reads through stale pointers obvious.
+	Platform::PlatformSetMemory(Stack.MemoryBlock + marker, SCRATCH_ALLOCATOR_POISON, Stack.Top - marker);
+#endif
+
+	Stack.Top = marker;
+}
+
+size_t ScratchAllocator::GetCommittedSize() {
+	return Stack.CommittedSize;
+}
+
+size_t ScratchAllocator::GetPeakSize() {
+	return Stack.PeakSize;
+}
+
+size_t ScratchAllocator::PushScope() {
+	Stack.ScopeDepth++;
+	return Stack.Top;
+}
+
+void ScratchAllocator::PopScope(size_t marker) {
+	FreeToMarker(marker);
+	Stack.ScopeDepth--;
+
+	// A large import should not keep its peak committed for the rest of the thread's life.
+	size_t Keep = DMAX(PaddingAligned(Stack.Top, SCRATCH_ALLOCATOR_COMMIT_GRANULE), (size_t)SCRATCH_ALLOCATOR_RETAIN_SIZE);
+	if (Stack.ScopeDepth == 0 && Stack.CommittedSize > Keep) {
+		Platform::PlatformDecommitMemory(Stack.MemoryBlock + Keep, Stack.CommittedSize - Keep);
+		Stack.CommittedSize = Keep;
+	}
+}
@@ -0,0 +1,143 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#define SCRATCH_ALLOCATOR_RESERVE_SIZE GIBIBYTES(1)		// 每个线程预留的地址空间，只在使用时提交
+#define SCRATCH_ALLOCATOR_COMMIT_GRANULE KIBIBYTES(64)
+#define SCRATCH_ALLOCATOR_RETAIN_SIZE MEBIBYTES(4)		// 最外层作用域结束后保留的已提交内存
+#define SCRATCH_ALLOCATOR_POISON 0xDB					// 调试模式下回收内存的填充值
+
+/**
+ * @brief Thread-local stack of scratch memory for temporaries of loaders and import passes.
+ *
+ * Each thread reserves its own range of address space on first use and commits it as the
+ * top grows. Allocation bumps the top; a ScratchScope records the top on entry and resets it
+ * on exit, so everything allocated inside the scope is released in one pointer reset without
+ * touching the global arena. Destructors are not run, objects that need them must be
+ * destroyed before their scope ends.
+ *
+ * Scratch memory must not outlive the scope that allocated it, and only the owning thread may
+ * allocate or free it. Other threads may read and write blocks while the owner is blocked
+ * waiting for them, e.g. the helpers of a JobSystem::ParallelFor issued inside the scope.
+ */
+class DAPI ScratchAllocator {
+public:
+	/**
+	 * @brief Allocates memory from the calling thread's scratch stack. The memory is not zeroed.
+	 *
+	 * @param size The size in bytes to be allocated.
+	 * @param alignment The alignment, must be a power of two.
+	 * @return The allocated block of memory unless this operation fails, then nullptr.
+	 */
+	static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/**
+	 * @brief Releases a block if it is the topmost allocation, otherwise it stays until its scope ends.
+	 */
+	static void Free(void* block, size_t size);
+
+	/**
+	 * @brief Obtains the current top of the calling thread's stack.
+	 */
+	static size_t GetMarker();
+
+	/**
+	 * @brief Releases every allocation made after the marker was taken.
+	 */
+	static void FreeToMarker(size_t marker);
+
+	/**
+	 * @brief Obtains the amount of scratch memory in use on the calling thread.
+	 */
+	static size_t GetUsedSize() { return GetMarker(); }
+
+	/**
+	 * @brief Obtains the amount of scratch memory committed on the calling thread.
+	 */
+	static size_t GetCommittedSize();
+
+	/**
+	 * @brief Obtains the highest usage of the calling thread so far.
+	 */
+	static size_t GetPeakSize();
+
+	template<typename T>
+	static T* NewArray(size_t count) {
+		static_assert(std::is_trivially_destructible<T>::value, "Scratch arrays are never destroyed, T must be trivially destructible.");
+		return (T*)Allocate(sizeof(T) * count, alignof(T));
+	}
+
+private:
+	friend class ScratchScope;
+
+	static size_t PushScope();
+	static void PopScope(size_t marker);
+};
+
+/**
+ * @brief Releases all scratch memory allocated by the calling thread during its lifetime.
+ *
+ * Containers using TScratchAllocator must be declared after the scope, so they are
+ * destroyed before it resets the stack.
+ */
+class ScratchScope {
+public:
+	ScratchScope() : Marker(ScratchAllocator::PushScope()) {}
+	~ScratchScope() { ScratchAllocator::PopScope(Marker); }
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+	size_t Marker;
+};
+
+/**
+ * @brief STL allocator adapter over ScratchAllocator.
+ *
+ * Deallocation only gives memory back when it is the topmost block, which covers the
+ * common reserve-then-fill and last-in-first-out patterns; the rest goes with the scope.
+ */
+template<typename T>
+class TScratchAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::true_type;
+
+	TScratchAllocator() noexcept {}
+	template<typename U>
+	TScratchAllocator(const TScratchAllocator<U>&) noexcept {}
+
+	T* allocate(size_t n) {
+		T* Block = (T*)ScratchAllocator::Allocate(sizeof(T) * n, alignof(T));
+		if (Block == nullptr) {
+			throw std::bad_alloc();
+		}
+		return Block;
+	}
+
+	void deallocate(T* block, size_t n) noexcept {
+		ScratchAllocator::Free(block, sizeof(T) * n);
+	}
+
+	template<typename U>
+	bool operator==(const TScratchAllocator<U>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const TScratchAllocator<U>&) const noexcept { return false; }
+};
+
+template<typename T>
+using TScratchVector = std::vector<T, TScratchAllocator<T>>;
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using TScratchMap = std::unordered_map<Key, Value, Hash, KeyEqual, TScratchAllocator<std::pair<const Key, Value>>>;
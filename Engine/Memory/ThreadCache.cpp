@@ -0,0 +1,257 @@
+﻿#include "ThreadCache.h"
+
+#include "Core/DMemory.hpp"
+#include "Memory/DynamicAllocator.h"
+#include "Platform/Thread/DMutex.hpp"
+
+#include <atomic>
+
+// 共享层：每个尺寸等级一条侵入式单链表，next 指针存放在空闲块的首字节
+struct CentralList {
+	Mutex Lock;
+	void* Head = nullptr;
+	uint32_t Count = 0;
+};
+
+static CentralList CentralLists[THREAD_CACHE_CLASS_COUNT];
+
+// 分配器重建时递增，线程缓存据此丢弃指向旧内存池的块
+static std::atomic<uint32_t> CacheGeneration{ 0 };
+
+static inline void*& NextOf(void* block) {
+	return *(void**)block;
+}
+
+static inline uint32_t ClassIndex(size_t size) {
+	uint32_t Index = 0;
+	size_t ClassSize = (size_t)1 << THREAD_CACHE_MIN_CLASS_SHIFT;
+	while (ClassSize < size) {
+		ClassSize <<= 1;
+		Index++;
+	}
+	return Index;
+}
+
+static inline size_t ClassSizeOf(uint32_t index) {
+	return (size_t)1 << (THREAD_CACHE_MIN_CLASS_SHIFT + index);
+}
+
+// Hands a chain of blocks back to the dynamic allocator under a single lock.
+static void ReleaseChain(void* head) {
+	if (head == nullptr) {
+		return;
+	}
+
+	MutexGuard Guard(Memory::AllocationMutex);
+	while (head != nullptr) {
+		void* Next = NextOf(head);
+		DynamicAllocator::Get().FreeAligned(head);
+		head = Next;
+	}
+}
+
+// Pushes a chain onto the central list and trims the list if it grew past its limit.
+static void PushCentral(uint32_t index, void* head, void* tail, uint32_t count) {
+	CentralList& List = CentralLists[index];
+	void* Surplus = nullptr;
+	{
+		MutexGuard Guard(List.Lock);
+		NextOf(tail) = List.Head;
+		List.Head = head;
+		List.Count += count;
+
+		if (List.Count > THREAD_CACHE_CENTRAL_LIMIT) {
+			// Detach one batch; it is freed outside the central lock.
+			Surplus = List.Head;
+			void* Last = Surplus;
+			for (uint32_t i = 1; i < THREAD_CACHE_BATCH_SIZE; ++i) {
+				Last = NextOf(Last);
+			}
+			List.Head = NextOf(Last);
+			NextOf(Last) = nullptr;
+			List.Count -= THREAD_CACHE_BATCH_SIZE;
+		}
+	}
+
+	ReleaseChain(Surplus);
+}
+
+struct ThreadMagazines {
+	struct Magazine {
+		uint32_t Count = 0;
+		void* Blocks[THREAD_CACHE_MAGAZINE_SIZE];
+	};
+
+	ThreadMagazines() : Generation(CacheGeneration.load(std::memory_order_acquire)) {}
+	~ThreadMagazines();
+
+	// Moves the oldest `count` blocks of a magazine to the central list.
+	void Drain(uint32_t index, uint32_t count) {
+		Magazine& Mag = Magazines[index];
+		if (count > Mag.Count) count = Mag.Count;
+		if (count == 0) return;
+
+		for (uint32_t i = 0; i + 1 < count; ++i) {
+			NextOf(Mag.Blocks[i]) = Mag.Blocks[i + 1];
+		}
+		PushCentral(index, Mag.Blocks[0], Mag.Blocks[count - 1], count);
+
+		Mag.Count -= count;
+		for (uint32_t i = 0; i < Mag.Count; ++i) {
+			Mag.Blocks[i] = Mag.Blocks[i + count];
+		}
+	}
+
+	void Refill(uint32_t index) {
+		Magazine& Mag = Magazines[index];
+
+		// 先从共享层批量取
+		CentralList& List = CentralLists[index];
+		{
+			MutexGuard Guard(List.Lock);
+			while (List.Head != nullptr && Mag.Count < THREAD_CACHE_BATCH_SIZE) {
+				Mag.Blocks[Mag.Count++] = List.Head;
+				List.Head = NextOf(List.Head);
+				List.Count--;
+			}
+		}
+
+		if (Mag.Count > 0) {
+			return;
+		}
+
+		// 共享层为空时再向全局分配器批量申请
+		size_t ClassSize = ClassSizeOf(index);
+		MutexGuard Guard(Memory::AllocationMutex);
+		while (Mag.Count < THREAD_CACHE_BATCH_SIZE) {
+			void* Block = DynamicAllocator::Get().AllocateAligned(ClassSize, DEFAULT_ALIGNMENT_SIZE);
+			if (Block == nullptr) {
+				break;
+			}
+			Mag.Blocks[Mag.Count++] = Block;
+		}
+	}
+
+	// Drops every block if the arena was recreated since the last access.
+	void Validate() {
+		uint32_t Current = CacheGeneration.load(std::memory_order_acquire);
+		if (Generation != Current) {
+			for (uint32_t i = 0; i < THREAD_CACHE_CLASS_COUNT; ++i) {
+				Magazines[i].Count = 0;
+			}
+			Generation = Current;
+		}
+	}
+
+	Magazine Magazines[THREAD_CACHE_CLASS_COUNT];
+	uint32_t Generation;
+};
+
+// 线程退出后缓存对象已析构，此后的请求直接走全局分配器
+static thread_local bool ThreadCacheRetired = false;
+static thread_local ThreadMagazines LocalMagazines;
+
+ThreadMagazines::~ThreadMagazines() {
+	Validate();
+	for (uint32_t i = 0; i < THREAD_CACHE_CLASS_COUNT; ++i) {
+		Drain(i, Magazines[i].Count);
+	}
+	ThreadCacheRetired = true;
+}
+
+static inline ThreadMagazines* GetMagazines() {
+	if (ThreadCacheRetired) {
+		return nullptr;
+	}
+
+	ThreadMagazines* Magazines = &LocalMagazines;
+	Magazines->Validate();
+	return Magazines;
+}
+
+bool ThreadCache::CanServe(size_t size, size_t alignment) {
+	return size > 0 && size <= THREAD_CACHE_MAX_SIZE && alignment == DEFAULT_ALIGNMENT_SIZE;
+}
+
+bool ThreadCache::IsCachedBlock(size_t block_size, size_t alignment) {
+	return alignment == DEFAULT_ALIGNMENT_SIZE && CanServe(block_size, alignment) &&
+		ClassSizeOf(ClassIndex(block_size)) == block_size;
+}
+
+size_t ThreadCache::GetClassSize(size_t size) {
+	return ClassSizeOf(ClassIndex(size));
+}
+
+void* ThreadCache::Allocate(size_t size) {
+	uint32_t Index = ClassIndex(size);
+	ThreadMagazines* Magazines = GetMagazines();
+	if (Magazines == nullptr) {
+		MutexGuard Guard(Memory::AllocationMutex);
+		return DynamicAllocator::Get().AllocateAligned(ClassSizeOf(Index), DEFAULT_ALIGNMENT_SIZE);
+	}
+
+	ThreadMagazines::Magazine& Mag = Magazines->Magazines[Index];
+	if (Mag.Count == 0) {
+		Magazines->Refill(Index);
+		if (Mag.Count == 0) {
+			return nullptr;
+		}
+	}
+
+	return Mag.Blocks[--Mag.Count];
+}
+
+void ThreadCache::Free(void* block, size_t block_size) {
+	uint32_t Index = ClassIndex(block_size);
+	ThreadMagazines* Magazines = GetMagazines();
+	if (Magazines == nullptr) {
+		MutexGuard Guard(Memory::AllocationMutex);
+		DynamicAllocator::Get().FreeAligned(block);
+		return;
+	}
+
+	ThreadMagazines::Magazine& Mag = Magazines->Magazines[Index];
+	if (Mag.Count == THREAD_CACHE_MAGAZINE_SIZE) {
+		Magazines->Drain(Index, THREAD_CACHE_BATCH_SIZE);
+	}
+
+	Mag.Blocks[Mag.Count++] = block;
+}
+
+void ThreadCache::Flush() {
+	ThreadMagazines* Magazines = GetMagazines();
+	if (Magazines == nullptr) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < THREAD_CACHE_CLASS_COUNT; ++i) {
+		Magazines->Drain(i, Magazines->Magazines[i].Count);
+	}
+}
+
+void ThreadCache::Release() {
+	Flush();
+
+	for (uint32_t i = 0; i < THREAD_CACHE_CLASS_COUNT; ++i) {
+		CentralList& List = CentralLists[i];
+		void* Chain = nullptr;
+		{
+			MutexGuard Guard(List.Lock);
+			Chain = List.Head;
+			List.Head = nullptr;
+			List.Count = 0;
+		}
+		ReleaseChain(Chain);
+	}
+}
+
+void ThreadCache::Invalidate() {
+	CacheGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+	for (uint32_t i = 0; i < THREAD_CACHE_CLASS_COUNT; ++i) {
+		CentralList& List = CentralLists[i];
+		MutexGuard Guard(List.Lock);
+		List.Head = nullptr;
+		List.Count = 0;
+	}
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+
+#ifndef DMEMORY_THREAD_CACHE
+#define DMEMORY_THREAD_CACHE 1
+#endif
+
+#define THREAD_CACHE_MIN_CLASS_SHIFT 4			// 最小尺寸等级 16 字节
+#define THREAD_CACHE_CLASS_COUNT 7				// 16, 32, 64, 128, 256, 512, 1024
+#define THREAD_CACHE_MAX_SIZE (1 << (THREAD_CACHE_MIN_CLASS_SHIFT + THREAD_CACHE_CLASS_COUNT - 1))
+#define THREAD_CACHE_MAGAZINE_SIZE 64			// 每个线程每个尺寸等级缓存的块数
+#define THREAD_CACHE_BATCH_SIZE 32				// 与共享层之间批量交换的块数
+#define THREAD_CACHE_CENTRAL_LIMIT 1024			// 共享层每个尺寸等级最多保留的块数
+
+/**
+ * @brief Small-block front end for Memory::AllocateAligned / Memory::FreeAligned.
+ *
+ * Every thread owns one magazine per size class. Allocations and frees that hit the
+ * magazine never take a lock. Empty magazines are refilled and full magazines are drained
+ * in batches of THREAD_CACHE_BATCH_SIZE through a per-class central list, and the central
+ * list hands surplus blocks back to the DynamicAllocator in batches as well.
+ *
+ * Cached blocks are ordinary DynamicAllocator blocks whose size is exactly a class size and
+ * whose alignment is DEFAULT_ALIGNMENT_SIZE, so they can always be freed straight into the
+ * DynamicAllocator when the cache is unavailable (e.g. during thread teardown).
+ */
+class DAPI ThreadCache {
+public:
+	/**
+	 * @brief Checks whether a request can be served by the thread cache.
+	 *
+	 * @param size The requested size in bytes.
+	 * @param alignment The requested alignment.
+	 * @return True if the request falls into one of the size classes.
+	 */
+	static bool CanServe(size_t size, size_t alignment);
+
+	/**
+	 * @brief Checks whether a live block was handed out by the thread cache.
+	 *
+	 * @param block_size The block size stored by the DynamicAllocator.
+	 * @param alignment The block alignment stored by the DynamicAllocator.
+	 * @return True if the block belongs to one of the size classes.
+	 */
+	static bool IsCachedBlock(size_t block_size, size_t alignment);
+
+	/**
+	 * @brief Rounds the requested size up to its size class.
+	 */
+	static size_t GetClassSize(size_t size);
+
+	/**
+	 * @brief Allocates a block of GetClassSize(size) bytes from the calling thread's magazine.
+	 *
+	 * @param size The requested size in bytes. Must satisfy CanServe().
+	 * @return The block, or nullptr if the shared allocator is exhausted.
+	 */
+	static void* Allocate(size_t size);
+
+	/**
+	 * @brief Returns a cached block to the calling thread's magazine.
+	 *
+	 * @param block The block to be freed.
+	 * @param block_size The class size of the block.
+	 */
+	static void Free(void* block, size_t block_size);
+
+	/**
+	 * @brief Moves every block held by the calling thread back to the central lists.
+	 * Called automatically when a thread exits.
+	 */
+	static void Flush();
+
+	/**
+	 * @brief Flushes the calling thread and hands every centrally held block back to the DynamicAllocator.
+	 */
+	static void Release();
+
+	/**
+	 * @brief Forgets every cached block without freeing it. Must be called when the
+	 * DynamicAllocator arena is recreated, since cached pointers refer to the old arena.
+	 */
+	static void Invalidate();
+};
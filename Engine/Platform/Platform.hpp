@@ -6,6 +6,21 @@ struct SPlatformState{
 	void* internalState = nullptr;
 };
 
+enum HugePageMode {
+	eHuge_Page_None,					// Regular pages only
+	eHuge_Page_Transparent,				// Let the kernel back the range with transparent huge pages where it can
+	eHuge_Page_Explicit					// Take pages from the explicit huge page pool, falls back to regular pages
+};
+
+// One logical processor as reported by the OS.
+struct PlatformProcessor {
+	uint32_t index = 0;					// Logical processor number, as taken by Thread::SetCurrentAffinity
+	uint32_t core = 0;					// Physical core, unique across packages
+	uint32_t package = 0;
+	uint32_t numa_node = 0;
+	uint32_t smt_index = 0;				// 0 for the first hardware thread of its core, 1 for its SMT sibling, ...
+};
+
 class DAPI Platform {
 public:
 	Platform() {};
@@ -24,6 +39,16 @@ public:
 	static void* PlatformCopyMemory(void* dst, const void* src, size_t size);
 	static void* PlatformSetMemory(void* dst, int val, size_t size);
 
+	// Virtual memory. A reserved range only takes address space; pages are backed once
+	// committed and given back to the system by decommitting them.
+	// out_backing receives what the range actually got: eHuge_Page_Explicit ranges are committed
+	// up front and must not be committed or decommitted, eHuge_Page_None means regular pages.
+	static size_t PlatformGetPageSize();
+	static void* PlatformReserveMemory(size_t size, HugePageMode huge_pages, HugePageMode* out_backing = nullptr);
+	static bool PlatformCommitMemory(void* block, size_t size);
+	static void PlatformDecommitMemory(void* block, size_t size);
+	static void PlatformReleaseMemory(void* block, size_t size);
+
 	static void PlatformConsoleWrite(const char* message, unsigned char color);
 	static void PlatformConsoleWriteError(const char* message, unsigned char color);
 
@@ -33,6 +58,11 @@ public:
 
 	static int GetProcessorCount();
 
+	// Fills up to max_count logical processors the process may run on, ordered by index, and
+	// returns how many there are. Platforms without topology information report one core per
+	// logical processor on a single node.
+	static uint32_t GetProcessorTopology(PlatformProcessor* out_processors, uint32_t max_count);
+
 	static void SetLogo(void* WindowHandle, const std::string& IconPath);
 };
 
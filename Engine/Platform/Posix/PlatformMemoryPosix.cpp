@@ -0,0 +1,75 @@
+﻿#include "Platform/Platform.hpp"
+
+#if defined(DPLATFORM_LINUX) || defined(DPLATFORM_APPLE)
+
+#include "Core/EngineLogger.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+#define HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+size_t Platform::PlatformGetPageSize() {
+	return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+void* Platform::PlatformReserveMemory(size_t size, HugePageMode huge_pages, HugePageMode* out_backing) {
+	HugePageMode Backing = eHuge_Page_None;
+
+#if defined(DPLATFORM_LINUX) && defined(MAP_HUGETLB)
+	if (huge_pages == eHuge_Page_Explicit) {
+		// Pages come from the hugetlbfs pool (vm.nr_hugepages). No MAP_NORESERVE, so an empty pool
+		// fails here instead of raising SIGBUS on first touch.
+		void* Block = mmap(nullptr, PaddingAligned(size, HUGE_PAGE_SIZE), PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (Block != MAP_FAILED) {
+			if (out_backing != nullptr) *out_backing = eHuge_Page_Explicit;
+			return Block;
+		}
+		GLOG(Log::eWarn, "Explicit huge pages are not available, using regular pages.");
+	}
+#endif
+
+	void* Block = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (Block == MAP_FAILED) {
+		return nullptr;
+	}
+
+#if defined(DPLATFORM_LINUX) && defined(MADV_HUGEPAGE)
+	if (huge_pages != eHuge_Page_None) {
+		// Only a hint; ignored when THP is disabled.
+		madvise(Block, size, MADV_HUGEPAGE);
+		Backing = eHuge_Page_Transparent;
+	}
+#else
+	(void)huge_pages;
+#endif
+
+	if (out_backing != nullptr) *out_backing = Backing;
+	return Block;
+}
+
+bool Platform::PlatformCommitMemory(void* block, size_t size) {
+	// Physical pages are still only assigned on first touch.
+	return mprotect(block, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void Platform::PlatformDecommitMemory(void* block, size_t size) {
+#if defined(DPLATFORM_LINUX)
+	madvise(block, size, MADV_DONTNEED);
+	mprotect(block, size, PROT_NONE);
+#else
+	// MADV_DONTNEED does not release pages here, so map fresh ones over the range instead.
+	mmap(block, size, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+#endif
+}
+
+void Platform::PlatformReleaseMemory(void* block, size_t size) {
+	munmap(block, size);
+}
+
+#endif	// DPLATFORM_LINUX || DPLATFORM_APPLE
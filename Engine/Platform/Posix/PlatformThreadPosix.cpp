@@ -0,0 +1,212 @@
+﻿#include "Platform/Platform.hpp"
+#include "Platform/Thread/DThread.hpp"
+
+#if defined(DPLATFORM_LINUX) || defined(DPLATFORM_APPLE)
+
+#include "Core/EngineLogger.hpp"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+#if defined(DPLATFORM_LINUX)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#elif defined(DPLATFORM_APPLE)
+#include <pthread/qos.h>
+#include <sys/sysctl.h>
+#endif
+
+#define POSIX_THREAD_NAME_LENGTH 16			// Linux 的线程名最多 15 个字符加结尾的 0
+#define POSIX_LOW_PRIORITY_NICE 10			// 后台线程的 nice 值
+
+#if defined(DPLATFORM_LINUX)
+// Reads the first integer of a sysfs file, or returns the fallback.
+static int ReadSysfsInt(const char* path, int fallback) {
+	FILE* File = fopen(path, "r");
+	if (File == nullptr) {
+		return fallback;
+	}
+
+	int Value = fallback;
+	if (fscanf(File, "%d", &Value) != 1) {
+		Value = fallback;
+	}
+	fclose(File);
+	return Value;
+}
+
+// Reads a sysfs list such as "0-7,16-23", used for both processor and node numbers.
+static std::vector<int> ReadSysfsList(const char* path) {
+	std::vector<int> Values;
+	FILE* File = fopen(path, "r");
+	if (File == nullptr) {
+		return Values;
+	}
+
+	int First = 0;
+	while (fscanf(File, "%d", &First) == 1) {
+		int Last = First;
+		int Separator = fgetc(File);
+		if (Separator == '-') {
+			if (fscanf(File, "%d", &Last) != 1) {
+				break;
+			}
+			Separator = fgetc(File);
+		}
+		for (int Value = First; Value <= Last; ++Value) {
+			Values.push_back(Value);
+		}
+		if (Separator != ',') {
+			break;
+		}
+	}
+	fclose(File);
+	return Values;
+}
+#endif
+
+uint32_t Platform::GetProcessorTopology(PlatformProcessor* out_processors, uint32_t max_count) {
+	std::vector<PlatformProcessor> Processors;
+
+#if defined(DPLATFORM_LINUX)
+	const long Configured = sysconf(_SC_NPROCESSORS_CONF);
+	const int CpuCount = Configured > 0 ? (int)Configured : 1;
+
+	// Only processors the process may run on, so containers and taskset are respected.
+	cpu_set_t Allowed;
+	CPU_ZERO(&Allowed);
+	const bool HasMask = sched_getaffinity(0, sizeof(Allowed), &Allowed) == 0;
+
+	// Node ids can be sparse (node0 and node2 on some dual-socket boards), so take them from the
+	// online list instead of probing nodeN until one is missing. Without NUMA everything is node 0.
+	std::vector<int> CpuNodes(CpuCount, 0);
+	char Path[128];
+	for (int Node : ReadSysfsList("/sys/devices/system/node/online")) {
+		snprintf(Path, sizeof(Path), "/sys/devices/system/node/node%d/cpulist", Node);
+		for (int Cpu : ReadSysfsList(Path)) {
+			if (Cpu >= 0 && Cpu < CpuCount) {
+				CpuNodes[Cpu] = Node;
+			}
+		}
+	}
+
+	// (package, core_id) -> dense core number, and how many hardware threads each core has so far.
+	std::map<std::pair<int, int>, std::pair<uint32_t, uint32_t>> Cores;
+	for (int Cpu = 0; Cpu < CpuCount && Cpu < CPU_SETSIZE; ++Cpu) {
+		if (HasMask && !CPU_ISSET(Cpu, &Allowed)) {
+			continue;
+		}
+
+		snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", Cpu);
+		const int Package = ReadSysfsInt(Path, 0);
+		snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%d/topology/core_id", Cpu);
+		const int CoreId = ReadSysfsInt(Path, Cpu);
+
+		auto Found = Cores.find({ Package, CoreId });
+		if (Found == Cores.end()) {
+			Found = Cores.emplace(std::make_pair(Package, CoreId), std::make_pair((uint32_t)Cores.size(), 0u)).first;
+		}
+
+		PlatformProcessor Processor;
+		Processor.index = (uint32_t)Cpu;
+		Processor.core = Found->second.first;
+		Processor.package = (uint32_t)(Package > 0 ? Package : 0);
+		Processor.numa_node = (uint32_t)CpuNodes[Cpu];
+		Processor.smt_index = Found->second.second++;
+		Processors.push_back(Processor);
+	}
+#elif defined(DPLATFORM_APPLE)
+	// macOS does not expose which logical processors share a core; assume siblings follow the
+	// physical cores, which matches how Intel Macs enumerate them. Apple silicon has no SMT.
+	int Logical = 0;
+	int Physical = 0;
+	size_t Size = sizeof(int);
+	if (sysctlbyname("hw.logicalcpu", &Logical, &Size, nullptr, 0) != 0 || Logical <= 0) {
+		Logical = GetProcessorCount();
+	}
+	Size = sizeof(int);
+	if (sysctlbyname("hw.physicalcpu", &Physical, &Size, nullptr, 0) != 0 || Physical <= 0) {
+		Physical = Logical;
+	}
+
+	for (int Cpu = 0; Cpu < Logical; ++Cpu) {
+		PlatformProcessor Processor;
+		Processor.index = (uint32_t)Cpu;
+		Processor.core = (uint32_t)(Cpu % Physical);
+		Processor.smt_index = (uint32_t)(Cpu / Physical);
+		Processors.push_back(Processor);
+	}
+#endif
+
+	for (uint32_t i = 0; i < (uint32_t)Processors.size() && i < max_count; ++i) {
+		out_processors[i] = Processors[i];
+	}
+	return (uint32_t)Processors.size();
+}
+
+bool Thread::SetCurrentAffinity(uint32_t processor) {
+#if defined(DPLATFORM_LINUX)
+	if (processor >= CPU_SETSIZE) {
+		return false;
+	}
+
+	cpu_set_t Set;
+	CPU_ZERO(&Set);
+	CPU_SET(processor, &Set);
+	const int Result = pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set);
+	if (Result != 0) {
+		GLOG(Log::eWarn, "pthread_setaffinity_np failed for processor %u (error %d).", processor, Result);
+		return false;
+	}
+	return true;
+#else
+	// macOS only takes affinity tags as hints and has no way to pin a thread.
+	(void)processor;
+	return false;
+#endif
+}
+
+bool Thread::SetCurrentPriority(ThreadPriority priority) {
+#if defined(DPLATFORM_LINUX)
+	// Linux applies nice values per thread.
+	int Nice = 0;
+	switch (priority) {
+	case ThreadPriority::eLow: Nice = POSIX_LOW_PRIORITY_NICE; break;
+	case ThreadPriority::eNormal: Nice = 0; break;
+	case ThreadPriority::eHigh: Nice = -5; break;
+	}
+	return setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), Nice) == 0;
+#else
+	qos_class_t Class = QOS_CLASS_DEFAULT;
+	switch (priority) {
+	case ThreadPriority::eLow: Class = QOS_CLASS_UTILITY; break;
+	case ThreadPriority::eNormal: Class = QOS_CLASS_DEFAULT; break;
+	case ThreadPriority::eHigh: Class = QOS_CLASS_USER_INITIATED; break;
+	}
+	return pthread_set_qos_class_self_np(Class, 0) == 0;
+#endif
+}
+
+void Thread::SetCurrentName(const char* name) {
+	if (name == nullptr) {
+		return;
+	}
+
+#if defined(DPLATFORM_LINUX)
+	char Truncated[POSIX_THREAD_NAME_LENGTH];
+	strncpy(Truncated, name, sizeof(Truncated) - 1);
+	Truncated[sizeof(Truncated) - 1] = '\0';
+	pthread_setname_np(pthread_self(), Truncated);
+#else
+	pthread_setname_np(name);
+#endif
+}
+
+#endif
@@ -4,6 +4,12 @@
 
 typedef unsigned int(*PFN_thread_start)(void*);
 
+enum class ThreadPriority {
+	eLow,
+	eNormal,
+	eHigh
+};
+
 /**
  * Represents a process thread in the system to be used for work.
  * Generally should not be created directly in user code.
@@ -51,6 +57,25 @@ public:
 
 	static size_t GetThreadID();
 
+	/**
+	 * Pins the calling thread to one logical processor (see PlatformProcessor::index).
+	 * @return False if the platform does not support affinity or the call failed.
+	 */
+	static bool SetCurrentAffinity(uint32_t processor);
+
+	/**
+	 * Changes the OS scheduling priority of the calling thread. Raising the priority may
+	 * need privileges the process does not have.
+	 * @return True on success.
+	 */
+	static bool SetCurrentPriority(ThreadPriority priority);
+
+	/**
+	 * Names the calling thread so debuggers and profilers can show it. Some platforms
+	 * truncate long names (Linux keeps 15 characters).
+	 */
+	static void SetCurrentName(const char* name);
+
 public:
 	size_t ThreadID;
 	void* InternalData;
@@ -80,6 +80,41 @@ void Thread::Sleep(size_t ms) {
 size_t Thread::GetThreadID() {
 	return (size_t)GetCurrentThreadId();
 }
+
+bool Thread::SetCurrentAffinity(uint32_t processor) {
+	GROUP_AFFINITY Affinity = {};
+	Affinity.Group = (WORD)(processor / 64);
+	Affinity.Mask = (KAFFINITY)1 << (processor % 64);
+	if (!SetThreadGroupAffinity(GetCurrentThread(), &Affinity, nullptr)) {
+		GLOG(Log::eWarn, "SetThreadGroupAffinity failed for processor %u (error %lu).", processor, GetLastError());
+		return false;
+	}
+	return true;
+}
+
+bool Thread::SetCurrentPriority(ThreadPriority priority) {
+	int Priority = THREAD_PRIORITY_NORMAL;
+	switch (priority) {
+	case ThreadPriority::eLow: Priority = THREAD_PRIORITY_BELOW_NORMAL; break;
+	case ThreadPriority::eNormal: Priority = THREAD_PRIORITY_NORMAL; break;
+	case ThreadPriority::eHigh: Priority = THREAD_PRIORITY_ABOVE_NORMAL; break;
+	}
+	return SetThreadPriority(GetCurrentThread(), Priority) != 0;
+}
+
+void Thread::SetCurrentName(const char* name) {
+	// SetThreadDescription only exists since Windows 10 1607, so look it up at runtime.
+	typedef HRESULT(WINAPI* PFN_SetThreadDescription)(HANDLE, PCWSTR);
+	static PFN_SetThreadDescription SetDescription = (PFN_SetThreadDescription)GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription");
+	if (SetDescription == nullptr || name == nullptr) {
+		return;
+	}
+
+	wchar_t WideName[64];
+	if (MultiByteToWideChar(CP_UTF8, 0, name, -1, WideName, 64) > 0) {
+		SetDescription(GetCurrentThread(), WideName);
+	}
+}
 // NOTE: End Threads
 
 #endif
\ No newline at end of file
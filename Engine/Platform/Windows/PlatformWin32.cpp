@@ -13,6 +13,8 @@
 #include <windowsx.h>
 #include <vulkan/vulkan_win32.h>
 
+#include <vector>
+
 struct SInternalState {
 	HINSTANCE h_instance;
 	HWND hwnd;
@@ -135,6 +137,45 @@ void* Platform::PlatformZeroMemory(void* block, size_t size) {
 	return memset(block, 0, size);
 }
 
+size_t Platform::PlatformGetPageSize() {
+	SYSTEM_INFO SystemInfo;
+	GetSystemInfo(&SystemInfo);
+	return (size_t)SystemInfo.dwPageSize;
+}
+
+void* Platform::PlatformReserveMemory(size_t size, HugePageMode huge_pages, HugePageMode* out_backing) {
+	if (huge_pages == eHuge_Page_Explicit) {
+		// Large pages can't be committed lazily, so the whole range is committed up front.
+		// Needs SeLockMemoryPrivilege; without it this fails and regular pages are used.
+		size_t LargePageSize = GetLargePageMinimum();
+		if (LargePageSize > 0) {
+			void* Block = VirtualAlloc(nullptr, PaddingAligned(size, LargePageSize), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (Block != nullptr) {
+				if (out_backing != nullptr) *out_backing = eHuge_Page_Explicit;
+				return Block;
+			}
+		}
+		GLOG(Log::eWarn, "Large pages are not available, using regular pages.");
+	}
+
+	// Windows has no transparent huge pages, eHuge_Page_Transparent behaves like eHuge_Page_None.
+	if (out_backing != nullptr) *out_backing = eHuge_Page_None;
+	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool Platform::PlatformCommitMemory(void* block, size_t size) {
+	return VirtualAlloc(block, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void Platform::PlatformDecommitMemory(void* block, size_t size) {
+	VirtualFree(block, size, MEM_DECOMMIT);
+}
+
+void Platform::PlatformReleaseMemory(void* block, size_t size) {
+	(void)size;
+	VirtualFree(block, 0, MEM_RELEASE);
+}
+
 void* Platform::PlatformCopyMemory(void* dst, const void* src, size_t size) {
 	return memcpy(dst, src, size);
 }
@@ -182,6 +223,87 @@ int Platform::GetProcessorCount() {
 	return SystemInfo.dwNumberOfProcessors;
 }
 
+uint32_t Platform::GetProcessorTopology(PlatformProcessor* out_processors, uint32_t max_count) {
+	DWORD Length = 0;
+	GetLogicalProcessorInformationEx(RelationAll, nullptr, &Length);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || Length == 0) {
+		GLOG(Log::eWarn, "GetLogicalProcessorInformationEx failed, assuming one core per processor.");
+		uint32_t Count = (uint32_t)GetProcessorCount();
+		for (uint32_t i = 0; i < Count && i < max_count; ++i) {
+			out_processors[i] = PlatformProcessor();
+			out_processors[i].index = i;
+			out_processors[i].core = i;
+		}
+		return Count;
+	}
+
+	std::vector<uint8_t> Buffer(Length);
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* Info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)Buffer.data();
+	if (!GetLogicalProcessorInformationEx(RelationAll, Info, &Length)) {
+		return 0;
+	}
+
+	// Logical processors are numbered group * 64 + bit, which is what SetCurrentAffinity expects.
+	const uint32_t MaxIndex = (uint32_t)GetMaximumProcessorGroupCount() * 64;
+	std::vector<PlatformProcessor> Processors(MaxIndex);
+	std::vector<bool> Present(MaxIndex, false);
+	uint32_t CoreCount = 0;
+	uint32_t PackageCount = 0;
+
+	for (DWORD Offset = 0; Offset < Length;) {
+		SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* Entry = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(Buffer.data() + Offset);
+		Offset += Entry->Size;
+
+		if (Entry->Relationship == RelationProcessorCore) {
+			uint32_t SmtIndex = 0;
+			for (WORD g = 0; g < Entry->Processor.GroupCount; ++g) {
+				const GROUP_AFFINITY& Group = Entry->Processor.GroupMask[g];
+				for (uint32_t Bit = 0; Bit < 64; ++Bit) {
+					if ((Group.Mask & ((KAFFINITY)1 << Bit)) == 0) continue;
+					uint32_t Index = Group.Group * 64 + Bit;
+					if (Index >= MaxIndex) continue;
+					Present[Index] = true;
+					Processors[Index].index = Index;
+					Processors[Index].core = CoreCount;
+					Processors[Index].smt_index = SmtIndex++;
+				}
+			}
+			CoreCount++;
+		}
+		else if (Entry->Relationship == RelationProcessorPackage) {
+			for (WORD g = 0; g < Entry->Processor.GroupCount; ++g) {
+				const GROUP_AFFINITY& Group = Entry->Processor.GroupMask[g];
+				for (uint32_t Bit = 0; Bit < 64; ++Bit) {
+					uint32_t Index = Group.Group * 64 + Bit;
+					if ((Group.Mask & ((KAFFINITY)1 << Bit)) != 0 && Index < MaxIndex) {
+						Processors[Index].package = PackageCount;
+					}
+				}
+			}
+			PackageCount++;
+		}
+		else if (Entry->Relationship == RelationNumaNode) {
+			const GROUP_AFFINITY& Group = Entry->NumaNode.GroupMask;
+			for (uint32_t Bit = 0; Bit < 64; ++Bit) {
+				uint32_t Index = Group.Group * 64 + Bit;
+				if ((Group.Mask & ((KAFFINITY)1 << Bit)) != 0 && Index < MaxIndex) {
+					Processors[Index].numa_node = Entry->NumaNode.NodeNumber;
+				}
+			}
+		}
+	}
+
+	uint32_t Count = 0;
+	for (uint32_t i = 0; i < MaxIndex; ++i) {
+		if (!Present[i]) continue;
+		if (Count < max_count) {
+			out_processors[Count] = Processors[i];
+		}
+		Count++;
+	}
+	return Count;
+}
+
 void Platform::SetLogo(void* WindowHandle, const std::string& IconPath) {
 	HWND hwnd = static_cast<HWND>(WindowHandle);
 
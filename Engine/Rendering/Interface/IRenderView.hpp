@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "Math/MathTypes.hpp"
 #include "Rendering/Vulkan/VulkanRenderpass.hpp"
+#include "Memory/FrameAllocator.h"
 
 #include <vector>
 #include <functional>
@@ -79,7 +80,7 @@ struct RenderViewPacket {
 	Vector4 ambient_color;
 	float global_time;
 	uint32_t geometry_count = 0;
-	std::vector<struct GeometryRenderData> geometries;
+	TFrameVector<struct GeometryRenderData> geometries;
 	const char* custom_shader_name = nullptr;
 	IRenderviewPacketData* extended_data = nullptr;
 };
@@ -64,7 +64,7 @@ public:
 
 	// Shader
 	virtual bool CreateShader(Shader* shader, const ShaderConfig* config, IRenderpass* pass, const TArray<FString>& stage_filenames, std::vector<ShaderStage>& stages) = 0;
-	virtual uint32_t AcquireInstanceResource(Shader* shader, std::vector<TextureMap*>& maps) = 0;
+	virtual uint64_t AcquireInstanceResource(Shader* shader, std::vector<TextureMap*>& maps) = 0;
 	virtual bool ReleaseInstanceResource(Shader* shader, uint64_t instance_id) = 0;
 
 	virtual bool AcquireTextureMap(TextureMap* map) = 0;
@@ -79,8 +79,8 @@ public:
 	void IncreaseFrameNum() { FrameNum++; }
 
 public:
-	// TODO: Make dynamic
-	GeometryData Geometries[4096];
+	// Uploaded geometry ranges, addressed by Geometry::InternalHandle.
+	TSlotMap<GeometryData> Geometries;
 
 protected:
 	RendererBackendType BackendType = RendererBackendType::eRenderer_Backend_Type_Vulkan;
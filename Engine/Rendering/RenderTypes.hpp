@@ -6,6 +6,7 @@
 #include "Resources/Shader/Shader.hpp"
 #include "Rendering/Interface/IGPUBuffer.hpp"
 #include "Framework/Classes/Actor.h"
+#include "Memory/FrameAllocator.h"
 
 #include <vector>
 #include <functional>
@@ -82,7 +83,7 @@ struct SRenderViewPassConfig {
 struct SRenderPacket {
 	double delta_time = 0.0;
 	unsigned short view_count = 0;
-	std::vector<struct RenderViewPacket> views;
+	TFrameVector<struct RenderViewPacket> views;
 };
 
 struct RenderTarget {
@@ -99,7 +100,7 @@ public:
 		Meshes = data.Meshes;
 	}
 
-	std::vector<GeometryRenderData> Meshes;
+	TFrameVector<GeometryRenderData> Meshes;
 	float GlobalTime;
 };
 
@@ -134,7 +135,7 @@ public:
 		Texts = data.Texts;
 	}
 
-	std::vector<GeometryRenderData> WorldMeshData;
+	TFrameVector<GeometryRenderData> WorldMeshData;
 	MeshPacketData UIMeshData;
 	uint32_t UIGeometryCount = 0;
 	// TODO: Temp.
@@ -213,11 +213,11 @@ bool IRenderer::InitializeRenderShader(Shader* shader) {
 	return shader->Initialize();
 }
 
-uint32_t IRenderer::AcquireInstanceResource(Shader* shader, std::vector<TextureMap*> maps) {
+uint64_t IRenderer::AcquireInstanceResource(Shader* shader, std::vector<TextureMap*> maps) {
 	return RHI_->AcquireInstanceResource(shader, maps);
 }
 
-bool IRenderer::ReleaseInstanceResource(Shader* shader, uint32_t instance_id) {
+bool IRenderer::ReleaseInstanceResource(Shader* shader, uint64_t instance_id) {
 	return RHI_->ReleaseInstanceResource(shader, instance_id);
 }
 
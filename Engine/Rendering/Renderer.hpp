@@ -97,9 +97,9 @@ public:
 	 *
 	 * @param shader A pointer to the shader to acquire resources from.
 	 * @param maps Array to hold the texture maps.
-	 * @return INVALID_ID on false; otherwise return the instance id.
+	 * @return INVALID_ID_U64 on false; otherwise return the instance id. The id goes stale once released.
 	 */
-	virtual uint32_t AcquireInstanceResource(Shader* shader, std::vector<TextureMap*> maps);
+	virtual uint64_t AcquireInstanceResource(Shader* shader, std::vector<TextureMap*> maps);
 
 	/**
 	 * @brief Releases internal instance-level resources for the given instance id.
@@ -108,7 +108,7 @@ public:
 	 * @param instance_id The instance identifier whose resources are to be released.
 	 * @return True on success; otherwise false.
 	 */
-	virtual bool ReleaseInstanceResource(Shader* shader, uint32_t instance_id);
+	virtual bool ReleaseInstanceResource(Shader* shader, uint64_t instance_id);
 
 	
 	/**
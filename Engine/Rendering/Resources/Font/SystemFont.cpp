@@ -2,6 +2,7 @@
 #include "Rendering/Renderer.hpp"
 #include "Systems/TextureSystem.h"
 #include "Systems/ResourceSystem.h"
+#include "Memory/ScratchAllocator.h"
 
 #ifndef STB_TRUETYPE_IMPLEMENTATION
 #define STB_TRUETYPE_IMPLEMENTATION
@@ -232,17 +233,20 @@ bool SystemFontVariant::RebuildAtlas() {
 	uint32_t packImageSize = atlasSizeX_ * atlasSizeY_ * sizeof(unsigned char);
 	uint32_t codepointCount = static_cast<uint32_t>(codepoints_.size());
 
-	unsigned char* pixels = static_cast<unsigned char*>(
-		Memory::Allocate(packImageSize, MemoryType::eMemory_Type_Array));
-	stbtt_packedchar* packedChars = static_cast<stbtt_packedchar*>(
-		Memory::Allocate(sizeof(stbtt_packedchar) * codepointCount, MemoryType::eMemory_Type_Array));
+	// Pack and conversion buffers are released together when the atlas is uploaded.
+	ScratchScope Scratch;
+	unsigned char* pixels = ScratchAllocator::NewArray<unsigned char>(packImageSize);
+	stbtt_packedchar* packedChars = ScratchAllocator::NewArray<stbtt_packedchar>(codepointCount);
+	if (!pixels || !packedChars) {
+		GLOG(Log::eError, "SystemFontVariant: unable to allocate atlas scratch buffers.");
+		return false;
+	}
+	Memory::Zero(packedChars, sizeof(stbtt_packedchar) * codepointCount);
 
 	// ── stbtt 打包 ───────────────────────────
 	stbtt_pack_context ctx;
 	if (!stbtt_PackBegin(&ctx, pixels, atlasSizeX_, atlasSizeY_, 0, 1, nullptr)) {
 		GLOG(Log::eError, "SystemFontVariant: stbtt_PackBegin failed.");
-		Memory::Free(pixels, MemoryType::eMemory_Type_Array);
-		Memory::Free(packedChars, MemoryType::eMemory_Type_Array);
 		return false;
 	}
 
@@ -257,15 +261,16 @@ bool SystemFontVariant::RebuildAtlas() {
 		static_cast<unsigned char*>(ctx_->fontBinary), ctx_->index, &range, 1)) {
 		stbtt_PackEnd(&ctx);
 		GLOG(Log::eError, "SystemFontVariant: stbtt_PackFontRanges failed.");
-		Memory::Free(pixels, MemoryType::eMemory_Type_Array);
-		Memory::Free(packedChars, MemoryType::eMemory_Type_Array);
 		return false;
 	}
 	stbtt_PackEnd(&ctx);
 
 	// ── 单通道 → RGBA ────────────────────────
-	unsigned char* rgbaPixels = static_cast<unsigned char*>(
-		Memory::Allocate(packImageSize * 4, MemoryType::eMemory_Type_Array));
+	unsigned char* rgbaPixels = ScratchAllocator::NewArray<unsigned char>(packImageSize * 4);
+	if (!rgbaPixels) {
+		GLOG(Log::eError, "SystemFontVariant: unable to allocate atlas scratch buffers.");
+		return false;
+	}
 	for (uint32_t j = 0; j < packImageSize; ++j) {
 		rgbaPixels[(j * 4) + 0] = pixels[j];
 		rgbaPixels[(j * 4) + 1] = pixels[j];
@@ -275,10 +280,6 @@ bool SystemFontVariant::RebuildAtlas() {
 
 	atlas_.texture->WriteTextureData(packImageSize * 4, rgbaPixels);
 
-	Memory::Free(pixels, MemoryType::eMemory_Type_Array);
-	Memory::Free(rgbaPixels, MemoryType::eMemory_Type_Array);
-	pixels = nullptr; rgbaPixels = nullptr;
-
 	// ── 重建 Glyph 数据 ──────────────────────
 	if (glyphs_ && glyphCount_) {
 		Memory::Free(glyphs_, MemoryType::eMemory_Type_Array);
@@ -314,15 +315,16 @@ bool SystemFontVariant::RebuildAtlas() {
 		kernings_ = static_cast<FontKerning*>(
 			Memory::Allocate(sizeof(FontKerning) * kerningCount_, MemoryType::eMemory_Type_Array));
 
-		stbtt_kerningentry* kerningTable = static_cast<stbtt_kerningentry*>(
-			Memory::Allocate(sizeof(stbtt_kerningentry) * kerningCount_, MemoryType::eMemory_Type_Array));
+		stbtt_kerningentry* kerningTable = ScratchAllocator::NewArray<stbtt_kerningentry>(kerningCount_);
+		if (!kerningTable) {
+			GLOG(Log::eError, "SystemFontVariant: unable to allocate kerning scratch buffer.");
+			return false;
+		}
 
 		int entryCount = stbtt_GetKerningTable(&ctx_->info, kerningTable, kerningCount_);
 		if (entryCount != static_cast<int>(kerningCount_)) {
 			GLOG(Log::eError, "SystemFontVariant: kerning count mismatch %d -> %d.",
 				entryCount, kerningCount_);
-			Memory::Free(kerningTable, MemoryType::eMemory_Type_Array);
-			Memory::Free(packedChars, MemoryType::eMemory_Type_Array);
 			return false;
 		}
 
@@ -331,10 +333,7 @@ bool SystemFontVariant::RebuildAtlas() {
 			kernings_[i].codePoint1 = kerningTable[i].glyph2;
 			kernings_[i].amount = static_cast<short>(kerningTable[i].advance);
 		}
-
-		Memory::Free(kerningTable, MemoryType::eMemory_Type_Array);
 	}
 
-	Memory::Free(packedChars, MemoryType::eMemory_Type_Array);
 	return true;
 }
\ No newline at end of file
@@ -5,6 +5,5 @@ Geometry::Geometry(){
 }
 
 Geometry::Geometry(const FString& name) : UAsset(name){
-	InternalID = INVALID_ID;
 	AssetType = EAssetType::Geometry;
 }
\ No newline at end of file
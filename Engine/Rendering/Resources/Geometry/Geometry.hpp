@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "GeometryType.hpp"
+#include "Containers/TSlotMap.hpp"
 #include "Rendering/Resources/Asset.hpp"
 
 class Material;
@@ -11,9 +12,10 @@ public:
 	Geometry(const FString& name);
 
 public:
-	uint32_t ID;
-	uint32_t InternalID;	// Renderer内部使用的ID，是Vulkan的Buffer ID
-	uint32_t Generation;
+	// ID 与 Generation 组成 GeometrySystem 注册表中的句柄
+	uint32_t ID = INVALID_ID;
+	FSlotHandle InternalHandle;	// Renderer内部使用的句柄，指向Vulkan的几何数据
+	uint32_t Generation = INVALID_ID;
 	Vector3 Center;
 	Extents3D Extents;
 	FString name;
@@ -21,4 +23,7 @@ public:
 
 	size_t reference_count = 0;
 	bool auto_release = false;
+
+public:
+	FSlotHandle GetHandle() const { return FSlotHandle(ID, Generation); }
 };
\ No newline at end of file
@@ -1,4 +1,6 @@
-﻿#include "BitmapFontLoader.hpp"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "BitmapFontLoader.hpp"
 #include "Rendering/Resources/Font/BitmapFont.hpp"
 
 #include "Core/DMemory.hpp"
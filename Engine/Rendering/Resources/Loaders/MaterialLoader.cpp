@@ -1,4 +1,6 @@
-﻿#include "MaterialLoader.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "MaterialLoader.h"
 
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
@@ -1,4 +1,6 @@
-﻿#include "MeshLoader.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "MeshLoader.h"
 
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
@@ -169,8 +171,11 @@ bool MeshLoader::Import3DModelFile(const FString& model_file, const FString& out
 	GLOG(Log::eInfo, "Successfully loaded 3D model: %s", model_file.CStr());
 	GLOG(Log::eDebug, "Model contains %u meshes, %u materials", scene->mNumMeshes, scene->mNumMaterials);
 
+	// Everything below only lives for this import pass.
+	ScratchScope Scratch;
+
 	// 材质配置
-	std::vector<SMaterialConfig> MaterialConfigs;
+	TScratchVector<SMaterialConfig> MaterialConfigs;
 
 	// 处理材质
 	if (!ProcessAssimpMaterials(scene, out_dsm_filename, MaterialConfigs)) {
@@ -189,7 +194,7 @@ bool MeshLoader::Import3DModelFile(const FString& model_file, const FString& out
 	return WriteDsmFile(out_dsm_filename, model_file, out_geometries);
 }
 
-bool MeshLoader::ProcessAssimpMaterials(const aiScene* scene, const FString& out_dsm_filename, std::vector<SMaterialConfig>& materialConfigs) {
+bool MeshLoader::ProcessAssimpMaterials(const aiScene* scene, const FString& out_dsm_filename, TScratchVector<SMaterialConfig>& materialConfigs) {
 	for (unsigned int i = 0; i < scene->mNumMaterials; ++i) {
 		const aiMaterial* mat = scene->mMaterials[i];
 		SMaterialConfig config;
@@ -352,7 +357,7 @@ void MeshLoader::ProcessAssimpTextures(const aiMaterial* mat, SMaterialConfig& c
 	}
 }
 
-void MeshLoader::ProcessAssimpNode(aiNode* node, const aiScene* scene, const std::vector<SMaterialConfig>& materialConfigs, const Matrix4& parentTransform, std::vector<SGeometryConfig>& out_geometries) {
+void MeshLoader::ProcessAssimpNode(aiNode* node, const aiScene* scene, const TScratchVector<SMaterialConfig>& materialConfigs, const Matrix4& parentTransform, std::vector<SGeometryConfig>& out_geometries) {
 	// 计算当前节点的变换矩阵
 	aiMatrix4x4 aiTrans = node->mTransformation;
 
@@ -379,7 +384,7 @@ void MeshLoader::ProcessAssimpNode(aiNode* node, const aiScene* scene, const std
 	}
 }
 
-void MeshLoader::ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const std::vector<SMaterialConfig>& materialConfigs, const Matrix4& transform, std::vector<SGeometryConfig>& out_geometries) {
+void MeshLoader::ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const TScratchVector<SMaterialConfig>& materialConfigs, const Matrix4& transform, std::vector<SGeometryConfig>& out_geometries) {
 	if (!mesh->HasFaces()) {
 		GLOG(Log::eWarn, "Mesh has no faces, skipping: %s", mesh->mName.C_Str());
 		return;
@@ -395,9 +400,11 @@ void MeshLoader::ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const std
 		return;
 	}
 
-	std::vector<Vector3> positions;
-	std::vector<Vector3> normals;
-	std::vector<Vector2f> texcoords;
+	// Per-mesh temporaries, released before the next mesh of the scene is processed.
+	ScratchScope Scratch;
+	TScratchVector<Vector3> positions;
+	TScratchVector<Vector3> normals;
+	TScratchVector<Vector2f> texcoords;
 
 	positions.reserve(mesh->mNumVertices);
 	normals.reserve(mesh->mNumVertices);
@@ -434,7 +441,7 @@ void MeshLoader::ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const std
 	}
 
 	// 转换为MeshFaceData格式以复用现有逻辑
-	std::vector<MeshFaceData> faces;
+	TScratchVector<MeshFaceData> faces;
 	faces.reserve(mesh->mNumFaces);
 
 	for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
@@ -510,11 +517,12 @@ void MeshLoader::ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const std
 		newData.name.CStr(), newData.vertex_count, (uint32_t)faces.size());
 }
 
-void MeshLoader::ProcessSubobject(std::vector<Vector3>& positions, std::vector<Vector3>& normals, std::vector<Vector2f>& texcoords, std::vector<MeshFaceData>& faces, SGeometryConfig* out_data) {
-	std::vector<uint32_t> Indices;
-	std::vector<Vertex> Vertices;
-	Indices.reserve(65535);
-	Vertices.reserve(65535);
+void MeshLoader::ProcessSubobject(TScratchVector<Vector3>& positions, TScratchVector<Vector3>& normals, TScratchVector<Vector2f>& texcoords, TScratchVector<MeshFaceData>& faces, SGeometryConfig* out_data) {
+	ScratchScope Scratch;
+	TScratchVector<uint32_t> Indices;
+	TScratchVector<Vertex> Vertices;
+	Indices.reserve(faces.size() * 3);
+	Vertices.reserve(faces.size() * 3);
 	
 	bool ExtentSet = false;
 	Memory::Zero(&out_data->min_extents, sizeof(Vector3));
@@ -615,16 +623,14 @@ void MeshLoader::ProcessSubobject(std::vector<Vector3>& positions, std::vector<V
 
 	out_data->vertex_count = (uint32_t)Vertices.size();
 	out_data->vertex_size = sizeof(Vertex);
-	out_data->vertices = Memory::Allocate(out_data->vertex_count * out_data->vertex_size, MemoryType::eMemory_Type_Array);
+	out_data->vertices = Memory::AllocateUninitialized(out_data->vertex_count * out_data->vertex_size, MemoryType::eMemory_Type_Array);
 	Memory::Copy(out_data->vertices, Vertices.data(), out_data->vertex_count * out_data->vertex_size);
 
 	out_data->index_count = (uint32_t)Indices.size();
 	out_data->index_size = sizeof(uint32_t);
-	out_data->indices = Memory::Allocate(out_data->index_count * out_data->index_size, MemoryType::eMemory_Type_Array);
+	out_data->indices = Memory::AllocateUninitialized(out_data->index_count * out_data->index_size, MemoryType::eMemory_Type_Array);
 	Memory::Copy(out_data->indices, Indices.data(), out_data->index_count * out_data->index_size);
 
-	std::vector<uint32_t>().swap(Indices);
-	std::vector<Vertex>().swap(Vertices);
 }	
 bool MeshLoader::WriteDmtFile(const FString& mtl_file_path, SMaterialConfig* config) {
 	// 从 mtl 文件路径提取目录，拼接目标路径
@@ -725,13 +731,13 @@ bool MeshLoader::LoadDsmFile(const FString& path, std::vector<SGeometryConfig>&
 		// Vertices (size / count / array)
 		if (!f.Read(&g.vertex_size))  return false;
 		if (!f.Read(&g.vertex_count)) return false;
-		g.vertices = Memory::Allocate(g.vertex_count * g.vertex_size, MemoryType::eMemory_Type_Array);
+		g.vertices = Memory::AllocateUninitialized(g.vertex_count * g.vertex_size, MemoryType::eMemory_Type_Array);
 		if (!f.ReadBuffer(g.vertices, g.vertex_count * g.vertex_size)) return false;
 
 		// Indices (size / count / array)
 		if (!f.Read(&g.index_size))  return false;
 		if (!f.Read(&g.index_count)) return false;
-		g.indices = Memory::Allocate(g.index_count * g.index_size, MemoryType::eMemory_Type_Array);
+		g.indices = Memory::AllocateUninitialized(g.index_count * g.index_size, MemoryType::eMemory_Type_Array);
 		if (!f.ReadBuffer(g.indices, g.index_count * g.index_size)) return false;
 
 		// Geometry name
@@ -847,7 +853,7 @@ bool MeshLoader::DeduplicateGeometry(std::vector<SGeometryConfig>& outGeometries
 		g->vertices = UniqueVerts;
 
 		// Take a copy of the indices as a normal.
-		uint32_t* Indices = (uint32_t*)Memory::Allocate(sizeof(uint32_t) * g->index_count, MemoryType::eMemory_Type_Array);
+		uint32_t* Indices = (uint32_t*)Memory::AllocateUninitialized(sizeof(uint32_t) * g->index_count, MemoryType::eMemory_Type_Array);
 		Memory::Copy(Indices, g->indices, sizeof(uint32_t) * g->index_count);
 		// Destroy.
 		Memory::Free(g->indices, MemoryType::eMemory_Type_Array);
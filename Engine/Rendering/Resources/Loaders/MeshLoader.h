@@ -2,6 +2,7 @@
 
 #include "Rendering/Interface/IResourceLoader.hpp"
 #include "Rendering/Resources/Geometry/Geometry.hpp"
+#include "Memory/ScratchAllocator.h"
 #include <vector>
 #include <unordered_map>
 
@@ -27,7 +28,7 @@ public:
 
 private:
 	// 通用文件处理
-	virtual void ProcessSubobject(std::vector<Vector3>& positions, std::vector<Vector3>& normals, std::vector<Vector2f>& texcoords, std::vector<MeshFaceData>& faces, SGeometryConfig* out_data);
+	virtual void ProcessSubobject(TScratchVector<Vector3>& positions, TScratchVector<Vector3>& normals, TScratchVector<Vector2f>& texcoords, TScratchVector<MeshFaceData>& faces, SGeometryConfig* out_data);
 	virtual bool LoadDsmFile(const FString& path, std::vector<SGeometryConfig>& out_geometries);
 	virtual bool WriteDsmFile(const FString& path, const FString& name, std::vector<SGeometryConfig>& geometries);
 	virtual bool WriteDmtFile(const FString& mtl_file_path, SMaterialConfig* config);
@@ -36,10 +37,10 @@ private:
 	virtual bool Import3DModelFile(const FString& model_file, const FString& out_dsm_filename, std::vector<SGeometryConfig>& out_geometries);
 
 	// Assimp相关处理函数
-	virtual bool ProcessAssimpMaterials(const aiScene* scene, const FString& out_dsm_filename, std::vector<SMaterialConfig>& materialConfigs);
+	virtual bool ProcessAssimpMaterials(const aiScene* scene, const FString& out_dsm_filename, TScratchVector<SMaterialConfig>& materialConfigs);
 	virtual void ProcessAssimpTextures(const aiMaterial* mat, SMaterialConfig& config);
-	virtual void ProcessAssimpNode(aiNode* node, const aiScene* scene, const std::vector<SMaterialConfig>& materialConfigs, const Matrix4& parentTransform, std::vector<SGeometryConfig>& out_geometries);
-	virtual void ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const std::vector<SMaterialConfig>& materialConfigs, const Matrix4& transform, std::vector<SGeometryConfig>& out_geometries);
+	virtual void ProcessAssimpNode(aiNode* node, const aiScene* scene, const TScratchVector<SMaterialConfig>& materialConfigs, const Matrix4& parentTransform, std::vector<SGeometryConfig>& out_geometries);
+	virtual void ProcessAssimpMesh(aiMesh* mesh, const aiScene* scene, const TScratchVector<SMaterialConfig>& materialConfigs, const Matrix4& transform, std::vector<SGeometryConfig>& out_geometries);
 
 	virtual bool ImportObjFile(const FString& obj_file, const FString& out_dsm_filename, std::vector<SGeometryConfig>& out_geometries) {
 		return Import3DModelFile(obj_file, out_dsm_filename, out_geometries);
@@ -1,4 +1,6 @@
-﻿#include "ShaderLoader.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "ShaderLoader.h"
 
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
@@ -1,4 +1,6 @@
-﻿#include "SystemFontLoader.hpp"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "SystemFontLoader.hpp"
 #include "Rendering/Resources/Font/SystemFont.hpp"
 
 #include "Core/DMemory.hpp"
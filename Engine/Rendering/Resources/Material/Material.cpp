@@ -5,7 +5,7 @@ Material::Material() {
 	AutoRelease = false;
 	ID = INVALID_ID;
 	Generation = INVALID_ID;
-	InternalID = INVALID_ID;
+	InternalID = INVALID_ID_U64;
 	DiffuseColor = Vector4(1.0f);
 	Shininess = 32.0f;
 	ShaderID = INVALID_ID;
@@ -27,7 +27,7 @@ private:
 
 public:
 	uint32_t Generation;
-	uint32_t InternalID;
+	uint64_t InternalID;
 	FString Name;
 	Vector4 DiffuseColor;
 	TextureMap DiffuseMap;
@@ -253,7 +253,7 @@ void Shader::AddUniform(const FString& uniform_name, uint32_t size,
 	}
 }
 
-uint32_t Shader::GetUniformIndex(const FString& name) const {
+uint32_t Shader::GetUniformIndex(FName name) const {
 	if (Status == EShaderStatus::eShader_State_Uninitialized) {
 		GLOG(Log::eError, "Shader::GetUniformIndex — Shader '%s' is not init.", Name.CStr());
 		return INVALID_ID;
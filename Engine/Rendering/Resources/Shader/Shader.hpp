@@ -2,6 +2,7 @@
 
 #include "Rendering/Resources/Asset.hpp"
 #include "ShaderType.hpp"
+#include "Containers/FName.hpp"
 #include <unordered_map>
 
 // Shader compiler
@@ -45,7 +46,7 @@ public:
 	virtual bool SetUniformByIndex(uint32_t index, const void* value) = 0;
 
 	/** 按名称写 uniform（内部转 index 后调用 SetUniformByIndex）*/
-	virtual bool SetUniform(const FString& name, const void* value) = 0;
+	virtual bool SetUniform(FName name, const void* value) = 0;
 	
 	virtual void ProcessAttributes(const std::vector<ShaderAttributeConfig>& attributes);
 	virtual void ProcessUniforms(const std::vector<ShaderUniformConfig>& uniforms);
@@ -62,7 +63,7 @@ public:
 	 * @param uniform_name The name of the uniform to search for.
 	 * @return The uniform index, if found; otherwise INVALID_ID_U16.
 	 */
-	uint32_t GetUniformIndex(const FString& name) const;
+	uint32_t GetUniformIndex(FName name) const;
 
 protected:
 	// Shader utils
@@ -113,5 +114,5 @@ public:
 	std::vector<ShaderUniform>              Uniforms;
 	std::vector<ShaderAttribute>            Attributes;
 	std::vector<TextureMap*>                GlobalTextureMaps;
-	std::unordered_map<FString, uint32_t>   HashMap;
+	std::unordered_map<FName, uint32_t>     HashMap;
 };
\ No newline at end of file
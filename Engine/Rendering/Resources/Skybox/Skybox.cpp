@@ -35,7 +35,7 @@ bool Skybox::Create(const FString& cubeName) {
 	std::vector<TextureMap*> Maps = { &CubeMap };
 
 	InstanceID = Renderer->AcquireInstanceResource(SkyboxShader, Maps);
-	if (InstanceID == INVALID_ID) {
+	if (InstanceID == INVALID_ID_U64) {
 		GLOG(Log::eFatal, "Unable to acquire shader resources for skybox texture.");
 		return false;
 	}
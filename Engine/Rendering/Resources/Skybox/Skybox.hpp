@@ -14,6 +14,6 @@ public:
 	IRenderer* Renderer = nullptr;
 	TextureMap CubeMap;
 	class Geometry* g = nullptr;
-	uint32_t InstanceID = INVALID_ID;
+	uint64_t InstanceID = INVALID_ID_U64;
 	size_t RenderFrameNumber = 0;
 };
@@ -1,4 +1,6 @@
-﻿#include "TextureHelper.hpp"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "TextureHelper.hpp"
 #include "Systems/ResourceSystem.h"
 
 #include "Core/DMemory.hpp"
@@ -211,7 +211,7 @@ bool RenderViewWorldDeferred::OnBuildPacket(IRenderviewPacketData* data, struct
 	}
 
 	WorldPacketData* Data = (WorldPacketData*)data;
-	const std::vector<GeometryRenderData> GeometryData = Data->Meshes;
+	const TFrameVector<GeometryRenderData>& GeometryData = Data->Meshes;
 	out_packet->view = this;
 
 	UCameraComponent* CameraComp = WorldCamera->GetCameraComponent();
@@ -228,6 +228,7 @@ bool RenderViewWorldDeferred::OnBuildPacket(IRenderviewPacketData* data, struct
 
 	// 获取所有几何体
 	uint32_t GeometryDataCount = (uint32_t)GeometryData.size();
+	out_packet->geometries.reserve(GeometryDataCount);
 	for (uint32_t i = 0; i < GeometryDataCount; ++i) {
 		const GeometryRenderData& GData = GeometryData[i];
 		if (GData.geometry == nullptr) {
@@ -243,8 +244,8 @@ bool RenderViewWorldDeferred::OnBuildPacket(IRenderviewPacketData* data, struct
 }
 
 void RenderViewWorldDeferred::OnDestroyPacket(struct RenderViewPacket* packet) {
+	// 几何体数据位于帧内存中，随帧回收
 	packet->geometries.clear();
-	std::vector<GeometryRenderData>().swap(packet->geometries);
 }
 
 bool RenderViewWorldDeferred::RegenerateAttachmentTarget(uint32_t passIndex, RenderTargetAttachment* attachment) {
@@ -54,36 +54,40 @@ static bool OnMouseMoved(eEventCode code, void* sender, void* listenerInst, SEve
 
 void RenderViewPick::AcquireShaderInstance() {
 	// UI Shader.
-	uint32_t Instance = Renderer->AcquireInstanceResource(UIShaderInfo.UsedShader, std::vector<TextureMap*>());
-	if (Instance == INVALID_ID) {
+	uint64_t UIInstance = Renderer->AcquireInstanceResource(UIShaderInfo.UsedShader, std::vector<TextureMap*>());
+	if (UIInstance == INVALID_ID_U64) {
 		GLOG(Log::eError, "Failed to acquire shader resource.");
 		return;
 	}
 
 	// World Shader.
-	Instance = Renderer->AcquireInstanceResource(WorldShaderInfo.UsedShader, std::vector<TextureMap*>());
-	if (Instance == INVALID_ID) {
+	uint64_t WorldInstance = Renderer->AcquireInstanceResource(WorldShaderInfo.UsedShader, std::vector<TextureMap*>());
+	if (WorldInstance == INVALID_ID_U64) {
 		GLOG(Log::eError, "Failed to acquire shader resource.");
+		Renderer->ReleaseInstanceResource(UIShaderInfo.UsedShader, UIInstance);
 		return;
 	}
 
-	InstanceCount++;
+	UIInstanceIDs.push_back(UIInstance);
+	WorldInstanceIDs.push_back(WorldInstance);
 	InstanceUpdated.push_back(false);
 }
 
 void RenderViewPick::ReleaseShaderInstance() {
-	for (int i = 0; i < InstanceCount; ++i) {
+	for (size_t i = 0; i < InstanceUpdated.size(); ++i) {
 		// UI Shader
-		if (!Renderer->ReleaseInstanceResource(UIShaderInfo.UsedShader, i)) {
+		if (!Renderer->ReleaseInstanceResource(UIShaderInfo.UsedShader, UIInstanceIDs[i])) {
 			GLOG(Log::eError, "Failed to release shader resource.");
 		}
 
-		// UI Shader
-		if (!Renderer->ReleaseInstanceResource(WorldShaderInfo.UsedShader, i)) {
+		// World Shader
+		if (!Renderer->ReleaseInstanceResource(WorldShaderInfo.UsedShader, WorldInstanceIDs[i])) {
 			GLOG(Log::eError, "Failed to release shader resource.");
 		}
 	}
 
+	UIInstanceIDs.clear();
+	WorldInstanceIDs.clear();
 	InstanceUpdated.clear();
 }
 
@@ -158,7 +162,6 @@ bool RenderViewPick::OnCreate(const RenderViewConfig& config) {
 		(float)config.width/config.height, WorldShaderInfo.NearClip, WorldShaderInfo.FarClip);
 	WorldShaderInfo.ViewMatrix = Matrix4::Identity();
 
-	InstanceCount = 0;
 	ColorTargetAttachment = Renderer->AcquireTexture("RenderviewPick_ColorTargetAttachment");
 	DepthTargetAttachment = Renderer->AcquireTexture("RenderviewPick_DepthTargetAttachment");
 
@@ -233,6 +236,7 @@ bool RenderViewPick::OnBuildPacket(IRenderviewPacketData* data, struct RenderVie
 	uint32_t WorldGeometryCount = (uint32_t)PacketData->WorldMeshData.size();
 
 	uint64_t HighestInstanceID = 0;
+	out_packet->geometries.reserve(WorldGeometryCount);
 	// Iterate all geometries in world data.
 	for (uint32_t i = 0; i < WorldGeometryCount; ++i) {
 		out_packet->geometries.push_back(PacketData->WorldMeshData[i]);
@@ -271,39 +275,26 @@ bool RenderViewPick::OnBuildPacket(IRenderviewPacketData* data, struct RenderVie
 
 	// TODO: this needs to take into account the highest id, not the count, because they can and do skip ids.
 	// Verify instance resources exist.
-	if (RequiredInstanceCount > (uint32_t)InstanceCount) {
-		uint64_t Diff = RequiredInstanceCount - InstanceCount;
+	if (RequiredInstanceCount > InstanceUpdated.size()) {
+		uint64_t Diff = RequiredInstanceCount - InstanceUpdated.size();
 		for (uint64_t i = 0; i < Diff; ++i) {
 			AcquireShaderInstance();
 		}
 	}
 	
 	// Copy over the packet data.
-	out_packet->extended_data = NewObject<PickPacketData>(*PacketData);
+	out_packet->extended_data = FrameAllocator::New<PickPacketData>(*PacketData);
 
 	return true;
 }
 
 void RenderViewPick::OnDestroyPacket(struct RenderViewPacket* packet) {
-	// No much to do here, just zero mem.
-	for (uint32_t i = 0; i < packet->geometry_count; ++i) {
-		packet->geometries[i].geometry = nullptr;
-	}
-	packet->geometries.clear();
-	std::vector<GeometryRenderData>().swap(packet->geometries);
-
+	// Geometries and packet data live in frame memory, which is reclaimed with the frame.
 	if (packet->extended_data) {
-		PickPacketData* PacketData = (PickPacketData*)packet->extended_data;
-		if (!PacketData->WorldMeshData.empty()) {
-			PacketData->WorldMeshData.clear();
-			std::vector<GeometryRenderData>().swap(PacketData->WorldMeshData);
-		}
-
-		DeleteObject(PacketData);
-		packet->extended_data = nullptr;
+		FrameAllocator::Destroy((PickPacketData*)packet->extended_data);
 	}
 
-	Memory::Zero(packet, sizeof(RenderViewPacket));
+	*packet = RenderViewPacket();
 }
 
 bool RenderViewPick::RegenerateAttachmentTarget(uint32_t passIndex, RenderTargetAttachment* attachment) {
@@ -391,7 +382,7 @@ bool RenderViewPick::OnRender(struct RenderViewPacket* packet, RHI* back_rendere
 			GeometryRenderData* Geo = &packet->geometries[i];
 			CurrentInstanceID = Geo->uniqueID;
 
-			WorldShader->BindInstance(CurrentInstanceID);
+			WorldShader->BindInstance(WorldInstanceIDs[CurrentInstanceID]);
 
 			// Get color based on id
 			Vector3 IDColor;
@@ -449,7 +440,7 @@ bool RenderViewPick::OnRender(struct RenderViewPacket* packet, RHI* back_rendere
 			GeometryRenderData* Geo = &packet->geometries[i];
 			CurrentInstanceID = Geo->uniqueID;
 
-			UIShader->BindInstance(CurrentInstanceID);
+			UIShader->BindInstance(UIInstanceIDs[CurrentInstanceID]);
 
 			// Get color based on id
 			Vector3 IDColor;
@@ -478,7 +469,7 @@ bool RenderViewPick::OnRender(struct RenderViewPacket* packet, RHI* back_rendere
  		for (uint32_t i = 0; i < PacketData->TextCount; ++i) {
 			ATextActor* Text = PacketData->Texts[i];
 			CurrentInstanceID = Text->GetUniqueID();
-			UIShader->BindInstance(CurrentInstanceID);
+			UIShader->BindInstance(UIInstanceIDs[CurrentInstanceID]);
 
 			// Get color based on id
 			Vector3 IDColor;
@@ -52,7 +52,9 @@ private:
 	UTexture* ColorTargetAttachment;
 	UTexture* DepthTargetAttachment;
 
-	int InstanceCount = 0;
+	// Shader instance ids, indexed by the unique id of the picked object.
+	std::vector<uint64_t> UIInstanceIDs;
+	std::vector<uint64_t> WorldInstanceIDs;
 	std::vector<bool> InstanceUpdated;
 
 	short MouseX = 0, MouseY = 0;
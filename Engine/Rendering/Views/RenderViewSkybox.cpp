@@ -128,19 +128,17 @@ bool RenderViewSkybox::OnBuildPacket(IRenderviewPacketData* data, struct RenderV
 	out_packet->view_position = CameraComp->GetPosition();
 
 	// Just set the extended data to the skybox data.
-	out_packet->extended_data = NewObject<SkyboxPacketData>(*SkyboxData);
+	out_packet->extended_data = FrameAllocator::New<SkyboxPacketData>(*SkyboxData);
 
 	return true;
 }
 
 void RenderViewSkybox::OnDestroyPacket(struct RenderViewPacket* packet) {
 	if (packet->extended_data) {
-		DeleteObject(packet->extended_data);
-		packet->extended_data = nullptr;
+		FrameAllocator::Destroy((SkyboxPacketData*)packet->extended_data);
 	}
 
-	// No much to do here, just zero mem.
-	Memory::Zero(packet, sizeof(RenderViewPacket));
+	*packet = RenderViewPacket();
 }
 
 bool RenderViewSkybox::RegenerateAttachmentTarget(uint32_t passIndex, RenderTargetAttachment* attachment) {
@@ -115,7 +115,7 @@ bool RenderViewUI::OnBuildPacket(IRenderviewPacketData* data, struct RenderViewP
 	out_packet->view_matrix = ViewMatrix;
 
 	// TODO: Temp set extended data to the test text objects for now.
-	out_packet->extended_data = NewObject<UIPacketData>(*PacketData);
+	out_packet->extended_data = FrameAllocator::New<UIPacketData>(*PacketData);
 
 	// Obtain all geometries from the current scene.
 	// Iterate all meshes and them to the packet's geometries collection.
@@ -134,27 +134,12 @@ bool RenderViewUI::OnBuildPacket(IRenderviewPacketData* data, struct RenderViewP
 }
 
 void RenderViewUI::OnDestroyPacket(struct RenderViewPacket* packet) {
-	// No much to do here, just zero mem.
-	packet->geometries.clear();
-	std::vector<GeometryRenderData>().swap(packet->geometries);
-
+	// Packet data, mesh and text arrays all live in frame memory, which is reclaimed with the frame.
 	if (packet->extended_data) {
-		UIPacketData* PacketData = (UIPacketData*)packet->extended_data;
-		if (PacketData->Textes != nullptr) {
-			Memory::Free(PacketData->Textes, MemoryType::eMemory_Type_Array);
-			PacketData->Textes = nullptr;
-		}
-
-		if (PacketData->meshData.meshes != nullptr) {
-			Memory::Free(PacketData->meshData.meshes, MemoryType::eMemory_Type_Array);
-			PacketData->meshData.meshes = nullptr;
-		}
-
-		DeleteObject(packet->extended_data);
-		packet->extended_data = nullptr;
+		FrameAllocator::Destroy((UIPacketData*)packet->extended_data);
 	}
 
-	Memory::Zero(packet, sizeof(RenderViewPacket));
+	*packet = RenderViewPacket();
 }
 
 bool RenderViewUI::RegenerateAttachmentTarget(uint32_t passIndex, RenderTargetAttachment* attachment) {
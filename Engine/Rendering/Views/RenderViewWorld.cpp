@@ -23,7 +23,7 @@ struct GeometryDistance {
 	float distance;
 };
 
-static void QuickSort(std::vector<GeometryDistance>& arr, int low_index, int high_index, bool ascending);
+static void QuickSort(TFrameVector<GeometryDistance>& arr, int low_index, int high_index, bool ascending);
 
 static bool RenderViewWorldOnEvent(eEventCode code, void* sender, void* listenerInst, SEventContext context) {
 	IRenderView* self = (IRenderView*)listenerInst;
@@ -156,7 +156,7 @@ bool RenderViewWorld::OnBuildPacket(IRenderviewPacketData* data, struct RenderVi
 	}
 
 	WorldPacketData* Data = (WorldPacketData*)data;
-	const std::vector<GeometryRenderData> GeometryData = Data->Meshes;
+	const TFrameVector<GeometryRenderData>& GeometryData = Data->Meshes;
 	out_packet->view = this;
 
 	// Set matrix, etc.
@@ -172,8 +172,11 @@ bool RenderViewWorld::OnBuildPacket(IRenderviewPacketData* data, struct RenderVi
 	out_packet->global_time = Data->GlobalTime;
 
 	// Obtain all geometries from the current scene.
-	std::vector<GeometryDistance> GeometryDistances;
+	// Frame memory is never given back, so reserve up front instead of growing.
 	uint32_t GeometryDataCount = (uint32_t)GeometryData.size();
+	out_packet->geometries.reserve(GeometryDataCount);
+	TFrameVector<GeometryDistance> GeometryDistances;
+	GeometryDistances.reserve(GeometryDataCount);
 	for (uint32_t i = 0; i < GeometryDataCount; ++i) {
 		const GeometryRenderData& GData = GeometryData[i];
 		if (GData.geometry == nullptr) {
@@ -212,17 +215,13 @@ bool RenderViewWorld::OnBuildPacket(IRenderviewPacketData* data, struct RenderVi
 		out_packet->geometry_count++;
 	}
 
-	GeometryDistances.clear();
-	std::vector<GeometryDistance>().swap(GeometryDistances);
-
 	return true;
 }
 
 
 void RenderViewWorld::OnDestroyPacket(struct RenderViewPacket* packet) {
-	// No much to do here, just zero mem.
+	// Geometries live in frame memory, which is reclaimed with the frame.
 	packet->geometries.clear();
-	std::vector<GeometryRenderData>().swap(packet->geometries);
 }
 
 bool RenderViewWorld::RegenerateAttachmentTarget(uint32_t passIndex, RenderTargetAttachment* attachment) {
@@ -292,7 +291,7 @@ static void Swap(GeometryDistance* a, GeometryDistance* b) {
 	*b = temp;
 }
 
-static int Partition(std::vector<GeometryDistance>& arr, int low_index, int high_index, bool ascending) {
+static int Partition(TFrameVector<GeometryDistance>& arr, int low_index, int high_index, bool ascending) {
 	GeometryDistance Privot = arr[high_index];
 	int i = (low_index - 1);
 
@@ -315,7 +314,7 @@ static int Partition(std::vector<GeometryDistance>& arr, int low_index, int high
 	return i + 1;
 }
 
-static void QuickSort(std::vector<GeometryDistance>& arr, int low_index, int high_index, bool ascending) {
+static void QuickSort(TFrameVector<GeometryDistance>& arr, int low_index, int high_index, bool ascending) {
 	if (low_index < high_index) {
 		int PartitionIndex = Partition(arr, low_index, high_index, ascending);
 
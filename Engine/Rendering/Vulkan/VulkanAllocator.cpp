@@ -1,4 +1,6 @@
-﻿#include "VulkanAllocator.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanAllocator.hpp"
 
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
@@ -12,7 +14,7 @@ void* VulkanAllocator::Allocation(void* user_data, size_t size, size_t alignment
 
 	void* Result = Memory::AllocateAligned(size, (unsigned short)alignment, MemoryType::eMemory_Type_Vulkan);
 #ifdef DVULKAN_ALLOCATOR_TRACE
-	GLOG(Log::eInfo, "Allocated block %p. Size=%llu, Alignment=%llu.", Result, size, alignment);
+	GLOG(Log::eDebug, "Allocated block %p. Size=%llu, Alignment=%llu.", Result, size, alignment);
 #endif
 	return Result;
 }
@@ -20,20 +22,20 @@ void* VulkanAllocator::Allocation(void* user_data, size_t size, size_t alignment
 void VulkanAllocator::Free(void* user_date, void* memory) {
 	if (memory == nullptr) {
 #ifdef DVULKAN_ALLOCATOR_TRACE
-		GLOG(Log::eInfo, "Block is nullptr, nothing to free: %p.", memory);
+		GLOG(Log::eDebug, "Block is nullptr, nothing to free: %p.", memory);
 #endif
 		return;
 	}
 
 #ifdef DVULKAN_ALLOCATOR_TRACE
-	GLOG(Log::eInfo, "Attempting to free block %p.", memory);
+	GLOG(Log::eDebug, "Attempting to free block %p.", memory);
 #endif
 	size_t size;
 	size_t alignment;
 	bool Result = Memory::GetAlignmentSize(memory, &size, &alignment);
 	if (Result) {
 #ifdef DVULKAN_ALLOCATOR_TRACE
-		GLOG(Log::eInfo, "Block %p found with size/alignment: %llu/%llu. Freeing aligned block.", memory, size, alignment);
+		GLOG(Log::eDebug, "Block %p found with size/alignment: %llu/%llu. Freeing aligned block.", memory, size, alignment);
 #endif
 		Memory::FreeAligned(memory, size, MemoryType::eMemory_Type_Vulkan);
 	}
@@ -66,19 +68,19 @@ void* VulkanAllocator::Reallocation(void* user_data, void* original, size_t size
 	}
 
 #ifdef DVULKAN_ALLOCATOR_TRACE
-	GLOG(Log::eInfo, "Attempting to realloc block %p.", original);
+	GLOG(Log::eDebug, "Attempting to realloc block %p.", original);
 #endif
 
 	void* Result = Allocation(user_data, size, alloc_alignment, allocation_scope);
 	if (Result) {
 #ifdef DVULKAN_ALLOCATOR_TRACE
-		GLOG(Log::eInfo, "Block %p reallocated to %p, copying data.", original, Result);
+		GLOG(Log::eDebug, "Block %p reallocated to %p, copying data.", original, Result);
 #endif
 
 		// Copy over the original memory.
 		Memory::Copy(Result, original, size);
 #ifdef DVULKAN_ALLOCATOR_TRACE
-		GLOG(Log::eInfo, "Freeing original aligned block %p.", original);
+		GLOG(Log::eDebug, "Freeing original aligned block %p.", original);
 #endif
 		// Free the original memory only if the new allocation was successful.
 		Memory::Free(original, MemoryType::eMemory_Type_Vulkan);
@@ -94,14 +96,14 @@ void* VulkanAllocator::Reallocation(void* user_data, void* original, size_t size
 
 void VulkanAllocator::InternalAlloc(void* pUserData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope) {
 #ifdef DVULKAN_ALLOCATOR_TRACE
-	GLOG(Log::eInfo, "External allocation of size: %llu.", size);
+	GLOG(Log::eDebug, "External allocation of size: %llu.", size);
 #endif
 	Memory::AllocateReport(size, MemoryType::eMemory_Type_Vulkan_EXT);
 }
 
 void VulkanAllocator::InternalFree(void* pUserData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope) {
 #ifdef DVULKAN_ALLOCATOR_TRACE
-	GLOG(Log::eInfo, "External free of size: %llu.", size);
+	GLOG(Log::eDebug, "External free of size: %llu.", size);
 #endif
 	Memory::FreeReport(size, MemoryType::eMemory_Type_Vulkan_EXT);
 }
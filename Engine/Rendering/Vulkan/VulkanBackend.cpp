@@ -1,4 +1,6 @@
-﻿#include "VulkanBackend.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanBackend.hpp"
 #include "VulkanPlatform.hpp"
 #include "VulkanDevice.hpp"
 #include "VulkanTexture.hpp"
@@ -33,16 +35,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL VulkanDebugCallback(
 	switch (message_servity) {
 	default:
 	case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-		GLOG(Log::eError, callback_data->pMessage);
+		GLOG(Log::eError, "%s", callback_data->pMessage);
 		break;
 	case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-		GLOG(Log::eWarn, callback_data->pMessage);
+		GLOG(Log::eWarn, "%s", callback_data->pMessage);
 		break;
 	case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-		GLOG(Log::eFatal, callback_data->pMessage);
+		GLOG(Log::eFatal, "%s", callback_data->pMessage);
 		break;
 	case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-		GLOG(Log::eInfo, callback_data->pMessage);
+		GLOG(Log::eInfo, "%s", callback_data->pMessage);
 		break;
 	}
 
@@ -321,10 +323,8 @@ bool VulkanRHI::Initialize(const RenderBackendConfig* config, unsigned char* out
 	Context.ObjectIndexBuffer->Bind(0);
 	GLOG(Log::eInfo, "VulkanBackend::CreateRenderbuffer(): Success allocated memory %llu bytes. Enable freelist: %s", IndexBufferSize, "true");
 
-	// Mark all geometry as invalid.
-	for (uint32_t i = 0; i < GEOMETRY_MAX_COUNT; ++i) {
-		Geometries[i].id = INVALID_ID;
-	}
+	Geometries.Clear();
+	Geometries.Reserve(GEOMETRY_MAX_COUNT);
 
 	GLOG(Log::eInfo, "Create vulkan instance succeed.");
 	return true;
@@ -641,13 +641,11 @@ bool VulkanRHI::CreateGeometry(Geometry* geometry, uint32_t vertex_size, uint32_
 	}
 
 	// Check if this is a re-upload. If it is, need to free old data afterward.
-	bool IsReupload = geometry->InternalID != INVALID_ID;
+	GeometryData* InternalData = Geometries.Get(geometry->InternalHandle);
+	bool IsReupload = InternalData != nullptr;
 	GeometryData OldRange;
 
-	GeometryData* InternalData = nullptr;
 	if (IsReupload) {
-		InternalData = &Geometries[geometry->InternalID];
-
 		// Take a copy of the old range.
 		OldRange.index_buffer_offset = InternalData->index_buffer_offset;
 		OldRange.index_count = InternalData->index_count;
@@ -657,20 +655,8 @@ bool VulkanRHI::CreateGeometry(Geometry* geometry, uint32_t vertex_size, uint32_
 		OldRange.vertex_element_size = InternalData->vertex_element_size;
 	}
 	else {
-		for (uint32_t i = 0; i < GEOMETRY_MAX_COUNT; ++i) {
-			if (Geometries[i].id == INVALID_ID) {
-				// Found a free index.
-				geometry->InternalID = i;
-				Geometries[i].id = i;
-				InternalData = &Geometries[i];
-				break;
-			}
-		}
-	}
-
-	if (InternalData == nullptr) {
-		GLOG(Log::eFatal, "Vulkan renderer create geometry failed to find a free index for a new geometry upload. Adjust config to allow for more.");
-		return false;
+		geometry->InternalHandle = Geometries.Emplace();
+		InternalData = Geometries.Get(geometry->InternalHandle);
 	}
 
 	// Vertex data.
@@ -704,20 +690,13 @@ bool VulkanRHI::CreateGeometry(Geometry* geometry, uint32_t vertex_size, uint32_
 		}
 	}
 
-	if (InternalData->generation == INVALID_ID) {
-		InternalData->generation = 0;
-	}
-	else {
-		InternalData->generation++;
-	}
-
 	if (IsReupload) {
 		// Free vertex data.
-		Context.ObjectVertexBuffer->FreeMemory(OldRange.vertext_buffer_offset, OldRange.vertex_element_size * OldRange.vertex_count);
+		Context.ObjectVertexBuffer->FreeMemory(OldRange.vertex_element_size * OldRange.vertex_count, OldRange.vertext_buffer_offset);
 
 		// Free index data.
 		if (OldRange.index_element_size > 0) {
-			Context.ObjectIndexBuffer->FreeMemory(OldRange.index_buffer_offset, OldRange.index_element_size * OldRange.index_count);
+			Context.ObjectIndexBuffer->FreeMemory(OldRange.index_element_size * OldRange.index_count, OldRange.index_buffer_offset);
 		}
 	}
 
@@ -725,9 +704,9 @@ bool VulkanRHI::CreateGeometry(Geometry* geometry, uint32_t vertex_size, uint32_
 }
 
 void VulkanRHI::DestroyGeometry(Geometry* geometry) {
-	if (geometry != nullptr && geometry->InternalID != INVALID_ID) {
+	GeometryData* InternalData = geometry != nullptr ? Geometries.Get(geometry->InternalHandle) : nullptr;
+	if (InternalData != nullptr) {
 		Context.Device.GetLogicalDevice().waitIdle();
-		GeometryData* InternalData = &Geometries[geometry->InternalID];
 
 		// Free vertex data.
 		Context.ObjectVertexBuffer->FreeMemory(InternalData->vertex_element_size * InternalData->vertex_count, InternalData->vertext_buffer_offset);
@@ -738,9 +717,8 @@ void VulkanRHI::DestroyGeometry(Geometry* geometry) {
 		}
 
 		// Clean up date.
-		Memory::Zero(InternalData, sizeof(GeometryData));
-		InternalData->id = INVALID_ID;
-		InternalData->generation = INVALID_ID;
+		Geometries.Erase(geometry->InternalHandle);
+		geometry->InternalHandle = FSlotHandle();
 	}
 }
 
@@ -750,11 +728,11 @@ void VulkanRHI::DrawGeometry(GeometryRenderData* geometry) {
 		return;
 	}
 
-	if (geometry->geometry->InternalID == INVALID_ID) {
+	GeometryData* BufferData = Geometries.Get(geometry->geometry->InternalHandle);
+	if (BufferData == nullptr) {
 		return;
 	}
 
-	GeometryData* BufferData = &Geometries[geometry->geometry->InternalID];
 	bool IncludIndexData = BufferData->index_count > 0;
 	if (!DrawRenderbuffer(Context.ObjectVertexBuffer, BufferData->vertext_buffer_offset, BufferData->vertex_count, IncludIndexData)) {
 		GLOG(Log::eError, "VulkanBackend::DrawGeometry() Failed to draw vertex buffer.");
@@ -971,11 +949,7 @@ bool VulkanRHI::CreateShader(Shader* shader, const ShaderConfig* config, IRender
 	}
 	
 	// Invalidate all instance states.
-	// TODO: Dynamic
-	for (uint32_t i = 0; i < 1024; ++i) {
-		OutShader->InstanceStates[i].id = INVALID_ID;
-		OutShader->InstanceStates[i].offset	= 0;
-	}
+	OutShader->InstanceStates.Clear();
 
 	// Keep a copy of the cull mode.
 	OutShader->Config.cull_mode = config->cull_mode;
@@ -1053,24 +1027,16 @@ void VulkanRHI::ReleaseTextureMap(TextureMap* map) {
 	}
 }
 
-uint32_t VulkanRHI::AcquireInstanceResource(Shader* shader, std::vector<TextureMap*>& maps) {
+uint64_t VulkanRHI::AcquireInstanceResource(Shader* shader, std::vector<TextureMap*>& maps) {
 	VulkanShader* VkShader = (VulkanShader*)shader;
-	// TODO: Dynamic
-	uint32_t OutInstanceID = INVALID_ID;
-	for (uint32_t i = 0; i < 1024; ++i) {
-		if (VkShader->InstanceStates[i].id == INVALID_ID) {
-			VkShader->InstanceStates[i].id = i;
-			OutInstanceID = i;
-			break;
-		}
-	}
-
-	if (OutInstanceID == INVALID_ID) {
+	// The uniform buffer is sized for VULKAN_MAX_MATERIAL_COUNT instances.
+	if (VkShader->InstanceStates.Size() >= VULKAN_MAX_MATERIAL_COUNT) {
 		GLOG(Log::eError, "vulkan_shader_acquire_instance_resources failed to acquire new id");
-		return INVALID_ID;
+		return INVALID_ID_U64;
 	}
-	
-	VulkanShaderInstanceState* InstanceState = &VkShader->InstanceStates[OutInstanceID];
+
+	FSlotHandle InstanceHandle = VkShader->InstanceStates.Emplace();
+	VulkanShaderInstanceState* InstanceState = VkShader->InstanceStates.Get(InstanceHandle);
 	unsigned char SamplerBindingIndex = VkShader->Config.descriptor_sets[DESC_SET_INDEX_INSTANCE].sampler_binding_index;
 	uint32_t InstanceTextureCount = VkShader->Config.descriptor_sets[DESC_SET_INDEX_INSTANCE].bindings[SamplerBindingIndex].descriptorCount;
 	
@@ -1092,7 +1058,8 @@ uint32_t VulkanRHI::AcquireInstanceResource(Shader* shader, std::vector<TextureM
 	if (Size > 0) {
 		if (!VkShader->UniformBuffer.AllocateMemory(Size, &InstanceState->offset)) {
 			GLOG(Log::eError, "vulkan_material_shader_acquire_resources failed to acquire ubo space");
-			return INVALID_ID;
+			VkShader->InstanceStates.Erase(InstanceHandle);
+			return INVALID_ID_U64;
 		}
 	}
 
@@ -1122,11 +1089,12 @@ uint32_t VulkanRHI::AcquireInstanceResource(Shader* shader, std::vector<TextureM
 	if(Context.Device.GetLogicalDevice().allocateDescriptorSets(&AllocInfo, InstanceState->descriptor_set_state.descriptorSets.data())
 		!= vk::Result::eSuccess) {
 			GLOG(Log::eError, "Allocate descriptor sets failed.");
-			return INVALID_ID;
+			VkShader->UniformBuffer.FreeMemory(shader->UboStride, InstanceState->offset);
+			VkShader->InstanceStates.Erase(InstanceHandle);
+			return INVALID_ID_U64;
 	}
-	VkShader->InstanceCount = OutInstanceID;
 
-	return OutInstanceID;
+	return InstanceHandle.ToUInt64();
 }
 
 bool VulkanRHI::ReleaseInstanceResource(Shader* shader, uint64_t instance_id) {
@@ -1135,7 +1103,12 @@ bool VulkanRHI::ReleaseInstanceResource(Shader* shader, uint64_t instance_id) {
 	}
 
 	VulkanShader* VkShader = (VulkanShader*)shader;
-	VulkanShaderInstanceState* InstanceState = &VkShader->InstanceStates[instance_id];
+	FSlotHandle InstanceHandle = FSlotHandle::FromUInt64(instance_id);
+	VulkanShaderInstanceState* InstanceState = VkShader->InstanceStates.Get(InstanceHandle);
+	if (InstanceState == nullptr) {
+		GLOG(Log::eWarn, "Tried to release a stale shader instance id %llu.", (unsigned long long)instance_id);
+		return false;
+	}
 
 	// Wait for any pending operations using the descriptor set to finish.
 	Context.Device.GetLogicalDevice().waitIdle();
@@ -1154,8 +1127,7 @@ bool VulkanRHI::ReleaseInstanceResource(Shader* shader, uint64_t instance_id) {
 	}
 
 	VkShader->UniformBuffer.FreeMemory(shader->UboStride, InstanceState->offset);
-	InstanceState->offset = INVALID_ID;
-	InstanceState->id = INVALID_ID;
+	VkShader->InstanceStates.Erase(InstanceHandle);
 
 	return true;
 }
@@ -53,7 +53,7 @@ public:
 
 	// Shaders.
 	virtual bool CreateShader(Shader* shader, const ShaderConfig* config, IRenderpass* pass, const TArray<FString>& stage_filenames, std::vector<ShaderStage>& stages) override;
-	virtual uint32_t AcquireInstanceResource(Shader* shader, std::vector<TextureMap*>& maps) override;
+	virtual uint64_t AcquireInstanceResource(Shader* shader, std::vector<TextureMap*>& maps) override;
 	virtual bool ReleaseInstanceResource(Shader* shader, uint64_t instance_id) override;
 
 	virtual bool AcquireTextureMap(TextureMap* map) override;
@@ -1,4 +1,6 @@
-﻿#include "VulkanBuffer.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanBuffer.hpp"
 
 #include "VulkanContext.hpp"
 
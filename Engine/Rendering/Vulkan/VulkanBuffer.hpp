@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.hpp>
 #include "Memory/Freelist.hpp"
+#include "Memory/ObjectPool.h"
 #include "Rendering/Interface/IGPUBuffer.hpp"
 
 class VulkanContext;
@@ -50,4 +51,6 @@ public:
 	vk::MemoryRequirements MemoryRequirements;
 	int MemoryIndex = -1;
 	vk::MemoryPropertyFlags MemoryPropertyFlags;
-};
\ No newline at end of file
+};
+
+DECLARE_OBJECT_POOL(VulkanBuffer)
\ No newline at end of file
@@ -1,4 +1,6 @@
-﻿#include "VulkanCommandBuffer.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanCommandBuffer.hpp"
 #include "VulkanContext.hpp"
 
 #include "Core/DMemory.hpp"
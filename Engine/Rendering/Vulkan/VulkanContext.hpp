@@ -43,7 +43,7 @@ public:
 			}
 		}
 
-		GLOG(Log::eWarn, "Unable to find suitable memory type!");
+		GLOG_CATEGORY(Log::Category::eVulkan, Log::eWarn, "Unable to find suitable memory type!");
 		return INVALID_ID;
 	}
 
@@ -1,4 +1,6 @@
-﻿#include "VulkanDevice.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanDevice.hpp"
 #include "VulkanContext.hpp"
 #include "Containers/TArray.hpp"
 
@@ -1,4 +1,6 @@
-﻿#include "VulkanPipeline.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanPipeline.hpp"
 #include "VulkanContext.hpp"
 
 #include "Systems/ShaderSystem.h"
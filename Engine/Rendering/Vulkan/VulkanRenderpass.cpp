@@ -1,4 +1,6 @@
-﻿#include "VulkanRenderpass.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanRenderpass.hpp"
 
 #include "VulkanContext.hpp"
 #include "VulkanCommandBuffer.hpp"
@@ -1,4 +1,6 @@
-﻿#include "VulkanShader.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanShader.hpp"
 #include "Systems/TextureSystem.h"
 #include "Systems/ResourceSystem.h"
 #include "Core/EngineLogger.hpp"
@@ -12,7 +14,6 @@ VulkanShader::VulkanShader() : Shader() {
 	ID = INVALID_ID;
 	MappedUniformBufferBlock = nullptr;
 	Renderpass = nullptr;
-	InstanceCount = 0;
 	GlobalUniformCount = 0;
 	GlobalUniformSamplerCount = 0;
 	InstanceUniformCount = 0;
@@ -233,8 +234,12 @@ bool VulkanShader::BindInstance(uint64_t instance_id) {
 	BoundInstanceId = instance_id;
 	BoundScope = eShader_Scope_Instance;
 
-	VulkanShaderInstanceState& State = InstanceStates[instance_id];
-	BoundUboOffset = (uint32_t)State.offset;
+	VulkanShaderInstanceState* State = InstanceStates.Get(FSlotHandle::FromUInt64(instance_id));
+	if (State == nullptr) {
+		GLOG(Log::eError, "BindInstance — instance id %llu 已失效。", (unsigned long long)instance_id);
+		return false;
+	}
+	BoundUboOffset = (uint32_t)State->offset;
 
 	return true;
 }
@@ -312,7 +317,12 @@ bool VulkanShader::ApplyInstance(bool need_update) {
 	VulkanContext& Context = Backend->Context;
 	uint32_t       ImageIndex = Context.ImageIndex;
 
-	VulkanShaderInstanceState& State = InstanceStates[BoundInstanceId];
+	VulkanShaderInstanceState* InstanceState = InstanceStates.Get(FSlotHandle::FromUInt64(BoundInstanceId));
+	if (InstanceState == nullptr) {
+		GLOG(Log::eError, "ApplyInstance — 未绑定有效的 instance。");
+		return false;
+	}
+	VulkanShaderInstanceState& State = *InstanceState;
 	vk::DescriptorSet          DescSet = State.descriptor_set_state.descriptorSets[ImageIndex];
 
 	if (!need_update) {
@@ -417,7 +427,7 @@ bool VulkanShader::ApplyInstance(bool need_update) {
 	return true;
 }
 
-bool VulkanShader::SetUniform(const FString& name, const void* value) {
+bool VulkanShader::SetUniform(FName name, const void* value) {
 	uint32_t Index = GetUniformIndex(name);
 	if (Index == INVALID_ID) return false;
 	return SetUniformByIndex(Index, value);
@@ -499,12 +509,12 @@ bool VulkanShader::SetSamplerByIndex(uint32_t index, const TextureMap* map) {
 		GlobalTextureMaps[Uniform->location] = const_cast<TextureMap*>(map);
 	}
 	else {
-		VulkanShaderInstanceState& State = InstanceStates[BoundInstanceId];
-		if (Uniform->location >= (uint32_t)State.instance_texture_maps.size()) {
+		VulkanShaderInstanceState* State = InstanceStates.Get(FSlotHandle::FromUInt64(BoundInstanceId));
+		if (State == nullptr || Uniform->location >= (uint32_t)State->instance_texture_maps.size()) {
 			GLOG(Log::eError, "SetSamplerByIndex — Instance sampler location 越界。");
 			return false;
 		}
-		State.instance_texture_maps[Uniform->location] = const_cast<TextureMap*>(map);
+		State->instance_texture_maps[Uniform->location] = const_cast<TextureMap*>(map);
 	}
 
 	return true;
@@ -4,6 +4,7 @@
 #include "VulkanPipeline.hpp"
 #include "VulkanBuffer.hpp"
 #include "Rendering/Resources/ResourceTypes.hpp"
+#include "Containers/TSlotMap.hpp"
 
 class VulkanRenderPass;
 class VulkanCommandBuffer;
@@ -62,7 +63,6 @@ struct VulkanShaderStage {
 };
 
 struct VulkanShaderInstanceState {
-	uint32_t id = INVALID_ID;
 	size_t offset = 0;
 	VulkanShaderDescriptorSetState descriptor_set_state;
 	std::vector<TextureMap*> instance_texture_maps;
@@ -134,7 +134,7 @@ public:
 	 * @param value A pointer to the value to be set.
 	 * @return b8 True on success; otherwise false.
 	 */
-	virtual bool SetUniform(const FString& name, const void* value) override;
+	virtual bool SetUniform(FName name, const void* value) override;
 
 	virtual bool SetUniformByIndex(uint32_t index, const void* value) override;
 
@@ -163,8 +163,8 @@ public:
 	vk::DescriptorSet         GlobalDescriptorSets[3];
 	VulkanBuffer              UniformBuffer;
 	VulkanPipeline            Pipeline;
-	uint32_t                  InstanceCount = 0;
-	VulkanShaderInstanceState InstanceStates[VULKAN_MAX_MATERIAL_COUNT];
+	// Instance ids handed out by AcquireInstanceResource are packed handles into this map.
+	TSlotMap<VulkanShaderInstanceState> InstanceStates;
 
 	unsigned char GlobalUniformCount = 0;
 	unsigned char GlobalUniformSamplerCount = 0;
@@ -1,4 +1,6 @@
-﻿#include "VulkanSwapchain.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanSwapchain.hpp"
 #include "VulkanContext.hpp"
 #include "VulkanTexture.hpp"
 
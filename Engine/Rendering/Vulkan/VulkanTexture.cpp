@@ -1,4 +1,6 @@
-﻿#include "VulkanTexture.hpp"
+﻿#define LOG_CATEGORY Log::Category::eVulkan
+
+#include "VulkanTexture.hpp"
 #include "VulkanContext.hpp"
 
 #include "Core/DMemory.hpp"
@@ -1,4 +1,6 @@
-﻿#include "FontSystem.hpp"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "FontSystem.hpp"
 
 #include "Core/DMemory.hpp"
 #include "Core/EngineLogger.hpp"
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "MaterialSystem.h"
+#include "Containers/FName.hpp"
+#include "Containers/TSlotMap.hpp"
 #include "Rendering/Resources/Geometry/Geometry.hpp"
 
 #define GEOMETRY_MAX_COUNT 4096
@@ -8,8 +10,6 @@
 #define DEFAULT_GEOMETRY_CUBE_NAME "DefaultGeometryCube"
 
 struct GeometryData {
-	uint32_t id = INVALID_ID;
-	uint32_t generation = INVALID_ID;
 	// Vertices
 	uint32_t vertex_count = 0;
 	uint32_t vertex_element_size = 0;
@@ -29,12 +29,20 @@ public:
 	void Shutdown();
 
 	/*
-	* @brief Acquires an existing geometry by id.
+	* @brief Acquires an existing geometry by its handle.
 	* 
-	* @param id The geometry identifier to acquire by.
-	* @return A pointer to the acquired geometry or nullptr if failed.
+	* @param handle The geometry handle, see Geometry::GetHandle().
+	* @return A pointer to the acquired geometry or nullptr if the handle is stale.
 	*/
-	Geometry* AcquireByID(uint32_t id);
+	Geometry* AcquireByHandle(FSlotHandle handle);
+
+	/*
+	* @brief Acquires an existing geometry by the name it was created with.
+	*
+	* @param name The geometry name.
+	* @return A pointer to the acquired geometry or nullptr if no geometry has this name.
+	*/
+	Geometry* AcquireByName(FName name);
 
 	/*
 	* @brief Registers and acquires a new geometry using the given config.
@@ -111,13 +119,16 @@ public:
 private:
 	bool CreateDefaultGeometries();
 	Geometry* CreateGeometry(SGeometryConfig config);
+	void RegisterGeometry(Geometry* geometry);
 	void DestroyGeometry(Geometry* geometry);
 
 public:
 	Geometry* DefaultGeometry = nullptr;
 	Geometry* Default2DGeometry = nullptr;
 
-	TArray<Geometry*> RegisteredGeometries;
+	TSlotMap<Geometry*> RegisteredGeometries;
+	// Geometry name to handle in RegisteredGeometries.
+	std::unordered_map<FName, FSlotHandle> GeometryMap;
 	IRenderer* Renderer = nullptr;
 
 	bool Initilized;
@@ -1,4 +1,6 @@
-﻿#include "GeometrySystem.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "GeometrySystem.h"
 
 #include "Rendering/Renderer.hpp"
 #include "Core/EngineLogger.hpp"
@@ -20,6 +22,7 @@ bool GeometrySystem::Initialize(IRenderer* renderer) {
 
 	// Invalidate all geometries in the array.
 	RegisteredGeometries.Clear();
+	GeometryMap.clear();
 	if (!CreateDefaultGeometries()) {
 		GLOG(Log::eFatal, "Failed to create default geometries. Application quit now!");
 		return false;
@@ -38,20 +41,33 @@ void GeometrySystem::Shutdown() {
 		DeleteObject(Default2DGeometry);
 	}
 
+	RegisteredGeometries.Clear();
+	GeometryMap.clear();
 	Initilized = false;
 }
 
-Geometry* GeometrySystem::AcquireByID(uint32_t id) {
-	if (id < RegisteredGeometries.Size() && RegisteredGeometries[id]->ID != INVALID_ID) {
-		RegisteredGeometries[id]->reference_count++;
-		return RegisteredGeometries[id];
+Geometry* GeometrySystem::AcquireByHandle(FSlotHandle handle) {
+	Geometry** Found = RegisteredGeometries.Get(handle);
+	if (Found != nullptr) {
+		(*Found)->reference_count++;
+		return *Found;
 	}
 
 	// NOTE: Should return default geometry instead.
-	GLOG(Log::eError, "Geometry system acquire by id cannot load invalid id. Reutrn nullptr.");
+	GLOG(Log::eError, "Geometry system acquire by handle cannot load stale handle (%u, %u). Reutrn nullptr.", handle.Index, handle.Generation);
 	return nullptr;
 }
 
+Geometry* GeometrySystem::AcquireByName(FName name) {
+	auto It = GeometryMap.find(name);
+	if (It == GeometryMap.end()) {
+		GLOG(Log::eWarn, "Geometry system acquire by name cannot find geometry '%s'. Reutrn nullptr.", name.CStr());
+		return nullptr;
+	}
+
+	return AcquireByHandle(It->second);
+}
+
 Geometry* GeometrySystem::AcquireFromConfig(SGeometryConfig config, bool auto_release) {
 	Geometry* geometry = CreateGeometry(config);
 	if (!geometry) {
@@ -59,8 +75,9 @@ Geometry* GeometrySystem::AcquireFromConfig(SGeometryConfig config, bool auto_re
 		return nullptr;
 	}
 
-	RegisteredGeometries.Push(geometry);
-	geometry->ID = (uint32_t)RegisteredGeometries.Size() - 1;
+	if (!config.name.IsEmpty()) {
+		GeometryMap[config.name] = geometry->GetHandle();
+	}
 
 	return geometry;
 }
@@ -140,7 +157,6 @@ bool GeometrySystem::CreateDefaultGeometries() {
 	}
 
 	// Send the geometry off to the renderer to be uploaded to the GPU.
-	DefaultGeometry->InternalID = INVALID_ID;
 	if (!Renderer->CreateGeometry(DefaultGeometry, sizeof(Vertex), 4, Verts, sizeof(uint32_t), 6, Indices)) {
 		GLOG(Log::eFatal, "Failed to create default geometry. Application quit now!");
 		return false;
@@ -175,7 +191,7 @@ bool GeometrySystem::CreateDefaultGeometries() {
 
 	// Indices NOTO: counter-clockwise.
 	uint32_t Indices2D[6] = { 2, 1, 0, 3, 0, 1 };
-	RegisteredGeometries.Push(DefaultGeometry);
+	RegisterGeometry(DefaultGeometry);
 
 	Default2DGeometry = NewObject<Geometry>("Default2DGeometry");
 	if (!Default2DGeometry) {
@@ -183,7 +199,6 @@ bool GeometrySystem::CreateDefaultGeometries() {
 	}
 
 	// Send the geometry off to the renderer to be uploaded to the GPU.
-	Default2DGeometry->InternalID = INVALID_ID;
 	if (!Renderer->CreateGeometry(Default2DGeometry, sizeof(Vertex2D), 4, Verts2D, sizeof(uint32_t), 6, Indices2D)) {
 		GLOG(Log::eFatal, "Failed to create default 2d geometry. Application quit now!");
 		return false;
@@ -191,7 +206,7 @@ bool GeometrySystem::CreateDefaultGeometries() {
 
 	// Acquire the default material.
 	Default2DGeometry->Material = MaterialSystem::Get().GetDefaultMaterial();
-	RegisteredGeometries.Push(Default2DGeometry);
+	RegisterGeometry(Default2DGeometry);
 
 	return true;
 }
@@ -225,12 +240,16 @@ Geometry* GeometrySystem::CreateGeometry(SGeometryConfig config) {
 		geometry->Material = MaterialSystem::Get().GetDefaultMaterial();
 	}
 
-	RegisteredGeometries.Push(geometry);
-	geometry->ID = (uint32_t)RegisteredGeometries.Size() - 1;
-
+	RegisterGeometry(geometry);
 	return geometry;
 }
 
+void GeometrySystem::RegisterGeometry(Geometry* geometry) {
+	FSlotHandle Handle = RegisteredGeometries.Insert(geometry);
+	geometry->ID = Handle.Index;
+	geometry->Generation = Handle.Generation;
+}
+
 void GeometrySystem::ConfigDispose(SGeometryConfig* config) {
 	if (config) {
 		if (config->vertices) {
@@ -244,10 +263,19 @@ void GeometrySystem::ConfigDispose(SGeometryConfig* config) {
 }
 
 void GeometrySystem::DestroyGeometry(Geometry* geometry) {
+	// Only drop the name if it still refers to this geometry.
+	auto It = GeometryMap.find(geometry->name);
+	if (It != GeometryMap.end() && It->second == geometry->GetHandle()) {
+		GeometryMap.erase(It);
+	}
+
+	// Any handle still pointing at this geometry goes stale.
+	RegisteredGeometries.Erase(geometry->GetHandle());
+
 	Renderer->DestroyGeometry(geometry);
 	geometry->ID = INVALID_ID;
 	geometry->Generation = INVALID_ID;
-	geometry->InternalID = INVALID_ID;
+	geometry->InternalHandle = FSlotHandle();
 
 	geometry->name[0] = '0';
 
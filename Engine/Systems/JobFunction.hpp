@@ -0,0 +1,207 @@
+﻿#pragma once
+
+#include "Defines.hpp"
+#include "Core/DMemory.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#define JOB_FUNCTION_INLINE_SIZE 64		// 闭包不超过这个大小时直接存放在对象内部，不分配内存
+
+template<typename Signature>
+class TJobFunction;
+
+//
+// 任务使用的可调用对象，用法与 std::function<R()> 相同。
+//
+// 闭包不超过 JOB_FUNCTION_INLINE_SIZE 字节、对齐不超过 max_align_t 且移动不抛异常时直接构造在
+// 对象内部，提交、拷贝、移动都不分配内存。例如捕获 this 加一个 shared_ptr 只有 24 字节。
+// 更大的闭包放进 Memory 的小块池（按线程缓存，命中时不加锁），标记为 eMemory_Type_Job。
+//
+// 返回值为 void 时可以接受有返回值的可调用对象，返回值被丢弃。
+//
+template<typename R>
+class TJobFunction<R()> {
+public:
+    TJobFunction() = default;
+    TJobFunction(std::nullptr_t) {}
+
+    template<typename Func, typename = std::enable_if_t<
+        !std::is_same<std::decay_t<Func>, TJobFunction>::value && !std::is_same<std::decay_t<Func>, std::nullptr_t>::value>>
+    TJobFunction(Func&& func) {
+        Assign(std::forward<Func>(func));
+    }
+
+    TJobFunction(const TJobFunction& other) {
+        if (other.ops != nullptr) {
+            other.ops->copy(storage, other.storage);
+            ops = other.ops;
+        }
+    }
+
+    TJobFunction(TJobFunction&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    ~TJobFunction() {
+        Reset();
+    }
+
+    TJobFunction& operator=(const TJobFunction& other) {
+        if (this != &other) {
+            TJobFunction copy(other);
+            Reset();
+            MoveFrom(copy);
+        }
+        return *this;
+    }
+
+    TJobFunction& operator=(TJobFunction&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    TJobFunction& operator=(std::nullptr_t) {
+        Reset();
+        return *this;
+    }
+
+    template<typename Func, typename = std::enable_if_t<
+        !std::is_same<std::decay_t<Func>, TJobFunction>::value && !std::is_same<std::decay_t<Func>, std::nullptr_t>::value>>
+    TJobFunction& operator=(Func&& func) {
+        Reset();
+        Assign(std::forward<Func>(func));
+        return *this;
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    R operator()() const {
+        return ops->invoke(const_cast<unsigned char*>(storage));
+    }
+
+    void Reset() {
+        if (ops != nullptr) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    // 闭包是否存放在对象内部，用于统计与测试
+    bool IsInline() const { return ops == nullptr || ops->is_inline; }
+
+private:
+    struct Ops {
+        R    (*invoke)(void* storage);
+        void (*copy)(void* dst, const void* src);
+        void (*move)(void* dst, void* src);     // 移动后 src 不再持有闭包
+        void (*destroy)(void* storage);
+        bool is_inline;
+    };
+
+    template<typename Func>
+    static constexpr bool FitsInline() {
+        return sizeof(Func) <= JOB_FUNCTION_INLINE_SIZE && alignof(Func) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible<Func>::value;
+    }
+
+    template<typename Func>
+    static constexpr size_t PoolAlignment() {
+        return alignof(Func) > DEFAULT_ALIGNMENT_SIZE ? alignof(Func) : DEFAULT_ALIGNMENT_SIZE;
+    }
+
+    template<typename Func>
+    static Func* Get(void* storage) {
+        if constexpr (FitsInline<Func>()) {
+            return static_cast<Func*>(storage);
+        }
+        else {
+            return *static_cast<Func**>(storage);
+        }
+    }
+
+    template<typename Func>
+    static void Construct(void* storage, Func&& func) {
+        using FuncType = std::decay_t<Func>;
+        if constexpr (FitsInline<FuncType>()) {
+            new(storage) FuncType(std::forward<Func>(func));
+        }
+        else {
+            void* block = Memory::AllocateUninitializedAligned(sizeof(FuncType), PoolAlignment<FuncType>(), eMemory_Type_Job);
+            *static_cast<FuncType**>(storage) = new(block) FuncType(std::forward<Func>(func));
+        }
+    }
+
+    template<typename Func>
+    static R Invoke(void* storage) {
+        if constexpr (std::is_void<R>::value) {
+            (*Get<Func>(storage))();
+        }
+        else {
+            return (*Get<Func>(storage))();
+        }
+    }
+
+    template<typename Func>
+    static void Copy(void* dst, const void* src) {
+        Construct(dst, *Get<Func>(const_cast<void*>(src)));
+    }
+
+    template<typename Func>
+    static void Move(void* dst, void* src) {
+        if constexpr (FitsInline<Func>()) {
+            Func* source = Get<Func>(src);
+            new(dst) Func(std::move(*source));
+            source->~Func();
+        }
+        else {
+            // 池里的闭包直接转交指针
+            *static_cast<Func**>(dst) = *static_cast<Func**>(src);
+        }
+    }
+
+    template<typename Func>
+    static void Destroy(void* storage) {
+        Func* func = Get<Func>(storage);
+        func->~Func();
+        if constexpr (!FitsInline<Func>()) {
+            Memory::FreeAligned(func, sizeof(Func), eMemory_Type_Job);
+        }
+    }
+
+    template<typename Func>
+    static const Ops* GetOps() {
+        static const Ops func_ops = { &Invoke<Func>, &Copy<Func>, &Move<Func>, &Destroy<Func>, FitsInline<Func>() };
+        return &func_ops;
+    }
+
+    template<typename Func>
+    void Assign(Func&& func) {
+        using FuncType = std::decay_t<Func>;
+        static_assert(std::is_copy_constructible<FuncType>::value, "TJobFunction requires a copyable callable.");
+        if constexpr (std::is_pointer<FuncType>::value) {
+            if (func == nullptr) {
+                return;
+            }
+        }
+        Construct(storage, std::forward<Func>(func));
+        ops = GetOps<FuncType>();
+    }
+
+    void MoveFrom(TJobFunction& other) {
+        if (other.ops != nullptr) {
+            other.ops->move(storage, other.storage);
+            ops = other.ops;
+            other.ops = nullptr;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char storage[JOB_FUNCTION_INLINE_SIZE];
+    const Ops* ops = nullptr;
+};
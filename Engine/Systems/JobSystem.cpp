@@ -1,210 +1,913 @@
-﻿#include "JobSystem.hpp"
+﻿#define LOG_CATEGORY Log::Category::eJobs
+
+#include "JobSystem.hpp"
 #include "Core/EngineLogger.hpp"
 #include "Platform/Platform.hpp"
+#include "Containers/TConcurrentQueue.hpp"
+#include "Containers/TInlineArray.hpp"
+#include "Containers/TWorkStealingDeque.hpp"
 
+#include <algorithm>
 #include <atomic>
-#include <queue>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <memory>
+#include <thread>
 #include <vector>
 
-// ─── 内部实现 ─────────────────────────────────────────────────────────────────
+#define JOB_PRIORITY_COUNT 3				// JobPriority 的个数，下标越大优先级越高
+#define JOB_INJECT_QUEUE_CAPACITY 4096		// 非工作线程提交的任务先进这里，每个类型每个优先级一个
+#define JOB_SPIN_COUNT 64					// 找不到任务时先自旋这么多轮
+#define JOB_YIELD_COUNT 8					// 自旋之后再让出时间片这么多轮，仍然没有任务才休眠
+#define JOB_CHUNK_SHIFT 10					// 任务记录按块分配，每块 1024 个
+#define JOB_MAX_CHUNKS 64					// 同时存在的任务最多 64 * 1024 个
+#define JOB_MAX_COUNT (JOB_MAX_CHUNKS << JOB_CHUNK_SHIFT)
+#define JOB_INLINE_DEPENDENTS 4				// 每个任务记录内联保存的后继个数
+#define JOB_LOCAL_FREE_COUNT 64				// 每个工作线程缓存的空闲任务记录数，满了把一半还给全局空闲队列
+#define JOB_PARALLEL_CHUNKS_PER_THREAD 4	// ParallelFor 给每个参与线程平均切几块，先做完的线程可以多领
+#define JOB_TRACE_EXTERNAL_THREADS 4		// 在 Wait 中帮忙执行任务的外部线程最多跟踪几个
+#define JOB_TRACE_EXTERNAL_TID_BASE 1000	// 导出时外部线程的 tid 从这里开始，与工作线程下标区分
+#define JOB_TRACE_MIN_IDLE_NS 10000			// 短于 10 微秒的空闲只计数，不写入跟踪，避免刷掉环形缓冲区
+#define JOB_THREAD_NAME_LENGTH 64			// 工作线程名的缓冲区大小，Linux 上系统只保留前 15 个字符
 
-struct JobSystemImpl {
+static_assert((JOB_TRACE_RING_EVENTS & (JOB_TRACE_RING_EVENTS - 1)) == 0, "JOB_TRACE_RING_EVENTS must be a power of two.");
 
-	// ── 单个类型的任务队列 ────────────────────────────────────────────────────
+// ─── 内部实现 ─────────────────────────────────────────────────────────────────
+//
+// 每个工作线程按优先级各有一个 Chase-Lev 双端队列，工作线程里提交的任务直接压入自己的队列。
+// 主线程、加载线程等外部线程没有自己的队列，提交到按 JobType 和优先级划分的无锁注入队列。
+//
+// 工作线程从高优先级到低优先级逐级查找：自己的队列 → 自己类型的注入队列 → 其他类型的注入队列
+// → 从随机位置开始依次窃取其他工作线程的队列。JobType 只决定先看哪个注入队列，空闲的线程
+// 会去帮其他类型干活。
+//
+// 找不到任务时先自旋，再让出时间片，最后在条件变量上休眠。提交方只在有线程休眠时才加锁唤醒。
+//
+// 工作线程按 JobSystemConfig 绑定到物理核心，先在自己的线程上构造 Worker（队列、空闲记录缓存、
+// 跟踪缓冲区），按首次访问落在本 NUMA 节点的内存上，全部就绪后 Initialize 才放行。
+//
+// 任务记录放在按块分配、地址不变的池里，句柄是记录下标加代数。任务完成时代数加一，旧句柄随之
+// 变为“已完成”，记录回到空闲列表复用。工作线程先用自己缓存的空闲记录，批量与全局空闲队列交换，
+// 大多数提交和回收不碰共享数据。有依赖的任务先挂到依赖的后继列表（或计数器的等待列表）上，
+// pending 记录还没完成的依赖数，降到 0 时才进入队列。
+//
+// 每个执行任务的线程有一个只由自己写入的跟踪环形缓冲区，记录任务的起止时间与排队等待时间、
+// 窃取和空闲区间，DumpTrace 随时可以读取。计数器同样只由所属线程写入，GetStats 从其他线程读。
+//
+// 有 on_success / on_failed 的任务完成后，记录连同回调一起挂到无锁的完成队列上。主线程在 Update
+// 里把它们按回调优先级移到各自的积压链表，在时间预算内执行回调后再回收记录，整个过程不加锁也不分配内存。
 
-	struct QueueEntry {
-		JobInfo job;
-		bool operator<(const QueueEntry& o) const {
-			return static_cast<int>(job.priority) < static_cast<int>(o.job.priority);
+// 只保护后继列表的几次读写，临界区很短，自旋即可
+class JobSpinLock {
+public:
+	explicit JobSpinLock(std::atomic_flag& flag) : Flag(flag) {
+		while (Flag.test_and_set(std::memory_order_acquire)) {
+			DCPU_PAUSE();
 		}
-	};
+	}
+	~JobSpinLock() { Flag.clear(std::memory_order_release); }
 
-	struct TypedQueue {
-		TypedQueue() = default;
-		~TypedQueue() = default;
+	JobSpinLock(const JobSpinLock&) = delete;
+	JobSpinLock& operator=(const JobSpinLock&) = delete;
 
-		TypedQueue(const TypedQueue&) = delete;
-		TypedQueue& operator=(const TypedQueue&) = delete;
+private:
+	std::atomic_flag& Flag;
+};
 
-		std::priority_queue<QueueEntry> pq;
-		Mutex                           mtx;
-		ConditionVariable               cv;
+// ─── 跟踪 ─────────────────────────────────────────────────────────────────────
 
-		void Push(JobInfo job) {
-			{
-				MutexGuard guard(mtx);
-				pq.push(QueueEntry{ std::move(job) });
-			}
-			// 只唤醒一个监听该队列的线程
-			cv.NotifyOne();
-		}
+static uint64_t TraceNow() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-		// 阻塞直到取到任务或 shutdown
-		// 返回 false = shutdown，线程应退出
-		bool WaitAndPop(JobInfo& out, std::atomic<bool>& running) {
-			mtx.Lock();
+enum class JobTraceKind : uint8_t {
+	eJob = 0,
+	eIdle = 1,
+	eSteal = 2
+};
 
-			while (running.load() && pq.empty()) {
-				cv.Wait(mtx);
-			}
+struct JobTraceEvent {
+	uint64_t     begin;
+	uint64_t     end;
+	const char*  name;
+	JobTraceKind kind;
+	uint8_t      type;
+	uint8_t      priority;
+	uint32_t     arg;				// 任务：排队等待的微秒数；窃取：被偷的工作线程下标
+};
 
-			if (!running.load() && pq.empty()) {
-				mtx.UnLock();
-				return false;
-			}
+// 单写者环形缓冲区：只有所属线程写入，其他线程可以同时读取。
+// 槽位都是 relaxed 原子变量，读取方拷贝完再看一次写下标，丢掉拷贝期间可能被覆盖的事件。
+class JobTraceRing {
+public:
+	void Record(JobTraceKind kind, uint64_t begin, uint64_t end, const char* name, uint8_t type, uint8_t priority, uint32_t arg) {
+		const uint64_t head = Head.load(std::memory_order_relaxed);
+		Slot& slot = Slots[head & (JOB_TRACE_RING_EVENTS - 1)];
+		slot.begin.store(begin, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.info.store((uint64_t)kind | ((uint64_t)type << 8) | ((uint64_t)priority << 16) | ((uint64_t)arg << 32), std::memory_order_relaxed);
+		Head.store(head + 1, std::memory_order_release);
+	}
 
-			out = std::move(const_cast<QueueEntry&>(pq.top()).job);
-			pq.pop();
+	// 追加与 [begin_ns, end_ns] 重叠的事件
+	void Collect(uint64_t begin_ns, uint64_t end_ns, std::vector<JobTraceEvent>& out_events) const {
+		const uint64_t head = Head.load(std::memory_order_acquire);
+		const uint64_t first = head > JOB_TRACE_RING_EVENTS ? head - JOB_TRACE_RING_EVENTS : 0;
 
-			mtx.UnLock();
-			return true;
+		std::vector<JobTraceEvent> copied;
+		copied.reserve((size_t)(head - first));
+		for (uint64_t i = first; i < head; ++i) {
+			const Slot& slot = Slots[i & (JOB_TRACE_RING_EVENTS - 1)];
+			const uint64_t info = slot.info.load(std::memory_order_relaxed);
+			JobTraceEvent event;
+			event.begin = slot.begin.load(std::memory_order_relaxed);
+			event.end = slot.end.load(std::memory_order_relaxed);
+			event.name = slot.name.load(std::memory_order_relaxed);
+			event.kind = (JobTraceKind)(info & 0xFF);
+			event.type = (uint8_t)((info >> 8) & 0xFF);
+			event.priority = (uint8_t)((info >> 16) & 0xFF);
+			event.arg = (uint32_t)(info >> 32);
+			copied.push_back(event);
 		}
 
-		void WakeAll() {
-			cv.NotifyAll();
+		// 写入方正在写的是下标 current 的事件，它覆盖的是 current - N，比它新的都完整
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64_t current = Head.load(std::memory_order_relaxed);
+		const uint64_t valid = current >= JOB_TRACE_RING_EVENTS ? current - JOB_TRACE_RING_EVENTS + 1 : 0;
+		for (uint64_t i = first > valid ? first : valid; i < head; ++i) {
+			const JobTraceEvent& event = copied[(size_t)(i - first)];
+			if (event.end >= begin_ns && event.begin <= end_ns) {
+				out_events.push_back(event);
+			}
 		}
+	}
+
+private:
+	struct Slot {
+		std::atomic<uint64_t>    begin{ 0 };
+		std::atomic<uint64_t>    end{ 0 };
+		std::atomic<const char*> name{ nullptr };
+		std::atomic<uint64_t>    info{ 0 };
+	};
+
+	Slot Slots[JOB_TRACE_RING_EVENTS];
+	std::atomic<uint64_t> Head{ 0 };
+};
+
+// 计数器只由一个线程写，不需要原子的读改写
+static void AddCounter(std::atomic<uint64_t>& counter, uint64_t value) {
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+struct JobSystemImpl {
+
+	struct Job {
+		JobInfo                info;
+		uint32_t               index = 0;
+		std::atomic<uint32_t>  generation{ 0 };
+		std::atomic<int32_t>   pending{ 0 };			// 未完成的依赖数，提交期间额外加一
+		std::atomic_flag       lock = ATOMIC_FLAG_INIT;
+		TInlineArray<uint32_t, JOB_INLINE_DEPENDENTS> dependents;		// 等待本任务的任务下标，受 lock 保护
+
+		uint64_t               ready_ns = 0;			// 进入队列的时间，用于统计排队等待
+		uint64_t               completed_ns = 0;		// 进入完成队列的时间，用于统计回调积压
+		// 完成队列使用，记录在 Update 执行回调之前不会被复用
+		bool                   succeeded = false;
+		Job*                   next_completed = nullptr;
 	};
 
 	// ── 工作线程 ──────────────────────────────────────────────────────────────
 
 	struct Worker {
-		Thread   thread;
 		JobType  type = JobType::eGeneral;
 		uint32_t index = 0;
-	};
+		uint32_t random_state = 0;
+		uint32_t processor = INVALID_ID;
+		uint32_t numa_node = 0;
+
+		// 下标对应 JobPriority 的整数值
+		TWorkStealingDeque<Job*> deques[JOB_PRIORITY_COUNT];
 
-	// ── 完成回调条目（主线程执行）────────────────────────────────────────────
+		// 只有本线程访问的空闲任务记录下标
+		uint32_t free_jobs[JOB_LOCAL_FREE_COUNT];
+		uint32_t free_job_count = 0;
 
-	struct ResultEntry {
-		std::function<void()> callback;
+		// 只由本线程写入，GetStats 在其他线程读取
+		std::atomic<uint64_t> jobs_executed{ 0 };
+		std::atomic<uint64_t> steals{ 0 };
+		std::atomic<uint64_t> busy_ns{ 0 };
+		std::atomic<uint64_t> idle_ns{ 0 };
+		std::atomic<uint64_t> busy_since{ 0 };		// 正在执行的最外层任务的开始时间，空闲时为 0
+
+		// GetStats 上次采样的值，只由调用 GetStats 的线程访问
+		uint64_t sampled_busy_ns = 0;
+		uint64_t sampled_at_ns = 0;
+
+#if DJOB_TRACE
+		JobTraceRing trace;
+#endif
+	};
+
+	// 线程的启动参数，Initialize 填写，Worker 由线程自己构造
+	struct WorkerLaunch {
+		Thread         thread;
+		JobType        type = JobType::eGeneral;
+		uint32_t       index = 0;
+		uint32_t       processor = INVALID_ID;		// INVALID_ID 表示不绑定
+		uint32_t       numa_node = 0;
+		ThreadPriority priority = ThreadPriority::eNormal;
 	};
 
 	// ── 成员 ──────────────────────────────────────────────────────────────────
 
 	std::atomic<bool> running{ false };
+	std::atomic<uint32_t> live_workers{ 0 };
+
+	// 外部线程提交的任务，[JobType][JobPriority]
+	std::unique_ptr<TMPMCQueue<Job*>> inject_queues[static_cast<uint32_t>(JobType::eCount)][JOB_PRIORITY_COUNT];
+
+	// 创建后地址不再变化，窃取方直接持有指针。各线程构造好自己的 Worker 后在 workers_released 处等待
+	std::vector<Worker*> workers;
+	std::vector<WorkerLaunch> launches;
+	std::atomic<uint32_t> ready_workers{ 0 };
+	std::atomic<bool>   workers_released{ false };
 
-	// 每种 JobType 独立队列，下标对应 JobType 的整数值
-	TypedQueue queues[static_cast<uint32_t>(JobType::eCount)];
+	// 休眠的工作线程数，提交方据此决定是否需要唤醒
+	std::atomic<uint32_t> sleeping_workers{ 0 };
+	Mutex               park_mutex;
+	ConditionVariable   park_cv;
 
-	std::vector<Worker> workers;
-	Mutex               result_mutex;
-	std::vector<ResultEntry> pending_results;
+	// 任务记录池
+	std::atomic<Job*>   job_chunks[JOB_MAX_CHUNKS] = {};
+	std::atomic<uint32_t> next_unused_job{ 0 };
+	std::unique_ptr<TMPMCQueue<uint32_t>> free_jobs;
 
-	TypedQueue& GetQueue(JobType type) {
+	// 等待主线程执行回调的任务
+	TIntrusiveMPSCQueue<Job, &Job::next_completed> completed_jobs;
+
+	// 主线程从完成队列取出、还没来得及执行回调的任务，按回调优先级分开，各自先进先出。只有主线程访问
+	struct CallbackBacklog {
+		Job*     head = nullptr;
+		Job*     tail = nullptr;
+	} callback_backlog[JOB_PRIORITY_COUNT];
+	uint32_t            callback_backlog_count = 0;
+
+#if DJOB_TRACE
+	// 外部线程第一次执行任务时认领一个，之后一直归该线程所有
+	JobTraceRing        external_traces[JOB_TRACE_EXTERNAL_THREADS];
+	std::atomic<uint32_t> external_trace_count{ 0 };
+	uint64_t            trace_epoch_ns = 0;			// 导出时间戳的零点
+#endif
+
+	static uint32_t TypeIndex(JobType type) {
 		uint32_t idx = static_cast<uint32_t>(type);
-		if (idx >= static_cast<uint32_t>(JobType::eCount)) {
-			idx = static_cast<uint32_t>(JobType::eGeneral);
+		return idx < static_cast<uint32_t>(JobType::eCount) ? idx : static_cast<uint32_t>(JobType::eGeneral);
+	}
+
+	static uint32_t PriorityIndex(JobPriority priority) {
+		int idx = static_cast<int>(priority);
+		return idx < 0 ? 0 : (idx >= JOB_PRIORITY_COUNT ? JOB_PRIORITY_COUNT - 1 : (uint32_t)idx);
+	}
+
+	Job* GetJob(uint32_t index) {
+		if (index >= JOB_MAX_COUNT) {
+			return nullptr;
 		}
-		return queues[idx];
+		Job* chunk = job_chunks[index >> JOB_CHUNK_SHIFT].load(std::memory_order_acquire);
+		return chunk != nullptr ? chunk + (index & ((1u << JOB_CHUNK_SHIFT) - 1)) : nullptr;
 	}
+
+	static void AddWaiter(JobCounter& counter, Job* job);
+	static void ReleaseCounter(JobCounter& counter);
 };
 
 static JobSystemImpl g_impl;
 
-// ─── 工作线程函数 ─────────────────────────────────────────────────────────────
+// 当前线程对应的工作线程，外部线程为 nullptr
+static thread_local JobSystemImpl::Worker* t_worker = nullptr;
+// 外部线程在 Wait 中窃取任务时使用
+static thread_local uint32_t t_random_state = 0x2545F491u;
+// 当前线程正在执行的任务嵌套层数，Wait 中帮忙执行的任务不重复计入忙碌时间
+static thread_local uint32_t t_job_depth = 0;
 
-static uint32_t WorkerThreadFunc(void* param) {
-	uint32_t worker_index = *reinterpret_cast<uint32_t*>(param);
-	JobType  type = g_impl.workers[worker_index].type;
-	uint32_t type_idx = static_cast<uint32_t>(type);
+#if DJOB_TRACE
+static thread_local JobTraceRing* t_trace_ring = nullptr;
+static thread_local bool t_trace_unavailable = false;
+
+static JobTraceRing* GetTraceRing() {
+	if (t_trace_ring == nullptr && !t_trace_unavailable) {
+		const uint32_t slot = g_impl.external_trace_count.fetch_add(1, std::memory_order_relaxed);
+		if (slot < JOB_TRACE_EXTERNAL_THREADS) {
+			t_trace_ring = &g_impl.external_traces[slot];
+		}
+		else {
+			t_trace_unavailable = true;
+		}
+	}
+	return t_trace_ring;
+}
+#endif
+
+static void RecordTrace(JobTraceKind kind, uint64_t begin, uint64_t end, const char* name, uint8_t type, uint8_t priority, uint32_t arg) {
+#if DJOB_TRACE
+	JobTraceRing* ring = GetTraceRing();
+	if (ring != nullptr) {
+		ring->Record(kind, begin, end, name, type, priority, arg);
+	}
+#else
+	(void)kind; (void)begin; (void)end; (void)name; (void)type; (void)priority; (void)arg;
+#endif
+}
 
-	GLOG(Log::eInfo, "Job thread #%u started (type=%u).", worker_index, type_idx);
+// ─── 调度 ─────────────────────────────────────────────────────────────────────
 
-	while (g_impl.running.load()) {
-		JobInfo job;
+static uint32_t NextRandom(uint32_t& state) {
+	// xorshift32，只用来挑选窃取对象
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
 
-		if (!g_impl.queues[type_idx].WaitAndPop(job, g_impl.running)) {
-			break;
+// worker 为 nullptr 时是外部线程在 Wait 中帮忙，没有自己的队列，类型从 eGeneral 开始看
+static JobSystemImpl::Job* FindJob(JobSystemImpl::Worker* worker, uint32_t& random_state) {
+	const uint32_t type_count = static_cast<uint32_t>(JobType::eCount);
+	const uint32_t worker_count = (uint32_t)g_impl.workers.size();
+	const uint32_t own_type = worker != nullptr ? static_cast<uint32_t>(worker->type) : 0;
+	JobSystemImpl::Job* job = nullptr;
+
+	for (int priority = JOB_PRIORITY_COUNT - 1; priority >= 0; --priority) {
+		if (worker != nullptr && worker->deques[priority].Pop(job)) {
+			return job;
 		}
 
-		if (!job.entry) {
-			continue;
+		for (uint32_t i = 0; i < type_count; ++i) {
+			uint32_t type_idx = (own_type + i) % type_count;
+			if (g_impl.inject_queues[type_idx][priority]->Pop(job)) {
+				return job;
+			}
+		}
+
+		uint32_t start = worker_count > 1 ? NextRandom(random_state) % worker_count : 0;
+		for (uint32_t i = 0; i < worker_count; ++i) {
+			JobSystemImpl::Worker* victim = g_impl.workers[(start + i) % worker_count];
+			if (victim != worker && victim->deques[priority].Steal(job)) {
+				if (worker != nullptr) {
+					AddCounter(worker->steals, 1);
+				}
+				const uint64_t now = TraceNow();
+				RecordTrace(JobTraceKind::eSteal, now, now, nullptr, (uint8_t)job->info.type, (uint8_t)priority, victim->index);
+				return job;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+static void NotifyWorkers() {
+	// 与休眠方的 fetch_add + fence 配对：要么这里看到有人休眠，要么休眠方重新检查时看到新任务
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (g_impl.sleeping_workers.load(std::memory_order_relaxed) > 0) {
+		MutexGuard guard(g_impl.park_mutex);
+		g_impl.park_cv.NotifyOne();
+	}
+}
+
+// 依赖都已完成的任务进入队列
+static void Schedule(JobSystemImpl::Job* job) {
+	const uint32_t type_idx = JobSystemImpl::TypeIndex(job->info.type);
+	const uint32_t priority = JobSystemImpl::PriorityIndex(job->info.priority);
+#if DJOB_TRACE
+	job->ready_ns = TraceNow();
+#endif
+
+	if (t_worker != nullptr) {
+		// 工作线程里提交的任务留在本线程，空闲线程会来窃取
+		t_worker->deques[priority].Push(job);
+	}
+	else {
+		TMPMCQueue<JobSystemImpl::Job*>& queue = *g_impl.inject_queues[type_idx][priority];
+		bool warned = false;
+		while (!queue.Push(job)) {
+			// 注入队列满说明工作线程已经跟不上了，等它们腾出位置
+			if (!warned) {
+				GLOG(Log::eWarn, "JobSystem: queue for type %u priority %u is full, waiting.", type_idx, priority);
+				warned = true;
+			}
+			NotifyWorkers();
+			std::this_thread::yield();
 		}
+	}
+
+	NotifyWorkers();
+}
+
+// 一个依赖完成，全部完成后进入队列
+static void ReleaseDependency(JobSystemImpl::Job* job) {
+	if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		Schedule(job);
+	}
+}
 
+void JobSystemImpl::AddWaiter(JobCounter& counter, Job* job) {
+	JobSpinLock guard(counter.lock);
+	if (counter.value.load(std::memory_order_acquire) > 0) {
+		job->pending.fetch_add(1, std::memory_order_relaxed);
+		counter.waiters.push_back(job->index);
+	}
+}
+
+void JobSystemImpl::ReleaseCounter(JobCounter& counter) {
+	int32_t current = counter.value.load(std::memory_order_relaxed);
+	while (current > 1) {
+		if (counter.value.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+
+	// 最后一次减到 0 在锁内完成，Wait 看到归零后再拿一次锁，返回时这里已经不再访问计数器
+	std::vector<uint32_t> waiters;
+	{
+		JobSpinLock guard(counter.lock);
+		if (counter.value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			waiters.swap(counter.waiters);
+		}
+	}
+	for (uint32_t index : waiters) {
+		ReleaseDependency(g_impl.GetJob(index));
+	}
+}
+
+static JobSystemImpl::Job* AllocateJob() {
+	uint32_t index = INVALID_ID;
+	JobSystemImpl::Worker* worker = t_worker;
+	if (worker != nullptr) {
+		if (worker->free_job_count == 0) {
+			// 本地缓存空了，一次从全局队列取半个缓存
+			worker->free_job_count = g_impl.free_jobs->PopBatch(worker->free_jobs, JOB_LOCAL_FREE_COUNT / 2);
+		}
+		if (worker->free_job_count > 0) {
+			return g_impl.GetJob(worker->free_jobs[--worker->free_job_count]);
+		}
+	}
+	else if (g_impl.free_jobs->Pop(index)) {
+		return g_impl.GetJob(index);
+	}
+
+	index = g_impl.next_unused_job.load(std::memory_order_relaxed);
+	do {
+		if (index >= JOB_MAX_COUNT) {
+			return nullptr;
+		}
+	} while (!g_impl.next_unused_job.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+
+	// 块的第一个记录由认领它的线程分配整块，认领同一块其他记录的线程等它发布
+	const uint32_t chunk = index >> JOB_CHUNK_SHIFT;
+	const uint32_t offset = index & ((1u << JOB_CHUNK_SHIFT) - 1);
+	if (offset == 0) {
+		JobSystemImpl::Job* jobs = new JobSystemImpl::Job[1u << JOB_CHUNK_SHIFT];
+		for (uint32_t i = 0; i < (1u << JOB_CHUNK_SHIFT); ++i) {
+			jobs[i].index = index + i;
+		}
+		g_impl.job_chunks[chunk].store(jobs, std::memory_order_release);
+	}
+
+	JobSystemImpl::Job* job = nullptr;
+	while ((job = g_impl.GetJob(index)) == nullptr) {
+		std::this_thread::yield();
+	}
+	return job;
+}
+
+static void FreeJob(JobSystemImpl::Job* job) {
+	JobSystemImpl::Worker* worker = t_worker;
+	if (worker == nullptr) {
+		g_impl.free_jobs->Push(job->index);
+		return;
+	}
+
+	if (worker->free_job_count == JOB_LOCAL_FREE_COUNT) {
+		// 本地缓存满了，把较早放入的一半还给全局队列，其他线程提交时可以用
+		const uint32_t half = JOB_LOCAL_FREE_COUNT / 2;
+		uint32_t returned = 0;
+		while (returned < half) {
+			returned += g_impl.free_jobs->PushBatch(worker->free_jobs + returned, half - returned);
+		}
+		for (uint32_t i = half; i < JOB_LOCAL_FREE_COUNT; ++i) {
+			worker->free_jobs[i - half] = worker->free_jobs[i];
+		}
+		worker->free_job_count -= half;
+	}
+	worker->free_jobs[worker->free_job_count++] = job->index;
+}
+
+// entry 执行完：句柄变为已完成，释放记录（有回调时交给完成队列），再放行后继
+static void CompleteJob(JobSystemImpl::Job* job, bool has_callback) {
+	JobCounter* signal_counter = job->info.signal_counter;
+	TInlineArray<uint32_t, JOB_INLINE_DEPENDENTS> dependents;
+	{
+		JobSpinLock guard(job->lock);
+		uint32_t next = job->generation.load(std::memory_order_relaxed) + 1;
+		// 跳过 INVALID_ID，保证有效句柄的代数永远不是无效值
+		job->generation.store(next == INVALID_ID ? 0 : next, std::memory_order_release);
+		dependents = std::move(job->dependents);
+		job->dependents.Clear();
+	}
+
+	if (has_callback) {
+		// 入队后记录归主线程所有，这里不能再访问
+		job->info.entry = nullptr;
+		job->completed_ns = TraceNow();
+		g_impl.completed_jobs.Push(job);
+	}
+	else {
+		job->info = JobInfo();
+		FreeJob(job);
+	}
+
+	for (size_t i = 0; i < dependents.Size(); ++i) {
+		ReleaseDependency(g_impl.GetJob(dependents[i]));
+	}
+	if (signal_counter != nullptr) {
+		JobSystemImpl::ReleaseCounter(*signal_counter);
+	}
+}
+
+// worker 为 nullptr 时是外部线程在 Wait 中帮忙执行
+static void ExecuteJob(JobSystemImpl::Job* job, JobSystemImpl::Worker* worker) {
+	const uint64_t begin = TraceNow();
+	const bool outermost = t_job_depth++ == 0;
+	if (worker != nullptr && outermost) {
+		worker->busy_since.store(begin, std::memory_order_relaxed);
+	}
+
+	bool has_callback = false;
+	if (job->info.entry) {
 		bool succeeded = false;
 		try {
-			succeeded = job.entry();
+			succeeded = job->info.entry();
 		}
 		catch (...) {
-			GLOG(Log::eError, "Job thread #%u: unhandled exception.", worker_index);
+			GLOG(Log::eError, "Job thread #%u: unhandled exception.", worker != nullptr ? worker->index : INVALID_ID);
 			succeeded = false;
 		}
 
-		auto& callback = succeeded ? job.on_success : job.on_failed;
-		if (callback) {
-			MutexGuard guard(g_impl.result_mutex);
-			g_impl.pending_results.push_back({ std::move(callback) });
+		job->succeeded = succeeded;
+		has_callback = (bool)(succeeded ? job->info.on_success : job->info.on_failed);
+	}
+
+	const uint64_t end = TraceNow();
+	--t_job_depth;
+	if (worker != nullptr) {
+		AddCounter(worker->jobs_executed, 1);
+		if (outermost) {
+			AddCounter(worker->busy_ns, end - begin);
+			worker->busy_since.store(0, std::memory_order_relaxed);
 		}
 	}
 
-	GLOG(Log::eInfo, "Job thread #%u exiting.", worker_index);
+#if DJOB_TRACE
+	// 记录在 CompleteJob 之后可能被复用，先记下来
+	const uint64_t wait_us = begin > job->ready_ns ? (begin - job->ready_ns) / 1000 : 0;
+	RecordTrace(JobTraceKind::eJob, begin, end, job->info.name != nullptr ? job->info.name : "Job",
+		(uint8_t)JobSystemImpl::TypeIndex(job->info.type), (uint8_t)JobSystemImpl::PriorityIndex(job->info.priority),
+		wait_us > UINT32_MAX ? UINT32_MAX : (uint32_t)wait_us);
+#endif
+
+	CompleteJob(job, has_callback);
+}
+
+// 一段空闲结束，累计空闲时间，足够长的写入跟踪
+static void EndIdle(JobSystemImpl::Worker& worker, uint64_t idle_begin) {
+	const uint64_t now = TraceNow();
+	AddCounter(worker.idle_ns, now - idle_begin);
+	if (now - idle_begin >= JOB_TRACE_MIN_IDLE_NS) {
+		RecordTrace(JobTraceKind::eIdle, idle_begin, now, "Idle", (uint8_t)worker.type, 0, 0);
+	}
+}
+
+// 等待时执行一个任务，没有可执行的任务时返回 false
+static bool RunPendingJob() {
+	JobSystemImpl::Job* job = t_worker != nullptr ? FindJob(t_worker, t_worker->random_state) : FindJob(nullptr, t_random_state);
+	if (job == nullptr) {
+		return false;
+	}
+
+	ExecuteJob(job, t_worker);
+	return true;
+}
+
+// ─── 工作线程函数 ─────────────────────────────────────────────────────────────
+
+static const char* GetJobTypeName(uint32_t type) {
+	static const char* names[] = { "General", "Resource_Load", "GPU_Resource" };
+	static_assert(sizeof(names) / sizeof(names[0]) == static_cast<uint32_t>(JobType::eCount), "Update the job type names.");
+	return type < static_cast<uint32_t>(JobType::eCount) ? names[type] : "Unknown";
+}
+
+const char* JobSystem::GetTypeName(JobType type) {
+	return GetJobTypeName(static_cast<uint32_t>(type));
+}
+
+// 系统线程名与跟踪里的线程名，类型放在后面，被截断时还能看出是第几个线程
+static void FormatWorkerName(char* out_name, size_t size, uint32_t index, JobType type) {
+	snprintf(out_name, size, "Job #%u %s", index, GetJobTypeName(JobSystemImpl::TypeIndex(type)));
+}
+
+// 在当前线程上构造 Worker，等 Initialize 放行所有线程后返回
+static JobSystemImpl::Worker* StartWorker(JobSystemImpl::WorkerLaunch& launch) {
+	// 先绑定再构造，Worker 的内存在本线程第一次写入时才分配物理页，落在所在的 NUMA 节点上
+	if (launch.processor != INVALID_ID && !Thread::SetCurrentAffinity(launch.processor)) {
+		GLOG(Log::eWarn, "Job thread #%u: failed to pin to processor %u.", launch.index, launch.processor);
+	}
+	if (launch.priority != ThreadPriority::eNormal && !Thread::SetCurrentPriority(launch.priority)) {
+		GLOG(Log::eWarn, "Job thread #%u: failed to change thread priority.", launch.index);
+	}
+
+	char name[JOB_THREAD_NAME_LENGTH];
+	FormatWorkerName(name, sizeof(name), launch.index, launch.type);
+	Thread::SetCurrentName(name);
+
+	JobSystemImpl::Worker* worker = new JobSystemImpl::Worker();
+	worker->index = launch.index;
+	worker->type = launch.type;
+	worker->processor = launch.processor;
+	worker->numa_node = launch.numa_node;
+	worker->random_state = 0x9E3779B9u * (launch.index + 1);
+	worker->sampled_at_ns = TraceNow();
+	g_impl.workers[launch.index] = worker;
+	g_impl.ready_workers.fetch_add(1, std::memory_order_release);
+
+	// 其他线程的 Worker 可能还没构造好，放行之前不能窃取
+	while (!g_impl.workers_released.load(std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+	return worker;
+}
+
+static uint32_t WorkerThreadFunc(void* param) {
+	JobSystemImpl::Worker& worker = *StartWorker(*reinterpret_cast<JobSystemImpl::WorkerLaunch*>(param));
+	t_worker = &worker;
+#if DJOB_TRACE
+	t_trace_ring = &worker.trace;
+#endif
+
+	GLOG(Log::eInfo, "Job thread #%u started (type=%u, processor=%d).", worker.index, static_cast<uint32_t>(worker.type),
+		worker.processor != INVALID_ID ? (int)worker.processor : -1);
+
+	uint32_t idle_rounds = 0;
+	uint64_t idle_begin = 0;			// 0 表示当前不在空闲
+	while (true) {
+		JobSystemImpl::Job* job = FindJob(&worker, worker.random_state);
+		if (job != nullptr) {
+			if (idle_begin != 0) {
+				EndIdle(worker, idle_begin);
+				idle_begin = 0;
+			}
+			idle_rounds = 0;
+			ExecuteJob(job, &worker);
+			continue;
+		}
+
+		// 关闭时把剩下的任务做完再退出
+		if (!g_impl.running.load(std::memory_order_acquire)) {
+			break;
+		}
+
+		if (idle_begin == 0) {
+			idle_begin = TraceNow();
+		}
+
+		if (idle_rounds < JOB_SPIN_COUNT) {
+			++idle_rounds;
+			DCPU_PAUSE();
+			continue;
+		}
+		if (idle_rounds < JOB_SPIN_COUNT + JOB_YIELD_COUNT) {
+			++idle_rounds;
+			std::this_thread::yield();
+			continue;
+		}
+
+		g_impl.park_mutex.Lock();
+		g_impl.sleeping_workers.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		job = FindJob(&worker, worker.random_state);
+		if (job == nullptr && g_impl.running.load(std::memory_order_acquire)) {
+			g_impl.park_cv.Wait(g_impl.park_mutex);
+		}
+		g_impl.sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+		g_impl.park_mutex.UnLock();
+
+		idle_rounds = 0;
+		if (job != nullptr) {
+			EndIdle(worker, idle_begin);
+			idle_begin = 0;
+			ExecuteJob(job, &worker);
+		}
+	}
+
+	if (idle_begin != 0) {
+		EndIdle(worker, idle_begin);
+	}
+
+	GLOG(Log::eInfo, "Job thread #%u exiting.", worker.index);
+	t_worker = nullptr;
+#if DJOB_TRACE
+	t_trace_ring = nullptr;
+#endif
+	g_impl.live_workers.fetch_sub(1, std::memory_order_release);
 	return 0;
 }
 
 // ─── Initialize ───────────────────────────────────────────────────────────────
 
-bool JobSystem::Initialize(const uint32_t* thread_count_per_type) {
+// 按 JobSystemConfig 的规则排出工作线程使用的逻辑处理器，越靠前越先分配。
+// out_physical_count 返回排在最前面、各占一个物理核心的处理器个数
+static void BuildProcessorOrder(const JobSystemConfig& config, std::vector<PlatformProcessor>& out_order, uint32_t& out_physical_count) {
+	out_order.clear();
+	out_physical_count = 0;
+
+	std::vector<PlatformProcessor> processors(Platform::GetProcessorTopology(nullptr, 0));
+	processors.resize(std::min((size_t)Platform::GetProcessorTopology(processors.data(), (uint32_t)processors.size()), processors.size()));
+	if (processors.empty()) {
+		const int count = Platform::GetProcessorCount();
+		for (int i = 0; i < (count > 0 ? count : 1); ++i) {
+			PlatformProcessor processor;
+			processor.index = (uint32_t)i;
+			processor.core = (uint32_t)i;
+			processors.push_back(processor);
+		}
+	}
+
+	// 按物理核心分组，同一核心的硬件线程按 smt_index 排列
+	std::map<uint32_t, std::vector<PlatformProcessor>> cores;
+	for (const PlatformProcessor& processor : processors) {
+		cores[processor.core].push_back(processor);
+	}
+	size_t max_smt = 0;
+	for (auto& core : cores) {
+		std::sort(core.second.begin(), core.second.end(),
+			[](const PlatformProcessor& a, const PlatformProcessor& b) { return a.smt_index < b.smt_index; });
+		max_smt = std::max(max_smt, core.second.size());
+	}
+
+	// 编号最小的几个核心留给主线程，至少给工作线程留一个核心
+	const uint32_t reserved = std::min(config.reserved_cores, (uint32_t)cores.size() - 1);
+	std::map<uint32_t, std::vector<const std::vector<PlatformProcessor>*>> nodes;
+	uint32_t skipped = 0;
+	for (const auto& core : cores) {
+		if (skipped++ < reserved) {
+			continue;
+		}
+		nodes[core.second.front().numa_node].push_back(&core.second);
+	}
+
+	// 先排每个核心的第一个硬件线程，再排 SMT 兄弟线程；同一层里各节点轮流取核心，线程均匀分布到各插槽
+	for (size_t level = 0; level < max_smt; ++level) {
+		for (size_t i = 0;; ++i) {
+			bool remaining = false;
+			for (const auto& node : nodes) {
+				if (i >= node.second.size()) {
+					continue;
+				}
+				remaining = true;
+				const std::vector<PlatformProcessor>& core = *node.second[i];
+				if (level < core.size()) {
+					out_order.push_back(core[level]);
+				}
+			}
+			if (!remaining) {
+				break;
+			}
+		}
+		if (level == 0) {
+			out_physical_count = (uint32_t)out_order.size();
+		}
+	}
+}
+
+bool JobSystem::Initialize(const JobSystemConfig& config) {
 	if (g_impl.running.load()) {
 		GLOG(Log::eWarn, "JobSystem::Initialize: already running.");
 		return false;
 	}
 
-	// 每种类型的默认线程数
 	const uint32_t type_count = static_cast<uint32_t>(JobType::eCount);
+	const uint32_t general_idx = static_cast<uint32_t>(JobType::eGeneral);
+
+	std::vector<PlatformProcessor> order;
+	uint32_t physical_count = 0;
+	BuildProcessorOrder(config, order, physical_count);
 
+	// 没有指定数量时其他类型各 1 个，eGeneral 用掉剩下的核心
 	uint32_t counts[static_cast<uint32_t>(JobType::eCount)];
-	if (thread_count_per_type) {
-		for (uint32_t i = 0; i < type_count; ++i) {
-			counts[i] = thread_count_per_type[i] > 0 ? thread_count_per_type[i] : 1;
+	uint32_t others = 0;
+	for (uint32_t i = 0; i < type_count; ++i) {
+		if (i != general_idx) {
+			counts[i] = config.types[i].thread_count > 0 ? config.types[i].thread_count : 1;
+			others += counts[i];
 		}
 	}
-	else {
-		// 默认：eGeneral = 核心数-1（最少1），其余各1个
-		uint32_t hw = (uint32_t)Platform::GetProcessorCount();
-		uint32_t general = (hw > type_count) ? (hw - type_count) : 1;
+	const uint32_t available = config.avoid_smt_siblings ? physical_count : (uint32_t)order.size();
+	counts[general_idx] = config.types[general_idx].thread_count > 0 ? config.types[general_idx].thread_count :
+		(available > others + 1 ? available - others : 1);
 
-		for (uint32_t i = 0; i < type_count; ++i) {
-			counts[i] = (i == static_cast<uint32_t>(JobType::eGeneral)) ? general : 1;
+	for (uint32_t type_idx = 0; type_idx < type_count; ++type_idx) {
+		for (uint32_t priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+			if (!g_impl.inject_queues[type_idx][priority]) {
+				g_impl.inject_queues[type_idx][priority].reset(new TMPMCQueue<JobSystemImpl::Job*>(JOB_INJECT_QUEUE_CAPACITY));
+			}
 		}
 	}
+	if (!g_impl.free_jobs) {
+		g_impl.free_jobs.reset(new TMPMCQueue<uint32_t>(JOB_MAX_COUNT));
+	}
 
-	// 计算总线程数并预分配，确保 resize 只做一次，之后内存不再移动
-	uint32_t total = 0;
-	for (uint32_t i = 0; i < type_count; ++i) total += counts[i];
-	g_impl.workers.resize(total);
+#if DJOB_TRACE
+	if (g_impl.trace_epoch_ns == 0) {
+		g_impl.trace_epoch_ns = TraceNow();
+	}
+#endif
 
-	// 配置所有 worker（不启动线程）
-	uint32_t worker_idx = 0;
-	for (uint32_t type_idx = 0; type_idx < type_count; ++type_idx) {
+	// 按挑选处理器的先后顺序编排线程：计算任务占最好的核心，后台加载线程排在最后
+	static const JobType placement_order[] = { JobType::eGeneral, JobType::eGPU_Resource, JobType::eResource_Load };
+	static_assert(sizeof(placement_order) / sizeof(placement_order[0]) == static_cast<uint32_t>(JobType::eCount), "Update the placement order.");
+
+	uint32_t total = 0;
+	for (JobType type : placement_order) {
+		const uint32_t type_idx = static_cast<uint32_t>(type);
 		for (uint32_t j = 0; j < counts[type_idx]; ++j) {
-			g_impl.workers[worker_idx].index = worker_idx;
-			g_impl.workers[worker_idx].type = static_cast<JobType>(type_idx);
-			++worker_idx;
+			JobSystemImpl::WorkerLaunch launch;
+			launch.index = total;
+			launch.type = type;
+			launch.priority = config.types[type_idx].priority;
+			if (config.pin_threads) {
+				// 线程比处理器多时从头复用
+				const PlatformProcessor& processor = order[total % order.size()];
+				launch.processor = processor.index;
+				launch.numa_node = processor.numa_node;
+			}
+			g_impl.launches.push_back(launch);
+			++total;
 		}
 	}
+	g_impl.workers.assign(total, nullptr);
 
 	// 配置完成后再设置 running，确保线程启动时状态正确
 	g_impl.running.store(true);
 
-	// 统一启动所有线程
-	for (uint32_t i = 0; i < total; ++i) {
-		if (!g_impl.workers[i].thread.Create(WorkerThreadFunc, &g_impl.workers[i].index, false)) {
-			GLOG(Log::eFatal, "JobSystem: failed to create worker thread #%u.", i);
-			Shutdown();
-			return false;
+	uint32_t created = 0;
+	for (; created < total; ++created) {
+		g_impl.live_workers.fetch_add(1, std::memory_order_relaxed);
+		if (!g_impl.launches[created].thread.Create(WorkerThreadFunc, &g_impl.launches[created], false)) {
+			g_impl.live_workers.fetch_sub(1, std::memory_order_relaxed);
+			GLOG(Log::eFatal, "JobSystem: failed to create worker thread #%u.", created);
+			break;
 		}
-		GLOG(Log::eInfo, "Job thread #%u created (type=%u).",
-			i, static_cast<uint32_t>(g_impl.workers[i].type));
 	}
 
-	GLOG(Log::eInfo, "JobSystem initialized: %u total threads.", total);
+	// 等已启动的线程都构造好自己的 Worker，之后 workers 不再变化
+	while (g_impl.ready_workers.load(std::memory_order_acquire) < created) {
+		std::this_thread::yield();
+	}
+	if (created < total) {
+		g_impl.workers.resize(created);
+		g_impl.workers_released.store(true, std::memory_order_release);
+		Shutdown();
+		return false;
+	}
+	g_impl.workers_released.store(true, std::memory_order_release);
+
+	GLOG(Log::eInfo, "JobSystem initialized: %u total threads on %u processors (%u physical cores).",
+		total, (uint32_t)order.size(), physical_count);
 	for (uint32_t i = 0; i < type_count; ++i) {
-		GLOG(Log::eInfo, "  Type %u: %u thread(s).", i, counts[i]);
+		GLOG(Log::eInfo, "  %s: %u thread(s) preferred.", GetJobTypeName(i), counts[i]);
+	}
+	for (const JobSystemImpl::WorkerLaunch& launch : g_impl.launches) {
+		if (launch.processor != INVALID_ID) {
+			GLOG(Log::eInfo, "  Job thread #%u: processor %u, node %u.", launch.index, launch.processor, launch.numa_node);
+		}
 	}
 
 	return true;
 }
 
+bool JobSystem::Initialize(const uint32_t* thread_count_per_type) {
+	JobSystemConfig config;
+	if (thread_count_per_type) {
+		for (uint32_t i = 0; i < static_cast<uint32_t>(JobType::eCount); ++i) {
+			config.types[i].thread_count = thread_count_per_type[i];
+		}
+	}
+	return Initialize(config);
+}
+
 // ─── Shutdown ─────────────────────────────────────────────────────────────────
 
 void JobSystem::Shutdown() {
@@ -212,56 +915,467 @@ void JobSystem::Shutdown() {
 
 	g_impl.running.store(false);
 
-	// 唤醒所有队列的所有等待线程
-	for (uint32_t i = 0; i < static_cast<uint32_t>(JobType::eCount); ++i) {
-		g_impl.queues[i].WakeAll();
+	// 唤醒所有休眠的线程，它们把剩下的任务做完后退出
+	{
+		MutexGuard guard(g_impl.park_mutex);
+		g_impl.park_cv.NotifyAll();
+	}
+
+	// Win32 的 Thread::Destroy 只关闭句柄不等待，这里先等所有线程退出主循环
+	while (g_impl.live_workers.load(std::memory_order_acquire) > 0) {
+		std::this_thread::yield();
 	}
 
-	for (auto& w : g_impl.workers) {
-		w.thread.Destroy();
+	for (JobSystemImpl::WorkerLaunch& launch : g_impl.launches) {
+		launch.thread.Destroy();
+	}
+	for (JobSystemImpl::Worker* worker : g_impl.workers) {
+		delete worker;
 	}
 
 	g_impl.workers.clear();
+	g_impl.launches.clear();
+	g_impl.ready_workers.store(0);
+	g_impl.workers_released.store(false);
 
-	{
-		MutexGuard guard(g_impl.result_mutex);
-		g_impl.pending_results.clear();
+	// 依赖永远不会完成的任务（例如等待一个不再归零的计数器）和没来得及执行的回调随记录池一起丢弃
+	g_impl.completed_jobs.PopAll();
+	for (uint32_t priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+		g_impl.callback_backlog[priority] = JobSystemImpl::CallbackBacklog();
+	}
+	g_impl.callback_backlog_count = 0;
+	uint32_t index = 0;
+	while (g_impl.free_jobs->Pop(index)) {}
+	for (uint32_t i = 0; i < JOB_MAX_CHUNKS; ++i) {
+		delete[] g_impl.job_chunks[i].exchange(nullptr);
 	}
+	g_impl.next_unused_job.store(0);
 
 	GLOG(Log::eInfo, "JobSystem shut down.");
 }
 
 // ─── Update ───────────────────────────────────────────────────────────────────
 
-void JobSystem::Update() {
+// 把完成队列里新到的任务按回调优先级追加到积压链表末尾
+static void DrainCompletedJobs() {
+	JobSystemImpl::Job* job = g_impl.completed_jobs.PopAll();
+	while (job != nullptr) {
+		JobSystemImpl::Job* next = job->next_completed;
+		JobSystemImpl::CallbackBacklog& backlog = g_impl.callback_backlog[JobSystemImpl::PriorityIndex(job->info.callback_priority)];
+		job->next_completed = nullptr;
+		if (backlog.tail != nullptr) {
+			backlog.tail->next_completed = job;
+		}
+		else {
+			backlog.head = job;
+		}
+		backlog.tail = job;
+		g_impl.callback_backlog_count++;
+		job = next;
+	}
+}
+
+void JobSystem::Update(double budget_ms) {
 	if (!g_impl.running.load()) return;
 
-	std::vector<JobSystemImpl::ResultEntry> frame_results;
-	{
-		MutexGuard guard(g_impl.result_mutex);
-		frame_results.swap(g_impl.pending_results);
-	}
+	DrainCompletedJobs();
 
-	for (auto& entry : frame_results) {
-		try {
-			entry.callback();
-		}
-		catch (...) {
-			GLOG(Log::eError, "JobSystem::Update: exception in result callback.");
+	const uint64_t start = TraceNow();
+	const uint64_t budget_ns = budget_ms > 0.0 ? (uint64_t)(budget_ms * 1000000.0) : UINT64_MAX;
+	uint32_t executed = 0;
+	for (int priority = JOB_PRIORITY_COUNT - 1; priority >= 0; --priority) {
+		JobSystemImpl::CallbackBacklog& backlog = g_impl.callback_backlog[priority];
+		while (backlog.head != nullptr) {
+			// 至少执行一个，之后用完预算就把剩下的留到下一帧
+			if (executed > 0 && TraceNow() - start >= budget_ns) {
+				return;
+			}
+
+			JobSystemImpl::Job* job = backlog.head;
+			backlog.head = job->next_completed;
+			if (backlog.head == nullptr) {
+				backlog.tail = nullptr;
+			}
+			g_impl.callback_backlog_count--;
+
+			try {
+				if (job->succeeded) {
+					job->info.on_success();
+				}
+				else {
+					job->info.on_failed();
+				}
+			}
+			catch (...) {
+				GLOG(Log::eError, "JobSystem::Update: exception in result callback.");
+			}
+
+			job->info = JobInfo();
+			FreeJob(job);
+			executed++;
 		}
 	}
 }
 
 // ─── Submit ───────────────────────────────────────────────────────────────────
 
-void JobSystem::Submit(JobInfo info) {
+JobHandle JobSystem::Submit(JobInfo info) {
 	if (!g_impl.running.load()) {
 		GLOG(Log::eWarn, "JobSystem::Submit: system not running.");
+		return JobHandle();
+	}
+
+	JobSystemImpl::Job* job = AllocateJob();
+	while (job == nullptr) {
+		// 记录池用完了，先帮忙执行任务腾出记录
+		if (!RunPendingJob()) {
+			std::this_thread::yield();
+		}
+		job = AllocateJob();
+	}
+
+	const JobHandle* dependencies = info.dependencies;
+	const uint32_t dependency_count = info.dependency_count;
+	info.dependencies = nullptr;
+	info.dependency_count = 0;
+	job->info = std::move(info);
+
+	JobHandle handle;
+	handle.index = job->index;
+	handle.generation = job->generation.load(std::memory_order_relaxed);
+
+	if (job->info.signal_counter != nullptr) {
+		job->info.signal_counter->value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// 提交期间多持有一个 pending，依赖在注册途中完成也不会提前放行
+	job->pending.store(1, std::memory_order_relaxed);
+	for (uint32_t i = 0; i < dependency_count; ++i) {
+		JobSystemImpl::Job* dependency = dependencies[i].IsValid() ? g_impl.GetJob(dependencies[i].index) : nullptr;
+		if (dependency == nullptr) {
+			continue;
+		}
+
+		JobSpinLock guard(dependency->lock);
+		if (dependency->generation.load(std::memory_order_relaxed) == dependencies[i].generation) {
+			job->pending.fetch_add(1, std::memory_order_relaxed);
+			dependency->dependents.Push(job->index);
+		}
+	}
+	if (job->info.wait_counter != nullptr) {
+		JobSystemImpl::AddWaiter(*job->info.wait_counter, job);
+	}
+
+	ReleaseDependency(job);
+	return handle;
+}
+
+// ─── Wait ─────────────────────────────────────────────────────────────────────
+
+bool JobSystem::IsComplete(JobHandle handle) {
+	JobSystemImpl::Job* job = handle.IsValid() ? g_impl.GetJob(handle.index) : nullptr;
+	return job == nullptr || job->generation.load(std::memory_order_acquire) != handle.generation;
+}
+
+// 执行其他任务直到 done() 为真，没有任务可做时先自旋再让出时间片
+template<typename Predicate>
+static void HelpUntil(Predicate&& done) {
+	uint32_t idle_rounds = 0;
+	while (!done()) {
+		if (RunPendingJob()) {
+			idle_rounds = 0;
+		}
+		else if (++idle_rounds < JOB_SPIN_COUNT) {
+			DCPU_PAUSE();
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::Wait(JobHandle handle) {
+	if (!g_impl.running.load()) return;
+	HelpUntil([handle]() { return IsComplete(handle); });
+}
+
+void JobSystem::Wait(const JobHandle* handles, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i) {
+		Wait(handles[i]);
+	}
+}
+
+void JobSystem::Wait(const JobCounter& counter) {
+	if (!g_impl.running.load()) return;
+	HelpUntil([&counter]() { return counter.IsDone(); });
+	JobSpinLock guard(counter.lock);
+}
+
+// ─── 统计与跟踪 ───────────────────────────────────────────────────────────────
+
+void JobSystem::GetStats(JobSystemStats& out_stats) {
+	const uint32_t type_count = static_cast<uint32_t>(JobType::eCount);
+	out_stats = JobSystemStats();
+	if (!g_impl.running.load()) return;
+
+	for (uint32_t type_idx = 0; type_idx < type_count; ++type_idx) {
+		for (uint32_t priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+			out_stats.queued[type_idx] += g_impl.inject_queues[type_idx][priority]->GetLength();
+		}
+	}
+	out_stats.sleeping_workers = g_impl.sleeping_workers.load(std::memory_order_relaxed);
+
+	// 先把新完成的任务移进积压链表，每个优先级的链表头就是该优先级等得最久的
+	DrainCompletedJobs();
+	const uint64_t now = TraceNow();
+	out_stats.callback_backlog = g_impl.callback_backlog_count;
+	for (uint32_t priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+		const JobSystemImpl::Job* oldest = g_impl.callback_backlog[priority].head;
+		if (oldest != nullptr && now > oldest->completed_ns) {
+			const double age_ms = (double)(now - oldest->completed_ns) / 1000000.0;
+			out_stats.oldest_callback_ms = age_ms > out_stats.oldest_callback_ms ? age_ms : out_stats.oldest_callback_ms;
+		}
+	}
+
+	uint32_t type_workers[static_cast<uint32_t>(JobType::eCount)] = {};
+	out_stats.workers.reserve(g_impl.workers.size());
+	for (auto& worker : g_impl.workers) {
+		for (uint32_t priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+			out_stats.local_queued += (uint32_t)worker->deques[priority].GetLength();
+		}
+
+		// 正在执行的任务还没计入 busy_ns，把已经执行的部分算上
+		uint64_t busy = worker->busy_ns.load(std::memory_order_relaxed);
+		const uint64_t busy_since = worker->busy_since.load(std::memory_order_relaxed);
+		if (busy_since != 0 && now > busy_since) {
+			busy += now - busy_since;
+		}
+
+		JobWorkerStats stats;
+		stats.type = worker->type;
+		stats.processor = worker->processor;
+		stats.numa_node = worker->numa_node;
+		stats.jobs_executed = worker->jobs_executed.load(std::memory_order_relaxed);
+		stats.steals = worker->steals.load(std::memory_order_relaxed);
+		stats.busy_ns = busy;
+		stats.idle_ns = worker->idle_ns.load(std::memory_order_relaxed);
+		if (now > worker->sampled_at_ns && busy >= worker->sampled_busy_ns) {
+			const double utilization = (double)(busy - worker->sampled_busy_ns) / (double)(now - worker->sampled_at_ns);
+			stats.utilization = (float)(utilization < 1.0 ? utilization : 1.0);
+		}
+		worker->sampled_busy_ns = busy;
+		worker->sampled_at_ns = now;
+
+		const uint32_t type_idx = JobSystemImpl::TypeIndex(worker->type);
+		out_stats.type_utilization[type_idx] += stats.utilization;
+		type_workers[type_idx]++;
+		out_stats.workers.push_back(stats);
+	}
+
+	for (uint32_t type_idx = 0; type_idx < type_count; ++type_idx) {
+		if (type_workers[type_idx] > 0) {
+			out_stats.type_utilization[type_idx] /= (float)type_workers[type_idx];
+		}
+	}
+}
+
+uint64_t JobSystem::GetTraceTime() {
+	return TraceNow();
+}
+
+#if DJOB_TRACE
+static void WriteJsonString(FILE* file, const char* text) {
+	fputc('"', file);
+	for (const char* c = text; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+			fputc(*c, file);
+		}
+		else if ((unsigned char)*c < 0x20) {
+			fprintf(file, "\\u%04x", (unsigned)(unsigned char)*c);
+		}
+		else {
+			fputc(*c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+// 写出一个线程的名字和事件，返回写出的事件数
+static size_t WriteTraceThread(FILE* file, const JobTraceRing& ring, uint32_t tid, const char* thread_name,
+	uint64_t begin_ns, uint64_t end_ns, bool& first) {
+	std::vector<JobTraceEvent> events;
+	ring.Collect(begin_ns, end_ns, events);
+
+	fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", tid);
+	WriteJsonString(file, thread_name);
+	fprintf(file, "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", tid, tid);
+	first = false;
+
+	const uint64_t epoch = g_impl.trace_epoch_ns;
+	for (const JobTraceEvent& event : events) {
+		const double ts = (double)(event.begin - epoch) / 1000.0;
+		const double dur = (double)(event.end - event.begin) / 1000.0;
+		switch (event.kind) {
+		case JobTraceKind::eJob:
+			fprintf(file, ",\n{\"name\":");
+			WriteJsonString(file, event.name);
+			fprintf(file, ",\"cat\":\"job\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+				"\"args\":{\"type\":\"%s\",\"priority\":%u,\"queue_wait_us\":%u}}",
+				ts, dur, tid, GetJobTypeName(event.type), (uint32_t)event.priority, event.arg);
+			break;
+		case JobTraceKind::eIdle:
+			fprintf(file, ",\n{\"name\":\"Idle\",\"cat\":\"idle\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+				ts, dur, tid);
+			break;
+		case JobTraceKind::eSteal:
+			fprintf(file, ",\n{\"name\":\"Steal\",\"cat\":\"steal\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+				"\"args\":{\"victim\":%u,\"priority\":%u}}",
+				ts, tid, event.arg, (uint32_t)event.priority);
+			break;
+		}
+	}
+	return events.size();
+}
+#endif
+
+bool JobSystem::DumpTrace(const char* path, uint64_t begin_ns, uint64_t end_ns) {
+#if DJOB_TRACE
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) {
+		GLOG(Log::eError, "JobSystem::DumpTrace: failed to open '%s'.", path);
+		return false;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	size_t event_count = 0;
+	char thread_name[64];
+	for (auto& worker : g_impl.workers) {
+		FormatWorkerName(thread_name, sizeof(thread_name), worker->index, worker->type);
+		event_count += WriteTraceThread(file, worker->trace, worker->index, thread_name, begin_ns, end_ns, first);
+	}
+
+	uint32_t external_count = g_impl.external_trace_count.load(std::memory_order_relaxed);
+	external_count = external_count < JOB_TRACE_EXTERNAL_THREADS ? external_count : JOB_TRACE_EXTERNAL_THREADS;
+	for (uint32_t i = 0; i < external_count; ++i) {
+		snprintf(thread_name, sizeof(thread_name), "External #%u", i);
+		event_count += WriteTraceThread(file, g_impl.external_traces[i], JOB_TRACE_EXTERNAL_TID_BASE + i, thread_name, begin_ns, end_ns, first);
+	}
+
+	fprintf(file, "\n]}\n");
+	const bool succeeded = ferror(file) == 0;
+	fclose(file);
+	if (!succeeded) {
+		GLOG(Log::eError, "JobSystem::DumpTrace: failed to write '%s'.", path);
+		return false;
+	}
+
+	GLOG(Log::eInfo, "JobSystem: wrote %zu trace events to '%s'.", event_count, path);
+	return true;
+#else
+	(void)path; (void)begin_ns; (void)end_ns;
+	GLOG(Log::eWarn, "JobSystem::DumpTrace: built without DJOB_TRACE.");
+	return false;
+#endif
+}
+
+// ─── ParallelFor ──────────────────────────────────────────────────────────────
+
+size_t JobSystem::GetParallelChunkSize(size_t count, size_t grain) {
+	grain = grain > 0 ? grain : 1;
+	if (count <= grain || !g_impl.running.load(std::memory_order_relaxed) || g_impl.workers.empty()) {
+		return count;
+	}
+
+	const size_t target_chunks = (g_impl.workers.size() + 1) * JOB_PARALLEL_CHUNKS_PER_THREAD;
+	const size_t chunk_size = (count + target_chunks - 1) / target_chunks;
+	return chunk_size > grain ? chunk_size : grain;
+}
+
+void JobSystem::ParallelForChunks(size_t begin, size_t end, size_t chunk_size, PFN_parallel_chunk invoke, void* context) {
+	struct ParallelState {
+		size_t              begin;
+		size_t              end;
+		size_t              chunk_size;
+		size_t              chunk_count;
+		PFN_parallel_chunk  invoke;
+		void*               context;
+		std::atomic<size_t> next_chunk{ 0 };
+		std::atomic<bool>   failed{ false };
+		std::exception_ptr  error;			// 第一个异常，帮手全部退出后在调用线程重新抛出
+
+		// 调用线程和辅助任务都从这里领块，领完为止。
+		// body 抛出异常时只记下第一个，并让所有线程不再领新块
+		void Run() {
+			try {
+				size_t chunk = 0;
+				while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < chunk_count) {
+					size_t chunk_begin = begin + chunk * chunk_size;
+					size_t chunk_end = end - chunk_begin > chunk_size ? chunk_begin + chunk_size : end;
+					invoke(context, chunk, chunk_begin, chunk_end);
+				}
+			}
+			catch (...) {
+				if (!failed.exchange(true, std::memory_order_acq_rel)) {
+					error = std::current_exception();
+				}
+				next_chunk.store(chunk_count, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	ParallelState state;
+	state.begin = begin;
+	state.end = end;
+	state.chunk_size = chunk_size > 0 ? chunk_size : 1;
+	state.chunk_count = (end - begin + state.chunk_size - 1) / state.chunk_size;
+	state.invoke = invoke;
+	state.context = context;
+
+	// 只有一块，或者系统在切块之后被关闭，直接在当前线程执行
+	if (state.chunk_count <= 1 || !g_impl.running.load(std::memory_order_acquire)) {
+		state.Run();
+		if (state.error) {
+			std::rethrow_exception(state.error);
+		}
 		return;
 	}
 
-	GLOG(Log::eInfo, "JobSystem::Submit: type=%u priority=%d",
-		static_cast<uint32_t>(info.type), static_cast<int>(info.priority));
+	// 调用线程自己也领块，所以最多再要 chunk_count - 1 个帮手
+	size_t helper_count = state.chunk_count - 1;
+	if (helper_count > g_impl.workers.size()) {
+		helper_count = g_impl.workers.size();
+	}
+
+	// 帮手引用栈上的 state 和计数器，提交中途出错时也要先让它们不再领新块，等全部退出
+	struct HelperGuard {
+		ParallelState& state;
+		JobCounter     helpers;
+
+		explicit HelperGuard(ParallelState& in_state) : state(in_state) {}
+		~HelperGuard() {
+			state.next_chunk.store(state.chunk_count, std::memory_order_relaxed);
+			Wait(helpers);
+		}
+	};
 
-	g_impl.GetQueue(info.type).Push(std::move(info));
-}
\ No newline at end of file
+	{
+		HelperGuard guard(state);
+		for (size_t i = 0; i < helper_count; ++i) {
+			JobInfo helper;
+			helper.name = "ParallelFor";
+			helper.entry = [&state]() { state.Run(); return true; };
+			helper.priority = JobPriority::eHigh;
+			helper.signal_counter = &guard.helpers;
+			Submit(helper);
+		}
+
+		state.Run();
+	}
+
+	// 不论异常发生在调用线程还是帮手里，都在这里传给调用者，不会带着做了一半的结果返回
+	if (state.error) {
+		std::rethrow_exception(state.error);
+	}
+}
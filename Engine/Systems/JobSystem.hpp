@@ -4,8 +4,18 @@
 #include "Platform/Thread/DThread.hpp"
 #include "Platform/Thread/DMutex.hpp"
 #include "Platform/Thread/ConditionVariable.hpp"
+#include "JobFunction.hpp"
 
-#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// 记录每个线程最近的任务执行、窃取与空闲区间，可用 JobSystem::DumpTrace 导出。关闭后只保留计数器
+#ifndef DJOB_TRACE
+#define DJOB_TRACE 1
+#endif
+#define JOB_TRACE_RING_EVENTS 8192          // 每个线程保留的最近事件数，写满后覆盖最旧的
 
 enum class JobType : uint32_t {
     eGeneral = 0,
@@ -20,15 +30,114 @@ enum class JobPriority : int {
     eHigh = 2
 };
 
+//
+// Submit 返回的任务句柄，只有两个整数，可以随意拷贝。
+// 任务的 entry 执行完后句柄即视为完成（on_success / on_failed 仍在之后的 Update 中执行，
+// 句柄完成时回调可能还没进入完成队列；signal_counter 则在回调入队之后才减一）。
+// 任务记录会被复用，复用后代数不同，旧句柄依然表示已完成。
+//
+struct JobHandle {
+    uint32_t index = INVALID_ID;
+    uint32_t generation = INVALID_ID;
+
+    bool IsValid() const { return index != INVALID_ID; }
+};
+
+//
+// 任务计数器：以它为 signal_counter 提交的任务在提交时 +1，entry 执行完后 -1。
+// 其他任务可以把它设为 wait_counter，等它归零后再开始；也可以用 JobSystem::Wait 等待它归零。
+// 计数器必须比引用它的任务活得更久，销毁前先用 JobSystem::Wait 等它归零；有任务在等待时不要让它从 0 重新开始计数。
+//
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    int32_t GetValue() const { return value.load(std::memory_order_acquire); }
+    bool IsDone() const { return GetValue() == 0; }
+
+private:
+    friend class JobSystem;
+    friend struct JobSystemImpl;
+
+    std::atomic<int32_t>  value{ 0 };
+    mutable std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::vector<uint32_t> waiters;          // 等待归零的任务记录下标，受 lock 保护
+};
+
 //
 // 所有参数与结果通过闭包捕获，无需 void* 传参。
+// 闭包不超过 JOB_FUNCTION_INLINE_SIZE 字节时提交不分配内存，见 TJobFunction。
 //
 struct JobInfo {
-    std::function<bool()> entry;
-    std::function<void()> on_success = nullptr;
-    std::function<void()> on_failed = nullptr;
+    const char*           name = nullptr;               // 跟踪时显示的名字，必须是字符串常量
+    TJobFunction<bool()>  entry;
+    TJobFunction<void()>  on_success = nullptr;
+    TJobFunction<void()>  on_failed = nullptr;
     JobType               type = JobType::eGeneral;
     JobPriority           priority = JobPriority::eNormal;
+
+    // 依赖的任务全部完成（不论成功失败）后才开始执行。数组只在 Submit 期间读取
+    const JobHandle*      dependencies = nullptr;
+    uint32_t              dependency_count = 0;
+    JobCounter*           wait_counter = nullptr;       // 归零后才开始执行
+    JobCounter*           signal_counter = nullptr;     // 提交时 +1，entry 执行完后 -1
+
+    // Update 先执行高优先级的回调，同一优先级按完成顺序执行
+    JobPriority           callback_priority = JobPriority::eNormal;
+};
+
+//
+// 单个工作线程的计数器，由 JobSystem::GetStats 填写。
+//
+struct JobWorkerStats {
+    JobType  type = JobType::eGeneral;
+    uint32_t processor = INVALID_ID;    // 绑定的逻辑处理器，INVALID_ID 表示未绑定
+    uint32_t numa_node = 0;
+    uint64_t jobs_executed = 0;
+    uint64_t steals = 0;                // 从其他工作线程队列偷到的任务数
+    uint64_t busy_ns = 0;               // 累计执行任务的时间
+    uint64_t idle_ns = 0;               // 累计找不到任务的时间（自旋、让出与休眠）
+    float    utilization = 0.0f;        // 上次 GetStats 以来执行任务的时间占比
+};
+
+struct JobSystemStats {
+    uint32_t queued[static_cast<uint32_t>(JobType::eCount)] = {};       // 外部线程提交、还没被取走的任务数
+    uint32_t local_queued = 0;                                          // 工作线程自己队列里的任务数
+    uint32_t sleeping_workers = 0;
+    uint32_t callback_backlog = 0;                                      // 已完成、回调还没在 Update 中执行的任务数
+    double   oldest_callback_ms = 0.0;                                  // 其中等得最久的已等了多久
+    float    type_utilization[static_cast<uint32_t>(JobType::eCount)] = {};     // 各类型线程的平均利用率
+    std::vector<JobWorkerStats> workers;
+};
+
+//
+// 每种 JobType 的线程配置。
+//
+struct JobTypeConfig {
+    uint32_t       thread_count = 0;                // 0 按处理器拓扑自动决定
+    ThreadPriority priority = ThreadPriority::eNormal;
+};
+
+//
+// 任务系统的线程布局，一般从 Engine/Config.json 的 "jobs" 一节读取。
+//
+// 绑定线程时按物理核心分配：先跳过保留给主线程与渲染线程的核心，再在各 NUMA 节点之间轮流挑选
+// 核心，每个核心先只用第一个硬件线程。物理核心不够时才用到 SMT 兄弟线程，再不够就从头复用。
+// eGeneral 线程最先挑选，其次 eGPU_Resource，eResource_Load 最后。
+//
+// 工作线程在自己的线程上构造队列等本地数据，按首次访问的原则落在所在 NUMA 节点的内存上。
+//
+struct JobSystemConfig {
+    JobSystemConfig() {
+        types[static_cast<uint32_t>(JobType::eResource_Load)].priority = ThreadPriority::eLow;
+    }
+
+    JobTypeConfig types[static_cast<uint32_t>(JobType::eCount)];
+    bool     pin_threads = true;                    // 把每个工作线程绑定到一个逻辑处理器
+    bool     avoid_smt_siblings = true;             // 自动决定线程数时只数物理核心
+    uint32_t reserved_cores = 1;                    // 不放工作线程的物理核心数，留给主线程
 };
 
 class JobSystem {
@@ -37,20 +146,155 @@ public:
     JobSystem& operator=(const JobSystem&) = delete;
 
     /**
-     * @brief 初始化任务系统。
-     * @param thread_count_per_type 每种 JobType 分配的线程数量数组，长度必须为 JobType::eCount。
-     *                              nullptr 则每种类型各分配 1 个线程。
+     * @brief 按配置初始化任务系统，返回前所有工作线程都已完成绑定与本地数据的构造。
+     * JobType 只是线程的偏好：线程优先取自己类型的任务，空闲时也会执行其他类型的任务。
+     */
+    static DAPI bool Initialize(const JobSystemConfig& config);
+
+    /**
+     * @brief 初始化任务系统，其余设置使用 JobSystemConfig 的默认值。
+     * @param thread_count_per_type 每种 JobType 分配的线程数量数组，长度必须为 JobType::eCount，
+     *                              0 表示自动决定。nullptr 则全部自动决定。
      */
     static DAPI bool Initialize(const uint32_t* thread_count_per_type = nullptr);
     static DAPI void Shutdown();
 
     /**
      * @brief 每帧在主线程调用，执行 on_success / on_failed 回调。
+     * 按 callback_priority 从高到低、同一优先级按完成顺序执行，用完预算后剩下的留到下一次调用。
+     * 每次至少执行一个回调，预算再小积压也会逐帧减少。
+     * @param budget_ms 本次最多花多少毫秒执行回调，0 表示不限制。
+     */
+    static DAPI void Update(double budget_ms = 0.0);
+
+    /**
+     * @brief 提交任务（线程安全）。
+     * 在工作线程中提交的任务进入该线程自己的队列，其他线程提交的进入对应 JobType 的队列。
+     * 同一时刻高优先级的任务先被取走，但不保证整体按优先级顺序完成。
+     * 有依赖的任务先挂在依赖上，依赖全部完成后才进入队列。
+     * 任务记录从工作线程本地的空闲列表复用，闭包足够小时提交过程不分配内存。
+     * @return 任务句柄，系统未运行时返回无效句柄。
+     */
+    static DAPI JobHandle Submit(JobInfo info);
+
+    /**
+     * @brief 任务的 entry 是否已执行完，无效句柄视为已完成。
+     */
+    static DAPI bool IsComplete(JobHandle handle);
+
+    /**
+     * @brief 等待任务完成。等待期间当前线程会执行其他任务，而不是阻塞，
+     * 因此可以在工作线程里等待自己提交的子任务。
      */
-    static DAPI void Update();
+    static DAPI void Wait(JobHandle handle);
+    static DAPI void Wait(const JobHandle* handles, uint32_t count);
 
     /**
-     * @brief 提交任务到对应 JobType 的队列（线程安全）。
+     * @brief 等待计数器归零，等待期间同样会执行其他任务。
      */
-    static DAPI void Submit(JobInfo info);
+    static DAPI void Wait(const JobCounter& counter);
+
+    /**
+     * @brief 读取队列长度、回调积压与各工作线程的计数器，均为近似值。
+     * 利用率按两次调用之间的时间计算。回调积压由主线程维护，只能在调用 Update 的线程上调用。
+     */
+    static DAPI void GetStats(JobSystemStats& out_stats);
+
+    /**
+     * @brief 任务类型的显示名，与线程名、跟踪导出使用同一张表。
+     */
+    static DAPI const char* GetTypeName(JobType type);
+
+    /**
+     * @brief 跟踪使用的时间戳（纳秒），用来指定 DumpTrace 的时间窗口。
+     */
+    static DAPI uint64_t GetTraceTime();
+
+    /**
+     * @brief 把 [begin_ns, end_ns] 内与之重叠的跟踪事件写成 Chrome Trace / Perfetto 可读的 JSON。
+     * 每个线程只保留最近 JOB_TRACE_RING_EVENTS 个事件，更早的已被覆盖。可以在任务执行期间调用。
+     *
+     * 使用示例：
+     *   uint64_t Start = JobSystem::GetTraceTime();
+     *   ...
+     *   JobSystem::DumpTrace("job_trace.json", Start, JobSystem::GetTraceTime());
+     *
+     * @return 文件无法写入或编译时关闭了 DJOB_TRACE 时返回 false。
+     */
+    static DAPI bool DumpTrace(const char* path, uint64_t begin_ns = 0, uint64_t end_ns = UINT64_MAX);
+
+    /**
+     * @brief 把 [begin, end) 切块并行执行 func(chunk_begin, chunk_end)，返回时所有块都已执行完。
+     * 调用线程也参与执行，空闲的工作线程动态领取剩下的块，块大小按线程数自动调整，不小于 grain。
+     * 元素个数不超过 grain 或任务系统未运行时直接在调用线程串行执行。
+     * 任何一块抛出异常后不再分发新块，等所有参与线程退出后把第一个异常在调用线程重新抛出。
+     *
+     * 使用示例：
+     *   JobSystem::ParallelFor(0, Count, 1024, [&](size_t begin, size_t end) {
+     *       for (size_t i = begin; i < end; ++i) Out[i] = Transform(In[i]);
+     *   });
+     *
+     * @param grain 每块最少的元素个数，0 按 1 处理。单个元素越便宜，grain 应越大。
+     */
+    template<typename Func>
+    static void ParallelFor(size_t begin, size_t end, size_t grain, Func&& func) {
+        if (end <= begin) {
+            return;
+        }
+
+        using FuncType = std::remove_reference_t<Func>;
+        const size_t chunk_size = GetParallelChunkSize(end - begin, grain);
+        ParallelForChunks(begin, end, chunk_size, [](void* context, size_t, size_t chunk_begin, size_t chunk_end) {
+            (*static_cast<FuncType*>(context))(chunk_begin, chunk_end);
+        }, (void*)&func);
+    }
+
+    /**
+     * @brief 并行归约：每块执行 map(chunk_begin, chunk_end) 得到一个部分结果，
+     * 再在调用线程按块的顺序用 combine 合并，结果与块的执行顺序无关。
+     *
+     * 使用示例：
+     *   float Sum = JobSystem::ParallelReduce(0, Count, 4096, 0.0f,
+     *       [&](size_t begin, size_t end) { float s = 0; for (size_t i = begin; i < end; ++i) s += Values[i]; return s; },
+     *       [](float a, float b) { return a + b; });
+     */
+    template<typename T, typename Map, typename Combine>
+    static T ParallelReduce(size_t begin, size_t end, size_t grain, T identity, Map&& map, Combine&& combine) {
+        if (end <= begin) {
+            return identity;
+        }
+
+        const size_t chunk_size = GetParallelChunkSize(end - begin, grain);
+        const size_t chunk_count = (end - begin + chunk_size - 1) / chunk_size;
+        if (chunk_count == 1) {
+            return combine(identity, map(begin, end));
+        }
+
+        // 包一层结构体，避免 std::vector<bool> 按位存放导致并发写同一个字节
+        struct Partial {
+            T value;
+        };
+        struct ReduceContext {
+            std::remove_reference_t<Map>* map;
+            std::vector<Partial> partials;
+        } context{ &map, std::vector<Partial>(chunk_count, Partial{ identity }) };
+
+        ParallelForChunks(begin, end, chunk_size, [](void* context, size_t chunk_index, size_t chunk_begin, size_t chunk_end) {
+            ReduceContext& reduce = *static_cast<ReduceContext*>(context);
+            reduce.partials[chunk_index].value = (*reduce.map)(chunk_begin, chunk_end);
+        }, &context);
+
+        T result = identity;
+        for (const Partial& partial : context.partials) {
+            result = combine(result, partial.value);
+        }
+        return result;
+    }
+
+private:
+    typedef void(*PFN_parallel_chunk)(void* context, size_t chunk_index, size_t chunk_begin, size_t chunk_end);
+
+    // 按参与的线程数决定块大小，返回值不小于 grain，区间太小时等于区间长度
+    static DAPI size_t GetParallelChunkSize(size_t count, size_t grain);
+    static DAPI void ParallelForChunks(size_t begin, size_t end, size_t chunk_size, PFN_parallel_chunk invoke, void* context);
 };
\ No newline at end of file
@@ -1,4 +1,6 @@
-﻿#include "MaterialSystem.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "MaterialSystem.h"
 
 #include "Core/EngineLogger.hpp"
 #include "Math/MathTypes.hpp"
@@ -31,9 +33,7 @@ bool MaterialSystem::Initialize(IRenderer* renderer, SMaterialSystemConfig confi
 	MaterialSystemConfig = config;
 	Renderer = renderer;
 
-	// Invalidate all textures in the array.
-	uint32_t Count = MaterialSystemConfig.max_material_count;
-	RegisteredMaterials.resize(Count);
+	RegisteredMaterials.Reserve(MaterialSystemConfig.max_material_count);
 
 	// Create default textures for use in the system.
 	if (!CreateDefaultMaterial()) {
@@ -48,14 +48,10 @@ bool MaterialSystem::Initialize(IRenderer* renderer, SMaterialSystemConfig confi
 void MaterialSystem::Shutdown() {
 	// Destroy all loaded textures.
 	for (Material* m : RegisteredMaterials) {
-		if (m) {
-			DestroyMaterial(m);
-			DeleteObject(m);
-			m = nullptr;
-		}
-	};
-	RegisteredMaterials.clear();
-	std::vector<Material*>().swap(RegisteredMaterials);
+		DestroyMaterial(m);
+		DeleteObject(m);
+	}
+	RegisteredMaterials.Clear();
 
 	if (DefaultMaterial) {
 		DestroyMaterial(DefaultMaterial);
@@ -66,14 +62,29 @@ void MaterialSystem::Shutdown() {
 	MaterialMap.clear();
 }
 
-Material* MaterialSystem::Acquire(const FString& name) {
-	if (name.Compare(DEFAULT_MATERIAL_NAME) == 0) {
+static FName GetDefaultMaterialName() {
+	static const FName DefaultName(DEFAULT_MATERIAL_NAME);
+	return DefaultName;
+}
+
+Material* MaterialSystem::Acquire(FName name) {
+	if (name == GetDefaultMaterialName()) {
 		return DefaultMaterial;
 	}
 
+	// Already loaded, no need to read the configuration again.
+	auto It = MaterialMap.find(name);
+	Material** Found = It != MaterialMap.end() ? RegisteredMaterials.Get(It->second) : nullptr;
+	if (Found != nullptr) {
+		Material* Mat = *Found;
+		Mat->IncreaseReferenceCount();
+		GLOG(Log::eDebug, "Material '%s' Reference count increased to %i.", name.CStr(), Mat->GetReferenceCount());
+		return Mat;
+	}
+
 	// Load the given material configuration from disk.
 	UAsset MatResource;
-	if (!ResourceSystem::Get().Load(name, EAssetType::Material, nullptr, &MatResource)) {
+	if (!ResourceSystem::Get().Load(name.ToString(), EAssetType::Material, nullptr, &MatResource)) {
 		GLOG(Log::eError, "Failed to load material resource, returning nullptr.");
 		return nullptr;
 	}
@@ -96,35 +107,33 @@ Material* MaterialSystem::Acquire(const FString& name) {
 }
 
 Material* MaterialSystem::AcquireFromConfig(SMaterialConfig config) {
+	FName Name(config.name);
+
 	// Return default material.
-	if (config.name.Compare(DEFAULT_MATERIAL_NAME) == 0) {
+	if (Name == GetDefaultMaterialName()) {
 		return DefaultMaterial;
 	}
 
 	// 如果找不到材质，则创建一个新的材质。
-	if (MaterialMap.find(config.name) == MaterialMap.end()) {
-		uint32_t Count = MaterialSystemConfig.max_material_count;
-		Material* m = nullptr;
-		for (uint32_t i = 0; i < Count; ++i) {
-			if (RegisteredMaterials[i] == nullptr) {
-				// A free slot has been found. Use it index as the handle.
-				RegisteredMaterials[i] = NewObject<Material>();
-				RegisteredMaterials[i]->SetID(i);
-				MaterialMap[config.name] = i;
-				m = RegisteredMaterials[i];
-				break;
-			}
-		}
-
-		// Make sure an empty slot was actually found.
-		if (m == nullptr || m->GetID() == INVALID_ID) {
+	auto It = MaterialMap.find(Name);
+	if (It == MaterialMap.end()) {
+		if (RegisteredMaterials.Size() >= MaterialSystemConfig.max_material_count) {
 			GLOG(Log::eFatal, "Material acquire failed. Material system cannot hold anymore materials. Adjust configuration to allow more.");
 			return nullptr;
 		}
 
+		// The handle of the new slot becomes the material id and generation.
+		Material* m = NewObject<Material>();
+		FSlotHandle Handle = RegisteredMaterials.Insert(m);
+		m->SetID(Handle.Index);
+		m->Generation = Handle.Generation;
+
 		// Create new material.
 		if (!LoadMaterial(config, m)) {
 			GLOG(Log::eError, "Load %s material failed.", config.name.CStr());
+			RegisteredMaterials.Erase(Handle);
+			DestroyMaterial(m);
+			DeleteObject(m);
 			return nullptr;
 		}
 
@@ -171,20 +180,11 @@ Material* MaterialSystem::AcquireFromConfig(SMaterialConfig config) {
 			UILocations.model = s->GetUniformIndex("model");
 		}
 
-
-		if (m->Generation == INVALID_ID) {
-			m->Generation = 1;
-		}
-		else {
-			m->Generation++;
-		}
+		It = MaterialMap.emplace(Name, Handle).first;
 	}
 
-	uint32_t MaterialID = MaterialMap[config.name];
-	Material* Mat = GetDefaultMaterial();
-	if (MaterialID != INVALID_ID) {
-		Mat = RegisteredMaterials[MaterialID];
-	}
+	Material** Found = RegisteredMaterials.Get(It->second);
+	Material* Mat = Found != nullptr ? *Found : GetDefaultMaterial();
 	ASSERT(Mat != nullptr);
 
 	// This can only be changed the first time a material is loaded.
@@ -199,34 +199,30 @@ Material* MaterialSystem::AcquireFromConfig(SMaterialConfig config) {
 	return Mat;
 }
 
-void MaterialSystem::Release(const FString& name) {
+void MaterialSystem::Release(FName name) {
 	// Ignore release requests for the default material.
-	if (name.Compare(DEFAULT_MATERIAL_NAME) == 0) {
+	if (name == GetDefaultMaterialName()) {
 		return;
 	}
 
-	// Take a copy of name, it will be zero-out in DestroyMaterial();
-	FString CopyMatName = name;
-
-	if (MaterialMap.find(CopyMatName) != MaterialMap.end()) {
-		uint32_t MaterialID = MaterialMap[CopyMatName];
-		Material* Mat = RegisteredMaterials[MaterialID];
+	auto It = MaterialMap.find(name);
+	Material** Found = It != MaterialMap.end() ? RegisteredMaterials.Get(It->second) : nullptr;
+	if (Found != nullptr) {
+		Material* Mat = *Found;
 		if (Mat->GetReferenceCount() == 0) {
-			GLOG(Log::eWarn, "Tried to release non-existent material: %s", CopyMatName.CStr());
+			GLOG(Log::eWarn, "Tried to release non-existent material: %s", name.CStr());
 			return;
 		}
 
 		Mat->DecreaseReferenceCount();
 		if (Mat->GetReferenceCount() == 0 && Mat->IsAutoRelease()) {
-			// Release material.
+			// Release material, the entry goes with it.
+			RegisteredMaterials.Erase(It->second);
+			MaterialMap.erase(It);
 			DestroyMaterial(Mat);
 			DeleteObject(Mat);
-			RegisteredMaterials[MaterialID] = nullptr;
-			GLOG(Log::eInfo, "Released material '%s'. Material unloaded.", CopyMatName.CStr());
+			GLOG(Log::eInfo, "Released material '%s'. Material unloaded.", name.CStr());
 		}
-
-		// Update the entry.
-		MaterialMap.erase(CopyMatName);
 	}
 }
 
@@ -341,7 +337,7 @@ bool MaterialSystem::LoadMaterial(SMaterialConfig config, Material* mat) {
 	// Gather a list of pointers to texture maps.
 	std::vector<TextureMap*> Maps = { &mat->DiffuseMap, &mat->NormalMap, &mat->RoughnessMetallicMap };
 	mat->InternalID = Renderer->AcquireInstanceResource(s, Maps);
-	if (mat->InternalID == INVALID_ID) {
+	if (mat->InternalID == INVALID_ID_U64) {
 		GLOG(Log::eError, "Failed to acquire renderer resources for material '%s'.", mat->Name.CStr());
 		return false;
 	}
@@ -370,7 +366,7 @@ void MaterialSystem::DestroyMaterial(Material* mat) {
 	Renderer->ReleaseTextureMap(&mat->RoughnessMetallicMap);
 
 	//Release renderer resources.
-	if (mat->ShaderID != INVALID_ID && mat->InternalID != INVALID_ID) {
+	if (mat->ShaderID != INVALID_ID && mat->InternalID != INVALID_ID_U64) {
 		Shader* s = ShaderSystem::Get().GetByID(mat->ShaderID);
 		Renderer->ReleaseInstanceResource(s, mat->InternalID);
 		mat->ShaderID = INVALID_ID;
@@ -379,7 +375,7 @@ void MaterialSystem::DestroyMaterial(Material* mat) {
 	// Zero it out, invalidate Ids.
 	mat->SetID(INVALID_ID);
 	mat->Generation = INVALID_ID;
-	mat->InternalID = INVALID_ID;
+	mat->InternalID = INVALID_ID_U64;
 	mat->RenderFrameNumer = INVALID_ID;
 }
 
@@ -442,7 +438,7 @@ bool MaterialSystem::CreateDefaultMaterial() {
 	}
 
 	DefaultMaterial->InternalID = Renderer->AcquireInstanceResource(s, Maps);
-	if (DefaultMaterial->InternalID == INVALID_ID) {
+	if (DefaultMaterial->InternalID == INVALID_ID_U64) {
 		GLOG(Log::eError, "Create default material failed. Application quit now!");
 		return false;
 	}
@@ -502,7 +498,7 @@ bool MaterialSystem::ApplyGlobal(uint32_t shader_id, size_t renderer_frame_numbe
 }
 
 bool MaterialSystem::ApplyInstance(Material* mat, bool need_update) {
-	if (mat->InternalID == INVALID_ID) {
+	if (mat->InternalID == INVALID_ID_U64) {
 		return false;
 	}
 
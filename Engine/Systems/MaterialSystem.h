@@ -2,6 +2,8 @@
 
 #include "Defines.hpp"
 #include "Containers/FString.hpp"
+#include "Containers/FName.hpp"
+#include "Containers/TSlotMap.hpp"
 #include "Rendering/Resources/ResourceTypes.hpp"
 #include <unordered_map>
 
@@ -19,10 +21,10 @@ public:
 	bool Initialize(IRenderer* renderer, SMaterialSystemConfig config);
 	void Shutdown();
 
-	Material* Acquire(const FString& name);
+	Material* Acquire(FName name);
 	Material* AcquireFromConfig(SMaterialConfig config);
 
-	void Release(const FString& name);
+	void Release(FName name);
 
 	Material* GetDefaultMaterial();
 
@@ -66,9 +68,9 @@ public:
 	Material* DefaultMaterial = nullptr;
 
 	// Array of registered materials.
-	std::vector<Material*> RegisteredMaterials;
-	// Hashtable for material lookups.
-	std::unordered_map<FString, uint32_t> MaterialMap;
+	TSlotMap<Material*> RegisteredMaterials;
+	// Hashtable for material lookups, material name to handle in RegisteredMaterials.
+	std::unordered_map<FName, FSlotHandle> MaterialMap;
 
 	// Know locations for the material shader.
 	MaterialShaderUniformLocations MaterialLocations;
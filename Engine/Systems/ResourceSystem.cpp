@@ -1,4 +1,6 @@
-﻿#include "ResourceSystem.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "ResourceSystem.h"
 
 #include "Rendering/Vulkan/VulkanContext.hpp"
 
@@ -1,4 +1,6 @@
-﻿#include "ShaderSystem.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "ShaderSystem.h"
 
 #include "Rendering/Renderer.hpp"
 #include "Systems/TextureSystem.h"
@@ -84,7 +86,7 @@ void ShaderSystem::Shutdown() {
 	}
 }
 
-bool ShaderSystem::ReloadShader(const FString& shader_name, EShaderLanguage language) {
+bool ShaderSystem::ReloadShader(FName shader_name, EShaderLanguage language) {
 	Shader* s = Get(shader_name);
 	if (s == nullptr) {
 		return false;
@@ -111,7 +113,7 @@ bool ShaderSystem::ReloadShader(Shader* shader, EShaderLanguage language) {
 }
 
 bool ShaderSystem::OnReloadShader(eEventCode code, void* sender, void* listenerInst, SEventContext context) {
-	FString ShaderName = context.data.c;
+	FName ShaderName = context.data.c;
 	if (!ReloadShader(ShaderName)) {
 		GLOG(Log::eError, "Failed to reload shader %s.", ShaderName.CStr());
 		return false;
@@ -206,7 +208,7 @@ bool ShaderSystem::Create(IRenderpass* pass, ShaderConfig* config) {
 	return true;
 }
 
-unsigned ShaderSystem::GetID(const FString& shader_name) {
+unsigned ShaderSystem::GetID(FName shader_name) {
 	return GetShaderID(shader_name);
 }
 
@@ -218,7 +220,7 @@ Shader* ShaderSystem::GetByID(uint32_t shader_id) {
 	return Shaders[shader_id];
 }
 
-Shader* ShaderSystem::Get(const FString& shader_name) {
+Shader* ShaderSystem::Get(FName shader_name) {
 	uint32_t ShaderID = GetShaderID(shader_name);
 	if (ShaderID != INVALID_ID) {
 		return GetByID(ShaderID);
@@ -227,7 +229,7 @@ Shader* ShaderSystem::Get(const FString& shader_name) {
 	return nullptr;
 }
 
-uint32_t ShaderSystem::GetShaderID(const FString& shader_name) {
+uint32_t ShaderSystem::GetShaderID(FName shader_name) {
 	auto it = ShaderMap.find(shader_name);
 	if (it == ShaderMap.end()){
 		return INVALID_ID;
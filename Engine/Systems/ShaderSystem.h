@@ -3,6 +3,7 @@
 #include "Defines.hpp"
 #include "Core/Event.hpp"
 #include "Containers/FString.hpp"
+#include "Containers/FName.hpp"
 #include "Rendering/Resources/ResourceTypes.hpp"
 #include <functional>
 #include <map>
@@ -52,7 +53,7 @@ public:
 	 * @param shader_name The name of the shader.
 	 * @return The shader id, if found; otherwise INVALID_ID.
 	 */
-	unsigned GetID(const FString& shader_name);
+	unsigned GetID(FName shader_name);
 
 	/**
 	 * @brief Returns a pointer to a shader with the given identifier.
@@ -68,9 +69,9 @@ public:
 	 * @param shader_name The name to search for. Case sensitive.
 	 * @return A pointer to a shader, if found; otherwise 0.
 	 */
-	Shader* Get(const FString& shader_name);
+	Shader* Get(FName shader_name);
 
-	bool ReloadShader(const FString& shader_name, EShaderLanguage language = EShaderLanguage::eGLSL);
+	bool ReloadShader(FName shader_name, EShaderLanguage language = EShaderLanguage::eGLSL);
 	bool ReloadShader(Shader* shader, EShaderLanguage language = EShaderLanguage::eGLSL);
 	
 public:
@@ -80,13 +81,13 @@ private:
 	bool OnReloadShader(eEventCode code, void* sender, void* listenerInst, SEventContext context);
 
 private:
-	uint32_t GetShaderID(const FString& shader_name);
+	uint32_t GetShaderID(FName shader_name);
 
 public:
 	IRenderer* Renderer = nullptr;
 	ShaderSystem::Config ShaderSystemConfig;
 	
-	std::unordered_map<FString, uint32_t> ShaderMap;
+	std::unordered_map<FName, uint32_t> ShaderMap;
 	TMap<size_t, Shader*> Shaders;
 	
 	bool Initilized = false;
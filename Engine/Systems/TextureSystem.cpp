@@ -1,11 +1,18 @@
-﻿#include "TextureSystem.h"
+﻿#define LOG_CATEGORY Log::Category::eResources
+
+#include "TextureSystem.h"
 
 #include "Core/Engine.hpp"
 
 #include "Systems/JobSystem.hpp"
+#include "Memory/ScratchAllocator.h"
 #include "Rendering/Renderer.hpp"
 #include "Rendering/Resources/Texture/Loader/TextureHelper.hpp"
 
+#include <atomic>
+
+#define TEXTURE_TRANSPARENCY_SCAN_GRAIN 65536		// 透明度扫描每块至少包含的像素数
+
 TextureSystem& TextureSystem::Get() {
 	static TextureSystem TextureSystemInstance;
 	return TextureSystemInstance;
@@ -55,9 +62,9 @@ void TextureSystem::Shutdown() {
 	DestroyDefaultTexture();
 }
 
-UTexture* TextureSystem::Acquire(const FString& name, bool auto_release) {
+UTexture* TextureSystem::Acquire(FName name, bool auto_release) {
 	// Return default texture, but warn about it since this should be returned via GetDefaultTexture()
-	UTexture* OutTexture = CheckTextureName(name);
+	UTexture* OutTexture = CheckTextureName(name.ToString());
 	if (OutTexture) {
 		return OutTexture;
 	}
@@ -74,14 +81,14 @@ UTexture* TextureSystem::Acquire(const FString& name, bool auto_release) {
 		return nullptr;
 	}
 
-	OutTexture->SetName(name);
+	OutTexture->SetName(name.ToString());
 
 	return OutTexture;
 }
 
-UTexture* TextureSystem::AcquireCube(const FString& name, bool auto_release) {
+UTexture* TextureSystem::AcquireCube(FName name, bool auto_release) {
 	// Return default texture, but warn about it since this should be returned via GetDefaultTexture()
-	UTexture* OutTexture = CheckTextureName(name);
+	UTexture* OutTexture = CheckTextureName(name.ToString());
 	if (OutTexture) {
 		return OutTexture;
 	}
@@ -101,7 +108,7 @@ UTexture* TextureSystem::AcquireCube(const FString& name, bool auto_release) {
 	return OutTexture;
 }
 
-UTexture* TextureSystem::AcquireWriteable(const FString& name, uint32_t width, uint32_t height,
+UTexture* TextureSystem::AcquireWriteable(FName name, uint32_t width, uint32_t height,
 	unsigned char channel_count, bool has_transparency, bool has_depth){
 	// NOTE: Wrapped textures are never auto-release because it means that their
 	// resources are created and managed somewhere within the renderer internals.
@@ -112,7 +119,7 @@ UTexture* TextureSystem::AcquireWriteable(const FString& name, uint32_t width, u
 	
 	UTexture* t = TextureMap[name];
 	t->SetTextureType(TextureType::eTexture_Type_2D);
-	t->SetName(name);
+	t->SetName(name.ToString());
 	t->SetWidth(width);
 	t->SetHeight(height);
 	t->SetChannelCount(channel_count);
@@ -124,12 +131,17 @@ UTexture* TextureSystem::AcquireWriteable(const FString& name, uint32_t width, u
 	return t;
 }
 
-void TextureSystem::Release(const FString& name) {
+void TextureSystem::Release(FName name) {
+	static const FName DefaultNames[] = {
+		DEFAULT_DIFFUSE_TEXTURE_NAME,
+		DEFAULT_SPECULAR_TEXTURE_NAME,
+		DEFAULT_NORMAL_TEXTURE_NAME,
+		DEFAULT_ROUGHNESS_METALLIC_TEXTURE_NAME
+	};
+
 	// Ignore release requests for the default texture.
-	if (name.Compare(DEFAULT_DIFFUSE_TEXTURE_NAME) == 0 ||
-		name.Compare(DEFAULT_SPECULAR_TEXTURE_NAME) == 0 ||
-		name.Compare(DEFAULT_NORMAL_TEXTURE_NAME) == 0 ||
-		name.Compare(DEFAULT_ROUGHNESS_METALLIC_TEXTURE_NAME) == 0
+	if (name == DefaultNames[0] || name == DefaultNames[1] ||
+		name == DefaultNames[2] || name == DefaultNames[3]
 	){
 		return;
 	}
@@ -351,6 +363,8 @@ void TextureSystem::DestroyDefaultTexture() {
 bool TextureSystem::LoadCubeTexture(const FString& name, const TArray<FString>& texture_names, UTexture* t) {
 	ASSERT(texture_names.Size() == 6);
 
+	// The faces are stitched in scratch memory, which is released once the texture is uploaded.
+	ScratchScope Scratch;
 	unsigned char* piexels = nullptr;
 	size_t ImageSize = 0;
 	for (unsigned char i = 0; i < 6; ++i) {
@@ -370,7 +384,13 @@ bool TextureSystem::LoadCubeTexture(const FString& name, const TArray<FString>&
 			t->SetChannelCount(ImageResource->GetChannelCount());
 			t->SetFlag(0);
 			ImageSize = t->GetWidth() * t->GetHeight() * t->GetChannelCount();
-			piexels = (unsigned char*)Memory::Allocate(ImageSize * sizeof(unsigned char) * 6, MemoryType::eMemory_Type_Array);
+			piexels = ScratchAllocator::NewArray<unsigned char>(ImageSize * 6);
+			if (!piexels) {
+				GLOG(Log::eError, "TextureSystem::LoadCubeTexture() Unable to allocate %llu bytes for cube texture '%s'.", (unsigned long long)(ImageSize * 6), name.CStr());
+				TextureHelper::Unload(ImageResource);
+				DestroyTexture(ImageResource);
+				return false;
+			}
 		}
 
 		// Copy to the relevant portion of the array.
@@ -385,9 +405,6 @@ bool TextureSystem::LoadCubeTexture(const FString& name, const TArray<FString>&
 
 	// Acquire internal texture resources and upload to GPU.
 	t->Load(piexels);
-
-	Memory::Free(piexels, MemoryType::eMemory_Type_Array);
-	piexels = nullptr;
 	return true;
 }
 
@@ -418,16 +435,20 @@ bool TextureSystem::LoadJobStart(TextureLoadParams* params, TextureLoadParams* r
 	}
 
 	size_t TotalSize = LoadParams->out_texture->GetSize();
-	// Check for transparency.
-	bool HasTransparency = false;
-	unsigned char* RawPixels = LoadParams->out_texture->GetPixels();
-	for (size_t i = 0; i < TotalSize; i += LoadParams->out_texture->GetChannelCount()) {
-		unsigned char a = RawPixels[i + 3];
-		if (a < 255) {
-			HasTransparency = true;
-			break;
+	// Check for transparency. Large images are scanned in parallel; every chunk stops as soon
+	// as any chunk has found a translucent pixel.
+	const size_t ChannelCount = LoadParams->out_texture->GetChannelCount();
+	const size_t PixelCount = ChannelCount > 0 ? TotalSize / ChannelCount : 0;
+	const unsigned char* RawPixels = LoadParams->out_texture->GetPixels();
+	std::atomic<bool> FoundTransparency{ false };
+	JobSystem::ParallelFor(0, PixelCount, TEXTURE_TRANSPARENCY_SCAN_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end && !FoundTransparency.load(std::memory_order_relaxed); ++i) {
+			if (RawPixels[i * ChannelCount + 3] < 255) {
+				FoundTransparency.store(true, std::memory_order_relaxed);
+			}
 		}
-	}
+	});
+	bool HasTransparency = FoundTransparency.load();
 
 	// Take a copy of the name
 	LoadParams->out_texture->AddFlag(HasTransparency ? TextureFlagBits::eTexture_Flag_Has_Transparency : 0);
@@ -469,16 +490,17 @@ bool TextureSystem::LoadTexture(const FString& name, UTexture* texture) {
 	//LoadJobStart(Params.get(), Params.get());
 
 	JobInfo Job;
+	Job.name = "TextureLoad";
 	Job.entry = [this, Params]() { return LoadJobStart(Params.get(), Params.get()); };
 	Job.on_success = [this, Params]() { return LoadJobSuccess(Params.get()); };
 	Job.on_failed = [this, Params]() { return LoadJobFail(Params.get()); };
 	Job.type = JobType::eResource_Load;
-	JobSystem::Submit(Job);
+	JobSystem::Submit(std::move(Job));
 
 	return true;
 }
 
-bool TextureSystem::ProcessTextureReference(const FString& name, TextureType type ,
+bool TextureSystem::ProcessTextureReference(FName name, TextureType type ,
 	short reference_diff, bool auto_release, bool skip_load) {
 	if (!Initilized) {
 		return false;
@@ -492,7 +514,7 @@ bool TextureSystem::ProcessTextureReference(const FString& name, TextureType typ
 		for (uint32_t i = 0; i < Count; ++i) {
 			if (Tex == nullptr) {
 				// A free slot has been found. Use its index as the handle.
-				Tex = Renderer->AcquireTexture(name);
+				Tex = Renderer->AcquireTexture(name.ToString());
 				// Either way, update the entry.
 				TextureMap[name] = Tex;
 				break;
@@ -511,7 +533,7 @@ bool TextureSystem::ProcessTextureReference(const FString& name, TextureType typ
 		}
 		else {
 			if (type == TextureType::eTexture_Type_2D) {
-				if (!LoadTexture(name, Tex)) {
+				if (!LoadTexture(name.ToString(), Tex)) {
 					GLOG(Log::eError, "Failed to load texture '%s'.", name.CStr());
 					return false;
 				}
@@ -527,7 +549,7 @@ bool TextureSystem::ProcessTextureReference(const FString& name, TextureType typ
 				TextureNames.Push(FString::Format("%s_f", name.CStr()));	// Front texture.
 				TextureNames.Push(FString::Format("%s_b", name.CStr()));	// Back texture.
 
-				if (!LoadCubeTexture(name, TextureNames, Tex)) {
+				if (!LoadCubeTexture(name.ToString(), TextureNames, Tex)) {
 					GLOG(Log::eError, "Failed to load cube texture '%s'.", name.CStr());
 					return false;
 				}
@@ -559,10 +581,6 @@ bool TextureSystem::ProcessTextureReference(const FString& name, TextureType typ
 
 	Tex->IncreaseReferenceCount(reference_diff);
 
-	// Take a copy of the name since it would be wiped out if destroyed,
-	// (as passed in name is generally a pointer to the actual texture's name).
-	FString NameCopy = name;
-
 	// If decrementing, this means a release.
 	if (reference_diff < 0) {
 		// Check if the reference count has reached 0. If it has, and the reference
@@ -573,7 +591,7 @@ bool TextureSystem::ProcessTextureReference(const FString& name, TextureType typ
 
 			// Reset the reference.
 			Tex->SetIsAutoRelease(false);
-			GLOG(Log::eDebug, "Released texture '%s', Texture unloaded because count=0 and auto_release=true.", NameCopy.CStr());
+			GLOG(Log::eDebug, "Released texture '%s', Texture unloaded because count=0 and auto_release=true.", name.CStr());
 		}
 	}
 	else {
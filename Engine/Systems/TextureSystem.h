@@ -2,6 +2,7 @@
 
 #include "Rendering/RenderTypes.hpp"
 #include "Rendering/Resources/Texture/Texture.hpp"
+#include "Containers/FName.hpp"
 
 #define DEFAULT_DIFFUSE_TEXTURE_NAME "DefaultBaseColorTexture"
 #define DEFAULT_SPECULAR_TEXTURE_NAME "DefaultSpecularTexture"
@@ -28,12 +29,12 @@ public:
 	bool Initialize(IRenderer* renderer, STextureSystemConfig config);
 	void Shutdown();
 
-	UTexture* Acquire(const FString& name, bool auto_release = true);
-	UTexture* AcquireCube(const FString& name, bool auto_release = true);
-	UTexture* AcquireWriteable(const FString& name, uint32_t width, uint32_t height,
+	UTexture* Acquire(FName name, bool auto_release = true);
+	UTexture* AcquireCube(FName name, bool auto_release = true);
+	UTexture* AcquireWriteable(FName name, uint32_t width, uint32_t height,
 		unsigned char channel_count, bool has_transparency, bool has_depth = false);
 
-	void Release(const FString& name);
+	void Release(FName name);
 	bool Resize(UTexture* t, uint32_t width, uint32_t height, bool regenerate_internal_data);
 
 	UTexture* GetDefaultDiffuseTexture();
@@ -49,7 +50,7 @@ private:
 
 	bool CreateDefaultTexture();
 	void DestroyDefaultTexture();
-	bool ProcessTextureReference(const FString& name, TextureType type,
+	bool ProcessTextureReference(FName name, TextureType type,
 		short reference_diff, bool auto_release, bool skip_load);
 
 	void LoadJobSuccess(void* params);
@@ -64,7 +65,7 @@ private:
 	UTexture* DefaultRoughnessMetallicTexture;
 
 	// Hashtable for texture lookups.
-	std::unordered_map<FString, UTexture*> TextureMap;
+	std::unordered_map<FName, UTexture*> TextureMap;
 
 	bool Initilized;
 
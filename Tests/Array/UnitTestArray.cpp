@@ -1,7 +1,21 @@
 ﻿#include <iostream>
 #include <Containers/TArray.hpp>
+#include <Containers/TInlineArray.hpp>
+#include <Containers/TSlotMap.hpp>
+#include <Containers/FString.hpp>
 #include <Core/DMemory.hpp>
 
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
 using namespace std;
 
 class CA {
@@ -87,6 +101,100 @@ public:
 	std::string ss;
 };
 
+static bool TestArrayBulk() {
+	cout << "\n=== 测试 TArray 批量操作 ===" << endl;
+
+	TArray<uint32_t> Empty;
+	TEST_ASSERT(Empty.Data() == nullptr && Empty.GetCapacity() == 0, "空数组不分配内存");
+
+	uint32_t Values[] = { 1, 2, 3, 4, 5 };
+	TArray<uint32_t> Arr;
+	Arr.Append(Values, 5);
+	Arr.InsertAt(1, Values + 3, 2);		// 1 4 5 2 3 4 5
+	TEST_ASSERT(Arr.Size() == 7 && Arr[1] == 4 && Arr[2] == 5 && Arr[3] == 2, "批量插入");
+
+	Arr.RemoveSwap(0);					// 5 4 5 2 3 4
+	TEST_ASSERT(Arr.Size() == 6 && Arr[0] == 5, "RemoveSwap 用末尾元素填补");
+
+	// FString 按字节搬移，扩容后内容保持不变
+	TArray<FString> Names;
+	for (uint32_t i = 0; i < 100; ++i) {
+		Names.Push(FString::Format("Assets/Textures/Texture_%u.png", i));
+	}
+	Names.PopAt(0);
+	TEST_ASSERT(Names.Size() == 99 && Names[0] == "Assets/Textures/Texture_1.png"
+		&& Names[98] == "Assets/Textures/Texture_99.png", "FString 扩容与删除");
+
+	return true;
+}
+
+static bool TestInlineArray() {
+	cout << "\n=== 测试 TInlineArray ===" << endl;
+
+	size_t CountBefore = Memory::GetAllocateCount();
+	TInlineArray<CA*, 4> Small;
+	CA Objects[8];
+	for (int i = 0; i < 4; ++i) {
+		Small.Push(&Objects[i]);
+	}
+	TEST_ASSERT(Small.IsInline() && Memory::GetAllocateCount() == CountBefore, "不超过内联容量时不分配内存");
+
+	Small.Push(&Objects[4]);
+	TEST_ASSERT(!Small.IsInline() && Small.Size() == 5 && Small[4] == &Objects[4], "超出后转为堆内存");
+
+	TInlineArray<CA*, 4> Moved(std::move(Small));
+	TEST_ASSERT(Moved.Size() == 5 && Small.IsEmpty() && Small.IsInline(), "移动堆内存数组");
+
+	// 非平凡类型走逐个移动
+	TInlineArray<CA, 2> Strings;
+	Strings.Push(CA("AAAAAA"));
+	Strings.Push(CA("BBBBBB"));
+	Strings.InsertAt(0, CA("CCCCCC"));
+	Strings.Push(Strings[0]);			// 扩容时引用自身元素
+	TEST_ASSERT(Strings.Size() == 4 && Strings[0].Str == "CCCCCC" && Strings[3].Str == "CCCCCC", "非平凡类型插入与扩容");
+
+	TInlineArray<CA, 2> Copy(Strings);
+	Copy.RemoveSwap(0);
+	TEST_ASSERT(Copy.Size() == 3 && Copy[0].Str == "CCCCCC" && Strings[0].Str == "CCCCCC", "拷贝后互不影响");
+
+	TInlineArray<FString, 2> InlineNames{ "Diffuse", "Normal" };
+	TInlineArray<FString, 2> MovedNames(std::move(InlineNames));
+	TEST_ASSERT(MovedNames.Size() == 2 && MovedNames[1] == "Normal" && InlineNames.IsEmpty(), "移动内联数组");
+
+	return true;
+}
+
+static bool TestSlotMapStrings() {
+	cout << "\n=== 测试 TSlotMap ===" << endl;
+
+	TSlotMap<FString> Names;
+	FSlotHandle A = Names.Insert("Diffuse");
+	FSlotHandle B = Names.Insert("Normal");
+	FSlotHandle C = Names.Insert("Specular");
+	TEST_ASSERT(Names.Size() == 3 && A.ToUInt64() == 0 && *Names.Get(B) == "Normal", "插入后按句柄取回");
+
+	// 删除中间元素，最后一个元素被搬到空位，句柄不受影响
+	TEST_ASSERT(Names.Erase(A) && !Names.Erase(A), "重复删除失败");
+	TEST_ASSERT(Names.Get(A) == nullptr && *Names.Get(C) == "Specular" && Names.Size() == 2, "删除后其他句柄仍然有效");
+
+	// 复用槽位后代数不同，旧句柄失效
+	FSlotHandle D = Names.Insert("Roughness");
+	TEST_ASSERT(D.Index == A.Index && D.Generation != A.Generation, "复用空闲槽位");
+	TEST_ASSERT(Names.Get(A) == nullptr && *Names.Get(D) == "Roughness", "旧句柄检测为失效");
+	TEST_ASSERT(FSlotHandle::FromUInt64(D.ToUInt64()) == D && !FSlotHandle().IsValid() && FSlotHandle().ToUInt64() == INVALID_ID_U64, "句柄打包");
+
+	size_t Count = 0;
+	for (size_t i = 0; i < Names.Size(); ++i) {
+		Count += Names.Get(Names.GetHandle(i)) == &Names.Data()[i] ? 1 : 0;
+	}
+	TEST_ASSERT(Count == 3, "紧密遍历并取回句柄");
+
+	Names.Clear();
+	TEST_ASSERT(Names.IsEmpty() && !Names.Contains(B) && !Names.Contains(D), "清空后句柄全部失效");
+
+	return true;
+}
+
 void TestArray(){
 	TArray<TArray<CA>> Arr1;
 	Arr1.Push(T());
@@ -103,4 +211,9 @@ void TestArray(){
 			cout << b->Str << endl;
 		}
 	}
+
+	bool AllPassed = TestArrayBulk();
+	AllPassed &= TestInlineArray();
+	AllPassed &= TestSlotMapStrings();
+	cout << (AllPassed ? "TArray 测试通过!" : "TArray 测试失败!") << endl;
 }
\ No newline at end of file
@@ -55,9 +55,10 @@ public:
 	}
 
 	void AnalyzeFragmentation() {
-		// 这里需要访问Freelist的内部状态，可能需要在Freelist中添加分析接口
 		std::cout << "\n[ANALYSIS] 碎片化分析:" << std::endl;
-		std::cout << "   (需要在Freelist中添加GetBlockCount()等分析接口)" << std::endl;
+		std::cout << "   最大空闲块: " << FormatBytes(allocator->GetLargestFreeBlock()) << std::endl;
+		std::cout << "   碎片化程度: " << std::fixed << std::setprecision(1)
+			<< allocator->GetFragmentation() * 100.0f << "%" << std::endl;
 
 		// 示例分析 - 尝试分配不同大小来检测碎片化
 		std::vector<size_t> test_sizes = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
@@ -0,0 +1,93 @@
+﻿#include <Core/DMemory.hpp>
+
+#include <cstring>
+#include <iostream>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define ZEROED_TEST_DIRTY 0xEE			// 释放前写入的脏数据
+
+namespace ZeroedAllocationTest {
+	// 线程缓存内的小块、普通块和跨过多个提交粒度的大块
+	static const size_t Sizes[] = { 24, 256, 4000, KIBIBYTES(200), MEBIBYTES(3) };
+
+	static bool IsZero(const void* block, size_t size) {
+		const uint8_t* Bytes = static_cast<const uint8_t*>(block);
+		for (size_t i = 0; i < size; ++i) {
+			if (Bytes[i] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool TestReusedBlocks() {
+		std::cout << "\n=== 测试复用的块清零 ===" << std::endl;
+
+		bool Zeroed = true;
+		bool Reused = true;
+		for (size_t Size : Sizes) {
+			void* Dirty = Memory::AllocateUninitialized(Size, MemoryType::eMemory_Type_Array);
+			if (Dirty == nullptr) {
+				Zeroed = false;
+				continue;
+			}
+			memset(Dirty, ZEROED_TEST_DIRTY, Size);
+			Memory::Free(Dirty, MemoryType::eMemory_Type_Array);
+
+			// 刚释放的同样大小的块会被立即复用，里面还是脏数据
+			void* Block = Memory::AllocateZeroed(Size, MemoryType::eMemory_Type_Array);
+			Reused &= Block == Dirty;
+			Zeroed &= Block != nullptr && IsZero(Block, Size);
+			Memory::Free(Block, MemoryType::eMemory_Type_Array);
+
+			Dirty = Memory::AllocateUninitialized(Size, MemoryType::eMemory_Type_Array);
+			memset(Dirty, ZEROED_TEST_DIRTY, Size);
+			Memory::Free(Dirty, MemoryType::eMemory_Type_Array);
+			Block = Memory::Allocate(Size, MemoryType::eMemory_Type_Array);
+			Zeroed &= Block != nullptr && IsZero(Block, Size);
+			Memory::Free(Block, MemoryType::eMemory_Type_Array);
+		}
+		TEST_ASSERT(Reused, "释放的块被下一次分配复用");
+		TEST_ASSERT(Zeroed, "AllocateZeroed 和 Allocate 返回的复用块全为零");
+		return true;
+	}
+
+	static bool TestReusedAlignedBlocks() {
+		std::cout << "\n=== 测试复用的对齐块清零 ===" << std::endl;
+
+		bool Zeroed = true;
+		for (size_t Size : Sizes) {
+			for (size_t Alignment = 16; Alignment <= 256; Alignment <<= 2) {
+				void* Dirty = Memory::AllocateUninitializedAligned(Size, Alignment, MemoryType::eMemory_Type_Array);
+				if (Dirty == nullptr || ((size_t)Dirty & (Alignment - 1)) != 0) {
+					Zeroed = false;
+					continue;
+				}
+				memset(Dirty, ZEROED_TEST_DIRTY, Size);
+				Memory::FreeAligned(Dirty, Size, MemoryType::eMemory_Type_Array);
+
+				void* Block = Memory::AllocateAligned(Size, Alignment, MemoryType::eMemory_Type_Array);
+				Zeroed &= Block != nullptr && ((size_t)Block & (Alignment - 1)) == 0 && IsZero(Block, Size);
+				Memory::FreeAligned(Block, Size, MemoryType::eMemory_Type_Array);
+			}
+		}
+		TEST_ASSERT(Zeroed, "AllocateAligned 返回的复用块对齐且全为零");
+		return true;
+	}
+}
+
+void TestAllocateZeroed() {
+	bool AllPassed = ZeroedAllocationTest::TestReusedBlocks();
+	AllPassed &= ZeroedAllocationTest::TestReusedAlignedBlocks();
+	std::cout << (AllPassed ? "清零分配测试通过!" : "清零分配测试失败!") << std::endl;
+}
@@ -0,0 +1,92 @@
+﻿#include <Core/DMemory.hpp>
+#include <Memory/DynamicAllocator.h>
+
+#include <cstring>
+#include <iostream>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define DYNAMIC_ALLOCATOR_TEST_CHUNK_SIZE MEBIBYTES(8)		// 测试分配器第一个区块的大小
+#define DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE MEBIBYTES(3)		// 跨过多个提交粒度的大块
+
+namespace DynamicAllocatorTest {
+	// 普通页，粒度固定为 DYNAMIC_ALLOCATOR_COMMIT_GRANULE
+	static const size_t Granule = DYNAMIC_ALLOCATOR_COMMIT_GRANULE;
+
+	static bool TestLazyCommit(DynamicAllocator& allocator) {
+		std::cout << "\n=== 测试按需提交与释放归还 ===" << std::endl;
+
+		TEST_ASSERT(allocator.GetCommittedSpace() == 0, "预留后尚未提交任何页");
+
+		void* Small = allocator.Allocate(100);
+		const size_t CommittedSmall = allocator.GetCommittedSpace();
+		TEST_ASSERT(Small != nullptr && CommittedSmall > 0 && CommittedSmall <= 2 * Granule, "小块只提交所在的粒度");
+
+		// 写满整个块，任何一页没有提交都会访问出错
+		void* Large = allocator.Allocate(DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE);
+		TEST_ASSERT(Large != nullptr, "分配跨粒度的大块");
+		memset(Large, 0xA5, DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE);
+		const size_t CommittedLarge = allocator.GetCommittedSpace();
+		TEST_ASSERT(CommittedLarge % Granule == 0 && CommittedLarge >= CommittedSmall + DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE, "大块跨过的粒度全部提交");
+		TEST_ASSERT(CommittedLarge < allocator.GetTotalSpace(), "未分配的部分仍未提交");
+
+		// 空闲区超过阈值的部分归还给系统，开头的阈值大小保留
+		allocator.Free(Large, DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE);
+		const size_t CommittedFreed = allocator.GetCommittedSpace();
+		TEST_ASSERT(CommittedFreed < CommittedLarge && CommittedFreed <= CommittedSmall + DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD + 2 * Granule, "释放后大块的页被归还");
+
+		// 归还过的页可以再次提交
+		Large = allocator.Allocate(DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE);
+		TEST_ASSERT(Large != nullptr, "归还后再次分配");
+		memset(Large, 0x5A, DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE);
+		TEST_ASSERT(allocator.GetCommittedSpace() == CommittedLarge, "再次分配提交同样多的页");
+
+		allocator.Free(Large, DYNAMIC_ALLOCATOR_TEST_LARGE_SIZE);
+		allocator.Free(Small, 100);
+		TEST_ASSERT(allocator.GetFreeSpace() == allocator.GetTotalSpace(), "全部释放后空闲空间复原");
+		return true;
+	}
+
+	static bool TestGrowth(DynamicAllocator& allocator) {
+		std::cout << "\n=== 测试追加区块 ===" << std::endl;
+
+		const size_t Size = DYNAMIC_ALLOCATOR_TEST_CHUNK_SIZE + MEBIBYTES(1);
+		TEST_ASSERT(allocator.Allocate(Size) == nullptr, "不可增长时超出容量的分配失败");
+
+		allocator.SetGrowable(true);
+		const size_t CommittedBefore = allocator.GetCommittedSpace();
+		void* Block = allocator.Allocate(Size);
+		TEST_ASSERT(Block != nullptr && allocator.GetChunkCount() == 2, "可增长时追加一个区块");
+		TEST_ASSERT(allocator.GetTotalSpace() >= DYNAMIC_ALLOCATOR_TEST_CHUNK_SIZE + Size, "总空间包含新区块");
+
+		memset(Block, 0xC3, Size);
+		TEST_ASSERT(allocator.GetCommittedSpace() >= CommittedBefore + Size, "新区块同样按需提交");
+
+		allocator.Free(Block, Size);
+		TEST_ASSERT(allocator.GetCommittedSpace() <= CommittedBefore + DYNAMIC_ALLOCATOR_DECOMMIT_THRESHOLD + Granule, "新区块释放后的页被归还");
+		allocator.SetGrowable(false);
+		return true;
+	}
+}
+
+void TestDynamicAllocator() {
+	// 独立的分配器，不影响全局分配器的统计
+	DynamicAllocator Allocator;
+	if (!Allocator.Resize(DYNAMIC_ALLOCATOR_TEST_CHUNK_SIZE, eHuge_Page_None)) {
+		std::cout << "分配器初始化失败!" << std::endl;
+		return;
+	}
+
+	bool AllPassed = DynamicAllocatorTest::TestLazyCommit(Allocator);
+	AllPassed &= DynamicAllocatorTest::TestGrowth(Allocator);
+	std::cout << (AllPassed ? "动态分配器测试通过!" : "动态分配器测试失败!") << std::endl;
+}
@@ -0,0 +1,153 @@
+﻿#include <Core/DMemory.hpp>
+#include <Memory/FrameAllocator.h>
+
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define FRAME_TEST_ARENA_SIZE KIBIBYTES(64)		// 测试用的每帧容量，溢出测试会超过它
+#define FRAME_TEST_BLOCK_SIZE KIBIBYTES(24)		// 溢出测试每次分配的大小
+
+namespace FrameAllocatorTest {
+	struct Counter {
+		explicit Counter(int value) : Value(value) {}
+		~Counter() { Destroyed++; }
+
+		int Value;
+		static int Destroyed;
+	};
+	int Counter::Destroyed = 0;
+
+	static bool TestFrameReset() {
+		std::cout << "\n=== 测试每帧复位 ===" << std::endl;
+
+		FrameAllocator::BeginFrame();
+		const uint64_t First = FrameAllocator::GetFrameNumber();
+		TEST_ASSERT(FrameAllocator::GetUsedSize() == 0, "新的一帧没有已用空间");
+		void* Block = FrameAllocator::Allocate(128);
+		TEST_ASSERT(Block != nullptr && FrameAllocator::GetUsedSize() >= 128, "分配计入本帧");
+		TEST_ASSERT(FrameAllocator::IsAlive(Block), "本帧的块有效");
+
+		Counter* Object = FrameAllocator::New<Counter>(42);
+		TEST_ASSERT(Object != nullptr && Object->Value == 42, "New 调用构造函数");
+		FrameAllocator::Destroy(Object);
+		TEST_ASSERT(Counter::Destroyed == 1, "Destroy 调用析构函数");
+		FrameAllocator::EndFrame();
+		TEST_ASSERT(!FrameAllocator::IsAlive(Block), "帧结束后块失效");
+
+		// 下一帧用另一块内存，上一帧的数据还在等 GPU 读取
+		FrameAllocator::BeginFrame();
+		TEST_ASSERT(FrameAllocator::GetFrameNumber() == First + 1 && FrameAllocator::GetUsedSize() == 0, "下一帧从空开始");
+		void* Next = FrameAllocator::Allocate(128);
+		TEST_ASSERT(Next != Block, "相邻两帧不共用内存");
+		FrameAllocator::EndFrame();
+
+		// 隔 FRAME_ALLOCATOR_FRAME_COUNT 帧后复用同一块内存
+		for (uint32_t i = 2; i < FRAME_ALLOCATOR_FRAME_COUNT; ++i) {
+			FrameAllocator::BeginFrame();
+			FrameAllocator::EndFrame();
+		}
+		FrameAllocator::BeginFrame();
+		TEST_ASSERT(FrameAllocator::Allocate(128) == Block, "复位后从头复用");
+#if DMEMORY_FRAME_CHECK
+		TEST_ASSERT(FrameAllocator::IsAlive(Block) && FrameAllocator::CheckFrame(FrameAllocator::GetFrameNumber()), "复用的块属于当前帧");
+		TEST_ASSERT(!FrameAllocator::CheckFrame(First), "旧帧号被检查出来");
+#endif
+		FrameAllocator::EndFrame();
+		return true;
+	}
+
+	static bool TestAlignment() {
+		std::cout << "\n=== 测试对齐 ===" << std::endl;
+
+		FrameAllocator::BeginFrame();
+		bool Aligned = true;
+		for (size_t Alignment = 1; Alignment <= 256; Alignment <<= 1) {
+			// 先放一个奇数大小的块，让栈顶错开
+			FrameAllocator::Allocate(3, 1);
+			void* Block = FrameAllocator::Allocate(40, Alignment);
+			Aligned &= Block != nullptr && ((size_t)Block & (Alignment - 1)) == 0;
+		}
+		TEST_ASSERT(Aligned, "1 到 256 字节的对齐都满足");
+
+		FrameAllocator::Allocate(1, 1);
+		double* Values = FrameAllocator::NewArray<double>(16);
+		TEST_ASSERT(Values != nullptr && ((size_t)Values & (alignof(double) - 1)) == 0, "NewArray 按元素类型对齐");
+
+		TFrameVector<uint64_t> Vector;
+		for (uint64_t i = 0; i < 100; ++i) Vector.push_back(i);
+		TEST_ASSERT(Vector.back() == 99 && ((size_t)Vector.data() & (alignof(uint64_t) - 1)) == 0, "TFrameVector 在本帧内扩容");
+		FrameAllocator::EndFrame();
+		return true;
+	}
+
+	static bool TestOverflow() {
+		std::cout << "\n=== 测试容量用尽 ===" << std::endl;
+
+		const uint32_t Count = FRAME_TEST_ARENA_SIZE / FRAME_TEST_BLOCK_SIZE * 3;
+
+		// 超出容量的请求改从溢出块分配，不会失败
+		FrameAllocator::BeginFrame();
+		std::vector<void*> Blocks;
+		for (uint32_t i = 0; i < Count; ++i) {
+			void* Block = FrameAllocator::Allocate(FRAME_TEST_BLOCK_SIZE);
+			if (Block != nullptr) {
+				memset(Block, (int)i, FRAME_TEST_BLOCK_SIZE);
+			}
+			Blocks.push_back(Block);
+		}
+
+		bool Intact = true;
+		for (uint32_t i = 0; i < Count; ++i) {
+			const uint8_t* Bytes = static_cast<const uint8_t*>(Blocks[i]);
+			Intact &= Bytes != nullptr && Bytes[0] == (uint8_t)i && Bytes[FRAME_TEST_BLOCK_SIZE - 1] == (uint8_t)i;
+			Intact &= FrameAllocator::IsAlive(Bytes);
+		}
+		std::set<void*> Unique(Blocks.begin(), Blocks.end());
+		TEST_ASSERT(Intact && Unique.size() == Count, "溢出的块互不重叠且属于本帧");
+		TEST_ASSERT(FrameAllocator::GetUsedSize() >= (size_t)Count * FRAME_TEST_BLOCK_SIZE, "已用空间包含溢出部分");
+		FrameAllocator::EndFrame();
+
+		// 同一块内存复位时扩大，之后同样的用量照常分配
+		for (uint32_t i = 1; i < FRAME_ALLOCATOR_FRAME_COUNT; ++i) {
+			FrameAllocator::BeginFrame();
+			FrameAllocator::EndFrame();
+		}
+		FrameAllocator::BeginFrame();
+		TEST_ASSERT(FrameAllocator::GetUsedSize() == 0, "复位后溢出块被回收");
+		bool Allocated = true;
+		for (uint32_t i = 0; i < Count; ++i) {
+			void* Block = FrameAllocator::Allocate(FRAME_TEST_BLOCK_SIZE);
+			Allocated &= Block != nullptr && FrameAllocator::IsAlive(Block);
+		}
+		TEST_ASSERT(Allocated, "复位后同样的用量照常分配");
+		FrameAllocator::EndFrame();
+		return true;
+	}
+}
+
+void TestFrameAllocator() {
+	if (!FrameAllocator::Initialize(FRAME_TEST_ARENA_SIZE)) {
+		std::cout << "帧分配器初始化失败!" << std::endl;
+		return;
+	}
+
+	bool AllPassed = FrameAllocatorTest::TestFrameReset();
+	AllPassed &= FrameAllocatorTest::TestAlignment();
+	AllPassed &= FrameAllocatorTest::TestOverflow();
+	std::cout << (AllPassed ? "帧分配器测试通过!" : "帧分配器测试失败!") << std::endl;
+
+	FrameAllocator::Shutdown();
+}
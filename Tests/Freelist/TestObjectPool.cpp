@@ -0,0 +1,108 @@
+﻿#include <Core/DMemory.hpp>
+#include <Memory/ObjectPool.h>
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define OBJECT_POOL_TEST_SLOT_SIZE 48		// 测试池的槽大小
+
+namespace ObjectPoolTest {
+	// 池注册后一直存在，和 DECLARE_OBJECT_POOL 一样放在静态存储里
+	static ObjectPool& GetTestPool() {
+		static ObjectPool Pool("ObjectPoolTest", OBJECT_POOL_TEST_SLOT_SIZE, 8);
+		return Pool;
+	}
+
+	static bool TestReuseOrder() {
+		std::cout << "\n=== 测试槽的复用顺序 ===" << std::endl;
+
+		ObjectPool& Pool = GetTestPool();
+		void* A = Pool.Allocate();
+		void* B = Pool.Allocate();
+		TEST_ASSERT(A != nullptr && B != nullptr && A != B && ObjectPool::FindOwner(A) == &Pool, "分配的槽属于该池");
+
+		// 线程缓存是栈，最后释放的槽最先被复用
+		Pool.Free(A);
+		Pool.Free(B);
+		void* C = Pool.Allocate();
+		void* D = Pool.Allocate();
+		TEST_ASSERT(C == B && D == A, "后释放的槽先复用");
+
+		bool Zeroed = true;
+		for (size_t i = 0; i < OBJECT_POOL_TEST_SLOT_SIZE; ++i) Zeroed &= static_cast<uint8_t*>(C)[i] == 0;
+		TEST_ASSERT(Zeroed, "复用的槽已清零");
+
+		Pool.Free(C);
+		Pool.Free(D);
+		return true;
+	}
+
+	static bool TestGrowth() {
+		std::cout << "\n=== 测试超过一个 slab 的增长 ===" << std::endl;
+
+		ObjectPool& Pool = GetTestPool();
+		const size_t LiveBefore = Pool.GetLiveCount();
+		const size_t Count = OBJECT_POOL_SLAB_SIZE / Pool.GetSlotSize() * 3;
+
+		std::vector<void*> Blocks;
+		for (size_t i = 0; i < Count; ++i) {
+			Blocks.push_back(Pool.Allocate());
+		}
+
+		bool Owned = true;
+		for (void* Block : Blocks) Owned &= Block != nullptr && ObjectPool::FindOwner(Block) == &Pool;
+		std::set<void*> Unique(Blocks.begin(), Blocks.end());
+		TEST_ASSERT(Owned && Unique.size() == Count, "每个槽互不相同且能查到所属池");
+		TEST_ASSERT(Pool.GetSlabCount() >= 3 && Pool.GetLiveCount() == LiveBefore + Count, "池增长到多个 slab");
+
+		for (void* Block : Blocks) {
+			Pool.Free(Block);
+		}
+		TEST_ASSERT(Pool.GetLiveCount() == LiveBefore, "全部释放后存活数复原");
+
+		int Local = 0;
+		TEST_ASSERT(ObjectPool::FindOwner(&Local) == nullptr, "非池内指针查不到所属池");
+		return true;
+	}
+
+	static bool TestDoubleFree() {
+		std::cout << "\n=== 测试重复释放检测 ===" << std::endl;
+
+#if DMEMORY_OBJECT_POOL_CHECKS
+		ObjectPool& Pool = GetTestPool();
+		void* Block = Pool.Allocate();
+		const size_t Live = Pool.GetLiveCount();
+		TEST_ASSERT(Pool.Free(Block), "第一次释放成功");
+		TEST_ASSERT(!Pool.Free(Block) && Pool.GetLiveCount() == Live - 1, "重复释放被拒绝且不改变计数");
+
+		// 空闲链表没有被破坏，同一个槽不会被分配两次
+		void* A = Pool.Allocate();
+		void* B = Pool.Allocate();
+		TEST_ASSERT(A == Block && B != Block, "重复释放后槽只被复用一次");
+		Pool.Free(A);
+		Pool.Free(B);
+#else
+		std::cout << "DMEMORY_OBJECT_POOL_CHECKS 未开启，跳过" << std::endl;
+#endif
+		return true;
+	}
+}
+
+void TestObjectPool() {
+	bool AllPassed = ObjectPoolTest::TestReuseOrder();
+	AllPassed &= ObjectPoolTest::TestGrowth();
+	AllPassed &= ObjectPoolTest::TestDoubleFree();
+	std::cout << (AllPassed ? "对象池测试通过!" : "对象池测试失败!") << std::endl;
+}
@@ -0,0 +1,124 @@
+﻿#include <Core/DMemory.hpp>
+#include <Memory/ScratchAllocator.h>
+
+#include <cstring>
+#include <iostream>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define SCRATCH_TEST_LARGE_SIZE MEBIBYTES(16)		// 超过保留大小的一次性分配
+#define SCRATCH_TEST_VECTOR_COUNT 100000			// TScratchVector 压入的元素个数，需要多次扩容
+
+namespace ScratchAllocatorTest {
+	static bool TestNestedScopes() {
+		std::cout << "\n=== 测试嵌套作用域回退 ===" << std::endl;
+
+		const size_t Base = ScratchAllocator::GetUsedSize();
+		{
+			ScratchScope Outer;
+			uint32_t* A = ScratchAllocator::NewArray<uint32_t>(64);
+			TEST_ASSERT(A != nullptr && ((size_t)A & (alignof(uint32_t) - 1)) == 0, "外层分配按类型对齐");
+			const size_t OuterUsed = ScratchAllocator::GetUsedSize();
+
+			void* First = nullptr;
+			{
+				ScratchScope Inner;
+				First = ScratchAllocator::Allocate(1000, 64);
+				void* Second = ScratchAllocator::Allocate(1000);
+				TEST_ASSERT(First != nullptr && ((size_t)First & 63) == 0 && Second > First, "内层分配依次向上");
+			}
+			TEST_ASSERT(ScratchAllocator::GetUsedSize() == OuterUsed, "内层结束回到外层的栈顶");
+
+			// 内层释放的空间被下一次分配复用，外层的数据不受影响
+			A[63] = 0x12345678;
+			{
+				ScratchScope Inner;
+				TEST_ASSERT(ScratchAllocator::Allocate(1000, 64) == First, "内层释放的空间被复用");
+			}
+			TEST_ASSERT(A[63] == 0x12345678, "外层的块不被内层覆盖");
+
+			// 只有最顶上的块能单独释放
+			void* Top = ScratchAllocator::Allocate(256);
+			ScratchAllocator::Free(A, sizeof(uint32_t) * 64);
+			TEST_ASSERT(ScratchAllocator::GetUsedSize() > OuterUsed, "非栈顶的块留到作用域结束");
+			ScratchAllocator::Free(Top, 256);
+			TEST_ASSERT(ScratchAllocator::GetUsedSize() == OuterUsed, "栈顶的块立即释放");
+		}
+		TEST_ASSERT(ScratchAllocator::GetUsedSize() == Base, "外层结束回到初始栈顶");
+		return true;
+	}
+
+	static bool TestRetainSize() {
+		std::cout << "\n=== 测试最外层作用域结束后归还内存 ===" << std::endl;
+
+		{
+			ScratchScope Outer;
+			{
+				ScratchScope Inner;
+				void* Large = ScratchAllocator::Allocate(SCRATCH_TEST_LARGE_SIZE);
+				TEST_ASSERT(Large != nullptr, "分配超过保留大小的块");
+				memset(Large, 0x3C, SCRATCH_TEST_LARGE_SIZE);
+				TEST_ASSERT(ScratchAllocator::GetCommittedSize() >= SCRATCH_TEST_LARGE_SIZE, "按需提交整个块");
+				TEST_ASSERT(ScratchAllocator::GetPeakSize() >= SCRATCH_TEST_LARGE_SIZE, "峰值包含大块");
+			}
+			TEST_ASSERT(ScratchAllocator::GetCommittedSize() >= SCRATCH_TEST_LARGE_SIZE, "内层结束时不归还");
+		}
+		TEST_ASSERT(ScratchAllocator::GetCommittedSize() == SCRATCH_ALLOCATOR_RETAIN_SIZE, "最外层结束后只保留 4 MiB");
+
+		// 归还过的部分可以再次提交
+		{
+			ScratchScope Outer;
+			void* Large = ScratchAllocator::Allocate(SCRATCH_TEST_LARGE_SIZE);
+			TEST_ASSERT(Large != nullptr, "归还后再次分配大块");
+			memset(Large, 0xC3, SCRATCH_TEST_LARGE_SIZE);
+		}
+		TEST_ASSERT(ScratchAllocator::GetCommittedSize() == SCRATCH_ALLOCATOR_RETAIN_SIZE, "再次结束后仍只保留 4 MiB");
+		return true;
+	}
+
+	static bool TestVectorGrowth() {
+		std::cout << "\n=== 测试 TScratchVector 扩容 ===" << std::endl;
+
+		const size_t Base = ScratchAllocator::GetUsedSize();
+		{
+			ScratchScope Scope;
+			TScratchVector<uint32_t> Values;
+			for (uint32_t i = 0; i < SCRATCH_TEST_VECTOR_COUNT; ++i) {
+				Values.push_back(i * 3);
+			}
+
+			bool Kept = Values.size() == SCRATCH_TEST_VECTOR_COUNT;
+			for (uint32_t i = 0; Kept && i < SCRATCH_TEST_VECTOR_COUNT; ++i) Kept &= Values[i] == i * 3;
+			TEST_ASSERT(Kept, "多次扩容后元素保持不变");
+			TEST_ASSERT(ScratchAllocator::GetUsedSize() >= Base + sizeof(uint32_t) * SCRATCH_TEST_VECTOR_COUNT, "元素放在暂存栈上");
+
+			// reserve 后填充只占一块，释放时就在栈顶
+			const size_t Before = ScratchAllocator::GetUsedSize();
+			{
+				TScratchVector<uint32_t> Reserved;
+				Reserved.reserve(1024);
+				for (uint32_t i = 0; i < 1024; ++i) Reserved.push_back(i);
+				TEST_ASSERT(Reserved.back() == 1023, "预留后填充");
+			}
+			TEST_ASSERT(ScratchAllocator::GetUsedSize() == Before, "栈顶的容器析构时立即归还");
+		}
+		TEST_ASSERT(ScratchAllocator::GetUsedSize() == Base, "作用域结束释放扩容留下的旧块");
+		return true;
+	}
+}
+
+void TestScratchAllocator() {
+	bool AllPassed = ScratchAllocatorTest::TestNestedScopes();
+	AllPassed &= ScratchAllocatorTest::TestRetainSize();
+	AllPassed &= ScratchAllocatorTest::TestVectorGrowth();
+	std::cout << (AllPassed ? "暂存分配器测试通过!" : "暂存分配器测试失败!") << std::endl;
+}
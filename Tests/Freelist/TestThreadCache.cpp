@@ -0,0 +1,119 @@
+﻿#include <Core/DMemory.hpp>
+#include <Memory/DynamicAllocator.h>
+#include <Memory/ThreadCache.h>
+
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define THREAD_CACHE_TEST_THREADS 4			// 分配线程数
+#define THREAD_CACHE_TEST_BLOCKS (THREAD_CACHE_MAGAZINE_SIZE * 2 + 1)	// 每个尺寸等级分配的块数，跨过补充与回收的边界
+
+namespace ThreadCacheTest {
+	static const size_t Sizes[] = { 8, 16, 24, 100, 256, 700, THREAD_CACHE_MAX_SIZE };
+
+	// 交还所有缓存的块后 DynamicAllocator 的空闲空间
+	static size_t SettledFreeSpace() {
+		ThreadCache::Release();
+		return DynamicAllocator::Get().GetFreeSpace();
+	}
+
+	// 每个块写满自己的编号，释放前检查没有被别的块覆盖
+	static void AllocateBlocks(std::vector<void*>& out_blocks, uint8_t tag) {
+		for (size_t Size : Sizes) {
+			for (uint32_t i = 0; i < THREAD_CACHE_TEST_BLOCKS; ++i) {
+				void* Block = Memory::Allocate(Size, MemoryType::eMemory_Type_Array);
+				if (Block != nullptr) {
+					memset(Block, tag, Size);
+				}
+				out_blocks.push_back(Block);
+			}
+		}
+	}
+
+	static bool CheckBlocks(const std::vector<void*>& blocks, uint8_t tag) {
+		size_t Index = 0;
+		for (size_t Size : Sizes) {
+			for (uint32_t i = 0; i < THREAD_CACHE_TEST_BLOCKS; ++i, ++Index) {
+				const uint8_t* Bytes = static_cast<const uint8_t*>(blocks[Index]);
+				if (Bytes == nullptr || Bytes[0] != tag || Bytes[Size - 1] != tag) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	static bool TestMagazineBoundaries() {
+		std::cout << "\n=== 测试补充与回收边界 ===" << std::endl;
+
+		const size_t FreeBefore = SettledFreeSpace();
+
+		std::vector<void*> Blocks;
+		AllocateBlocks(Blocks, 0x5A);
+		std::set<void*> Unique(Blocks.begin(), Blocks.end());
+		TEST_ASSERT(Unique.size() == Blocks.size() && CheckBlocks(Blocks, 0x5A), "多次补充后的块互不重叠");
+
+		for (void* Block : Blocks) {
+			Memory::Free(Block, MemoryType::eMemory_Type_Array);
+		}
+		TEST_ASSERT(SettledFreeSpace() == FreeBefore, "释放并交还后空闲空间复原");
+
+		return true;
+	}
+
+	static bool TestCrossThreadFree() {
+		std::cout << "\n=== 测试跨线程释放与线程退出 ===" << std::endl;
+
+		const size_t FreeBefore = SettledFreeSpace();
+
+		// 分配线程退出时弹匣里还剩补充多出来的块，需要在线程退出时交还
+		std::vector<std::vector<void*>> Blocks(THREAD_CACHE_TEST_THREADS);
+		std::vector<std::thread> Threads;
+		for (uint32_t t = 0; t < THREAD_CACHE_TEST_THREADS; ++t) {
+			Threads.emplace_back([&Blocks, t]() { AllocateBlocks(Blocks[t], (uint8_t)(t + 1)); });
+		}
+		for (std::thread& Thread : Threads) {
+			Thread.join();
+		}
+
+		bool Intact = true;
+		for (uint32_t t = 0; t < THREAD_CACHE_TEST_THREADS; ++t) {
+			Intact &= CheckBlocks(Blocks[t], (uint8_t)(t + 1));
+		}
+		TEST_ASSERT(Intact, "各线程分配的块互不覆盖");
+
+		// 全部交给另一个线程释放，它的弹匣同样在退出时交还
+		std::thread Freer([&Blocks]() {
+			for (const std::vector<void*>& ThreadBlocks : Blocks) {
+				for (void* Block : ThreadBlocks) {
+					Memory::Free(Block, MemoryType::eMemory_Type_Array);
+				}
+			}
+		});
+		Freer.join();
+
+		TEST_ASSERT(SettledFreeSpace() == FreeBefore, "跨线程释放且线程退出后空闲空间复原");
+
+		return true;
+	}
+}
+
+void TestThreadCache() {
+	bool AllPassed = ThreadCacheTest::TestMagazineBoundaries();
+	AllPassed &= ThreadCacheTest::TestCrossThreadFree();
+	std::cout << (AllPassed ? "线程缓存测试通过!" : "线程缓存测试失败!") << std::endl;
+}
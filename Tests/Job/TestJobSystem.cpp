@@ -0,0 +1,292 @@
+﻿#include <Systems/JobSystem.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define JOB_TEST_FAN_OUT 256				// 每轮扇出的子任务个数
+
+namespace JobTest {
+	static bool TestHandles() {
+		std::cout << "\n=== 测试任务句柄与 Wait ===" << std::endl;
+
+		TEST_ASSERT(JobSystem::IsComplete(JobHandle()), "无效句柄视为已完成");
+
+		std::atomic<int> Value{ 0 };
+		JobInfo Job;
+		Job.entry = [&Value]() { Value.store(42); return true; };
+		JobHandle Handle = JobSystem::Submit(Job);
+		TEST_ASSERT(Handle.IsValid(), "Submit 返回有效句柄");
+		JobSystem::Wait(Handle);
+		TEST_ASSERT(JobSystem::IsComplete(Handle) && Value.load() == 42, "Wait 返回时任务已执行");
+
+		// 任务内部扇出子任务并等待，工作线程在等待时执行子任务
+		std::atomic<int> Children{ 0 };
+		JobInfo Parent;
+		Parent.entry = [&Children]() {
+			JobCounter Counter;
+			for (int i = 0; i < JOB_TEST_FAN_OUT; ++i) {
+				JobInfo Child;
+				Child.entry = [&Children]() { Children.fetch_add(1); return true; };
+				Child.signal_counter = &Counter;
+				JobSystem::Submit(Child);
+			}
+			JobSystem::Wait(Counter);
+			return Children.load() == JOB_TEST_FAN_OUT;
+		};
+		JobSystem::Wait(JobSystem::Submit(Parent));
+		TEST_ASSERT(Children.load() == JOB_TEST_FAN_OUT, "工作线程内等待子任务不死锁");
+
+		return true;
+	}
+
+	static bool TestDependencies() {
+		std::cout << "\n=== 测试任务依赖 ===" << std::endl;
+
+		// 第二批任务依赖第一批全部完成，读到的一定是最终值
+		std::atomic<int> Produced{ 0 };
+		std::atomic<int> WrongOrder{ 0 };
+		std::vector<JobHandle> Producers;
+		for (int i = 0; i < JOB_TEST_FAN_OUT; ++i) {
+			JobInfo Producer;
+			Producer.entry = [&Produced]() { Produced.fetch_add(1); return true; };
+			Producers.push_back(JobSystem::Submit(Producer));
+		}
+
+		JobCounter Consumers;
+		for (int i = 0; i < JOB_TEST_FAN_OUT; ++i) {
+			JobInfo Consumer;
+			Consumer.entry = [&]() {
+				if (Produced.load() != JOB_TEST_FAN_OUT) WrongOrder.fetch_add(1);
+				return true;
+			};
+			Consumer.dependencies = Producers.data();
+			Consumer.dependency_count = (uint32_t)Producers.size();
+			Consumer.signal_counter = &Consumers;
+			JobSystem::Submit(Consumer);
+		}
+		JobSystem::Wait(Consumers);
+		TEST_ASSERT(WrongOrder.load() == 0, "依赖全部完成后才开始执行");
+
+		// 等待计数器：计数器归零前不会开始
+		JobCounter Gate;
+		std::atomic<int> Stage{ 0 };
+		std::atomic<bool> Release{ false };
+		JobInfo Blocker;
+		Blocker.entry = [&]() { while (!Release.load()) {} Stage.store(1); return true; };
+		Blocker.signal_counter = &Gate;
+		JobSystem::Submit(Blocker);
+
+		std::atomic<int> Observed{ -1 };
+		JobInfo Follower;
+		Follower.entry = [&]() { Observed.store(Stage.load()); return true; };
+		Follower.wait_counter = &Gate;
+		JobHandle FollowerHandle = JobSystem::Submit(Follower);
+		TEST_ASSERT(!JobSystem::IsComplete(FollowerHandle), "计数器未归零时任务不执行");
+		Release.store(true);
+		JobSystem::Wait(FollowerHandle);
+		TEST_ASSERT(Observed.load() == 1, "计数器归零后任务执行");
+
+		return true;
+	}
+
+	static bool TestCallbacks() {
+		std::cout << "\n=== 测试任务闭包与完成回调 ===" << std::endl;
+
+		// 小闭包存放在对象内部，大闭包放进内存池，两者拷贝后都能正常调用
+		int Small = 0;
+		TJobFunction<void()> SmallFunction = [&Small]() { Small++; };
+		struct LargeCapture { char Bytes[JOB_FUNCTION_INLINE_SIZE * 2]; };
+		LargeCapture Large{};
+		Large.Bytes[sizeof(Large.Bytes) - 1] = 7;
+		TJobFunction<bool()> LargeFunction = [Large]() { return Large.Bytes[sizeof(Large.Bytes) - 1] == 7; };
+		TJobFunction<bool()> LargeCopy = LargeFunction;
+		SmallFunction();
+		TEST_ASSERT(SmallFunction.IsInline() && Small == 1, "小闭包内联存放");
+		TEST_ASSERT(!LargeCopy.IsInline() && LargeCopy() && LargeFunction(), "大闭包放入内存池并可拷贝");
+
+		// 计数器归零时回调都已进入完成队列，下一次 Update 全部执行
+		std::atomic<int> Succeeded{ 0 };
+		std::atomic<int> Failed{ 0 };
+		JobCounter Counter;
+		for (int i = 0; i < JOB_TEST_FAN_OUT; ++i) {
+			JobInfo Job;
+			Job.entry = [i]() { return (i & 1) == 0; };
+			Job.on_success = [&Succeeded]() { Succeeded.fetch_add(1); };
+			Job.on_failed = [&Failed]() { Failed.fetch_add(1); };
+			Job.signal_counter = &Counter;
+			JobSystem::Submit(std::move(Job));
+		}
+		JobSystem::Wait(Counter);
+		JobSystem::Update();
+		TEST_ASSERT(Succeeded.load() == JOB_TEST_FAN_OUT / 2 && Failed.load() == JOB_TEST_FAN_OUT / 2, "Update 执行所有完成回调");
+
+		// 预算用完后剩下的回调留到下一次 Update，高优先级的先执行
+		std::vector<int> Order;
+		JobCounter BudgetCounter;
+		for (int i = 0; i < 8; ++i) {
+			JobInfo Job;
+			Job.entry = []() { return true; };
+			Job.on_success = [&Order, i]() { Order.push_back(i); };
+			Job.callback_priority = i == 7 ? JobPriority::eHigh : JobPriority::eLow;
+			Job.signal_counter = &BudgetCounter;
+			JobSystem::Submit(std::move(Job));
+		}
+		JobSystem::Wait(BudgetCounter);
+		JobSystem::Update(0.000001);
+		JobSystemStats Stats;
+		JobSystem::GetStats(Stats);
+		TEST_ASSERT(Order.size() == 1 && Order[0] == 7 && Stats.callback_backlog == 7, "预算用完后保留积压，高优先级先执行");
+		JobSystem::Update();
+		JobSystem::GetStats(Stats);
+		TEST_ASSERT(Order.size() == 8 && Stats.callback_backlog == 0, "下一次 Update 执行剩下的回调");
+
+		return true;
+	}
+
+	static bool TestInstrumentation() {
+		std::cout << "\n=== 测试统计与跟踪导出 ===" << std::endl;
+
+		JobSystemStats Stats;
+		JobSystem::GetStats(Stats);
+
+		uint64_t Start = JobSystem::GetTraceTime();
+		JobCounter Counter;
+		for (int i = 0; i < JOB_TEST_FAN_OUT; ++i) {
+			JobInfo Job;
+			Job.name = "TraceTestJob";
+			Job.entry = []() { return true; };
+			Job.signal_counter = &Counter;
+			JobSystem::Submit(std::move(Job));
+		}
+		JobSystem::Wait(Counter);
+
+		// 任务可能全被等待的主线程执行，这里只检查计数器的形状
+		JobSystem::GetStats(Stats);
+		bool ValidUtilization = true;
+		for (const JobWorkerStats& Worker : Stats.workers) ValidUtilization &= Worker.utilization >= 0.0f && Worker.utilization <= 1.0f;
+		TEST_ASSERT(Stats.workers.size() == 4 && ValidUtilization, "GetStats 返回每个工作线程的计数");
+
+#if DJOB_TRACE
+		const char* Path = "job_trace_test.json";
+		TEST_ASSERT(JobSystem::DumpTrace(Path, Start, JobSystem::GetTraceTime()), "DumpTrace 写出文件");
+		std::ifstream File(Path);
+		std::stringstream Content;
+		Content << File.rdbuf();
+		File.close();
+		std::remove(Path);
+		TEST_ASSERT(Content.str().find("\"traceEvents\"") != std::string::npos && Content.str().find("TraceTestJob") != std::string::npos,
+			"导出的跟踪包含任务名");
+#endif
+
+		return true;
+	}
+
+	static bool TestParallel() {
+		std::cout << "\n=== 测试 ParallelFor / ParallelReduce ===" << std::endl;
+
+		const size_t Count = 100000;
+		std::vector<uint32_t> Values(Count, 0);
+		JobSystem::ParallelFor(0, Count, 256, [&Values](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) Values[i] += (uint32_t)i;
+		});
+		bool Filled = true;
+		for (size_t i = 0; i < Count; ++i) Filled &= Values[i] == (uint32_t)i;
+		TEST_ASSERT(Filled, "ParallelFor 每个下标恰好执行一次");
+
+		uint64_t Sum = JobSystem::ParallelReduce(0, Count, 256, (uint64_t)0,
+			[&Values](size_t begin, size_t end) {
+				uint64_t Partial = 0;
+				for (size_t i = begin; i < end; ++i) Partial += Values[i];
+				return Partial;
+			},
+			[](uint64_t a, uint64_t b) { return a + b; });
+		TEST_ASSERT(Sum == (uint64_t)Count * (Count - 1) / 2, "ParallelReduce 求和正确");
+
+		// 少于一个粒度时在调用线程上直接执行
+		int Calls = 0;
+		JobSystem::ParallelFor(0, 10, 64, [&Calls](size_t begin, size_t end) { Calls += (begin == 0 && end == 10); });
+		TEST_ASSERT(Calls == 1, "小范围串行执行");
+
+		// 调用线程上抛出异常时，异常传出前帮手已经全部退出。
+		// 帮手等调用线程领到块后才开始，帮手最多 chunk_count - 1 个，调用线程一定能领到
+		const std::thread::id Caller = std::this_thread::get_id();
+		std::atomic<bool> CallerStarted{ false };
+		std::atomic<int> Running{ 0 };
+		std::atomic<int> Overlapped{ 0 };
+		bool Caught = false;
+		try {
+			JobSystem::ParallelFor(0, Count, 256, [&](size_t, size_t) {
+				if (std::this_thread::get_id() == Caller) {
+					CallerStarted.store(true);
+					throw std::runtime_error("ParallelFor body");
+				}
+				while (!CallerStarted.load()) std::this_thread::yield();
+				Running.fetch_add(1);
+				for (volatile int Spin = 0; Spin < 1000; ++Spin) {}
+				Running.fetch_sub(1);
+			});
+		}
+		catch (const std::runtime_error&) {
+			Caught = true;
+			Overlapped.store(Running.load());
+		}
+		TEST_ASSERT(Caught && Overlapped.load() == 0, "异常传出前帮手已退出");
+
+		// 帮手里抛出的异常在调用线程重新抛出，之后不再领新块。
+		// 调用线程停在第一块里等帮手抛出，保证帮手一定能领到块
+		std::atomic<bool> HelperThrew{ false };
+		std::atomic<size_t> Processed{ 0 };
+		Caught = false;
+		try {
+			JobSystem::ParallelFor(0, Count, 256, [&](size_t begin, size_t end) {
+				if (std::this_thread::get_id() != Caller) {
+					HelperThrew.store(true);
+					throw std::runtime_error("ParallelFor helper");
+				}
+				while (!HelperThrew.load()) std::this_thread::yield();
+				Processed.fetch_add(end - begin);
+			});
+		}
+		catch (const std::runtime_error&) {
+			Caught = true;
+		}
+		TEST_ASSERT(Caught, "帮手抛出的异常传给调用者");
+		TEST_ASSERT(Processed.load() < Count, "异常之后不再分发新块");
+
+		return true;
+	}
+}
+
+void TestJobSystem() {
+	uint32_t Threads[] = { 2, 1, 1 };
+	if (!JobSystem::Initialize(Threads)) {
+		std::cout << "任务系统初始化失败!" << std::endl;
+		return;
+	}
+
+	bool AllPassed = JobTest::TestHandles();
+	AllPassed &= JobTest::TestDependencies();
+	AllPassed &= JobTest::TestCallbacks();
+	AllPassed &= JobTest::TestInstrumentation();
+	AllPassed &= JobTest::TestParallel();
+	std::cout << (AllPassed ? "任务系统测试通过!" : "任务系统测试失败!") << std::endl;
+
+	JobSystem::Shutdown();
+}
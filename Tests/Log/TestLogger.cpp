@@ -0,0 +1,119 @@
+﻿#include <Core/EngineLogger.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define LOG_TEST_THREADS 4					// 同时写日志的线程数
+#define LOG_TEST_RECORDS 1000				// 每个线程写的条数
+
+namespace LogTest {
+	static std::atomic<uint32_t> Received{ 0 };
+	static std::atomic<uint32_t> Corrupted{ 0 };
+
+	static bool CountLine(Log::Logger::Level, const std::string& line) {
+		if (line.compare(0, 11, "LoggerTest ") != 0) {
+			return true;
+		}
+
+		// 参数里的字符串在调用返回后就被改写，异步格式化必须用的是拷贝
+		int Thread = -1, Index = -1;
+		char Tag[16] = {};
+		if (sscanf(line.c_str(), "LoggerTest %d %d %15s", &Thread, &Index, Tag) != 3 || strcmp(Tag, "payload") != 0) {
+			Corrupted.fetch_add(1);
+		}
+		Received.fetch_add(1);
+		return true;
+	}
+
+	static bool TestAsyncLogging() {
+		std::cout << "\n=== 测试异步日志 ===" << std::endl;
+
+		Received.store(0);
+		Corrupted.store(0);
+		Console::RegisterConsumer(&CountLine);
+
+		uint64_t Dropped = 0;
+		{
+			EngineLogger Logger;
+			const uint64_t DroppedBefore = EngineLogger::GetDroppedCount();
+
+			std::vector<std::thread> Threads;
+			for (int t = 0; t < LOG_TEST_THREADS; ++t) {
+				Threads.emplace_back([t]() {
+					char Tag[16];
+					for (int i = 0; i < LOG_TEST_RECORDS; ++i) {
+						strcpy(Tag, "payload");
+						GLOG(Log::eInfo, "LoggerTest %d %d %s", t, i, Tag);
+						strcpy(Tag, "overwritten");
+					}
+				});
+			}
+			for (std::thread& Thread : Threads) {
+				Thread.join();
+			}
+
+			EngineLogger::Flush();
+			Dropped = EngineLogger::GetDroppedCount() - DroppedBefore;
+			TEST_ASSERT(Received.load() + Dropped == LOG_TEST_THREADS * LOG_TEST_RECORDS, "Flush 返回时所有记录已写出或计入丢弃");
+			TEST_ASSERT(Corrupted.load() == 0, "字符串参数按内容拷贝");
+		}
+
+		// 写入线程停止后在调用线程上同步写出
+		const uint32_t Before = Received.load();
+		GLOG(Log::eInfo, "LoggerTest %d %d %s", 0, 0, "payload");
+		TEST_ASSERT(Received.load() == Before + 1, "写入线程停止后同步写出");
+
+		Console::UnregisterConsumer(&CountLine);
+		return true;
+	}
+
+	static bool TestCategoryLevels() {
+		std::cout << "\n=== 测试分类级别过滤 ===" << std::endl;
+
+		Received.store(0);
+		Console::RegisterConsumer(&CountLine);
+
+		// 被过滤的调用不会对参数求值
+		int Evaluated = 0;
+		const Log::Level Previous = EngineLogger::GetCategoryLevel(Log::Category::eMemory);
+		EngineLogger::SetCategoryLevel(Log::Category::eMemory, Log::eWarn);
+		GLOG_CATEGORY(Log::Category::eMemory, Log::eInfo, "LoggerTest %d %d %s", ++Evaluated, 0, "payload");
+		EngineLogger::Flush();
+		TEST_ASSERT(Received.load() == 0 && Evaluated == 0, "低于分类级别的调用被丢弃且不求值");
+
+		GLOG_CATEGORY(Log::Category::eMemory, Log::eError, "LoggerTest %d %d %s", ++Evaluated, 0, "payload");
+		GLOG_CATEGORY(Log::Category::eVulkan, Log::eInfo, "LoggerTest %d %d %s", ++Evaluated, 0, "payload");
+		EngineLogger::Flush();
+		TEST_ASSERT(Received.load() == 2 && Evaluated == 2, "其他级别和分类不受影响");
+		EngineLogger::SetCategoryLevel(Log::Category::eMemory, Previous);
+
+		Log::Category Category;
+		Log::Level Level;
+		TEST_ASSERT(EngineLogger::ParseCategory("vulkan", Category) && Category == Log::Category::eVulkan
+			&& EngineLogger::ParseLevel("WARN", Level) && Level == Log::eWarn && !EngineLogger::ParseLevel("verbose", Level), "按名字解析分类和级别");
+
+		Console::UnregisterConsumer(&CountLine);
+		return true;
+	}
+}
+
+void TestLogger() {
+	bool AllPassed = LogTest::TestAsyncLogging();
+	AllPassed &= LogTest::TestCategoryLevels();
+	std::cout << (AllPassed ? "日志测试通过!" : "日志测试失败!") << std::endl;
+}
@@ -0,0 +1,182 @@
+﻿#include <Containers/TMap.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define MAP_TEST_CHURN_LIVE 64				// 反复增删时同时存活的键数
+#define MAP_TEST_RANDOM_OPS 200000			// 随机对比测试的操作次数
+
+namespace MapTest {
+	// 所有键哈希到同一条探测链，删除一定留下墓碑
+	struct CollidingHasher {
+		size_t operator()(uint32_t) const noexcept { return 0; }
+	};
+
+	static bool TestInsertFind() {
+		std::cout << "\n=== 测试插入与查找 ===" << std::endl;
+
+		TMap<uint32_t, uint32_t> Map;
+		TEST_ASSERT(Map.IsEmpty() && Map.Find(1) == nullptr, "空表查找返回空");
+
+		for (uint32_t i = 0; i < 1000; ++i) {
+			Map.Insert(i, i * 3);
+		}
+		bool Found = true;
+		for (uint32_t i = 0; i < 1000; ++i) {
+			const uint32_t* Value = Map.Find(i);
+			Found &= Value != nullptr && *Value == i * 3;
+		}
+		TEST_ASSERT(Map.Size() == 1000 && Found, "插入后全部能找到");
+		TEST_ASSERT(Map.Find(1000) == nullptr && !Map.Contains(5000), "不存在的键返回空");
+
+		// 相同键覆盖，不增加个数
+		Map.Insert(7, 42);
+		Map[8] = 43;
+		TEST_ASSERT(Map.Size() == 1000 && *Map.Find(7) == 42 && *Map.Find(8) == 43, "相同键覆盖值");
+
+		return true;
+	}
+
+	static bool TestTombstones() {
+		std::cout << "\n=== 测试删除与墓碑复用 ===" << std::endl;
+
+		TMap<uint32_t, uint32_t, CollidingHasher> Map;
+		for (uint32_t i = 0; i < 40; ++i) {
+			Map.Insert(i, i);
+		}
+		const size_t Capacity = Map.Capacity();
+
+		for (uint32_t i = 0; i < 40; i += 2) {
+			Map.Remove(i);
+		}
+		bool Correct = !Map.Remove(0);
+		for (uint32_t i = 0; i < 40; ++i) {
+			Correct &= (Map.Find(i) != nullptr) == ((i & 1) == 1);
+		}
+		TEST_ASSERT(Map.Size() == 20 && Correct, "删除后探测链上其余的键仍能找到");
+
+		// 重新插入落在墓碑上，容量不变
+		for (uint32_t i = 100; i < 120; ++i) {
+			Map.Insert(i, i);
+		}
+		Correct = true;
+		for (uint32_t i = 100; i < 120; ++i) {
+			Correct &= Map.Find(i) != nullptr && *Map.Find(i) == i;
+		}
+		TEST_ASSERT(Map.Size() == 40 && Map.Capacity() == Capacity && Correct, "新键复用墓碑不扩容");
+
+		return true;
+	}
+
+	static bool TestChurn() {
+		std::cout << "\n=== 测试反复增删触发重建 ===" << std::endl;
+
+		// 存活的键数不变，墓碑积累后应按原容量重建而不是一直翻倍
+		TMap<uint32_t, uint32_t> Map;
+		size_t MaxCapacity = 0;
+		for (uint32_t i = 0; i < 100000; ++i) {
+			Map.Insert(i, i);
+			if (i >= MAP_TEST_CHURN_LIVE) {
+				Map.Remove(i - MAP_TEST_CHURN_LIVE);
+			}
+			MaxCapacity = Map.Capacity() > MaxCapacity ? Map.Capacity() : MaxCapacity;
+		}
+
+		bool Correct = true;
+		for (uint32_t i = 100000 - MAP_TEST_CHURN_LIVE; i < 100000; ++i) {
+			Correct &= Map.Find(i) != nullptr && *Map.Find(i) == i;
+		}
+		Correct &= Map.Find(100000 - MAP_TEST_CHURN_LIVE - 1) == nullptr;
+		TEST_ASSERT(Map.Size() == MAP_TEST_CHURN_LIVE && Correct, "增删之后内容正确");
+		TEST_ASSERT(MaxCapacity <= MAP_TEST_CHURN_LIVE * 4, "容量不随墓碑增长");
+
+		return true;
+	}
+
+	static bool TestIteration() {
+		std::cout << "\n=== 测试删除后的迭代 ===" << std::endl;
+
+		TMap<uint32_t, uint32_t> Map;
+		for (uint32_t i = 0; i < 1000; ++i) {
+			Map.Insert(i, i);
+		}
+		for (uint32_t i = 0; i < 1000; i += 2) {
+			Map.Remove(i);
+		}
+
+		std::vector<uint8_t> Seen(1000, 0);
+		size_t Visited = 0;
+		bool Correct = true;
+		for (const auto& Pair : Map) {
+			Correct &= Pair.Key < 1000 && (Pair.Key & 1) == 1 && Pair.Value == Pair.Key && Seen[Pair.Key] == 0;
+			if (Pair.Key < 1000) Seen[Pair.Key] = 1;
+			++Visited;
+		}
+		TEST_ASSERT(Visited == 500 && Correct, "迭代只访问存活的键且每个一次");
+
+		return true;
+	}
+
+	static bool TestRandomAgainstStd() {
+		std::cout << "\n=== 与 std::unordered_map 随机对比 ===" << std::endl;
+
+		TMap<uint32_t, uint32_t> Map;
+		std::unordered_map<uint32_t, uint32_t> Reference;
+		std::mt19937 Random(12345);
+
+		bool Correct = true;
+		for (uint32_t i = 0; i < MAP_TEST_RANDOM_OPS && Correct; ++i) {
+			const uint32_t Key = Random() % 4096;
+			switch (Random() % 3) {
+			case 0:
+				Map.Insert(Key, i);
+				Reference[Key] = i;
+				break;
+			case 1:
+				Correct &= Map.Remove(Key) == (Reference.erase(Key) == 1);
+				break;
+			default: {
+				const uint32_t* Value = Map.Find(Key);
+				auto Found = Reference.find(Key);
+				Correct &= (Value != nullptr) == (Found != Reference.end()) && (Value == nullptr || *Value == Found->second);
+				break;
+			}
+			}
+			Correct &= Map.Size() == Reference.size();
+		}
+		TEST_ASSERT(Correct, "每一步的结果与 std::unordered_map 一致");
+
+		size_t Visited = 0;
+		for (const auto& Pair : Map) {
+			auto Found = Reference.find(Pair.Key);
+			Correct &= Found != Reference.end() && Found->second == Pair.Value;
+			++Visited;
+		}
+		TEST_ASSERT(Correct && Visited == Reference.size(), "最终内容一致");
+
+		return true;
+	}
+}
+
+void TestMap() {
+	bool AllPassed = MapTest::TestInsertFind();
+	AllPassed &= MapTest::TestTombstones();
+	AllPassed &= MapTest::TestChurn();
+	AllPassed &= MapTest::TestIteration();
+	AllPassed &= MapTest::TestRandomAgainstStd();
+	std::cout << (AllPassed ? "哈希表测试通过!" : "哈希表测试失败!") << std::endl;
+}
@@ -0,0 +1,225 @@
+﻿#include <Containers/TConcurrentQueue.hpp>
+#include <Containers/TQueue.hpp>
+#include <Containers/TWorkStealingDeque.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+#define QUEUE_TEST_ITEMS 1000000			// 每次并发测试传递的元素总数
+#define QUEUE_TEST_BATCH 32				// 批量接口每次读写的个数
+
+namespace QueueTest {
+	// 满或空时先自旋，等太久就让出时间片，线程数多于核数时不至于空转整个时间片
+	inline void Backoff(uint32_t& spins) {
+		if (++spins < 64) {
+			DCPU_PAUSE();
+		}
+		else {
+			spins = 0;
+			std::this_thread::yield();
+		}
+	}
+
+	struct TransferResult {
+		uint64_t Sum = 0;
+		uint64_t Count = 0;
+	};
+
+	/**
+	 * @brief 每个生产者推送 [p * per, (p + 1) * per) 的整数，消费者取到指定总数为止。
+	 * 满或空时自旋重试，返回收到元素的个数与和，用来校验没有丢失或重复。
+	 */
+	template<typename Queue>
+	TransferResult Transfer(Queue& queue, uint32_t producers, uint32_t consumers, uint64_t total, uint32_t batch) {
+		const uint64_t PerProducer = total / producers;
+		const uint64_t Expected = PerProducer * producers;
+		std::atomic<uint64_t> Received{ 0 };
+		std::atomic<uint64_t> Sum{ 0 };
+		std::atomic<bool> Start{ false };
+		std::vector<std::thread> Threads;
+
+		for (uint32_t p = 0; p < producers; ++p) {
+			Threads.emplace_back([&, p]() {
+				while (!Start.load(std::memory_order_acquire)) {}
+				std::vector<uint64_t> Values(batch);
+				uint64_t Next = p * PerProducer;
+				const uint64_t End = Next + PerProducer;
+				uint32_t Spins = 0;
+				while (Next < End) {
+					if (batch <= 1) {
+						if (!queue.Push(Next)) { Backoff(Spins); continue; }
+						++Next;
+					}
+					else {
+						uint32_t Count = (uint32_t)DMIN((uint64_t)batch, End - Next);
+						for (uint32_t i = 0; i < Count; ++i) Values[i] = Next + i;
+						uint32_t Pushed = queue.PushBatch(Values.data(), Count);
+						if (Pushed == 0) Backoff(Spins);
+						Next += Pushed;
+					}
+				}
+			});
+		}
+
+		for (uint32_t c = 0; c < consumers; ++c) {
+			Threads.emplace_back([&]() {
+				while (!Start.load(std::memory_order_acquire)) {}
+				std::vector<uint64_t> Values(DMAX(batch, 1u));
+				uint64_t LocalSum = 0;
+				uint32_t Spins = 0;
+				while (Received.load(std::memory_order_relaxed) < Expected) {
+					uint32_t Count = batch <= 1 ? (queue.Pop(Values[0]) ? 1 : 0) : queue.PopBatch(Values.data(), batch);
+					if (Count == 0) { Backoff(Spins); continue; }
+					for (uint32_t i = 0; i < Count; ++i) LocalSum += Values[i];
+					Received.fetch_add(Count, std::memory_order_relaxed);
+				}
+				Sum.fetch_add(LocalSum, std::memory_order_relaxed);
+			});
+		}
+
+		Start.store(true, std::memory_order_release);
+		for (std::thread& T : Threads) {
+			T.join();
+		}
+
+		TransferResult Result;
+		Result.Sum = Sum.load();
+		Result.Count = Received.load();
+		return Result;
+	}
+
+	inline uint64_t ExpectedSum(uint64_t count) {
+		return count * (count - 1) / 2;
+	}
+
+	static bool TestRingQueue() {
+		std::cout << "\n=== 测试 RingQueue ===" << std::endl;
+
+		RingQueue<uint32_t> Queue(4);
+		for (uint32_t i = 1; i <= 4; ++i) {
+			Queue.Enqueue(&i);
+		}
+		RingQueue<uint32_t> Copy(Queue);
+		uint32_t Value = 0;
+		Queue.Dequeue(&Value);
+		TEST_ASSERT(Value == 1 && Queue.GetLength() == 3, "先进先出");
+		Copy.Dequeue(&Value);
+		Copy.Dequeue(&Value);
+		TEST_ASSERT(Value == 2 && Copy.GetLength() == 2 && Queue.GetLength() == 3, "拷贝拥有独立的内存");
+
+		return true;
+	}
+
+	static bool TestSPSCQueue() {
+		std::cout << "\n=== 测试 TSPSCQueue ===" << std::endl;
+
+		TSPSCQueue<std::string> Strings(3);
+		TEST_ASSERT(Strings.GetCapacity() == 4, "容量取整到 2 的幂");
+		for (int i = 0; i < 4; ++i) {
+			Strings.Push(std::to_string(i));
+		}
+		TEST_ASSERT(!Strings.Push("full"), "队列满时 Push 失败");
+		std::string Out[4];
+		TEST_ASSERT(Strings.PopBatch(Out, 3) == 3 && Out[2] == "2", "批量取出");
+		std::string Wrap[] = { "a", "b", "c" };
+		TEST_ASSERT(Strings.PushBatch(Wrap, 3) == 3 && Strings.GetLength() == 4, "批量写入跨越环尾");
+		TEST_ASSERT(Strings.Pop(Out[0]) && Out[0] == "3" && Strings.Pop(Out[0]) && Out[0] == "a", "环绕后顺序正确");
+
+		TSPSCQueue<uint64_t> Numbers(1024);
+		TransferResult Single = Transfer(Numbers, 1, 1, QUEUE_TEST_ITEMS, 1);
+		TEST_ASSERT(Single.Sum == ExpectedSum(QUEUE_TEST_ITEMS), "单线程对传递不丢失");
+		TransferResult Batch = Transfer(Numbers, 1, 1, QUEUE_TEST_ITEMS, QUEUE_TEST_BATCH);
+		TEST_ASSERT(Batch.Sum == ExpectedSum(QUEUE_TEST_ITEMS), "批量传递不丢失");
+
+		return true;
+	}
+
+	static bool TestMPMCQueue() {
+		std::cout << "\n=== 测试 TMPMCQueue ===" << std::endl;
+
+		TMPMCQueue<std::string> Strings(4);
+		std::string Values[] = { "a", "b", "c", "d", "e" };
+		TEST_ASSERT(Strings.PushBatch(Values, 5) == 4 && !Strings.Push("f"), "批量写入只写到容量为止");
+		std::string Out[4];
+		TEST_ASSERT(Strings.Pop(Out[0]) && Out[0] == "a", "先进先出");
+		TEST_ASSERT(Strings.PopBatch(Out, 4) == 3 && Out[2] == "d" && Strings.IsEmpty(), "批量取出剩余元素");
+
+		TMPMCQueue<uint64_t> Numbers(1024);
+		const uint64_t Total = QUEUE_TEST_ITEMS / 4 * 4;
+		TransferResult Single = Transfer(Numbers, 4, 4, Total, 1);
+		TEST_ASSERT(Single.Count == Total && Single.Sum == ExpectedSum(Total), "4 生产者 4 消费者不丢失不重复");
+		TransferResult Batch = Transfer(Numbers, 4, 4, Total, QUEUE_TEST_BATCH);
+		TEST_ASSERT(Batch.Count == Total && Batch.Sum == ExpectedSum(Total), "批量读写不丢失不重复");
+
+		return true;
+	}
+
+	static bool TestWorkStealingDeque() {
+		std::cout << "\n=== 测试 TWorkStealingDeque ===" << std::endl;
+
+		TWorkStealingDeque<uint64_t> Deque(4);
+		for (uint64_t i = 0; i < 10; ++i) {
+			Deque.Push(i);
+		}
+		uint64_t Value = 0;
+		TEST_ASSERT(Deque.GetCapacity() == 16 && Deque.GetLength() == 10, "满了自动扩容");
+		TEST_ASSERT(Deque.Pop(Value) && Value == 9, "所有者后进先出");
+		TEST_ASSERT(Deque.Steal(Value) && Value == 0, "窃取者先进先出");
+		while (Deque.Pop(Value)) {}
+		TEST_ASSERT(Deque.IsEmpty() && !Deque.Steal(Value), "取空后窃取失败");
+
+		// 所有者边压边取，3 个窃取者同时偷，每个元素恰好被取走一次
+		std::atomic<bool> Done{ false };
+		std::atomic<uint64_t> Sum{ 0 };
+		std::atomic<uint64_t> Count{ 0 };
+		std::vector<std::thread> Thieves;
+		for (int t = 0; t < 3; ++t) {
+			Thieves.emplace_back([&]() {
+				uint64_t Stolen = 0, LocalSum = 0, LocalCount = 0;
+				uint32_t Spins = 0;
+				while (!Done.load(std::memory_order_acquire) || !Deque.IsEmpty()) {
+					if (Deque.Steal(Stolen)) { LocalSum += Stolen; ++LocalCount; }
+					else Backoff(Spins);
+				}
+				Sum.fetch_add(LocalSum);
+				Count.fetch_add(LocalCount);
+			});
+		}
+
+		uint64_t OwnerSum = 0, OwnerCount = 0;
+		for (uint64_t i = 0; i < QUEUE_TEST_ITEMS; ++i) {
+			Deque.Push(i);
+			if ((i & 3) == 0 && Deque.Pop(Value)) { OwnerSum += Value; ++OwnerCount; }
+		}
+		while (Deque.Pop(Value)) { OwnerSum += Value; ++OwnerCount; }
+		Done.store(true, std::memory_order_release);
+		for (std::thread& T : Thieves) {
+			T.join();
+		}
+		TEST_ASSERT(Count.load() + OwnerCount == QUEUE_TEST_ITEMS && Sum.load() + OwnerSum == ExpectedSum(QUEUE_TEST_ITEMS), "并发窃取不丢失不重复");
+
+		return true;
+	}
+}
+
+void TestQueue() {
+	bool AllPassed = QueueTest::TestRingQueue();
+	AllPassed &= QueueTest::TestSPSCQueue();
+	AllPassed &= QueueTest::TestMPMCQueue();
+	AllPassed &= QueueTest::TestWorkStealingDeque();
+	std::cout << (AllPassed ? "队列测试通过!" : "队列测试失败!") << std::endl;
+}
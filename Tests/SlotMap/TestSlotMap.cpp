@@ -0,0 +1,97 @@
+﻿#include <Containers/TSlotMap.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#ifndef TEST_ASSERT
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "[FAIL] " << message << " (Line: " << __LINE__ << ")" << std::endl; \
+            return false; \
+        } \
+        std::cout << "[PASS] " << message << std::endl; \
+    } while(0)
+#endif
+
+namespace SlotMapTest {
+	static bool TestInsertGet() {
+		std::cout << "\n=== 测试插入与查找 ===" << std::endl;
+
+		TSlotMap<int> Map;
+		TEST_ASSERT(Map.Get(FSlotHandle()) == nullptr && !Map.Contains(FSlotHandle()), "无效句柄查不到元素");
+
+		FSlotHandle A = Map.Insert(10);
+		FSlotHandle B = Map.Insert(20);
+		FSlotHandle C = Map.Emplace(30);
+		TEST_ASSERT(A.IsValid() && A != B && B != C && Map.Size() == 3, "插入返回互不相同的有效句柄");
+		TEST_ASSERT(*Map.Get(A) == 10 && *Map.Get(B) == 20 && *Map.Get(C) == 30, "句柄取回插入的值");
+		TEST_ASSERT(FSlotHandle::FromUInt64(B.ToUInt64()) == B, "句柄打包后可以还原");
+
+		return true;
+	}
+
+	static bool TestStaleHandles() {
+		std::cout << "\n=== 测试过期句柄 ===" << std::endl;
+
+		TSlotMap<int> Map;
+		FSlotHandle A = Map.Insert(1);
+		FSlotHandle B = Map.Insert(2);
+
+		TEST_ASSERT(Map.Erase(A) && Map.Get(A) == nullptr && !Map.Contains(A), "删除后旧句柄查不到");
+		TEST_ASSERT(!Map.Erase(A), "重复删除返回 false");
+		TEST_ASSERT(*Map.Get(B) == 2, "其他句柄不受影响");
+
+		// 新元素复用 A 的槽位，代数加一，旧句柄仍然无效
+		FSlotHandle Reused = Map.Insert(3);
+		TEST_ASSERT(Reused.Index == A.Index && Reused.Generation != A.Generation, "复用槽位时代数增加");
+		TEST_ASSERT(Map.Get(A) == nullptr && !Map.Erase(A) && *Map.Get(Reused) == 3, "复用后旧句柄仍然无效");
+
+		Map.Clear();
+		TEST_ASSERT(Map.IsEmpty() && Map.Get(B) == nullptr && Map.Get(Reused) == nullptr, "Clear 使所有句柄失效");
+
+		return true;
+	}
+
+	static bool TestDenseIteration() {
+		std::cout << "\n=== 测试删除后的紧密遍历 ===" << std::endl;
+
+		TSlotMap<int> Map;
+		std::vector<FSlotHandle> Handles;
+		for (int i = 0; i < 100; ++i) {
+			Handles.push_back(Map.Insert(i));
+		}
+
+		// 删除中间、开头的元素，最后一个元素被搬过来填补空位
+		for (int i = 0; i < 100; i += 3) {
+			Map.Erase(Handles[i]);
+		}
+
+		bool Correct = true;
+		size_t Visited = 0;
+		for (int Value : Map) {
+			Correct &= Value % 3 != 0;
+			++Visited;
+		}
+		TEST_ASSERT(Visited == Map.Size() && Map.Size() == 66 && Correct, "遍历只访问存活的元素");
+
+		for (size_t i = 0; i < Map.Size(); ++i) {
+			Correct &= Map.Get(Map.GetHandle(i)) == Map.Data() + i;
+		}
+		for (int i = 0; i < 100; ++i) {
+			const int* Value = Map.Get(Handles[i]);
+			Correct &= i % 3 == 0 ? Value == nullptr : (Value != nullptr && *Value == i);
+		}
+		TEST_ASSERT(Correct, "搬动后句柄仍指向原来的元素");
+
+		return true;
+	}
+}
+
+void TestSlotMap() {
+	bool AllPassed = SlotMapTest::TestInsertGet();
+	AllPassed &= SlotMapTest::TestStaleHandles();
+	AllPassed &= SlotMapTest::TestDenseIteration();
+	std::cout << (AllPassed ? "槽位表测试通过!" : "槽位表测试失败!") << std::endl;
+}
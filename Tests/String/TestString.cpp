@@ -1,4 +1,5 @@
 ﻿#include "Containers/FString.hpp"
+#include "Containers/FName.hpp"
 #include <iostream>
 #include <cassert>
 #include <vector>
@@ -90,6 +91,16 @@ public:
 		str1 += '?';
 		TEST_ASSERT(str1.Equal("Hello World!?"), "+= 字符操作正确");
 
+		// 追加自身的内容，结果超过内联容量时需要扩容
+		FString self_inline("Hello World!");
+		self_inline += self_inline.CStr();
+		TEST_ASSERT(self_inline.Equal("Hello World!Hello World!"), "+= 自身的内联缓冲区正确");
+
+		FString self_heap("0123456789ABCDEFGHIJKLMNO");
+		self_heap += self_heap.CStr();
+		self_heap += self_heap.CStr() + 25;
+		TEST_ASSERT(self_heap.Equal("0123456789ABCDEFGHIJKLMNO0123456789ABCDEFGHIJKLMNO0123456789ABCDEFGHIJKLMNO"), "+= 自身的堆缓冲区正确");
+
 		// + 操作符
 		FString result1 = FString("Good") + FString(" Morning");
 		TEST_ASSERT(result1.Equal("Good Morning"), "+ FString操作正确");
@@ -256,6 +267,54 @@ public:
 		return true;
 	}
 
+	// 测试短字符串内联存储
+	static bool TestSmallString() {
+		std::cout << "\n=== 测试短字符串 ===" << std::endl;
+
+		FString short_str("TransformComponent");
+		TEST_ASSERT(short_str.IsInline(), "短字符串不分配内存");
+
+		FString long_str("Assets/Textures/Environment/Skybox_Front.png");
+		TEST_ASSERT(!long_str.IsInline(), "长字符串使用堆内存");
+
+		// 追加到超过内联容量时转为堆内存，内容保持不变
+		FString grow("Component");
+		grow += "TransformComponent";
+		TEST_ASSERT(!grow.IsInline(), "追加后转为堆内存");
+		TEST_ASSERT(grow == "ComponentTransformComponent", "追加后内容正确");
+
+		// 移动内联字符串
+		FString moved(static_cast<FString&&>(short_str));
+		TEST_ASSERT(moved == "TransformComponent", "移动内联字符串内容正确");
+		TEST_ASSERT(short_str.IsEmpty(), "移动后原对象为空");
+
+		// 自身追加
+		FString self("abc");
+		self += self;
+		TEST_ASSERT(self == "abcabc", "自身追加正确");
+
+		return true;
+	}
+
+	// 测试驻留名字
+	static bool TestName() {
+		std::cout << "\n=== 测试 FName ===" << std::endl;
+
+		FName none;
+		TEST_ASSERT(none.IsNone() && FName("") == none, "空名字为 None");
+
+		FName name1("DefaultMaterial");
+		FName name2(FString("DefaultMaterial"));
+		TEST_ASSERT(name1 == name2, "相同字符串得到相同名字");
+		TEST_ASSERT(name1 != FName("defaultmaterial"), "名字区分大小写");
+		TEST_ASSERT(strcmp(name1.CStr(), "DefaultMaterial") == 0, "名字可以取回原始字符串");
+		TEST_ASSERT(name1.Length() == 15, "名字长度正确");
+		TEST_ASSERT(FName::Find("DefaultMaterial") == name1, "Find 找到已驻留的名字");
+		TEST_ASSERT(FName::Find("NeverInterned").IsNone(), "Find 不驻留新名字");
+
+		return true;
+	}
+
 	// 运行所有测试
 	static bool RunAllTests() {
 		std::cout << "开始运行FString测试用例..." << std::endl;
@@ -271,6 +330,8 @@ public:
 		all_passed &= TestTypeConversions();
 		all_passed &= TestStaticMethods();
 		all_passed &= TestMemoryManagement();
+		all_passed &= TestSmallString();
+		all_passed &= TestName();
 
 		std::cout << "\n=== 测试结果 ===" << std::endl;
 		if (all_passed) {
@@ -1,9 +1,20 @@
 ﻿#include "Freelist/TestFreelist.cpp"
+#include "Freelist/TestThreadCache.cpp"
+#include "Freelist/TestObjectPool.cpp"
+#include "Freelist/TestDynamicAllocator.cpp"
+#include "Freelist/TestScratchAllocator.cpp"
+#include "Freelist/TestFrameAllocator.cpp"
+#include "Freelist/TestAllocateZeroed.cpp"
 #include "String/TestString.cpp"
 #include "Audio/TestAudio.cpp"
 #include "Array/UnitTestArray.cpp"
 #include "MathLibrary/TestMatrix.cpp"
 #include "SIMD/TestSIMD.cpp"
+#include "Queue/TestQueue.cpp"
+#include "Map/TestMap.cpp"
+#include "SlotMap/TestSlotMap.cpp"
+#include "Job/TestJobSystem.cpp"
+#include "Log/TestLogger.cpp"
 
 #include<functional>
 
@@ -21,6 +32,17 @@ int main() {
 	CHECK_FUNC_CONTINUE(&UnitTestAudio, "UnitTestAudio Failed.");
 	CHECK_FUNC_CONTINUE(&TestSIMD, "TestSIMD Failed.");
 	CHECK_FUNC_CONTINUE(&TestMathLibrary, "TestMathLibrary Failed.");
+	CHECK_FUNC_CONTINUE(&TestQueue, "TestQueue Failed.");
+	CHECK_FUNC_CONTINUE(&TestMap, "TestMap Failed.");
+	CHECK_FUNC_CONTINUE(&TestSlotMap, "TestSlotMap Failed.");
+	CHECK_FUNC_CONTINUE(&TestJobSystem, "TestJobSystem Failed.");
+	CHECK_FUNC_CONTINUE(&TestLogger, "TestLogger Failed.");
+	CHECK_FUNC_CONTINUE(&TestThreadCache, "TestThreadCache Failed.");
+	CHECK_FUNC_CONTINUE(&TestObjectPool, "TestObjectPool Failed.");
+	CHECK_FUNC_CONTINUE(&TestDynamicAllocator, "TestDynamicAllocator Failed.");
+	CHECK_FUNC_CONTINUE(&TestScratchAllocator, "TestScratchAllocator Failed.");
+	CHECK_FUNC_CONTINUE(&TestFrameAllocator, "TestFrameAllocator Failed.");
+	CHECK_FUNC_CONTINUE(&TestAllocateZeroed, "TestAllocateZeroed Failed.");
 	// 放在最后，有延时测试
 	CHECK_FUNC_CONTINUE(&TestFreelist, "TestFreelist Failed.");
 
@@ -0,0 +1,580 @@
+﻿/**
+ * Benchmarks the engine allocators against system malloc.
+ *
+ * Two kinds of scenarios are run for every allocator:
+ *  - "mixed": N threads each keep a window of live blocks and replace a random one per step,
+ *    so allocations and frees interleave the way gameplay code does. Sizes are drawn from a
+ *    recorded trace when one is given, otherwise from a fixed small/medium/large mix.
+ *  - "trace": replays the allocations and frees of a memory trace (.dmt, see MemoryTrace) in
+ *    recorded order on one thread.
+ *
+ * Every allocate and free is timed, and the report lists throughput, p50/p99/p999 latency and,
+ * for allocators backed by the DynamicAllocator, fragmentation with the live set in place.
+ * --json writes the results for CI; --baseline compares against an earlier --json output and
+ * exits with 2 when throughput or tail latency regressed by more than the tolerance.
+ *
+ * Usage: AllocatorBenchmark [--threads 1,2,4,8] [--ops per thread] [--allocators system,memory,...]
+ *                           [--trace <trace.dmt>] [--json <out.json>] [--baseline <base.json>] [--tolerance 0.15]
+ */
+#include "Core/DMemory.hpp"
+#include "Memory/DynamicAllocator.h"
+#include "Memory/LinearAllocator.h"
+#include "Memory/MemoryTraceFormat.h"
+#include "Memory/ObjectPool.h"
+#include "Memory/ScratchAllocator.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define BENCHMARK_ARENA_SIZE GIBIBYTES(1)
+#define BENCHMARK_LIVE_WINDOW 1024				// 每个线程同时存活的块数
+#define BENCHMARK_FRAME_ALLOCATIONS 1024		// 线性分配器每次复位之间的分配数
+#define BENCHMARK_POOL_SLOT_SIZE 64
+#define BENCHMARK_RESULT_VERSION 1
+
+struct BenchmarkAllocator {
+	const char* Name;
+	void* (*Allocate)(size_t size);
+	void (*Free)(void* block, size_t size);
+	void (*BeginThread)();
+	void (*EndThread)();
+	void (*Reset)();							// Not null for allocators that only release in bulk
+	bool FixedSize;								// Ignores the requested size
+	bool UsesArena;								// Backed by the DynamicAllocator, so fragmentation is meaningful
+};
+
+struct BenchmarkResult {
+	std::string Scenario;
+	std::string Allocator;
+	uint32_t Threads = 0;
+	uint64_t Operations = 0;
+	uint64_t Failures = 0;
+	double Seconds = 0.0;
+	double OpsPerSecond = 0.0;
+	uint64_t P50 = 0;
+	uint64_t P99 = 0;
+	uint64_t P999 = 0;
+	uint64_t Max = 0;
+	double Fragmentation = -1.0;				// < 0 when not applicable
+};
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------------------------
+// Allocators under test
+
+static ObjectPool& GetBenchmarkPool() {
+	static ObjectPool Pool("Benchmark", BENCHMARK_POOL_SLOT_SIZE, 16);
+	return Pool;
+}
+
+static thread_local LinearAllocator* ThreadLinear = nullptr;
+static thread_local ScratchScope* ThreadScratch = nullptr;
+
+static void NoThreadHook() {}
+
+static BenchmarkAllocator Allocators[] = {
+	{ "system",
+		[](size_t size) { return malloc(size); },
+		[](void* block, size_t) { free(block); },
+		NoThreadHook, NoThreadHook, nullptr, false, false },
+	{ "memory",
+		[](size_t size) { return Memory::AllocateUninitialized(size, MemoryType::eMemory_Type_Array); },
+		[](void* block, size_t) { Memory::Free(block, MemoryType::eMemory_Type_Array); },
+		NoThreadHook, NoThreadHook, nullptr, false, true },
+	{ "dynamic",
+		[](size_t size) { return DynamicAllocator::Get().AllocateAligned(size, 16); },
+		[](void* block, size_t) { DynamicAllocator::Get().FreeAligned(block); },
+		NoThreadHook, NoThreadHook, nullptr, false, true },
+	{ "pool",
+		[](size_t) { return GetBenchmarkPool().Allocate(); },
+		[](void* block, size_t) { GetBenchmarkPool().Free(block); },
+		NoThreadHook, ObjectPool::Flush, nullptr, true, true },
+	{ "linear",
+		[](size_t size) { return ThreadLinear->Allocate(size, 16); },
+		[](void*, size_t) {},
+		[]() { ThreadLinear = new LinearAllocator(); ThreadLinear->Create(MEBIBYTES(16)); },
+		[]() { delete ThreadLinear; ThreadLinear = nullptr; },
+		[]() { ThreadLinear->Reset(); },
+		false, false },
+	{ "scratch",
+		[](size_t size) { return ScratchAllocator::Allocate(size, 16); },
+		[](void* block, size_t size) { ScratchAllocator::Free(block, size); },
+		[]() { ThreadScratch = new ScratchScope(); },
+		[]() { delete ThreadScratch; ThreadScratch = nullptr; },
+		[]() { delete ThreadScratch; ThreadScratch = new ScratchScope(); },
+		false, false },
+};
+
+// ---------------------------------------------------------------------------------------------
+// Trace loading
+
+struct TraceOp {
+	uint64_t Address;
+	uint64_t Size;
+	bool Allocate;
+};
+
+static bool LoadTrace(const char* path, std::vector<TraceOp>& out_ops, std::vector<uint32_t>& out_sizes) {
+	FILE* File = fopen(path, "rb");
+	if (File == nullptr) {
+		printf("Unable to open '%s'.\n", path);
+		return false;
+	}
+
+	MemoryTraceHeader Header;
+	if (fread(&Header, sizeof(Header), 1, File) != 1 || Header.Magic != MEMORY_TRACE_MAGIC ||
+		Header.Version != MEMORY_TRACE_VERSION || Header.EventSize != sizeof(MemoryTraceEvent)) {
+		printf("'%s' is not a compatible memory trace.\n", path);
+		fclose(File);
+		return false;
+	}
+
+	if (fseek(File, (long)(sizeof(MemoryTraceTypeName) * Header.TypeCount), SEEK_CUR) != 0) {
+		fclose(File);
+		return false;
+	}
+
+	std::vector<MemoryTraceEvent> Events;
+	MemoryTraceEvent Chunk[4096];
+	size_t Read = 0;
+	while ((Read = fread(Chunk, sizeof(MemoryTraceEvent), 4096, File)) > 0) {
+		Events.insert(Events.end(), Chunk, Chunk + Read);
+	}
+	fclose(File);
+
+	std::stable_sort(Events.begin(), Events.end(), [](const MemoryTraceEvent& a, const MemoryTraceEvent& b) {
+		return a.Timestamp < b.Timestamp;
+	});
+
+	for (const MemoryTraceEvent& Event : Events) {
+		// Pool slots live inside a slab that is already in the trace.
+		if (Event.Flags & MEMORY_TRACE_FLAG_SUB_ALLOCATION) {
+			continue;
+		}
+
+		if (Event.Op == eMemory_Trace_Allocate) {
+			out_ops.push_back(TraceOp{ Event.Address, Event.Size, true });
+			out_sizes.push_back((uint32_t)DMIN(Event.Size, (uint64_t)0xFFFFFFFF));
+		}
+		else if (Event.Op == eMemory_Trace_Free) {
+			out_ops.push_back(TraceOp{ Event.Address, Event.Size, false });
+		}
+		else if (Event.Op == eMemory_Trace_Shutdown) {
+			break;
+		}
+	}
+
+	printf("Loaded %llu operations from '%s'.\n", (unsigned long long)out_ops.size(), path);
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Scenarios
+
+static void Summarize(std::vector<uint32_t>& latencies, BenchmarkResult& result) {
+	if (latencies.empty()) {
+		return;
+	}
+
+	auto Percentile = [&](double p) {
+		size_t Index = DMIN((size_t)(p * (double)latencies.size()), latencies.size() - 1);
+		std::nth_element(latencies.begin(), latencies.begin() + Index, latencies.end());
+		return (uint64_t)latencies[Index];
+	};
+
+	result.P50 = Percentile(0.50);
+	result.P99 = Percentile(0.99);
+	result.P999 = Percentile(0.999);
+	result.Max = *std::max_element(latencies.begin(), latencies.end());
+	result.OpsPerSecond = result.Seconds > 0.0 ? (double)result.Operations / result.Seconds : 0.0;
+}
+
+static inline uint32_t Elapsed(Clock::time_point start) {
+	return (uint32_t)DMIN((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(), (uint64_t)0xFFFFFFFF);
+}
+
+static size_t PickSize(std::mt19937& random, const std::vector<uint32_t>& trace_sizes) {
+	if (!trace_sizes.empty()) {
+		return DMAX((size_t)trace_sizes[random() % trace_sizes.size()], (size_t)1);
+	}
+
+	// 70% small, 25% medium, 5% large.
+	uint32_t Roll = random() % 100;
+	if (Roll < 70) return 16 + random() % 240;
+	if (Roll < 95) return 256 + random() % 3840;
+	return 4096 + random() % 61440;
+}
+
+static BenchmarkResult RunMixed(const BenchmarkAllocator& allocator, uint32_t thread_count, uint64_t ops_per_thread, const std::vector<uint32_t>& trace_sizes) {
+	BenchmarkResult Result;
+	Result.Scenario = "mixed";
+	Result.Allocator = allocator.Name;
+	Result.Threads = thread_count;
+
+	std::vector<std::vector<uint32_t>> Latencies(thread_count);
+	std::vector<uint64_t> Failures(thread_count, 0);
+	std::atomic<uint32_t> Ready{ 0 };
+	std::atomic<bool> Go{ false };
+	std::atomic<uint32_t> Measured{ 0 };
+	std::atomic<bool> Release{ false };
+	double Fragmentation = -1.0;
+
+	auto Worker = [&](uint32_t thread_index) {
+		allocator.BeginThread();
+
+		std::mt19937 Random(1234u + thread_index);
+		std::vector<uint32_t>& Samples = Latencies[thread_index];
+		Samples.reserve(ops_per_thread * 2);
+
+		struct LiveBlock { void* Block; size_t Size; };
+		std::vector<LiveBlock> Live(allocator.Reset ? 0 : BENCHMARK_LIVE_WINDOW, LiveBlock{ nullptr, 0 });
+
+		Ready.fetch_add(1);
+		while (!Go.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+
+		for (uint64_t i = 0; i < ops_per_thread; ++i) {
+			size_t Size = allocator.FixedSize ? BENCHMARK_POOL_SLOT_SIZE : PickSize(Random, trace_sizes);
+			LiveBlock* Slot = nullptr;
+
+			if (allocator.Reset) {
+				if (i > 0 && i % BENCHMARK_FRAME_ALLOCATIONS == 0) {
+					Clock::time_point Start = Clock::now();
+					allocator.Reset();
+					Samples.push_back(Elapsed(Start));
+				}
+			}
+			else {
+				// Replace a random member of the live set.
+				Slot = &Live[Random() % Live.size()];
+				if (Slot->Block != nullptr) {
+					Clock::time_point Start = Clock::now();
+					allocator.Free(Slot->Block, Slot->Size);
+					Samples.push_back(Elapsed(Start));
+					Slot->Block = nullptr;
+				}
+			}
+
+			Clock::time_point Start = Clock::now();
+			void* Block = allocator.Allocate(Size);
+			Samples.push_back(Elapsed(Start));
+
+			if (Block == nullptr) {
+				Failures[thread_index]++;
+				continue;
+			}
+			*(volatile char*)Block = (char)i;
+
+			if (Slot != nullptr) {
+				*Slot = LiveBlock{ Block, Size };
+			}
+		}
+
+		// Hold the live set until the fragmentation of the arena has been sampled.
+		Measured.fetch_add(1);
+		while (!Release.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+
+		for (LiveBlock& Slot : Live) {
+			if (Slot.Block != nullptr) {
+				allocator.Free(Slot.Block, Slot.Size);
+			}
+		}
+
+		allocator.EndThread();
+	};
+
+	std::vector<std::thread> Threads;
+	for (uint32_t i = 0; i < thread_count; ++i) {
+		Threads.emplace_back(Worker, i);
+	}
+
+	while (Ready.load() < thread_count) {
+		std::this_thread::yield();
+	}
+
+	Clock::time_point Start = Clock::now();
+	Go.store(true, std::memory_order_release);
+
+	while (Measured.load() < thread_count) {
+		std::this_thread::yield();
+	}
+	Result.Seconds = std::chrono::duration<double>(Clock::now() - Start).count();
+
+	if (allocator.UsesArena) {
+		Fragmentation = DynamicAllocator::Get().GetFragmentation();
+	}
+	Release.store(true, std::memory_order_release);
+
+	for (std::thread& Thread : Threads) {
+		Thread.join();
+	}
+
+	std::vector<uint32_t> All;
+	for (uint32_t i = 0; i < thread_count; ++i) {
+		All.insert(All.end(), Latencies[i].begin(), Latencies[i].end());
+		Result.Failures += Failures[i];
+	}
+	Result.Operations = All.size();
+	Result.Fragmentation = Fragmentation;
+	Summarize(All, Result);
+	return Result;
+}
+
+static BenchmarkResult RunTrace(const BenchmarkAllocator& allocator, const std::vector<TraceOp>& ops) {
+	BenchmarkResult Result;
+	Result.Scenario = "trace";
+	Result.Allocator = allocator.Name;
+	Result.Threads = 1;
+
+	allocator.BeginThread();
+
+	std::unordered_map<uint64_t, std::pair<void*, size_t>> Live;
+	Live.reserve(ops.size() / 2 + 1);
+	std::vector<uint32_t> Samples;
+	Samples.reserve(ops.size());
+	size_t PeakLive = 0;
+
+	Clock::time_point RunStart = Clock::now();
+	for (const TraceOp& Op : ops) {
+		if (Op.Allocate) {
+			size_t Size = DMAX((size_t)Op.Size, (size_t)1);
+			Clock::time_point Start = Clock::now();
+			void* Block = allocator.Allocate(Size);
+			Samples.push_back(Elapsed(Start));
+
+			if (Block == nullptr) {
+				Result.Failures++;
+				continue;
+			}
+			Live[Op.Address] = std::make_pair(Block, Size);
+
+			if (Live.size() > PeakLive) {
+				PeakLive = Live.size();
+				if (allocator.UsesArena) {
+					Result.Fragmentation = DynamicAllocator::Get().GetFragmentation();
+				}
+			}
+		}
+		else {
+			auto It = Live.find(Op.Address);
+			if (It == Live.end()) {
+				continue;
+			}
+
+			Clock::time_point Start = Clock::now();
+			allocator.Free(It->second.first, It->second.second);
+			Samples.push_back(Elapsed(Start));
+			Live.erase(It);
+		}
+	}
+	Result.Seconds = std::chrono::duration<double>(Clock::now() - RunStart).count();
+
+	// Blocks the trace never freed.
+	for (auto& Pair : Live) {
+		allocator.Free(Pair.second.first, Pair.second.second);
+	}
+
+	allocator.EndThread();
+
+	Result.Operations = Samples.size();
+	Summarize(Samples, Result);
+	return Result;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Reporting
+
+static nlohmann::json ToJson(const BenchmarkResult& result) {
+	nlohmann::json Json;
+	Json["scenario"] = result.Scenario;
+	Json["allocator"] = result.Allocator;
+	Json["threads"] = result.Threads;
+	Json["operations"] = result.Operations;
+	Json["failures"] = result.Failures;
+	Json["seconds"] = result.Seconds;
+	Json["ops_per_second"] = result.OpsPerSecond;
+	Json["p50_ns"] = result.P50;
+	Json["p99_ns"] = result.P99;
+	Json["p999_ns"] = result.P999;
+	Json["max_ns"] = result.Max;
+	if (result.Fragmentation >= 0.0) {
+		Json["fragmentation"] = result.Fragmentation;
+	}
+	else {
+		Json["fragmentation"] = nullptr;
+	}
+	return Json;
+}
+
+static void PrintResult(const BenchmarkResult& result) {
+	printf("%-7s %-8s %3u %12.0f %8llu %8llu %8llu %10llu ", result.Scenario.c_str(), result.Allocator.c_str(), result.Threads,
+		result.OpsPerSecond, (unsigned long long)result.P50, (unsigned long long)result.P99, (unsigned long long)result.P999, (unsigned long long)result.Max);
+	if (result.Fragmentation >= 0.0) {
+		printf("%7.2f%%", result.Fragmentation * 100.0);
+	}
+	else {
+		printf("%8s", "-");
+	}
+	if (result.Failures > 0) {
+		printf("  %llu failed", (unsigned long long)result.Failures);
+	}
+	printf("\n");
+}
+
+static int CompareBaseline(const char* path, const std::vector<BenchmarkResult>& results, double tolerance) {
+	std::ifstream Stream(path);
+	if (!Stream.is_open()) {
+		printf("Unable to open baseline '%s'.\n", path);
+		return 1;
+	}
+
+	nlohmann::json Baseline = nlohmann::json::parse(Stream, nullptr, false);
+	if (Baseline.is_discarded() || !Baseline.contains("results")) {
+		printf("'%s' is not a benchmark result file.\n", path);
+		return 1;
+	}
+
+	uint32_t Regressions = 0;
+	printf("\nCompared with '%s' (tolerance %.0f%%):\n", path, tolerance * 100.0);
+	for (const nlohmann::json& Base : Baseline["results"]) {
+		for (const BenchmarkResult& Result : results) {
+			if (Base.value("scenario", "") != Result.Scenario || Base.value("allocator", "") != Result.Allocator ||
+				Base.value("threads", 0u) != Result.Threads) {
+				continue;
+			}
+
+			double BaseOps = Base.value("ops_per_second", 0.0);
+			double BaseP99 = (double)Base.value("p99_ns", (uint64_t)0);
+			bool Slower = BaseOps > 0.0 && Result.OpsPerSecond < BaseOps * (1.0 - tolerance);
+			bool TailWorse = BaseP99 > 0.0 && (double)Result.P99 > BaseP99 * (1.0 + tolerance);
+			if (Slower || TailWorse) {
+				Regressions++;
+				printf(" REGRESSION %-7s %-8s %3u threads: %.0f -> %.0f ops/s, p99 %.0f -> %llu ns\n", Result.Scenario.c_str(),
+					Result.Allocator.c_str(), Result.Threads, BaseOps, Result.OpsPerSecond, BaseP99, (unsigned long long)Result.P99);
+			}
+		}
+	}
+
+	if (Regressions == 0) {
+		printf(" No regressions.\n");
+		return 0;
+	}
+	return 2;
+}
+
+// ---------------------------------------------------------------------------------------------
+
+static std::vector<uint32_t> ParseThreadList(const char* list) {
+	std::vector<uint32_t> Counts;
+	std::string Text = list;
+	size_t Start = 0;
+	while (Start < Text.size()) {
+		size_t End = Text.find(',', Start);
+		if (End == std::string::npos) {
+			End = Text.size();
+		}
+		int Count = atoi(Text.substr(Start, End - Start).c_str());
+		if (Count > 0) {
+			Counts.push_back((uint32_t)Count);
+		}
+		Start = End + 1;
+	}
+	return Counts;
+}
+
+int main(int argc, char** argv) {
+	std::vector<uint32_t> ThreadCounts = { 1, 2, 4, 8 };
+	uint64_t OpsPerThread = 200000;
+	std::string AllocatorList = "system,memory,dynamic,pool,linear,scratch";
+	const char* TracePath = nullptr;
+	const char* JsonPath = nullptr;
+	const char* BaselinePath = nullptr;
+	double Tolerance = 0.15;
+
+	for (int i = 1; i < argc; ++i) {
+		bool HasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--threads") == 0 && HasValue) ThreadCounts = ParseThreadList(argv[++i]);
+		else if (strcmp(argv[i], "--ops") == 0 && HasValue) OpsPerThread = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--allocators") == 0 && HasValue) AllocatorList = argv[++i];
+		else if (strcmp(argv[i], "--trace") == 0 && HasValue) TracePath = argv[++i];
+		else if (strcmp(argv[i], "--json") == 0 && HasValue) JsonPath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && HasValue) BaselinePath = argv[++i];
+		else if (strcmp(argv[i], "--tolerance") == 0 && HasValue) Tolerance = atof(argv[++i]);
+		else {
+			printf("Usage: %s [--threads 1,2,4,8] [--ops per thread] [--allocators system,memory,dynamic,pool,linear,scratch]\n"
+				"          [--trace <trace.dmt>] [--json <out.json>] [--baseline <base.json>] [--tolerance 0.15]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<TraceOp> TraceOps;
+	std::vector<uint32_t> TraceSizes;
+	if (TracePath != nullptr && !LoadTrace(TracePath, TraceOps, TraceSizes)) {
+		return 1;
+	}
+
+	if (!Memory::Initialize(BENCHMARK_ARENA_SIZE)) {
+		printf("Memory system failed to initialize.\n");
+		return 1;
+	}
+
+	std::vector<BenchmarkResult> Results;
+	printf("%-7s %-8s %3s %12s %8s %8s %8s %10s %8s\n", "scene", "alloc", "thr", "ops/s", "p50 ns", "p99 ns", "p999 ns", "max ns", "frag");
+
+	for (const BenchmarkAllocator& Allocator : Allocators) {
+		if (("," + AllocatorList + ",").find(std::string(",") + Allocator.Name + ",") == std::string::npos) {
+			continue;
+		}
+
+		for (uint32_t Threads : ThreadCounts) {
+			Results.push_back(RunMixed(Allocator, Threads, OpsPerThread, TraceSizes));
+			PrintResult(Results.back());
+		}
+
+		// Replaying needs real frees and sizes.
+		if (!TraceOps.empty() && !Allocator.Reset && !Allocator.FixedSize) {
+			Results.push_back(RunTrace(Allocator, TraceOps));
+			PrintResult(Results.back());
+		}
+	}
+
+	ObjectPool::Release();
+	Memory::Shutdown();
+
+	if (JsonPath != nullptr) {
+		nlohmann::json Json;
+		Json["version"] = BENCHMARK_RESULT_VERSION;
+		Json["ops_per_thread"] = OpsPerThread;
+		Json["trace"] = TracePath != nullptr ? TracePath : "";
+		Json["results"] = nlohmann::json::array();
+		for (const BenchmarkResult& Result : Results) {
+			Json["results"].push_back(ToJson(Result));
+		}
+
+		std::ofstream Stream(JsonPath);
+		Stream << Json.dump(2) << "\n";
+		printf("\nResults written to '%s'.\n", JsonPath);
+	}
+
+	if (BaselinePath != nullptr) {
+		return CompareBaseline(BaselinePath, Results, Tolerance);
+	}
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+﻿#pragma once
+
+/**
+ * Measurement harness for the container benchmarks.
+ *
+ * BenchmarkMeasure() runs a case a few times untimed so caches, the allocator arena and the
+ * branch predictors are warm, then takes a number of timed samples and reports min, median and
+ * p99 in nanoseconds per operation. Cases smaller than BENCHMARK_MIN_SAMPLE_OPERATIONS are
+ * repeated inside one sample so that clock overhead does not dominate the small sizes.
+ */
+#include "Defines.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#define BENCHMARK_MIN_SAMPLE_OPERATIONS 100000		// 一个样本至少包含的操作数，规模小的用例在样本内重复
+
+struct BenchmarkConfig {
+	uint32_t Warmup = 2;
+	uint32_t Repetitions = 15;
+};
+
+struct BenchmarkStats {
+	double Min = 0.0;							// Nanoseconds per operation
+	double Median = 0.0;
+	double P99 = 0.0;
+	uint32_t Samples = 0;
+};
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+// Keeps results from being optimized away.
+inline volatile uint64_t BenchmarkSink = 0;
+
+inline BenchmarkStats BenchmarkSummarize(std::vector<double>& samples) {
+	BenchmarkStats Stats;
+	if (samples.empty()) {
+		return Stats;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	const size_t Count = samples.size();
+	Stats.Min = samples.front();
+	Stats.Median = (Count & 1) ? samples[Count / 2] : (samples[Count / 2 - 1] + samples[Count / 2]) * 0.5;
+	// Nearest rank, so with fewer than 100 samples this is the slowest one.
+	Stats.P99 = samples[(size_t)std::ceil(0.99 * (double)Count) - 1];
+	Stats.Samples = (uint32_t)Count;
+	return Stats;
+}
+
+/**
+ * @brief Times run(rounds), which must perform rounds * operations operations. setup(rounds) is
+ * called before every run, untimed, for cases that consume their input such as erase.
+ */
+template<typename Setup, typename Run>
+BenchmarkStats BenchmarkMeasure(const BenchmarkConfig& config, size_t operations, Setup&& setup, Run&& run) {
+	const size_t Operations = DMAX(operations, (size_t)1);
+	const size_t Rounds = DMAX((size_t)1, (size_t)BENCHMARK_MIN_SAMPLE_OPERATIONS / Operations);
+
+	for (uint32_t i = 0; i < config.Warmup; ++i) {
+		setup(Rounds);
+		run(Rounds);
+	}
+
+	std::vector<double> Samples;
+	Samples.reserve(config.Repetitions);
+	for (uint32_t i = 0; i < config.Repetitions; ++i) {
+		setup(Rounds);
+		BenchmarkClock::time_point Start = BenchmarkClock::now();
+		run(Rounds);
+		double Elapsed = std::chrono::duration<double, std::nano>(BenchmarkClock::now() - Start).count();
+		Samples.push_back(Elapsed / (double)(Rounds * Operations));
+	}
+
+	return BenchmarkSummarize(Samples);
+}
+
+template<typename Run>
+BenchmarkStats BenchmarkMeasure(const BenchmarkConfig& config, size_t operations, Run&& run) {
+	return BenchmarkMeasure(config, operations, [](size_t) {}, std::forward<Run>(run));
+}
+
+/**
+ * @brief Pins the calling thread to one CPU so samples do not pay for migrations.
+ * Returns false where the platform has no affinity call (macOS) or the CPU does not exist.
+ */
+inline bool BenchmarkPinThread(int cpu) {
+	if (cpu < 0) {
+		return false;
+	}
+
+#if defined(_WIN32)
+	if (cpu >= 64) {
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__)
+	cpu_set_t Set;
+	CPU_ZERO(&Set);
+	CPU_SET(cpu, &Set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set) == 0;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,889 @@
+﻿/**
+ * Benchmarks the engine containers against their std equivalents.
+ *
+ * Every case is measured with BenchmarkHarness.hpp: warm-up runs, then --reps timed samples,
+ * reported as min, median and p99 nanoseconds per operation. The last column is the median
+ * relative to the engine container of the same row group, so above 1.00x means the engine
+ * container is faster.
+ *
+ * Suites, each run at every size of --sizes:
+ *  - "array":  TArray against std::vector for uint64 and FString elements.
+ *              push (into an empty array, including the final free), iterate, lookup (random
+ *              index), erase (swap-remove at random positions until empty).
+ *  - "map":    TMap against the previous Robin Hood TMap (LegacyTMap.hpp) and
+ *              std::unordered_map on uint32 ids, FString names and object pointers.
+ *              insert, hit, miss, iterate, churn (remove a key and insert a new one with the
+ *              size held constant), erase.
+ *  - "set":    TSet against std::unordered_set. insert, hit, iterate, erase.
+ *  - "string": FString against std::string. format, append, copy (short strings), compare.
+ *  - "queue":  RingQueue and TSPSCQueue against std::deque. fill (push to the size, then pop
+ *              everything) and steady (one push and one pop at a shallow depth).
+ *              Once per run, independent of --sizes, the contention cases pass
+ *              BENCHMARK_QUEUE_CONTENTION_ITEMS integers from producer to consumer threads:
+ *              TMPMCQueue against a mutex-guarded std::deque at 1, 2, 4 and 8 producers and as
+ *              many consumers (capped at half the hardware threads), plus TSPSCQueue at 1P1C,
+ *              one element at a time and in batches of BENCHMARK_QUEUE_CONTENTION_BATCH.
+ *
+ * --json writes the results; --baseline compares against an earlier --json output and exits
+ * with 2 when a median regressed by more than the tolerance.
+ *
+ * Usage: ContainerBenchmark [--sizes 16,1024,65536,1048576,10000000] [--reps 15] [--warmup 2]
+ *                           [--suites array,map,set,string,queue] [--keys uint32,fstring,pointer]
+ *                           [--cpu <index>, -1 to not pin] [--json <out.json>]
+ *                           [--baseline <base.json>] [--tolerance 0.15]
+ */
+#include "Core/DMemory.hpp"
+#include "Containers/FString.hpp"
+#include "Containers/TArray.hpp"
+#include "Containers/TConcurrentQueue.hpp"
+#include "Containers/TMap.hpp"
+#include "Containers/TQueue.hpp"
+
+#include "BenchmarkHarness.hpp"
+#include "LegacyTMap.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#define BENCHMARK_ARENA_SIZE GIBIBYTES(1)		// 竞技场可增长，大规模用例不需要预留更多
+#define BENCHMARK_RESULT_VERSION 1
+#define BENCHMARK_QUEUE_STEADY_DEPTH 64			// steady 用例中队列保持的深度
+#define BENCHMARK_QUEUE_CONTENTION_ITEMS 1000000	// 竞争用例每个样本传递的元素总数
+#define BENCHMARK_QUEUE_CONTENTION_BATCH 32		// 竞争用例批量接口每次读写的个数
+#define BENCHMARK_QUEUE_CONTENTION_CAPACITY 4096	// 竞争用例的队列容量
+
+struct BenchmarkResult {
+	std::string Suite;
+	std::string Element;
+	std::string Case;
+	std::string Container;
+	size_t Size = 0;
+	BenchmarkStats Stats;
+};
+
+static BenchmarkConfig Config;
+static std::vector<BenchmarkResult> Results;
+
+static void Report(const char* suite, const char* element, const char* op, const char* container, size_t size, const BenchmarkStats& stats) {
+	BenchmarkResult Result{ suite, element, op, container, size, stats };
+
+	// The first container of a group is the engine one, the others are compared with it.
+	double Relative = 1.0;
+	for (const BenchmarkResult& Other : Results) {
+		if (Other.Suite == Result.Suite && Other.Element == Result.Element && Other.Case == Result.Case && Other.Size == Result.Size) {
+			Relative = Other.Stats.Median > 0.0 ? stats.Median / Other.Stats.Median : 0.0;
+			break;
+		}
+	}
+
+	printf("%-6s %-8s %-8s %-14s %9zu %10.2f %10.2f %10.2f %7.2fx\n", suite, element, op, container, size,
+		stats.Min, stats.Median, stats.P99, Relative);
+	Results.push_back(Result);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Elements
+
+struct BenchmarkObject {
+	uint64_t Payload[4];
+};
+
+static void GenerateIds(size_t count, std::mt19937_64& rng, std::vector<uint32_t>& out_present, std::vector<uint32_t>& out_absent) {
+	// Sequential-ish ids with gaps, the way entity and component ids are handed out.
+	std::vector<uint32_t> Ids(count * 2);
+	for (size_t i = 0; i < Ids.size(); ++i) {
+		Ids[i] = (uint32_t)(i * 3 + 1);
+	}
+	std::shuffle(Ids.begin(), Ids.end(), rng);
+	out_present.assign(Ids.begin(), Ids.begin() + count);
+	out_absent.assign(Ids.begin() + count, Ids.end());
+}
+
+// Asset-like names sharing a long prefix, which is what font and texture names look like.
+static FString MakeName(uint32_t id) {
+	return FString::Format("Assets/Fonts/Font_%u.ttf", id);
+}
+
+static uint64_t Weigh(uint64_t value) { return value; }
+static uint64_t Weigh(uint32_t value) { return value; }
+static uint64_t Weigh(const FString& value) { return value.Length(); }
+static uint64_t Weigh(const std::string& value) { return value.size(); }
+static uint64_t Weigh(const BenchmarkObject* value) { return (uint64_t)(uintptr_t)value; }
+
+// ---------------------------------------------------------------------------------------------
+// Arrays
+
+template<typename T> static void ArrayPush(TArray<T>& array, const T& value) { array.Push(value); }
+template<typename T> static void ArrayPush(std::vector<T>& array, const T& value) { array.push_back(value); }
+
+template<typename T> static void ArrayRemoveSwap(TArray<T>& array, size_t index) { array.RemoveSwap(index); }
+template<typename T> static void ArrayRemoveSwap(std::vector<T>& array, size_t index) {
+	if (index != array.size() - 1) {
+		array[index] = std::move(array.back());
+	}
+	array.pop_back();
+}
+
+template<typename Array, typename T>
+static void RunArrayCases(const char* container, const char* element, const std::vector<T>& values, const std::vector<uint32_t>& order) {
+	const size_t Count = values.size();
+
+	Report("array", element, "push", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		for (size_t r = 0; r < rounds; ++r) {
+			Array A;
+			for (size_t i = 0; i < Count; ++i) {
+				ArrayPush(A, values[i]);
+			}
+			BenchmarkSink = BenchmarkSink + (uint64_t)(A.end() - A.begin());
+		}
+	}));
+
+	Array Filled;
+	for (size_t i = 0; i < Count; ++i) {
+		ArrayPush(Filled, values[i]);
+	}
+
+	Report("array", element, "iterate", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (const T& Value : Filled) {
+				Sum += Weigh(Value);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	Report("array", element, "lookup", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < Count; ++i) {
+				Sum += Weigh(Filled[order[i]]);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	std::vector<Array> Victims;
+	Report("array", element, "erase", container, Count, BenchmarkMeasure(Config, Count,
+		[&](size_t rounds) {
+			Victims.clear();
+			Victims.resize(rounds);
+			for (Array& A : Victims) {
+				for (size_t i = 0; i < Count; ++i) {
+					ArrayPush(A, values[i]);
+				}
+			}
+		},
+		[&](size_t rounds) {
+			for (size_t r = 0; r < rounds; ++r) {
+				Array& A = Victims[r];
+				for (size_t i = 0; i < Count; ++i) {
+					ArrayRemoveSwap(A, order[i] % (Count - i));
+				}
+			}
+		}));
+}
+
+static void RunArraySuite(size_t count, std::mt19937_64& rng) {
+	std::vector<uint32_t> Present, Absent;
+	GenerateIds(count, rng, Present, Absent);
+
+	std::vector<uint32_t> Order(count);
+	for (size_t i = 0; i < count; ++i) {
+		Order[i] = (uint32_t)i;
+	}
+	std::shuffle(Order.begin(), Order.end(), rng);
+
+	std::vector<uint64_t> Numbers(Present.begin(), Present.end());
+	RunArrayCases<TArray<uint64_t>>("TArray", "uint64", Numbers, Order);
+	RunArrayCases<std::vector<uint64_t>>("std::vector", "uint64", Numbers, Order);
+
+	std::vector<FString> Names;
+	Names.reserve(count);
+	for (uint32_t Id : Present) Names.push_back(FString::Format("Element_%u", Id));
+	RunArrayCases<TArray<FString>>("TArray", "fstring", Names, Order);
+	RunArrayCases<std::vector<FString>>("std::vector", "fstring", Names, Order);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Maps and sets, all used through the same calls
+
+template<typename K>
+using TStdMap = std::unordered_map<K, uint64_t>;
+
+template<typename K> static void MapInsert(TMap<K, uint64_t>& map, const K& key, uint64_t value) { map.Insert(key, value); }
+template<typename K> static void MapInsert(TLegacyMap<K, uint64_t>& map, const K& key, uint64_t value) { map.Insert(key, value); }
+template<typename K> static void MapInsert(TStdMap<K>& map, const K& key, uint64_t value) { map[key] = value; }
+
+template<typename K> static const uint64_t* MapFind(const TMap<K, uint64_t>& map, const K& key) { return map.Find(key); }
+template<typename K> static const uint64_t* MapFind(const TLegacyMap<K, uint64_t>& map, const K& key) { return map.Find(key); }
+template<typename K> static const uint64_t* MapFind(const TStdMap<K>& map, const K& key) {
+	auto It = map.find(key);
+	return It == map.end() ? nullptr : &It->second;
+}
+
+template<typename K> static void MapRemove(TMap<K, uint64_t>& map, const K& key) { map.Remove(key); }
+template<typename K> static void MapRemove(TLegacyMap<K, uint64_t>& map, const K& key) { map.Remove(key); }
+template<typename K> static void MapRemove(TStdMap<K>& map, const K& key) { map.erase(key); }
+
+template<typename Pair> static uint64_t MapValue(const Pair& pair) { return pair.Value; }
+template<typename K> static uint64_t MapValue(const std::pair<const K, uint64_t>& pair) { return pair.second; }
+
+template<typename K> static void SetInsert(TSet<K>& set, const K& key) { set.Insert(key); }
+template<typename K> static void SetInsert(std::unordered_set<K>& set, const K& key) { set.insert(key); }
+
+template<typename K> static bool SetContains(const TSet<K>& set, const K& key) { return set.Contains(key); }
+template<typename K> static bool SetContains(const std::unordered_set<K>& set, const K& key) { return set.count(key) != 0; }
+
+template<typename K> static void SetRemove(TSet<K>& set, const K& key) { set.Remove(key); }
+template<typename K> static void SetRemove(std::unordered_set<K>& set, const K& key) { set.erase(key); }
+
+template<typename K>
+struct KeySet {
+	std::vector<K> Present;					// Inserted before the lookups
+	std::vector<K> Absent;					// Never inserted, also the supply of new keys for churn
+};
+
+static KeySet<uint32_t> MakeUInt32Keys(size_t count, std::mt19937_64& rng) {
+	KeySet<uint32_t> Keys;
+	GenerateIds(count, rng, Keys.Present, Keys.Absent);
+	return Keys;
+}
+
+static KeySet<FString> MakeFStringKeys(size_t count, std::mt19937_64& rng) {
+	std::vector<uint32_t> Present, Absent;
+	GenerateIds(count, rng, Present, Absent);
+	KeySet<FString> Keys;
+	Keys.Present.reserve(count);
+	Keys.Absent.reserve(count);
+	for (uint32_t Id : Present) Keys.Present.push_back(MakeName(Id));
+	for (uint32_t Id : Absent) Keys.Absent.push_back(MakeName(Id));
+	return Keys;
+}
+
+static KeySet<BenchmarkObject*> MakePointerKeys(size_t count, std::mt19937_64& rng, std::vector<BenchmarkObject>& storage) {
+	storage.assign(count * 2, BenchmarkObject{});
+	std::vector<uint32_t> Present, Absent;
+	GenerateIds(count, rng, Present, Absent);
+	KeySet<BenchmarkObject*> Keys;
+	for (uint32_t Id : Present) Keys.Present.push_back(&storage[Id / 3]);
+	for (uint32_t Id : Absent) Keys.Absent.push_back(&storage[Id / 3]);
+	return Keys;
+}
+
+template<typename Map, typename K>
+static void RunMapCases(const char* container, const char* key_name, const KeySet<K>& keys) {
+	const size_t Count = keys.Present.size();
+
+	Report("map", key_name, "insert", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		for (size_t r = 0; r < rounds; ++r) {
+			Map M;
+			for (size_t i = 0; i < Count; ++i) {
+				MapInsert(M, keys.Present[i], (uint64_t)i);
+			}
+		}
+	}));
+
+	Map Filled;
+	for (size_t i = 0; i < Count; ++i) {
+		MapInsert(Filled, keys.Present[i], (uint64_t)i);
+	}
+
+	Report("map", key_name, "hit", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < Count; ++i) {
+				Sum += *MapFind(Filled, keys.Present[i]);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	Report("map", key_name, "miss", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < Count; ++i) {
+				Sum += MapFind(Filled, keys.Absent[i]) != nullptr;
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	Report("map", key_name, "iterate", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (const auto& Pair : Filled) {
+				Sum += MapValue(Pair);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	// Swap the present half out for the absent one and back, one key at a time, so every run
+	// leaves the map with the keys it started with.
+	Report("map", key_name, "churn", container, Count, BenchmarkMeasure(Config, Count * 2, [&](size_t rounds) {
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < Count; ++i) {
+				MapRemove(Filled, keys.Present[i]);
+				MapInsert(Filled, keys.Absent[i], (uint64_t)i);
+			}
+			for (size_t i = 0; i < Count; ++i) {
+				MapRemove(Filled, keys.Absent[i]);
+				MapInsert(Filled, keys.Present[i], (uint64_t)i);
+			}
+		}
+	}));
+
+	std::vector<Map> Victims;
+	Report("map", key_name, "erase", container, Count, BenchmarkMeasure(Config, Count,
+		[&](size_t rounds) {
+			Victims.clear();
+			Victims.resize(rounds);
+			for (Map& M : Victims) {
+				for (size_t i = 0; i < Count; ++i) {
+					MapInsert(M, keys.Present[i], (uint64_t)i);
+				}
+			}
+		},
+		[&](size_t rounds) {
+			for (size_t r = 0; r < rounds; ++r) {
+				for (size_t i = 0; i < Count; ++i) {
+					MapRemove(Victims[r], keys.Present[i]);
+				}
+			}
+		}));
+}
+
+template<typename K>
+static void RunMapSuite(const char* key_name, const KeySet<K>& keys) {
+	RunMapCases<TMap<K, uint64_t>>("TMap", key_name, keys);
+	RunMapCases<TLegacyMap<K, uint64_t>>("legacy TMap", key_name, keys);
+	RunMapCases<TStdMap<K>>("unordered_map", key_name, keys);
+}
+
+template<typename Set, typename K>
+static void RunSetCases(const char* container, const char* key_name, const KeySet<K>& keys) {
+	const size_t Count = keys.Present.size();
+
+	Report("set", key_name, "insert", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		for (size_t r = 0; r < rounds; ++r) {
+			Set S;
+			for (size_t i = 0; i < Count; ++i) {
+				SetInsert(S, keys.Present[i]);
+			}
+		}
+	}));
+
+	Set Filled;
+	for (size_t i = 0; i < Count; ++i) {
+		SetInsert(Filled, keys.Present[i]);
+	}
+
+	Report("set", key_name, "hit", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < Count; ++i) {
+				Sum += SetContains(Filled, keys.Present[i]);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	Report("set", key_name, "iterate", container, Count, BenchmarkMeasure(Config, Count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (const K& Key : Filled) {
+				Sum += Weigh(Key);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	std::vector<Set> Victims;
+	Report("set", key_name, "erase", container, Count, BenchmarkMeasure(Config, Count,
+		[&](size_t rounds) {
+			Victims.clear();
+			Victims.resize(rounds);
+			for (Set& S : Victims) {
+				for (size_t i = 0; i < Count; ++i) {
+					SetInsert(S, keys.Present[i]);
+				}
+			}
+		},
+		[&](size_t rounds) {
+			for (size_t r = 0; r < rounds; ++r) {
+				for (size_t i = 0; i < Count; ++i) {
+					SetRemove(Victims[r], keys.Present[i]);
+				}
+			}
+		}));
+}
+
+template<typename K>
+static void RunSetSuite(const char* key_name, const KeySet<K>& keys) {
+	RunSetCases<TSet<K>>("TSet", key_name, keys);
+	RunSetCases<std::unordered_set<K>>("unordered_set", key_name, keys);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Strings
+
+static FString FormatName(FString*, uint32_t id) {
+	return FString::Format("Assets/Textures/Texture_%u.png", id);
+}
+
+static std::string FormatName(std::string*, uint32_t id) {
+	char Buffer[64];
+	int Length = snprintf(Buffer, sizeof(Buffer), "Assets/Textures/Texture_%u.png", id);
+	return std::string(Buffer, (size_t)Length);
+}
+
+template<typename String>
+static void RunStringCases(const char* container, size_t count, const std::vector<uint32_t>& ids) {
+	Report("string", "ascii", "format", container, count, BenchmarkMeasure(Config, count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				Sum += Weigh(FormatName((String*)nullptr, ids[i]));
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	Report("string", "ascii", "append", container, count, BenchmarkMeasure(Config, count, [&](size_t rounds) {
+		for (size_t r = 0; r < rounds; ++r) {
+			String S;
+			for (size_t i = 0; i < count; ++i) {
+				S += "ab";
+			}
+			BenchmarkSink = BenchmarkSink + Weigh(S);
+		}
+	}));
+
+	// Short names fit the inline storage of both strings.
+	std::vector<String> Sources, Others;
+	Sources.reserve(count);
+	Others.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		char Buffer[32];
+		snprintf(Buffer, sizeof(Buffer), "Mat_%u", ids[i]);
+		Sources.push_back(String(Buffer));
+		Others.push_back(String(Buffer));
+	}
+
+	Report("string", "ascii", "copy", container, count, BenchmarkMeasure(Config, count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				String Copy(Sources[i]);
+				Sum += Weigh(Copy);
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	Report("string", "ascii", "compare", container, count, BenchmarkMeasure(Config, count, [&](size_t rounds) {
+		uint64_t Sum = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				Sum += Sources[i] == Others[count - 1 - i];
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+}
+
+static void RunStringSuite(size_t count, std::mt19937_64& rng) {
+	std::vector<uint32_t> Present, Absent;
+	GenerateIds(count, rng, Present, Absent);
+	RunStringCases<FString>("FString", count, Present);
+	RunStringCases<std::string>("std::string", count, Present);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Queues
+
+static bool QueuePush(RingQueue<uint64_t>& queue, uint64_t value) { return queue.Enqueue(&value); }
+static bool QueuePush(TSPSCQueue<uint64_t>& queue, uint64_t value) { return queue.Push(value); }
+static bool QueuePush(std::deque<uint64_t>& queue, uint64_t value) { queue.push_back(value); return true; }
+
+static bool QueuePop(RingQueue<uint64_t>& queue, uint64_t& out_value) { return queue.Dequeue(&out_value); }
+static bool QueuePop(TSPSCQueue<uint64_t>& queue, uint64_t& out_value) { return queue.Pop(out_value); }
+static bool QueuePop(std::deque<uint64_t>& queue, uint64_t& out_value) {
+	if (queue.empty()) {
+		return false;
+	}
+	out_value = queue.front();
+	queue.pop_front();
+	return true;
+}
+
+template<typename Queue>
+static void RunQueueCases(const char* container, Queue& queue, size_t count) {
+	Report("queue", "uint64", "fill", container, count, BenchmarkMeasure(Config, count * 2, [&](size_t rounds) {
+		uint64_t Sum = 0, Value = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				QueuePush(queue, (uint64_t)i);
+			}
+			while (QueuePop(queue, Value)) {
+				Sum += Value;
+			}
+		}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+
+	const size_t Depth = DMIN(count, (size_t)BENCHMARK_QUEUE_STEADY_DEPTH);
+	Report("queue", "uint64", "steady", container, count, BenchmarkMeasure(Config, count * 2, [&](size_t rounds) {
+		uint64_t Sum = 0, Value = 0;
+		for (size_t i = 0; i + 1 < Depth; ++i) {
+			QueuePush(queue, (uint64_t)i);
+		}
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				QueuePush(queue, (uint64_t)i);
+				QueuePop(queue, Value);
+				Sum += Value;
+			}
+		}
+		while (QueuePop(queue, Value)) {}
+		BenchmarkSink = BenchmarkSink + Sum;
+	}));
+}
+
+static void RunQueueSuite(size_t count) {
+	if (count > 0xFFFFFFFFull) {
+		return;
+	}
+
+	RingQueue<uint64_t> Ring((uint32_t)count);
+	RunQueueCases("RingQueue", Ring, count);
+
+	TSPSCQueue<uint64_t> SPSC((uint32_t)count);
+	RunQueueCases("TSPSCQueue", SPSC, count);
+
+	std::deque<uint64_t> Deque;
+	RunQueueCases("std::deque", Deque, count);
+}
+
+// Mutex-guarded std::deque with the interface of the lock-free queues, as the contention baseline.
+template<typename T>
+class LockedQueue {
+public:
+	explicit LockedQueue(uint32_t capacity) : Capacity(capacity) {}
+
+	bool Push(const T& value) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (Items.size() >= Capacity) {
+			return false;
+		}
+		Items.push_back(value);
+		return true;
+	}
+
+	bool Pop(T& out_value) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (Items.empty()) {
+			return false;
+		}
+		out_value = Items.front();
+		Items.pop_front();
+		return true;
+	}
+
+	uint32_t PushBatch(const T* values, uint32_t count) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		uint32_t Count = DMIN(count, Capacity - (uint32_t)Items.size());
+		Items.insert(Items.end(), values, values + Count);
+		return Count;
+	}
+
+	uint32_t PopBatch(T* out_values, uint32_t max_count) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		uint32_t Count = DMIN(max_count, (uint32_t)Items.size());
+		std::copy(Items.begin(), Items.begin() + Count, out_values);
+		Items.erase(Items.begin(), Items.begin() + Count);
+		return Count;
+	}
+
+private:
+	std::mutex Mutex;
+	std::deque<T> Items;
+	uint32_t Capacity;
+};
+
+// Spins first when the queue is full or empty, then yields so oversubscribed runs still progress.
+static inline void QueueBackoff(uint32_t& spins) {
+	if (++spins < 64) {
+		DCPU_PAUSE();
+	}
+	else {
+		spins = 0;
+		std::this_thread::yield();
+	}
+}
+
+// Producer p pushes [p * per, (p + 1) * per); consumers pop until everything has arrived.
+template<typename Queue>
+static void QueueTransfer(Queue& queue, uint32_t producers, uint32_t consumers, uint64_t total, uint32_t batch) {
+	const uint64_t PerProducer = total / producers;
+	const uint64_t Expected = PerProducer * producers;
+	std::atomic<uint64_t> Received{ 0 };
+	std::atomic<uint64_t> Sum{ 0 };
+	std::vector<std::thread> Threads;
+
+	for (uint32_t p = 0; p < producers; ++p) {
+		Threads.emplace_back([&, p]() {
+			std::vector<uint64_t> Values(batch);
+			uint64_t Next = p * PerProducer;
+			const uint64_t End = Next + PerProducer;
+			uint32_t Spins = 0;
+			while (Next < End) {
+				if (batch <= 1) {
+					if (!queue.Push(Next)) { QueueBackoff(Spins); continue; }
+					++Next;
+				}
+				else {
+					uint32_t Count = (uint32_t)DMIN((uint64_t)batch, End - Next);
+					for (uint32_t i = 0; i < Count; ++i) Values[i] = Next + i;
+					uint32_t Pushed = queue.PushBatch(Values.data(), Count);
+					if (Pushed == 0) QueueBackoff(Spins);
+					Next += Pushed;
+				}
+			}
+		});
+	}
+
+	for (uint32_t c = 0; c < consumers; ++c) {
+		Threads.emplace_back([&]() {
+			std::vector<uint64_t> Values(DMAX(batch, 1u));
+			uint64_t LocalSum = 0;
+			uint32_t Spins = 0;
+			while (Received.load(std::memory_order_relaxed) < Expected) {
+				uint32_t Count = batch <= 1 ? (queue.Pop(Values[0]) ? 1 : 0) : queue.PopBatch(Values.data(), batch);
+				if (Count == 0) { QueueBackoff(Spins); continue; }
+				for (uint32_t i = 0; i < Count; ++i) LocalSum += Values[i];
+				Received.fetch_add(Count, std::memory_order_relaxed);
+			}
+			Sum.fetch_add(LocalSum, std::memory_order_relaxed);
+		});
+	}
+
+	for (std::thread& Thread : Threads) {
+		Thread.join();
+	}
+	BenchmarkSink = BenchmarkSink + Sum.load();
+}
+
+template<typename Queue>
+static void RunQueueContentionCase(const char* container, uint32_t producers, uint32_t consumers, uint32_t batch) {
+	char Case[32];
+	snprintf(Case, sizeof(Case), "%uP%uC/%u", producers, consumers, batch);
+
+	Queue Q(BENCHMARK_QUEUE_CONTENTION_CAPACITY);
+	Report("queue", "uint64", Case, container, BENCHMARK_QUEUE_CONTENTION_ITEMS, BenchmarkMeasure(Config, BENCHMARK_QUEUE_CONTENTION_ITEMS, [&](size_t rounds) {
+		for (size_t r = 0; r < rounds; ++r) {
+			QueueTransfer(Q, producers, consumers, BENCHMARK_QUEUE_CONTENTION_ITEMS, batch);
+		}
+	}));
+}
+
+// Thread creation is part of every sample, which the item count keeps small.
+// TMPMCQueue leads each group, so the single-producer rows also compare TSPSCQueue with it.
+static void RunQueueContentionSuite() {
+	const uint32_t MaxThreads = DMIN(DMAX(std::thread::hardware_concurrency() / 2, 1u), 8u);
+	for (uint32_t Threads = 1; Threads <= MaxThreads; Threads *= 2) {
+		for (uint32_t Batch : { 1u, (uint32_t)BENCHMARK_QUEUE_CONTENTION_BATCH }) {
+			RunQueueContentionCase<TMPMCQueue<uint64_t>>("TMPMCQueue", Threads, Threads, Batch);
+			RunQueueContentionCase<LockedQueue<uint64_t>>("mutex+deque", Threads, Threads, Batch);
+			if (Threads == 1) {
+				RunQueueContentionCase<TSPSCQueue<uint64_t>>("TSPSCQueue", 1, 1, Batch);
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------
+// Reporting
+
+static nlohmann::json ToJson(const BenchmarkResult& result) {
+	nlohmann::json Json;
+	Json["suite"] = result.Suite;
+	Json["element"] = result.Element;
+	Json["case"] = result.Case;
+	Json["container"] = result.Container;
+	Json["size"] = result.Size;
+	Json["samples"] = result.Stats.Samples;
+	Json["min_ns"] = result.Stats.Min;
+	Json["median_ns"] = result.Stats.Median;
+	Json["p99_ns"] = result.Stats.P99;
+	return Json;
+}
+
+static int CompareBaseline(const char* path, double tolerance) {
+	std::ifstream Stream(path);
+	if (!Stream.is_open()) {
+		printf("Unable to open baseline '%s'.\n", path);
+		return 1;
+	}
+
+	nlohmann::json Baseline = nlohmann::json::parse(Stream, nullptr, false);
+	if (Baseline.is_discarded() || !Baseline.contains("results")) {
+		printf("'%s' is not a benchmark result file.\n", path);
+		return 1;
+	}
+
+	uint32_t Regressions = 0;
+	printf("\nCompared with '%s' (tolerance %.0f%%):\n", path, tolerance * 100.0);
+	for (const nlohmann::json& Base : Baseline["results"]) {
+		for (const BenchmarkResult& Result : Results) {
+			if (Base.value("suite", "") != Result.Suite || Base.value("element", "") != Result.Element ||
+				Base.value("case", "") != Result.Case || Base.value("container", "") != Result.Container ||
+				Base.value("size", (size_t)0) != Result.Size) {
+				continue;
+			}
+
+			double BaseMedian = Base.value("median_ns", 0.0);
+			if (BaseMedian > 0.0 && Result.Stats.Median > BaseMedian * (1.0 + tolerance)) {
+				Regressions++;
+				printf(" REGRESSION %-6s %-8s %-8s %-14s %9zu: median %.2f -> %.2f ns\n", Result.Suite.c_str(), Result.Element.c_str(),
+					Result.Case.c_str(), Result.Container.c_str(), Result.Size, BaseMedian, Result.Stats.Median);
+			}
+		}
+	}
+
+	if (Regressions == 0) {
+		printf(" No regressions.\n");
+		return 0;
+	}
+	return 2;
+}
+
+// ---------------------------------------------------------------------------------------------
+
+static std::vector<size_t> ParseSizeList(const char* list) {
+	std::vector<size_t> Sizes;
+	const char* p = list;
+	while (*p) {
+		size_t Size = (size_t)strtoull(p, (char**)&p, 10);
+		if (Size > 0) Sizes.push_back(Size);
+		if (*p == ',') ++p;
+		else if (*p) break;
+	}
+	return Sizes;
+}
+
+static bool IsSelected(const std::string& list, const char* name) {
+	return ("," + list + ",").find(std::string(",") + name + ",") != std::string::npos;
+}
+
+int main(int argc, char** argv) {
+	std::vector<size_t> Sizes = { 16, 1024, 65536, 1048576, 10000000 };
+	std::string SuiteList = "array,map,set,string,queue";
+	std::string KeyList = "uint32,fstring,pointer";
+	int Cpu = (int)DMAX(std::thread::hardware_concurrency(), 1u) - 1;
+	const char* JsonPath = nullptr;
+	const char* BaselinePath = nullptr;
+	double Tolerance = 0.15;
+
+	for (int i = 1; i < argc; ++i) {
+		bool HasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--sizes") == 0 && HasValue) Sizes = ParseSizeList(argv[++i]);
+		else if (strcmp(argv[i], "--reps") == 0 && HasValue) Config.Repetitions = (uint32_t)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--warmup") == 0 && HasValue) Config.Warmup = (uint32_t)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--suites") == 0 && HasValue) SuiteList = argv[++i];
+		else if (strcmp(argv[i], "--keys") == 0 && HasValue) KeyList = argv[++i];
+		else if (strcmp(argv[i], "--cpu") == 0 && HasValue) Cpu = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--json") == 0 && HasValue) JsonPath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && HasValue) BaselinePath = argv[++i];
+		else if (strcmp(argv[i], "--tolerance") == 0 && HasValue) Tolerance = atof(argv[++i]);
+		else {
+			printf("Usage: %s [--sizes 16,1024,65536,1048576,10000000] [--reps 15] [--warmup 2]\n"
+				"          [--suites array,map,set,string,queue] [--keys uint32,fstring,pointer]\n"
+				"          [--cpu <index>, -1 to not pin] [--json <out.json>] [--baseline <base.json>] [--tolerance 0.15]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	Config.Repetitions = DMAX(Config.Repetitions, 1u);
+
+	if (Cpu >= 0 && !BenchmarkPinThread(Cpu)) {
+		printf("Unable to pin to CPU %d, running unpinned.\n", Cpu);
+		Cpu = -1;
+	}
+
+	if (!Memory::Initialize(BENCHMARK_ARENA_SIZE)) {
+		printf("Memory system failed to initialize.\n");
+		return 1;
+	}
+
+	{
+		printf("%-6s %-8s %-8s %-14s %9s %10s %10s %10s %8s\n", "suite", "element", "case", "container", "size",
+			"min ns", "median ns", "p99 ns", "vs eng");
+
+		std::mt19937_64 Rng(0xD1CE);
+		std::vector<BenchmarkObject> Objects;
+		for (size_t Size : Sizes) {
+			if (IsSelected(SuiteList, "array")) RunArraySuite(Size, Rng);
+
+			if (IsSelected(SuiteList, "map") || IsSelected(SuiteList, "set")) {
+				if (IsSelected(KeyList, "uint32")) {
+					KeySet<uint32_t> Keys = MakeUInt32Keys(Size, Rng);
+					if (IsSelected(SuiteList, "map")) RunMapSuite("uint32", Keys);
+					if (IsSelected(SuiteList, "set")) RunSetSuite("uint32", Keys);
+				}
+				if (IsSelected(KeyList, "fstring")) {
+					KeySet<FString> Keys = MakeFStringKeys(Size, Rng);
+					if (IsSelected(SuiteList, "map")) RunMapSuite("fstring", Keys);
+					if (IsSelected(SuiteList, "set")) RunSetSuite("fstring", Keys);
+				}
+				if (IsSelected(KeyList, "pointer") && IsSelected(SuiteList, "map")) {
+					RunMapSuite("pointer", MakePointerKeys(Size, Rng, Objects));
+				}
+			}
+
+			if (IsSelected(SuiteList, "string")) RunStringSuite(Size, Rng);
+			if (IsSelected(SuiteList, "queue")) RunQueueSuite(Size);
+		}
+
+		if (IsSelected(SuiteList, "queue")) RunQueueContentionSuite();
+	}
+
+	Memory::Shutdown();
+
+	if (JsonPath != nullptr) {
+		nlohmann::json Json;
+		Json["version"] = BENCHMARK_RESULT_VERSION;
+		Json["warmup"] = Config.Warmup;
+		Json["repetitions"] = Config.Repetitions;
+		Json["cpu"] = Cpu;
+		Json["results"] = nlohmann::json::array();
+		for (const BenchmarkResult& Result : Results) {
+			Json["results"].push_back(ToJson(Result));
+		}
+
+		std::ofstream Stream(JsonPath);
+		Stream << Json.dump(2) << "\n";
+		printf("\nResults written to '%s'.\n", JsonPath);
+	}
+
+	if (BaselinePath != nullptr) {
+		return CompareBaseline(BaselinePath, Tolerance);
+	}
+
+	return 0;
+}
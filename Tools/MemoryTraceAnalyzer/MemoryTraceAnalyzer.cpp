@@ -0,0 +1,309 @@
+﻿/**
+ * Reads a memory trace written by MemoryTrace (engine built with DMEMORY_TRACE) and reports
+ * the top allocators of the frame loop, allocation lifetimes, peak usage per tag and the
+ * blocks still alive at Memory::Shutdown().
+ *
+ * Usage: MemoryTraceAnalyzer <trace.dmt> [top count]
+ */
+#include "Memory/MemoryTraceFormat.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#define LIFETIME_BUCKET_COUNT 10			// <1us, <10us ... <100s, >=100s
+
+struct LiveBlock {
+	uint64_t Size;
+	uint64_t CallSite;
+	uint64_t Timestamp;
+	uint16_t Type;
+	uint8_t Flags;
+};
+
+struct CallSiteStats {
+	uint64_t CallSite = 0;
+	uint64_t FrameCount = 0;				// Allocations made inside the frame loop
+	uint64_t FrameBytes = 0;
+	uint64_t LeakCount = 0;
+	uint64_t LeakBytes = 0;
+	uint16_t Type = 0;
+};
+
+struct TagStats {
+	uint64_t Current = 0;
+	uint64_t Peak = 0;
+	uint64_t Count = 0;
+};
+
+static bool ReadTrace(const char* path, MemoryTraceHeader& out_header, std::vector<std::string>& out_types, std::vector<MemoryTraceEvent>& out_events) {
+	FILE* File = fopen(path, "rb");
+	if (File == nullptr) {
+		printf("Unable to open '%s'.\n", path);
+		return false;
+	}
+
+	if (fread(&out_header, sizeof(out_header), 1, File) != 1 || out_header.Magic != MEMORY_TRACE_MAGIC) {
+		printf("'%s' is not a memory trace.\n", path);
+		fclose(File);
+		return false;
+	}
+
+	if (out_header.Version != MEMORY_TRACE_VERSION || out_header.EventSize != sizeof(MemoryTraceEvent)) {
+		printf("'%s' was written by an incompatible version (%u, event size %u).\n", path, out_header.Version, out_header.EventSize);
+		fclose(File);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < out_header.TypeCount; ++i) {
+		MemoryTraceTypeName TypeName;
+		if (fread(&TypeName, sizeof(TypeName), 1, File) != 1) {
+			printf("'%s' is truncated.\n", path);
+			fclose(File);
+			return false;
+		}
+		TypeName.Name[sizeof(TypeName.Name) - 1] = '\0';
+		out_types.push_back(TypeName.Name);
+	}
+
+	MemoryTraceEvent Chunk[4096];
+	size_t Read = 0;
+	while ((Read = fread(Chunk, sizeof(MemoryTraceEvent), 4096, File)) > 0) {
+		out_events.insert(out_events.end(), Chunk, Chunk + Read);
+	}
+
+	fclose(File);
+
+	// Threads flush their buffers independently.
+	std::stable_sort(out_events.begin(), out_events.end(), [](const MemoryTraceEvent& a, const MemoryTraceEvent& b) {
+		return a.Timestamp < b.Timestamp;
+	});
+
+	return true;
+}
+
+static const char* GetTypeName(const std::vector<std::string>& types, uint16_t type) {
+	return type < types.size() ? types[type].c_str() : "?";
+}
+
+static void PrintCallSite(uint64_t call_site, uint64_t anchor) {
+	printf("0x%016llx (anchor%+lld)", (unsigned long long)call_site, (long long)(call_site - anchor));
+}
+
+static void PrintSize(double bytes) {
+	if (bytes >= 1024.0 * 1024.0 * 1024.0) {
+		printf("%9.2f GiB", bytes / (1024.0 * 1024.0 * 1024.0));
+	}
+	else if (bytes >= 1024.0 * 1024.0) {
+		printf("%9.2f MiB", bytes / (1024.0 * 1024.0));
+	}
+	else if (bytes >= 1024.0) {
+		printf("%9.2f KiB", bytes / 1024.0);
+	}
+	else {
+		printf("%9.2f B  ", bytes);
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("Usage: %s <trace.dmt> [top count]\n", argv[0]);
+		return 1;
+	}
+
+	size_t TopCount = argc > 2 ? (size_t)atoi(argv[2]) : 20;
+
+	MemoryTraceHeader Header;
+	std::vector<std::string> Types;
+	std::vector<MemoryTraceEvent> Events;
+	if (!ReadTrace(argv[1], Header, Types, Events)) {
+		return 1;
+	}
+
+	std::unordered_map<uint64_t, LiveBlock> Live;
+	std::unordered_map<uint64_t, CallSiteStats> CallSites;
+	std::unordered_set<uint32_t> Threads;
+	std::vector<TagStats> Tags(Header.TypeCount > 0 ? Header.TypeCount : 1);
+	uint64_t Lifetimes[LIFETIME_BUCKET_COUNT] = {};
+
+	uint64_t CurrentFrame = 0;
+	uint64_t FrameCount = 0;
+	uint64_t FrameAllocations = 0;
+	uint64_t BusiestFrame = 0;
+	uint64_t BusiestFrameCount = 0;
+	uint64_t UnmatchedFrees = 0;
+	bool ReachedShutdown = false;
+
+	for (const MemoryTraceEvent& Event : Events) {
+		Threads.insert(Event.ThreadId);
+
+		if (Event.Op == eMemory_Trace_Shutdown) {
+			ReachedShutdown = true;
+			break;
+		}
+
+		if (Event.Op == eMemory_Trace_Frame) {
+			if (CurrentFrame != 0 && FrameAllocations > BusiestFrameCount) {
+				BusiestFrame = CurrentFrame;
+				BusiestFrameCount = FrameAllocations;
+			}
+			CurrentFrame = Event.Size;
+			FrameAllocations = 0;
+			FrameCount++;
+			continue;
+		}
+
+		uint16_t Type = Event.Type < Tags.size() ? Event.Type : 0;
+		bool Counted = (Event.Flags & MEMORY_TRACE_FLAG_SUB_ALLOCATION) == 0;
+
+		if (Event.Op == eMemory_Trace_Allocate) {
+			Live[Event.Address] = LiveBlock{ Event.Size, Event.CallSite, Event.Timestamp, Type, Event.Flags };
+
+			CallSiteStats& Site = CallSites[Event.CallSite];
+			Site.CallSite = Event.CallSite;
+			Site.Type = Type;
+			if (CurrentFrame != 0) {
+				Site.FrameCount++;
+				Site.FrameBytes += Event.Size;
+				FrameAllocations++;
+			}
+
+			if (Counted) {
+				TagStats& Tag = Tags[Type];
+				Tag.Current += Event.Size;
+				Tag.Count++;
+				Tag.Peak = std::max(Tag.Peak, Tag.Current);
+			}
+		}
+		else if (Event.Op == eMemory_Trace_Free) {
+			auto It = Live.find(Event.Address);
+			if (It == Live.end()) {
+				UnmatchedFrees++;
+				continue;
+			}
+
+			const LiveBlock& Block = It->second;
+			double Seconds = (double)(Event.Timestamp - Block.Timestamp) / 1000000000.0;
+			uint32_t Bucket = 0;
+			for (double Limit = 0.000001; Bucket < LIFETIME_BUCKET_COUNT - 1 && Seconds >= Limit; Limit *= 10.0) {
+				Bucket++;
+			}
+			Lifetimes[Bucket]++;
+
+			if ((Block.Flags & MEMORY_TRACE_FLAG_SUB_ALLOCATION) == 0) {
+				Tags[Block.Type].Current -= std::min(Tags[Block.Type].Current, Block.Size);
+			}
+			Live.erase(It);
+		}
+	}
+
+	if (CurrentFrame != 0 && FrameAllocations > BusiestFrameCount) {
+		BusiestFrame = CurrentFrame;
+		BusiestFrameCount = FrameAllocations;
+	}
+
+	double Duration = Events.empty() ? 0.0 : (double)(Events.back().Timestamp - Header.StartTime) / 1000000000.0;
+	printf("Trace '%s': %llu events, %llu threads, %llu frames, %.2fs.\n", argv[1],
+		(unsigned long long)Events.size(), (unsigned long long)Threads.size(), (unsigned long long)FrameCount, Duration);
+	if (!ReachedShutdown) {
+		printf("The trace has no shutdown marker, live blocks are reported as of the last event.\n");
+	}
+	if (UnmatchedFrees > 0) {
+		printf("%llu frees had no matching allocation in the trace.\n", (unsigned long long)UnmatchedFrees);
+	}
+
+	std::vector<CallSiteStats> Sites;
+	Sites.reserve(CallSites.size());
+	for (auto& Pair : CallSites) {
+		Sites.push_back(Pair.second);
+	}
+
+	// Top allocators of the frame loop.
+	if (FrameCount > 0) {
+		printf("\nTop allocators per frame (busiest frame %llu with %llu allocations):\n",
+			(unsigned long long)BusiestFrame, (unsigned long long)BusiestFrameCount);
+		std::sort(Sites.begin(), Sites.end(), [](const CallSiteStats& a, const CallSiteStats& b) {
+			return a.FrameCount != b.FrameCount ? a.FrameCount > b.FrameCount : a.FrameBytes > b.FrameBytes;
+		});
+		for (size_t i = 0; i < Sites.size() && i < TopCount && Sites[i].FrameCount > 0; ++i) {
+			printf(" %10.2f allocs/frame ", (double)Sites[i].FrameCount / (double)FrameCount);
+			PrintSize((double)Sites[i].FrameBytes / (double)FrameCount);
+			printf("/frame  %-18s ", GetTypeName(Types, Sites[i].Type));
+			PrintCallSite(Sites[i].CallSite, Header.Anchor);
+			printf("\n");
+		}
+	}
+
+	// Lifetime histogram.
+	{
+		static const char* BucketNames[LIFETIME_BUCKET_COUNT] = {
+			"< 1us", "< 10us", "< 100us", "< 1ms", "< 10ms", "< 100ms", "< 1s", "< 10s", "< 100s", ">= 100s"
+		};
+		uint64_t Total = 0;
+		for (uint32_t i = 0; i < LIFETIME_BUCKET_COUNT; ++i) {
+			Total += Lifetimes[i];
+		}
+
+		printf("\nAllocation lifetimes (%llu freed blocks):\n", (unsigned long long)Total);
+		for (uint32_t i = 0; i < LIFETIME_BUCKET_COUNT; ++i) {
+			double Percent = Total > 0 ? (double)Lifetimes[i] * 100.0 / (double)Total : 0.0;
+			printf(" %8s %12llu %6.2f%% ", BucketNames[i], (unsigned long long)Lifetimes[i], Percent);
+			for (int Bar = 0; Bar < (int)(Percent / 2.0); ++Bar) {
+				printf("#");
+			}
+			printf("\n");
+		}
+	}
+
+	// Peak usage per tag.
+	printf("\nPeak usage per tag:\n");
+	for (size_t i = 0; i < Tags.size(); ++i) {
+		if (Tags[i].Count == 0) {
+			continue;
+		}
+		printf(" %-18s peak ", GetTypeName(Types, (uint16_t)i));
+		PrintSize((double)Tags[i].Peak);
+		printf("  at end ");
+		PrintSize((double)Tags[i].Current);
+		printf("  %llu allocations\n", (unsigned long long)Tags[i].Count);
+	}
+
+	// Leaks at Memory::Shutdown(), grouped by call site.
+	{
+		std::unordered_map<uint64_t, CallSiteStats> Leaks;
+		uint64_t LeakBytes = 0;
+		for (auto& Pair : Live) {
+			CallSiteStats& Site = Leaks[Pair.second.CallSite];
+			Site.CallSite = Pair.second.CallSite;
+			Site.Type = Pair.second.Type;
+			Site.LeakCount++;
+			Site.LeakBytes += Pair.second.Size;
+			LeakBytes += Pair.second.Size;
+		}
+
+		printf("\n%llu blocks (", (unsigned long long)Live.size());
+		PrintSize((double)LeakBytes);
+		printf(") still alive at %s:\n", ReachedShutdown ? "Memory::Shutdown()" : "the end of the trace");
+
+		Sites.clear();
+		for (auto& Pair : Leaks) {
+			Sites.push_back(Pair.second);
+		}
+		std::sort(Sites.begin(), Sites.end(), [](const CallSiteStats& a, const CallSiteStats& b) {
+			return a.LeakBytes > b.LeakBytes;
+		});
+		for (size_t i = 0; i < Sites.size() && i < TopCount; ++i) {
+			printf(" %8llu blocks ", (unsigned long long)Sites[i].LeakCount);
+			PrintSize((double)Sites[i].LeakBytes);
+			printf("  %-18s ", GetTypeName(Types, Sites[i].Type));
+			PrintCallSite(Sites[i].CallSite, Header.Anchor);
+			printf("\n");
+		}
+	}
+
+	return 0;
+}